@@ -19,8 +19,9 @@
  */
 
 /*
- * We simulate a simple scenario where a node sends a packet to another node, each second for a time of 1000000 seconds.
+ * We simulate a simple scenario where a node sends a packet to another node, each second for a time of 100 seconds.
  * We trace the energy consumption and the time spent in the specific transceiver states.
+ * With --lifetime, the node sends until the first node dies, and the periodic regime is fast-forwarded.
  */
 #include <ns3/log.h>
 #include <ns3/core-module.h>
@@ -33,6 +34,12 @@
 #include <ns3/packet.h>
 #include "ns3/lr-wpan-radio-energy-model.h"
 #include "ns3/basic-energy-source.h"
+#include "ns3/basic-energy-source-helper.h"
+#include "ns3/lr-wpan-radio-energy-model-helper.h"
+#include "ns3/lr-wpan-lifetime-estimator.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
 
 #include <iostream>
 
@@ -58,11 +65,23 @@ static void GetTotalEnergyConsumption(std::string context, double oldValue,
 	//std::cout << "Count" << count << "\n";
 }
 
+/**
+ * Sends a packet and schedules the next one a second later, so that the
+ * traffic continues over the whole lifetime of the network.
+ */
+static void SendPeriodically(Ptr<LrWpanMac> mac, McpsDataRequestParams params,
+		int payload) {
+	mac->McpsDataRequest(params, Create<Packet>(payload));
+	Simulator::Schedule(Seconds(1), &SendPeriodically, mac, params, payload);
+}
+
 int main(int argc, char *argv[]) {
 	bool verbose = false;
 	bool jrbEnabled = false; //to enable the JRB
 	int payload = 0; //to determine the payload size (in bytes) of the packets
 	bool e_logger = false;
+	bool lifetime = false; //to estimate the lifetime of the network
+	std::string traceFile = ""; //to record every energy sample in a binary trace
 	ns3::PacketMetadata::Enable();
 
 	CommandLine cmd;
@@ -72,6 +91,12 @@ int main(int argc, char *argv[]) {
 	cmd.AddValue("payload",
 			"determine the payload size (in bytes) of the packets", payload);
 	cmd.AddValue("e_logging", "log energy changes", e_logger);
+	cmd.AddValue("lifetime",
+			"send until the first node dies, fast-forwarding the periodic regime",
+			lifetime);
+	cmd.AddValue("traceFile",
+			"record every energy sample in a binary trace (read it with utils/read-binary-trace.py)",
+			traceFile);
 
 	cmd.Parse(argc, argv);
 
@@ -121,25 +146,22 @@ int main(int argc, char *argv[]) {
 	n0->AddDevice(dev0);
 	n1->AddDevice(dev1);
 
-	Ptr<LrWpanRadioEnergyModel> em0 = CreateObject<LrWpanRadioEnergyModel>();
-	Ptr<LrWpanRadioEnergyModel> em1 = CreateObject<LrWpanRadioEnergyModel>();
-
-	Ptr<BasicEnergySource> es0 = CreateObject<BasicEnergySource>();
-	es0->SetSupplyVoltage(1.2); //1.2 Volt
-	es0->SetInitialEnergy(11232.0); //11232 Joules energy
-	Ptr<BasicEnergySource> es1 = CreateObject<BasicEnergySource>();
-	es1->SetSupplyVoltage(1.2);
-	es1->SetInitialEnergy(11232.0);
+	// Install an energy source and a radio energy model on each node
+	BasicEnergySourceHelper sourceHelper;
+	sourceHelper.Set("BasicEnergySupplyVoltageV", DoubleValue(1.2)); //1.2 Volt
+	sourceHelper.Set("BasicEnergySourceInitialEnergyJ", DoubleValue(11232.0)); //11232 Joules energy
+	EnergySourceContainer sources = sourceHelper.Install(NodeContainer(n0, n1));
 
-	es0->SetNode(n0);
-	es0->AppendDeviceEnergyModel(em0);
-	em0->SetEnergySource(es0);
-	em0->AttachPhy(dev0->GetPhy());
+	NetDeviceContainer devices;
+	devices.Add(dev0);
+	devices.Add(dev1);
+	LrWpanRadioEnergyModelHelper radioHelper;
+	DeviceEnergyModelContainer models = radioHelper.Install(devices, sources);
 
-	es1->SetNode(n1);
-	es1->AppendDeviceEnergyModel(em1);
-	em1->SetEnergySource(es1);
-	em1->AttachPhy(dev1->GetPhy());
+	Ptr<BasicEnergySource> es0 = DynamicCast<BasicEnergySource>(sources.Get(0));
+	Ptr<BasicEnergySource> es1 = DynamicCast<BasicEnergySource>(sources.Get(1));
+	Ptr<LrWpanRadioEnergyModel> em0 = DynamicCast<LrWpanRadioEnergyModel>(models.Get(0));
+	Ptr<LrWpanRadioEnergyModel> em1 = DynamicCast<LrWpanRadioEnergyModel>(models.Get(1));
 
 	//++++++++Enable/Disable JRB, Energy Logging++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 	if (jrbEnabled) {
@@ -157,6 +179,19 @@ int main(int argc, char *argv[]) {
 		es1->TraceConnect("RemainingEnergy", std::string("phy1"),
 				MakeCallback(&GetTotalEnergyConsumption));
 	}
+
+	Ptr<BinaryTraceRecorder> recorder;
+	if (!traceFile.empty()) {
+		recorder = CreateObject<BinaryTraceRecorder>(traceFile);
+		es0->TraceConnectWithoutContext("RemainingEnergy",
+				recorder->MakeTracedValueSink<double>(recorder->AddSeries("phy0/RemainingEnergy")));
+		es1->TraceConnectWithoutContext("RemainingEnergy",
+				recorder->MakeTracedValueSink<double>(recorder->AddSeries("phy1/RemainingEnergy")));
+		em0->TraceConnectWithoutContext("TotalEnergyConsumption",
+				recorder->MakeTracedValueSink<double>(recorder->AddSeries("phy0/TotalEnergyConsumption")));
+		em1->TraceConnectWithoutContext("TotalEnergyConsumption",
+				recorder->MakeTracedValueSink<double>(recorder->AddSeries("phy1/TotalEnergyConsumption")));
+	}
 	//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 	Ptr<ConstantPositionMobilityModel> sender0Mobility = CreateObject<
@@ -179,26 +214,49 @@ int main(int argc, char *argv[]) {
 	params.m_msduHandle = 0;
 	params.m_txOptions = TX_OPTION_NONE;	//no Acknowledgment requested
 
-	//transmit one packet each second for one million seconds:
-	for (int i = 0; i < 100; i++) {
-		Ptr<Packet> p = Create<Packet>(payload); // payload can be set via parameter
-		Simulator::Schedule(Seconds(i), &LrWpanMac::McpsDataRequest,
-				dev1->GetMac(), params, p);
+	Ptr<LrWpanLifetimeEstimator> estimator;
+	if (lifetime) {
+		//transmit one packet each second until the first node dies; the
+		//estimator skips the periodic regime and stops the simulation
+		estimator = CreateObject<LrWpanLifetimeEstimator>();
+		estimator->Install(models, sources);
+		Simulator::Schedule(Seconds(0), &SendPeriodically, dev1->GetMac(),
+				params, payload);
+		Simulator::Stop(Seconds(1000));
+	} else {
+		//transmit one packet each second for 100 seconds:
+		for (int i = 0; i < 100; i++) {
+			Ptr<Packet> p = Create<Packet>(payload); // payload can be set via parameter
+			Simulator::Schedule(Seconds(i), &LrWpanMac::McpsDataRequest,
+					dev1->GetMac(), params, p);
+		}
+		Simulator::Stop(Seconds(100));
 	}
-
-	Simulator::Stop(Seconds(100));
 	Simulator::Run();
+	if (recorder) {
+		recorder->Close();
+	}
+
+	if (lifetime) {
+		NS_LOG_UNCOND("Simulated Time "<< Simulator::Now().GetSeconds());
+		NS_LOG_UNCOND("Skipped Time "<< estimator->GetTimeOffset().GetSeconds());
+		NS_LOG_UNCOND("First Node Died "<< estimator->GetFirstDepletionTime().GetSeconds());
+		NS_LOG_UNCOND("Receiver Depleted "<< (estimator->GetDepletionTime(0) != Time::Max()));
+		NS_LOG_UNCOND("Sender Depleted "<< (estimator->GetDepletionTime(1) != Time::Max()));
+	}
 
 	//Statistics for the analysis:
-	NS_LOG_UNCOND("TX_ON Time Receiver "<< em0->trans_duration);
-	NS_LOG_UNCOND("RX_ON Time Receiver "<< em0->recv_duration);
-	NS_LOG_UNCOND("TRX_OFF Time Receiver "<< em0->sleep_duration);
+	NS_LOG_UNCOND("TX_ON Time Receiver "<< (em0->GetStateResidency(IEEE_802_15_4_PHY_TX_ON) + em0->GetStateResidency(IEEE_802_15_4_PHY_BUSY_TX)).GetSeconds());
+	NS_LOG_UNCOND("RX_ON Time Receiver "<< (em0->GetStateResidency(IEEE_802_15_4_PHY_RX_ON) + em0->GetStateResidency(IEEE_802_15_4_PHY_BUSY_RX)).GetSeconds());
+	NS_LOG_UNCOND("TRX_OFF Time Receiver "<< em0->GetStateResidency(IEEE_802_15_4_PHY_TRX_OFF).GetSeconds());
+	NS_LOG_UNCOND("Transition Time Receiver "<< em0->GetStateResidency(IEEE_802_15_4_PHY_UNSPECIFIED).GetSeconds());
 	NS_LOG_UNCOND("Remaining Energy Receiver " << es0->GetRemainingEnergy());
 	NS_LOG_UNCOND("Consumed Energy Receiver " << es0-> GetConsumedEnergy());
 
-	NS_LOG_UNCOND("TX_ON Time Sender "<< em1->trans_duration);
-	NS_LOG_UNCOND("RX_ON Time Sender "<< em1->recv_duration);
-	NS_LOG_UNCOND("TRX_OFF Time Sender "<< em1->sleep_duration);
+	NS_LOG_UNCOND("TX_ON Time Sender "<< (em1->GetStateResidency(IEEE_802_15_4_PHY_TX_ON) + em1->GetStateResidency(IEEE_802_15_4_PHY_BUSY_TX)).GetSeconds());
+	NS_LOG_UNCOND("RX_ON Time Sender "<< (em1->GetStateResidency(IEEE_802_15_4_PHY_RX_ON) + em1->GetStateResidency(IEEE_802_15_4_PHY_BUSY_RX)).GetSeconds());
+	NS_LOG_UNCOND("TRX_OFF Time Sender "<< em1->GetStateResidency(IEEE_802_15_4_PHY_TRX_OFF).GetSeconds());
+	NS_LOG_UNCOND("Transition Time Sender "<< em1->GetStateResidency(IEEE_802_15_4_PHY_UNSPECIFIED).GetSeconds());
 	NS_LOG_UNCOND("Remaining Energy Sender " << es1->GetRemainingEnergy());
 	NS_LOG_UNCOND("Consumed Energy Sender " << es1-> GetConsumedEnergy());
 
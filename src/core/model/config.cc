@@ -18,14 +18,17 @@
  * Authors: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "config.h"
-#include "singleton.h"
+#include "simulation-context.h"
 #include "object.h"
 #include "global-value.h"
 #include "object-ptr-container.h"
 #include "names.h"
 #include "pointer.h"
+#include "trace-source-accessor.h"
 #include "log.h"
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 
 /**
@@ -40,6 +43,41 @@ NS_LOG_COMPONENT_DEFINE ("Config");
 
 namespace Config {
 
+/**
+ * \ingroup config
+ * Look up a trace source on the objects of a MatchContainer, which are
+ * mostly of the same type: the TypeId is searched again only when the
+ * type changes from one object to the next.
+ */
+class TraceSourceLookup
+{
+public:
+  /**
+   * \param name The name of the trace source.
+   */
+  TraceSourceLookup (std::string name)
+    : m_name (name)
+  {}
+  /**
+   * \param object The object.
+   * \returns The accessor of the trace source of the object, or 0.
+   */
+  Ptr<const TraceSourceAccessor> Get (Ptr<Object> object)
+  {
+    TypeId tid = object->GetInstanceTypeId ();
+    if (tid != m_tid)
+      {
+        m_tid = tid;
+        m_accessor = tid.LookupTraceSourceByName (m_name);
+      }
+    return m_accessor;
+  }
+private:
+  std::string m_name;                        //!< The name of the trace source.
+  TypeId m_tid;                              //!< The type of the last object.
+  Ptr<const TraceSourceAccessor> m_accessor; //!< The accessor of m_tid.
+};
+
 MatchContainer::MatchContainer ()
 {
   NS_LOG_FUNCTION (this);
@@ -105,11 +143,15 @@ MatchContainer::Connect (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
   NS_ASSERT (m_objects.size () == m_contexts.size ());
+  TraceSourceLookup lookup (name);
   for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
       Ptr<Object> object = m_objects[i];
-      std::string ctx = m_contexts[i] + name;
-      object->TraceConnect (name, ctx, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (object);
+      if (accessor != 0)
+        {
+          accessor->Connect (PeekPointer (object), m_contexts[i] + name, cb);
+        }
     }
 }
 void 
@@ -117,10 +159,15 @@ MatchContainer::ConnectWithoutContext (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
 
+  TraceSourceLookup lookup (name);
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      object->TraceConnectWithoutContext (name, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (object);
+      if (accessor != 0)
+        {
+          accessor->ConnectWithoutContext (PeekPointer (object), cb);
+        }
     }
 }
 void 
@@ -128,105 +175,164 @@ MatchContainer::Disconnect (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
   NS_ASSERT (m_objects.size () == m_contexts.size ());
+  TraceSourceLookup lookup (name);
   for (uint32_t i = 0; i < m_objects.size (); ++i)
     {
       Ptr<Object> object = m_objects[i];
-      std::string ctx = m_contexts[i] + name;
-      object->TraceDisconnect (name, ctx, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (object);
+      if (accessor != 0)
+        {
+          accessor->Disconnect (PeekPointer (object), m_contexts[i] + name, cb);
+        }
     }
 }
 void 
 MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << name << &cb);
+  TraceSourceLookup lookup (name);
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      object->TraceDisconnectWithoutContext (name, cb);
+      Ptr<const TraceSourceAccessor> accessor = lookup.Get (object);
+      if (accessor != 0)
+        {
+          accessor->DisconnectWithoutContext (PeekPointer (object), cb);
+        }
     }
 }
 
 } // namespace Config
 
+/**
+ * \ingroup config
+ * Match the indexes of an ObjectPtrContainer against a path element:
+ * "*", an index, a range "[lo-hi]", or several of them separated by "|".
+ * The element is parsed once, into a list of ranges.
+ */
 class ArrayMatcher
 {
 public:
   ArrayMatcher (std::string element);
   bool Matches (uint32_t i) const;
+  /**
+   * Get the indexes which can match, when they are fewer than the items
+   * of the container.
+   *
+   * \param [in] n The number of items of the container.
+   * \param [out] indexes The indexes below n which can match, in
+   *              increasing order.
+   * \returns false if all the items must be checked.
+   */
+  bool GetIndexes (uint32_t n, std::vector<uint32_t> *indexes) const;
 private:
+  void Parse (std::string element);
   bool StringToUint32 (std::string str, uint32_t *value) const;
-  std::string m_element;
+  bool m_all;  //!< The element matches all the indexes.
+  /** The inclusive ranges of indexes which match. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 };
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (uint32_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      Parse (element.substr (0, tmp-0));
+      Parse (element.substr (tmp+1, element.size () - (tmp + 1)));
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
           StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
+          min <= max)
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
       return true;
     }
-  NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = m_ranges.begin ();
+       j != m_ranges.end (); j++)
+    {
+      if (i >= j->first && i <= j->second)
+        {
+          return true;
+        }
+    }
   return false;
 }
+bool
+ArrayMatcher::GetIndexes (uint32_t n, std::vector<uint32_t> *indexes) const
+{
+  NS_LOG_FUNCTION (this << n << indexes);
+  if (m_all)
+    {
+      return false;
+    }
+  uint64_t count = 0;
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = m_ranges.begin ();
+       j != m_ranges.end (); j++)
+    {
+      if (j->first < n)
+        {
+          count += std::min (j->second, n - 1) - j->first + 1;
+        }
+    }
+  if (count >= n)
+    {
+      return false;
+    }
+  indexes->clear ();
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = m_ranges.begin ();
+       j != m_ranges.end (); j++)
+    {
+      for (uint32_t i = j->first; i < n && i <= j->second; i++)
+        {
+          indexes->push_back (i);
+        }
+    }
+  std::sort (indexes->begin (), indexes->end ());
+  indexes->erase (std::unique (indexes->begin (), indexes->end ()), indexes->end ());
+  return true;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
@@ -239,29 +345,207 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 }
 
 
+/**
+ * \ingroup config
+ * A path split into its elements, which is resolved many times.
+ */
+class CompiledPath : public SimpleRefCount<CompiledPath>
+{
+public:
+  /**
+   * Compile a path.
+   *
+   * \param path The path.
+   */
+  CompiledPath (std::string path);
+
+  std::vector<std::string> m_items;     //!< The elements of the path.
+  std::vector<ArrayMatcher> m_matchers; //!< The elements, as indexes of a container.
+};
+
+CompiledPath::CompiledPath (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::string::size_type start = path.find ("/") == 0 ? 1 : 0;
+  while (start < path.size ())
+    {
+      std::string::size_type next = path.find ("/", start);
+      if (next == std::string::npos)
+        {
+          next = path.size ();
+        }
+      std::string item = path.substr (start, next - start);
+      m_items.push_back (item);
+      m_matchers.push_back (ArrayMatcher (item));
+      start = next + 1;
+    }
+}
+
+/**
+ * \ingroup config
+ * An attribute through which a path element is resolved.
+ */
+struct PathAttribute
+{
+  std::string name;  //!< The name of the attribute.
+  bool pointer;      //!< The attribute is a PointerValue, else an ObjectPtrContainerValue.
+  /** The accessor of the container, to get its items one at a time. */
+  const ObjectPtrContainerAccessor *container;
+};
+
+/**
+ * \ingroup config
+ * The compiled paths and the attributes of the types they went through,
+ * so that the same path, or the same element on objects of the same
+ * type, is not parsed and looked up again.
+ */
+class PathCache
+{
+public:
+  /**
+   * Get a compiled path.
+   *
+   * \param path The path, canonical.
+   * \returns The compiled path.
+   */
+  Ptr<const CompiledPath> Compile (std::string path);
+  /**
+   * Look up a TypeId of a "$" element.
+   *
+   * \param name The name of the TypeId.
+   * \returns The TypeId.
+   */
+  TypeId LookupTypeId (const std::string &name);
+  /**
+   * Look up the attributes of a type and its parents matching an element.
+   *
+   * \param tid The type.
+   * \param item The element, an attribute name or "*".
+   * \returns The PointerValue and ObjectPtrContainerValue attributes.
+   */
+  const std::vector<PathAttribute> &LookupAttributes (TypeId tid, const std::string &item);
+
+private:
+  /** The most paths kept; the loops on the nodes give many paths used once. */
+  static const uint32_t MAX_PATHS = 1024;
+  /** The compiled paths. */
+  std::map<std::string, Ptr<const CompiledPath> > m_paths;
+  /** The TypeIds of the "$" elements. */
+  std::map<std::string, TypeId> m_tids;
+  /** The attributes, by TypeId uid and element. */
+  std::map<std::pair<uint16_t, std::string>, std::vector<PathAttribute> > m_attributes;
+};
+
+Ptr<const CompiledPath>
+PathCache::Compile (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::map<std::string, Ptr<const CompiledPath> >::const_iterator i = m_paths.find (path);
+  if (i != m_paths.end ())
+    {
+      return i->second;
+    }
+  if (m_paths.size () >= MAX_PATHS)
+    {
+      m_paths.clear ();
+    }
+  Ptr<const CompiledPath> compiled = Create<CompiledPath> (path);
+  m_paths[path] = compiled;
+  return compiled;
+}
+
+TypeId
+PathCache::LookupTypeId (const std::string &name)
+{
+  NS_LOG_FUNCTION (this << name);
+  std::map<std::string, TypeId>::const_iterator i = m_tids.find (name);
+  if (i != m_tids.end ())
+    {
+      return i->second;
+    }
+  TypeId tid = TypeId::LookupByName (name);
+  m_tids[name] = tid;
+  return tid;
+}
+
+const std::vector<PathAttribute> &
+PathCache::LookupAttributes (TypeId tid, const std::string &item)
+{
+  NS_LOG_FUNCTION (this << tid << item);
+  std::pair<uint16_t, std::string> key = std::make_pair (tid.GetUid (), item);
+  std::map<std::pair<uint16_t, std::string>, std::vector<PathAttribute> >::iterator i;
+  i = m_attributes.find (key);
+  if (i != m_attributes.end ())
+    {
+      return i->second;
+    }
+  std::vector<PathAttribute> &attributes = m_attributes[key];
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t j = 0; j < tid.GetAttributeN (); j++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (j);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          PathAttribute attribute;
+          attribute.name = info.name;
+          attribute.container = 0;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.pointer = true;
+              attributes.push_back (attribute);
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.pointer = false;
+              attribute.container = dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (info.accessor));
+              attributes.push_back (attribute);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+      nextTid = tid.GetParent ();
+    } while (nextTid != tid);
+  return attributes;
+}
+
+
+/**
+ * \ingroup config
+ * Resolve a path to the objects it matches, element by element, from a
+ * root object.
+ */
 class Resolver
 {
 public:
-  Resolver (std::string path);
+  Resolver (std::string path, PathCache *cache);
   virtual ~Resolver ();
 
   void Resolve (Ptr<Object> root);
 private:
   void Canonicalize (void);
-  void DoResolve (std::string path, Ptr<Object> root);
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoResolve (uint32_t index, Ptr<Object> root);
+  void DoArrayResolve (uint32_t index, Ptr<Object> root, const PathAttribute &attribute);
   void DoResolveOne (Ptr<Object> object);
   std::string GetResolvedPath (void) const;
   virtual void DoOne (Ptr<Object> object, std::string path) = 0;
   std::vector<std::string> m_workStack;
   std::string m_path;
+  PathCache *m_cache;
+  Ptr<const CompiledPath> m_compiled;
 };
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Resolver::Resolver (std::string path, PathCache *cache)
+  : m_path (path),
+    m_cache (cache)
 {
-  NS_LOG_FUNCTION (this << path);
+  NS_LOG_FUNCTION (this << path << cache);
   Canonicalize ();
+  m_compiled = m_cache->Compile (m_path);
 }
 Resolver::~Resolver ()
 {
@@ -292,7 +576,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -318,13 +602,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t index, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << index << root);
 
-  if (next == std::string::npos)
+  if (index == m_compiled->m_items.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name 
@@ -340,8 +622,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const std::string &item = m_compiled->m_items[index];
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -352,11 +633,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.compare (0, 5, "Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (index + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -373,7 +653,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (index + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -395,7 +675,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
       // This is a call to GetObject
       std::string tidString = item.substr (1, item.size () - 1);
       NS_LOG_DEBUG ("GetObject="<<tidString<<" on path="<<GetResolvedPath ());
-      TypeId tid = TypeId::LookupByName (tidString);
+      TypeId tid = m_cache->LookupTypeId (tidString);
       Ptr<Object> object = root->GetObject<Object> (tid);
       if (object == 0)
         {
@@ -403,67 +683,44 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (index + 1, object);
       m_workStack.pop_back ();
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      const std::vector<PathAttribute> &attributes =
+        m_cache->LookupAttributes (root->GetInstanceTypeId (), item);
       bool foundMatch = false;
-      
-      do
+      for (std::vector<PathAttribute>::const_iterator i = attributes.begin (); i != attributes.end (); i++)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          if (i->pointer)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<i->name<<" on path="<<GetResolvedPath ());
+              PointerValue ptr;
+              root->GetAttribute (i->name, ptr);
+              Ptr<Object> object = ptr.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\""<<item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoResolve (index + 1, object);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<i->name<<" on path="<<GetResolvedPath ());
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoArrayResolve (index + 1, root, *i);
+              m_workStack.pop_back ();
+            }
+        }
       
       if (!foundMatch)
         {
@@ -474,32 +731,79 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t index, Ptr<Object> root, const PathAttribute &attribute)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << index << root << attribute.name);
+  if (index == m_compiled->m_items.size ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  const ArrayMatcher &matcher = m_compiled->m_matchers[index];
 
-  ArrayMatcher matcher = ArrayMatcher (item);
-  ObjectPtrContainerValue::Iterator it;
-  for (it = container.Begin (); it != container.End (); ++it)
+  // The matching items, in increasing order of index, as they would be
+  // in an ObjectPtrContainerValue.
+  std::vector<std::pair<uint32_t, Ptr<Object> > > items;
+  uint32_t n;
+  if (attribute.container != 0 && attribute.container->GetN (PeekPointer (root), &n))
     {
-      if (matcher.Matches ((*it).first))
+      // Get the items directly from the container, without copying it:
+      // first by position, which is the index of the items of a vector.
+      std::vector<uint32_t> positions;
+      bool direct = matcher.GetIndexes (n, &positions);
+      for (std::vector<uint32_t>::const_iterator i = positions.begin (); direct && i != positions.end (); i++)
         {
-          std::ostringstream oss;
-          oss << (*it).first;
-          m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
-          m_workStack.pop_back ();
+          uint32_t k;
+          Ptr<Object> object = attribute.container->Get (PeekPointer (root), *i, &k);
+          if (k != *i)
+            {
+              direct = false;
+            }
+          items.push_back (std::make_pair (k, object));
+        }
+      if (!direct)
+        {
+          items.clear ();
+          bool sorted = true;
+          for (uint32_t i = 0; i < n; i++)
+            {
+              uint32_t k;
+              Ptr<Object> object = attribute.container->Get (PeekPointer (root), i, &k);
+              if (matcher.Matches (k))
+                {
+                  sorted = sorted && (items.empty () || items.back ().first < k);
+                  items.push_back (std::make_pair (k, object));
+                }
+            }
+          if (!sorted)
+            {
+              // keep the first item of an index, as ObjectPtrContainerValue
+              std::map<uint32_t, Ptr<Object> > byIndex (items.begin (), items.end ());
+              items.assign (byIndex.begin (), byIndex.end ());
+            }
+        }
+    }
+  else
+    {
+      ObjectPtrContainerValue container;
+      root->GetAttribute (attribute.name, container);
+      for (ObjectPtrContainerValue::Iterator it = container.Begin (); it != container.End (); ++it)
+        {
+          if (matcher.Matches ((*it).first))
+            {
+              items.push_back (*it);
+            }
         }
     }
+
+  for (std::vector<std::pair<uint32_t, Ptr<Object> > >::const_iterator it = items.begin ();
+       it != items.end (); ++it)
+    {
+      std::ostringstream oss;
+      oss << it->first;
+      m_workStack.push_back (oss.str ());
+      DoResolve (index + 1, it->second);
+      m_workStack.pop_back ();
+    }
 }
 
 
@@ -523,8 +827,20 @@ private:
   void ParsePath (std::string path, std::string *root, std::string *leaf) const;
   typedef std::vector<Ptr<Object> > Roots;
   Roots m_roots;
+  PathCache m_cache;
 };
 
+/**
+ * \ingroup config
+ * \returns The ConfigImpl of the SimulationContext of the calling thread.
+ */
+static ConfigImpl *
+GetConfigImpl (void)
+{
+  static ContextLocal<ConfigImpl> config;
+  return &config.Get ();
+}
+
 void 
 ConfigImpl::ParsePath (std::string path, std::string *root, std::string *leaf) const
 {
@@ -593,8 +909,8 @@ ConfigImpl::LookupMatches (std::string path)
   class LookupMatchesResolver : public Resolver 
   {
   public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
+    LookupMatchesResolver (std::string path, PathCache *cache)
+      : Resolver (path, cache)
     {}
     virtual void DoOne (Ptr<Object> object, std::string path) {
       m_objects.push_back (object);
@@ -602,7 +918,7 @@ ConfigImpl::LookupMatches (std::string path)
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  } resolver = LookupMatchesResolver (path, &m_cache);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -678,7 +994,7 @@ void Reset (void)
 void Set (std::string path, const AttributeValue &value)
 {
   NS_LOG_FUNCTION (path << &value);
-  Singleton<ConfigImpl>::Get ()->Set (path, value);
+  GetConfigImpl ()->Set (path, value);
 }
 void SetDefault (std::string name, const AttributeValue &value)
 {
@@ -733,53 +1049,53 @@ bool SetGlobalFailSafe (std::string name, const AttributeValue &value)
 void ConnectWithoutContext (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  Singleton<ConfigImpl>::Get ()->ConnectWithoutContext (path, cb);
+  GetConfigImpl ()->ConnectWithoutContext (path, cb);
 }
 void DisconnectWithoutContext (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  Singleton<ConfigImpl>::Get ()->DisconnectWithoutContext (path, cb);
+  GetConfigImpl ()->DisconnectWithoutContext (path, cb);
 }
 void 
 Connect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  Singleton<ConfigImpl>::Get ()->Connect (path, cb);
+  GetConfigImpl ()->Connect (path, cb);
 }
 void 
 Disconnect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
-  Singleton<ConfigImpl>::Get ()->Disconnect (path, cb);
+  GetConfigImpl ()->Disconnect (path, cb);
 }
 Config::MatchContainer LookupMatches (std::string path)
 {
   NS_LOG_FUNCTION (path);
-  return Singleton<ConfigImpl>::Get ()->LookupMatches (path);
+  return GetConfigImpl ()->LookupMatches (path);
 }
 
 void RegisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (obj);
-  Singleton<ConfigImpl>::Get ()->RegisterRootNamespaceObject (obj);
+  GetConfigImpl ()->RegisterRootNamespaceObject (obj);
 }
 
 void UnregisterRootNamespaceObject (Ptr<Object> obj)
 {
   NS_LOG_FUNCTION (obj);
-  Singleton<ConfigImpl>::Get ()->UnregisterRootNamespaceObject (obj);
+  GetConfigImpl ()->UnregisterRootNamespaceObject (obj);
 }
 
 uint32_t GetRootNamespaceObjectN (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  return Singleton<ConfigImpl>::Get ()->GetRootNamespaceObjectN ();
+  return GetConfigImpl ()->GetRootNamespaceObjectN ();
 }
 
 Ptr<Object> GetRootNamespaceObject (uint32_t i)
 {
   NS_LOG_FUNCTION (i);
-  return Singleton<ConfigImpl>::Get ()->GetRootNamespaceObject (i);
+  return GetConfigImpl ()->GetRootNamespaceObject (i);
 }
 
 } // namespace Config
@@ -25,6 +25,8 @@
 
 #include "ptr.h"
 #include "pointer.h"
+#include "string.h"
+#include "uinteger.h"
 #include "assert.h"
 #include "log.h"
 
@@ -53,6 +55,38 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("SchedulerTraceFile",
+                   "The file to which the operations on the scheduler are "
+                   "recorded, for utils/bench-scheduler-replay.cc. "
+                   "Nothing is recorded if empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::SetSchedulerTraceFile,
+                                       &DefaultSimulatorImpl::GetSchedulerTraceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ProfileFile",
+                   "The file to which the wall-clock time and the number "
+                   "of the events, by handler and context, are written "
+                   "when the simulator is destroyed, sorted by time. "
+                   "The events are not profiled if this attribute and "
+                   "ProfileFoldedFile are empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::SetProfileFile,
+                                       &DefaultSimulatorImpl::GetProfileFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ProfileFoldedFile",
+                   "The file to which the profile of the events is written "
+                   "as folded stacks, the input of flamegraph.pl.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::SetProfileFoldedFile,
+                                       &DefaultSimulatorImpl::GetProfileFoldedFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ProfileSamplePeriod",
+                   "Measure the time of one profiled event out of this "
+                   "number; all the events are counted.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::SetProfileSamplePeriod,
+                                         &DefaultSimulatorImpl::GetProfileSamplePeriod),
+                   MakeUintegerChecker<uint32_t> (1))
   ;
   return tid;
 }
@@ -71,13 +105,17 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = 0xffffffff;
   m_unscheduledEvents = 0;
-  m_eventsWithContextEmpty = true;
   m_main = SystemThread::Self();
+  m_schedulerTrace = 0;
+  m_profileSamplePeriod = 1;
+  m_profiler = 0;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_schedulerTrace;
+  delete m_profiler;
 }
 
 void
@@ -90,6 +128,13 @@ DefaultSimulatorImpl::DoDispose (void)
       next.impl->Unref ();
     }
   m_events = 0;
+  SetSchedulerTraceFile ("");
+  if (m_profiler != 0)
+    {
+      m_profiler->Write (m_profileFile, m_profileFoldedFile);
+      delete m_profiler;
+      m_profiler = 0;
+    }
   SimulatorImpl::DoDispose ();
 }
 void
@@ -144,7 +189,18 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_schedulerTrace != 0 && !next.impl->IsCancelled ())
+    {
+      m_schedulerTrace->RecordExecute (next.key.m_uid);
+    }
+  if (m_profiler != 0)
+    {
+      m_profiler->Invoke (next.impl, next.key.m_context);
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -159,22 +215,18 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  if (m_eventsWithContext.IsEmpty ())
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap(eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  // take all the events at once
+  m_eventsWithContextBatch.clear ();
+  m_eventsWithContext.PopAll (m_eventsWithContextBatch);
+  for (std::vector<EventWithContext>::const_iterator i = m_eventsWithContextBatch.begin ();
+       i != m_eventsWithContextBatch.end (); i++)
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
+       const EventWithContext &event = *i;
        Scheduler::Event ev;
        ev.impl = event.event;
        ev.key.m_ts = m_currentTs + event.timestamp;
@@ -183,6 +235,10 @@ DefaultSimulatorImpl::ProcessEventsWithContext (void)
        m_uid++;
        m_unscheduledEvents++;
        m_events->Insert (ev);
+       if (m_schedulerTrace != 0)
+         {
+           m_schedulerTrace->RecordInsert (ev.key.m_uid, event.timestamp);
+         }
     }
 }
 
@@ -240,6 +296,10 @@ DefaultSimulatorImpl::Schedule (Time const &time, EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_schedulerTrace != 0)
+    {
+      m_schedulerTrace->RecordInsert (ev.key.m_uid, ev.key.m_ts - m_currentTs);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -259,6 +319,10 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, E
       m_uid++;
       m_unscheduledEvents++;
       m_events->Insert (ev);
+      if (m_schedulerTrace != 0)
+        {
+          m_schedulerTrace->RecordInsert (ev.key.m_uid, ev.key.m_ts - m_currentTs);
+        }
     }
   else
     {
@@ -266,11 +330,7 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &time, E
       ev.context = context;
       ev.timestamp = time.GetTimeStep ();
       ev.event = event;
-      {
-        CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back(ev);
-        m_eventsWithContextEmpty = false;
-      }
+      m_eventsWithContext.Push (ev);
     }
 }
 
@@ -287,6 +347,10 @@ DefaultSimulatorImpl::ScheduleNow (EventImpl *event)
   m_uid++;
   m_unscheduledEvents++;
   m_events->Insert (ev);
+  if (m_schedulerTrace != 0)
+    {
+      m_schedulerTrace->RecordInsert (ev.key.m_uid, 0);
+    }
   return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
@@ -341,6 +405,16 @@ DefaultSimulatorImpl::Remove (const EventId &id)
     {
       return;
     }
+  if (m_schedulerTrace != 0)
+    {
+      m_schedulerTrace->RecordRemove (id.GetUid ());
+    }
+  RemoveEvent (id);
+}
+
+void
+DefaultSimulatorImpl::RemoveEvent (const EventId &id)
+{
   Scheduler::Event event;
   event.impl = id.PeekEventImpl ();
   event.key.m_ts = id.GetTs ();
@@ -359,6 +433,19 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
 {
   if (!IsExpired (id))
     {
+      if (id.GetUid () != 2)
+        {
+          if (m_schedulerTrace != 0)
+            {
+              m_schedulerTrace->RecordCancel (id.GetUid ());
+            }
+          if (m_events->IsRemoveCheap ())
+            {
+              // do not keep the cancelled event in the event list
+              RemoveEvent (id);
+              return;
+            }
+        }
       id.PeekEventImpl ()->Cancel ();
     }
 }
@@ -411,4 +498,87 @@ DefaultSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+void
+DefaultSimulatorImpl::SetContext (uint32_t context)
+{
+  m_currentContext = context;
+}
+
+void
+DefaultSimulatorImpl::SetSchedulerTraceFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  delete m_schedulerTrace;
+  m_schedulerTrace = 0;
+  m_schedulerTraceFile = filename;
+  if (!filename.empty ())
+    {
+      m_schedulerTrace = new SchedulerTraceWriter (filename);
+    }
+}
+
+std::string
+DefaultSimulatorImpl::GetSchedulerTraceFile (void) const
+{
+  return m_schedulerTraceFile;
+}
+
+void
+DefaultSimulatorImpl::SetProfileFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_profileFile = filename;
+  UpdateProfiler ();
+}
+
+std::string
+DefaultSimulatorImpl::GetProfileFile (void) const
+{
+  return m_profileFile;
+}
+
+void
+DefaultSimulatorImpl::SetProfileFoldedFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_profileFoldedFile = filename;
+  UpdateProfiler ();
+}
+
+std::string
+DefaultSimulatorImpl::GetProfileFoldedFile (void) const
+{
+  return m_profileFoldedFile;
+}
+
+void
+DefaultSimulatorImpl::SetProfileSamplePeriod (uint32_t samplePeriod)
+{
+  NS_LOG_FUNCTION (this << samplePeriod);
+  m_profileSamplePeriod = samplePeriod;
+  UpdateProfiler ();
+}
+
+uint32_t
+DefaultSimulatorImpl::GetProfileSamplePeriod (void) const
+{
+  return m_profileSamplePeriod;
+}
+
+void
+DefaultSimulatorImpl::UpdateProfiler (void)
+{
+  if (m_profileFile.empty () && m_profileFoldedFile.empty ())
+    {
+      delete m_profiler;
+      m_profiler = 0;
+      return;
+    }
+  if (m_profiler == 0)
+    {
+      m_profiler = new EventProfiler ();
+    }
+  m_profiler->SetSamplePeriod (m_profileSamplePeriod);
+}
+
 } // namespace ns3
@@ -25,11 +25,16 @@
 #include "scheduler.h"
 #include "event-impl.h"
 #include "system-thread.h"
+#include "scheduler-trace.h"
+#include "event-profiler.h"
+#include "mpsc-queue.h"
 #include "ns3/system-mutex.h"
 
 #include "ptr.h"
 
 #include <list>
+#include <string>
+#include <vector>
 
 /**
  * \file
@@ -70,21 +75,74 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual void SetContext (uint32_t context);
+
+  /**
+   * Record the operations on the scheduler to a file, from now on.
+   *
+   * \param filename The name of the file, or an empty string to stop
+   *        recording.
+   */
+  void SetSchedulerTraceFile (std::string filename);
+  /**
+   * \returns The name of the scheduler trace file, or an empty string.
+   */
+  std::string GetSchedulerTraceFile (void) const;
+
+  /**
+   * Profile the events, and write the profile to a report file, sorted
+   * by time, when the simulator is destroyed.
+   *
+   * \param filename The name of the file, or an empty string.
+   */
+  void SetProfileFile (std::string filename);
+  /**
+   * \returns The name of the profile report file, or an empty string.
+   */
+  std::string GetProfileFile (void) const;
+  /**
+   * Profile the events, and write the profile to a folded stacks file,
+   * for flamegraph.pl, when the simulator is destroyed.
+   *
+   * \param filename The name of the file, or an empty string.
+   */
+  void SetProfileFoldedFile (std::string filename);
+  /**
+   * \returns The name of the profile folded stacks file, or an empty
+   *          string.
+   */
+  std::string GetProfileFoldedFile (void) const;
+  /**
+   * \param samplePeriod Measure the time of one event out of samplePeriod.
+   */
+  void SetProfileSamplePeriod (uint32_t samplePeriod);
+  /**
+   * \returns The sample period of the profiler.
+   */
+  uint32_t GetProfileSamplePeriod (void) const;
 
 private:
   virtual void DoDispose (void);
   void ProcessOneEvent (void);
   void ProcessEventsWithContext (void);
+  /**
+   * Remove a pending event from the scheduler.
+   *
+   * \param id The event.
+   */
+  void RemoveEvent (const EventId &id);
+  /** Create or delete the profiler, after a change of its attributes. */
+  void UpdateProfiler (void);
  
   struct EventWithContext {
     uint32_t context;
     uint64_t timestamp;
     EventImpl *event;
   };
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  EventsWithContext m_eventsWithContext;
-  bool m_eventsWithContextEmpty;
-  SystemMutex m_eventsWithContextMutex;
+  /** The events scheduled by the other threads, lock-free. */
+  MpscQueue<struct EventWithContext> m_eventsWithContext;
+  /** The batch of events taken from m_eventsWithContext, reused. */
+  std::vector<struct EventWithContext> m_eventsWithContextBatch;
 
   typedef std::list<EventId> DestroyEvents;
   DestroyEvents m_destroyEvents;
@@ -100,6 +158,20 @@ private:
   int m_unscheduledEvents;
 
   SystemThread::ThreadId m_main;
+
+  /** The name of the scheduler trace file. */
+  std::string m_schedulerTraceFile;
+  /** The writer of the scheduler trace, if recording. */
+  SchedulerTraceWriter *m_schedulerTrace;
+
+  /** The name of the profile report file. */
+  std::string m_profileFile;
+  /** The name of the profile folded stacks file. */
+  std::string m_profileFoldedFile;
+  /** Measure the time of one event out of m_profileSamplePeriod. */
+  uint32_t m_profileSamplePeriod;
+  /** The profiler, if profiling. */
+  EventProfiler *m_profiler;
 };
 
 } // namespace ns3
@@ -18,8 +18,12 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include "ns3/core-config.h"
 #include "event-impl.h"
 #include "log.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 /**
  * \file
@@ -31,13 +35,97 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+/**
+ * \ingroup events
+ * The memory of a destroyed event in a free list.
+ */
+struct EventImplFreeBlock
+{
+  EventImplFreeBlock *next; /**< The next block of the free list. */
+};
+
+/**
+ * \ingroup events
+ * The size classes of the pool are multiples of this size.
+ */
+static const std::size_t g_eventPoolGranularity = 16;
+/**
+ * \ingroup events
+ * The number of size classes of the pool. Larger events are allocated
+ * from the heap.
+ */
+static const std::size_t g_eventPoolSizeClasses = 16;
+/**
+ * \ingroup events
+ * The largest number of blocks in a free list. Events allocated by one
+ * thread and destroyed by another, e.g. the events injected by the reader
+ * thread of a device, would otherwise make the lists of the destroying
+ * thread grow forever.
+ */
+static const uint32_t g_eventPoolMaxBlocks = 1000;
+/**
+ * \ingroup events
+ * The free lists of the calling thread, one per size class.
+ */
+static __thread EventImplFreeBlock *g_eventPool[g_eventPoolSizeClasses];
+/**
+ * \ingroup events
+ * The number of blocks in each free list of the calling thread.
+ */
+static __thread uint32_t g_eventPoolBlocks[g_eventPoolSizeClasses];
+/**
+ * \ingroup events
+ * Reuse the memory of destroyed events; read by all the threads.
+ */
+static bool g_eventPoolEnabled = true;
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * \ingroup events
+ * The key, whose destructor releases the free lists of an exiting thread.
+ */
+static pthread_key_t g_eventPoolKey;
+/**
+ * \ingroup events
+ * Create g_eventPoolKey once.
+ */
+static pthread_once_t g_eventPoolKeyOnce = PTHREAD_ONCE_INIT;
+/**
+ * \ingroup events
+ * The calling thread has set g_eventPoolKey.
+ */
+static __thread bool g_eventPoolKeySet = false;
+
+/**
+ * \ingroup events
+ * Release the free lists of an exiting thread.
+ */
+extern "C" void
+EventImplReleasePoolAtExit (void *)
+{
+  EventImpl::ReleasePool ();
+  g_eventPoolKeySet = false;
+}
+
+/**
+ * \ingroup events
+ * Create g_eventPoolKey.
+ */
+extern "C" void
+EventImplCreatePoolKey (void)
+{
+  pthread_key_create (&g_eventPoolKey, &EventImplReleasePoolAtExit);
+}
+#endif /* HAVE_PTHREAD_H */
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
 }
 
 EventImpl::EventImpl ()
-  : m_cancel (false)
+  : m_schedulerSlot (0),
+    m_cancel (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,4 +154,88 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+const void *
+EventImpl::GetHandler (void) const
+{
+  return 0;
+}
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  std::size_t sizeClass = (size + g_eventPoolGranularity - 1) / g_eventPoolGranularity;
+  if (sizeClass > g_eventPoolSizeClasses)
+    {
+      return ::operator new (size);
+    }
+  EventImplFreeBlock *&head = g_eventPool[sizeClass - 1];
+  if (head != 0)
+    {
+      EventImplFreeBlock *block = head;
+      head = block->next;
+      g_eventPoolBlocks[sizeClass - 1]--;
+      return block;
+    }
+  // always allocate the whole size class, so that the memory can be
+  // reused by any event of the size class
+  return ::operator new (sizeClass * g_eventPoolGranularity);
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  std::size_t sizeClass = (size + g_eventPoolGranularity - 1) / g_eventPoolGranularity;
+  if (sizeClass > g_eventPoolSizeClasses
+      || g_eventPoolBlocks[sizeClass - 1] >= g_eventPoolMaxBlocks
+      || !__atomic_load_n (&g_eventPoolEnabled, __ATOMIC_RELAXED))
+    {
+      ::operator delete (p);
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (!g_eventPoolKeySet)
+    {
+      pthread_once (&g_eventPoolKeyOnce, &EventImplCreatePoolKey);
+      // any non-null value, for the destructor to be called
+      pthread_setspecific (g_eventPoolKey, &g_eventPoolKeySet);
+      g_eventPoolKeySet = true;
+    }
+#endif /* HAVE_PTHREAD_H */
+  EventImplFreeBlock *block = static_cast<EventImplFreeBlock *> (p);
+  block->next = g_eventPool[sizeClass - 1];
+  g_eventPool[sizeClass - 1] = block;
+  g_eventPoolBlocks[sizeClass - 1]++;
+}
+
+void
+EventImpl::EnablePool (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  __atomic_store_n (&g_eventPoolEnabled, true, __ATOMIC_RELAXED);
+}
+
+void
+EventImpl::DisablePool (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  __atomic_store_n (&g_eventPoolEnabled, false, __ATOMIC_RELAXED);
+  ReleasePool ();
+}
+
+void
+EventImpl::ReleasePool (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  for (std::size_t i = 0; i < g_eventPoolSizeClasses; i++)
+    {
+      while (g_eventPool[i] != 0)
+        {
+          EventImplFreeBlock *block = g_eventPool[i];
+          g_eventPool[i] = block->next;
+          ::operator delete (block);
+        }
+      g_eventPoolBlocks[i] = 0;
+    }
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,15 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are small and short-lived, so they are not allocated from
+ * the heap one by one. Instead, the memory of a destroyed event is
+ * kept in a free list of its size class, and reused by the next
+ * event of the same size class. The free lists are thread-local, so
+ * events can be created and destroyed by the threads of the realtime
+ * simulator without locking; an event freed by another thread than
+ * the one which created it ends up in the free list of the freeing
+ * thread.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -65,6 +75,69 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * \returns The address of the function or method called by
+   *          Invoke(), or 0 if unknown.
+   *
+   * Used by ns3::EventProfiler to attribute the time of the events
+   * to their handlers. The events made by MakeEvent() return the
+   * function, or the method which overrides the virtual method of
+   * their object.
+   */
+  virtual const void * GetHandler (void) const;
+
+  /**
+   * Allocate the memory of an event from the free list of its size
+   * class, or from the heap if the free list is empty.
+   *
+   * \param size The size of the event.
+   * \returns The memory of the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Return the memory of an event to the free list of its size class of
+   * the calling thread, or to the heap if the list is full. The lists of
+   * a thread are returned to the heap when it exits.
+   *
+   * \param p The memory of the event.
+   * \param size The size of the event.
+   */
+  static void operator delete (void *p, std::size_t size);
+  /**
+   * Enable the reuse of the memory of destroyed events, the default.
+   */
+  static void EnablePool (void);
+  /**
+   * Disable the reuse of the memory of destroyed events, so that every
+   * event is allocated from the heap, e.g. to debug memory errors or to
+   * measure the effect of the pool. The lists of the calling thread are
+   * released; those of the other threads are drained by their next
+   * allocations, or released when they exit.
+   */
+  static void DisablePool (void);
+  /**
+   * Return the memory of the destroyed events kept by the calling thread
+   * to the heap. Called by Simulator::Destroy().
+   */
+  static void ReleasePool (void);
+
+  /**
+   * \param slot An index of the event, kept by the scheduler.
+   *
+   * Used by schedulers which locate events by an index, such as
+   * ns3::IndexedHeapScheduler, to remove them without a search.
+   */
+  inline void SetSchedulerSlot (uint32_t slot)
+  {
+    m_schedulerSlot = slot;
+  }
+  /**
+   * \returns The index set by SetSchedulerSlot().
+   */
+  inline uint32_t GetSchedulerSlot (void) const
+  {
+    return m_schedulerSlot;
+  }
 
 protected:
   /**
@@ -76,6 +149,7 @@ protected:
   virtual void Notify (void) = 0;
 
 private:
+  uint32_t m_schedulerSlot;  /**< The index of the event in the scheduler. */
   bool m_cancel;  /**< Has this event been cancelled. */
 };
 
@@ -0,0 +1,345 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "abort.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include <cxxabi.h>
+#include <time.h>
+#ifdef __GLIBC__
+#include <execinfo.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::EventProfiler.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+/**
+ * \ingroup simulator
+ * The lock of the process-wide profile, see EventProfiler::Write().
+ */
+static int g_profileLock = 0;
+
+/**
+ * \ingroup simulator
+ * \returns The monotonic clock, in ns.
+ */
+static uint64_t
+NowNs (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * \ingroup simulator
+ * \param mangled A mangled C++ name.
+ * \returns The demangled name, or the mangled name if it cannot be
+ *          demangled.
+ */
+static std::string
+Demangle (const std::string &mangled)
+{
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled.c_str (), NULL, NULL, &status);
+  std::string name = status == 0 ? demangled : mangled;
+  std::free (demangled);
+  return name;
+}
+
+bool
+EventProfiler::Key::operator < (const Key &o) const
+{
+  if (handler != o.handler)
+    {
+      return handler < o.handler;
+    }
+  if (type != o.type)
+    {
+      return type < o.type;
+    }
+  return context < o.context;
+}
+
+EventProfiler::EventProfiler ()
+  : m_samplePeriod (1),
+    m_untilSample (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EventProfiler::~EventProfiler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+EventProfiler::SetSamplePeriod (uint32_t samplePeriod)
+{
+  NS_LOG_FUNCTION (this << samplePeriod);
+  m_samplePeriod = std::max (samplePeriod, (uint32_t) 1);
+  m_untilSample = 0;
+}
+
+void
+EventProfiler::Invoke (EventImpl *event, uint32_t context)
+{
+  if (event->IsCancelled ())
+    {
+      return;
+    }
+  Key key;
+  key.handler = event->GetHandler ();
+  key.type = key.handler == 0 ? &typeid (*event) : 0;
+  key.context = context;
+  Counters &counters = m_profile[key];
+  counters.events++;
+  counters.type = &typeid (*event);
+  if (m_untilSample > 0)
+    {
+      m_untilSample--;
+      event->Invoke ();
+      return;
+    }
+  m_untilSample = m_samplePeriod - 1;
+  uint64_t start = NowNs ();
+  event->Invoke ();
+  counters.sampledNs += NowNs () - start;
+  counters.sampledEvents++;
+}
+
+double
+EventProfiler::GetTime (const Counters &counters)
+{
+  if (counters.sampledEvents == 0)
+    {
+      return 0;
+    }
+  return (double) counters.sampledNs * counters.events / counters.sampledEvents;
+}
+
+std::string
+EventProfiler::GetName (const Key &key, const Counters &counters)
+{
+#ifdef __GLIBC__
+  if (key.handler != 0)
+    {
+      // "file(symbol+offset) [address]"
+      void *address = const_cast<void *> (key.handler);
+      char **symbols = backtrace_symbols (&address, 1);
+      std::string symbol = symbols != 0 ? symbols[0] : "";
+      std::free (symbols);
+      std::string::size_type begin = symbol.find ('(');
+      std::string::size_type end = symbol.find_first_of ("+)", begin);
+      if (begin != std::string::npos && end != std::string::npos && end > begin + 1)
+        {
+          // a method called through another base than its first one is
+          // reached through a thunk, which adjusts this
+          std::string name = Demangle (symbol.substr (begin + 1, end - begin - 1));
+          std::string::size_type thunk = name.find ("thunk to ");
+          if (thunk != std::string::npos && name.find_first_of ("(<") > thunk)
+            {
+              name = name.substr (thunk + 9);
+            }
+          return name;
+        }
+    }
+#endif
+  std::ostringstream oss;
+  oss << Demangle (counters.type->name ());
+  if (key.handler != 0)
+    {
+      oss << " " << key.handler;
+    }
+  return oss.str ();
+}
+
+void
+EventProfiler::Summarize (const Profile &profile, Summary &summary)
+{
+  std::map<std::pair<const void *, const std::type_info *>, std::string> names;
+  for (Profile::const_iterator i = profile.begin (); i != profile.end (); i++)
+    {
+      std::pair<const void *, const std::type_info *> handler (i->first.handler, i->first.type);
+      std::map<std::pair<const void *, const std::type_info *>, std::string>::iterator name =
+        names.find (handler);
+      if (name == names.end ())
+        {
+          name = names.insert (std::make_pair (handler, GetName (i->first, i->second))).first;
+        }
+      std::pair<uint64_t, double> &counters = summary[name->second][i->first.context];
+      counters.first += i->second.events;
+      counters.second += GetTime (i->second);
+    }
+}
+
+void
+EventProfiler::Write (std::string reportFile, std::string foldedFile)
+{
+  NS_LOG_FUNCTION (this << reportFile << foldedFile);
+  // the process-wide profile
+  static Profile profile;
+  while (__atomic_test_and_set (&g_profileLock, __ATOMIC_ACQUIRE))
+    {
+    }
+  for (Profile::const_iterator i = m_profile.begin (); i != m_profile.end (); i++)
+    {
+      Counters &counters = profile[i->first];
+      counters.events += i->second.events;
+      counters.sampledEvents += i->second.sampledEvents;
+      counters.sampledNs += i->second.sampledNs;
+      counters.type = i->second.type;
+    }
+  m_profile.clear ();
+  Summary summary;
+  Summarize (profile, summary);
+  __atomic_clear (&g_profileLock, __ATOMIC_RELEASE);
+  if (!reportFile.empty ())
+    {
+      WriteReport (summary, reportFile);
+    }
+  if (!foldedFile.empty ())
+    {
+      WriteFolded (summary, foldedFile);
+    }
+}
+
+/**
+ * \ingroup simulator
+ * Write a line of a profile report.
+ *
+ * \param os The report.
+ * \param events The number of events.
+ * \param ns The time of the events.
+ * \param total The time of all the events.
+ */
+static void
+WriteReportLine (std::ostream &os, uint64_t events, double ns, double total)
+{
+  os << std::setw (14) << (uint64_t) ns
+     << std::setw (8) << std::fixed << std::setprecision (2) << (total > 0 ? 100 * ns / total : 0)
+     << std::setw (12) << events
+     << std::setw (12) << std::setprecision (1) << ns / events;
+}
+
+void
+EventProfiler::WriteReport (const Summary &summary, std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ofstream os (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (os.good (), "Cannot create event profile " << filename);
+
+  // the totals by handler, and the counters by handler and context,
+  // sorted by decreasing time
+  typedef std::pair<std::string, uint32_t> Context;
+  std::vector<std::pair<double, std::pair<uint64_t, std::string> > > handlers;
+  std::vector<std::pair<double, std::pair<uint64_t, Context> > > contexts;
+  uint64_t events = 0;
+  double total = 0;
+  for (Summary::const_iterator i = summary.begin (); i != summary.end (); i++)
+    {
+      uint64_t handlerEvents = 0;
+      double handlerNs = 0;
+      for (std::map<uint32_t, std::pair<uint64_t, double> >::const_iterator j = i->second.begin ();
+           j != i->second.end (); j++)
+        {
+          contexts.push_back (std::make_pair (j->second.second,
+                                              std::make_pair (j->second.first, Context (i->first, j->first))));
+          handlerEvents += j->second.first;
+          handlerNs += j->second.second;
+        }
+      handlers.push_back (std::make_pair (handlerNs, std::make_pair (handlerEvents, i->first)));
+      events += handlerEvents;
+      total += handlerNs;
+    }
+  std::sort (handlers.rbegin (), handlers.rend ());
+  std::sort (contexts.rbegin (), contexts.rend ());
+
+  os << "# " << events << " events, " << (uint64_t) total << " ns" << std::endl
+     << "#" << std::endl
+     << "# by handler" << std::endl
+     << "#" << std::setw (13) << "ns" << std::setw (8) << "%" << std::setw (12) << "events"
+     << std::setw (12) << "ns/event" << "  handler" << std::endl;
+  for (uint32_t i = 0; i < handlers.size (); i++)
+    {
+      WriteReportLine (os, handlers[i].second.first, handlers[i].first, total);
+      os << "  " << handlers[i].second.second << std::endl;
+    }
+  os << "#" << std::endl
+     << "# by handler and context" << std::endl
+     << "#" << std::setw (13) << "ns" << std::setw (8) << "%" << std::setw (12) << "events"
+     << std::setw (12) << "ns/event" << std::setw (12) << "context" << "  handler" << std::endl;
+  for (uint32_t i = 0; i < contexts.size (); i++)
+    {
+      const Context &context = contexts[i].second.second;
+      WriteReportLine (os, contexts[i].second.first, contexts[i].first, total);
+      if (context.second == 0xffffffff)
+        {
+          os << std::setw (12) << "-";
+        }
+      else
+        {
+          os << std::setw (12) << context.second;
+        }
+      os << "  " << context.first << std::endl;
+    }
+}
+
+void
+EventProfiler::WriteFolded (const Summary &summary, std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ofstream os (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (os.good (), "Cannot create event profile " << filename);
+
+  // one stack per handler and context: "handler;node 3 time"
+  for (Summary::const_iterator i = summary.begin (); i != summary.end (); i++)
+    {
+      for (std::map<uint32_t, std::pair<uint64_t, double> >::const_iterator j = i->second.begin ();
+           j != i->second.end (); j++)
+        {
+          os << i->first << ";";
+          if (j->first == 0xffffffff)
+            {
+              os << "no context";
+            }
+          else
+            {
+              os << "node " << j->first;
+            }
+          os << " " << (uint64_t) j->second.second << std::endl;
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::EventProfiler.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ * \brief Attribute the wall-clock time of the events to their handlers.
+ *
+ * The simulator invokes its events through the profiler, which counts
+ * the events by handler (see EventImpl::GetHandler()) and context (the
+ * node id), and measures the time of one event out of a sample period.
+ * The time of a handler in a context is estimated from the mean time of
+ * its sampled events.
+ *
+ * The counters of a profiler are only used by the thread of its
+ * simulator. Write() adds them to the process-wide profile, which thus
+ * covers all the profiled simulations of the process, e.g. the
+ * replications of a ReplicationRunner, and writes it out.
+ */
+class EventProfiler
+{
+public:
+  EventProfiler ();
+  ~EventProfiler ();
+
+  /**
+   * \param samplePeriod Measure the time of one event out of
+   *        samplePeriod, 1 by default.
+   */
+  void SetSamplePeriod (uint32_t samplePeriod);
+
+  /**
+   * Invoke an event, and count it.
+   *
+   * \param event The event.
+   * \param context The context of the event.
+   */
+  void Invoke (EventImpl *event, uint32_t context);
+
+  /**
+   * Add the counters to the process-wide profile, reset them, and write
+   * the process-wide profile.
+   *
+   * \param reportFile The name of the file of the report, sorted by
+   *        time, or an empty string.
+   * \param foldedFile The name of the file of the folded stacks, the
+   *        input of flamegraph.pl, or an empty string.
+   */
+  void Write (std::string reportFile, std::string foldedFile);
+
+private:
+  /** The key of the counters: a handler in a context. */
+  struct Key
+  {
+    const void *handler;          //!< The handler, or 0.
+    const std::type_info *type;   //!< The type of the event, if no handler.
+    uint32_t context;             //!< The context.
+    /**
+     * \param o The other key.
+     * \returns true if this key is before o.
+     */
+    bool operator < (const Key &o) const;
+  };
+  /** The counters. */
+  struct Counters
+  {
+    uint64_t events;              //!< The number of events.
+    uint64_t sampledEvents;       //!< The number of timed events.
+    uint64_t sampledNs;           //!< The time of the timed events, in ns.
+    const std::type_info *type;   //!< The type of the last event.
+  };
+  /** The profile. */
+  typedef std::map<Key, Counters> Profile;
+  /** The number and time of the events, by handler name and context. */
+  typedef std::map<std::string, std::map<uint32_t, std::pair<uint64_t, double> > > Summary;
+
+  /**
+   * \param counters The counters.
+   * \returns The estimated time of all the events, in ns.
+   */
+  static double GetTime (const Counters &counters);
+  /**
+   * \param key The key.
+   * \param counters The counters.
+   * \returns The name of the handler, demangled if possible.
+   */
+  static std::string GetName (const Key &key, const Counters &counters);
+  /**
+   * Add the events of a profile by the name of their handler, so that
+   * the handlers reached through different addresses are merged.
+   *
+   * \param profile The profile.
+   * \param summary The summary.
+   */
+  static void Summarize (const Profile &profile, Summary &summary);
+  /**
+   * \param summary The summary of the profile.
+   * \param filename The name of the report file.
+   */
+  static void WriteReport (const Summary &summary, std::string filename);
+  /**
+   * \param summary The summary of the profile.
+   * \param filename The name of the folded stacks file.
+   */
+  static void WriteFolded (const Summary &summary, std::string filename);
+
+  Profile m_profile;              //!< The counters of this profiler.
+  uint32_t m_samplePeriod;        //!< The sample period.
+  uint32_t m_untilSample;         //!< The number of events until the next timed one.
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
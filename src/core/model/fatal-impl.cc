@@ -172,6 +172,8 @@ void
 FlushStreams (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  // the deferred log messages come before the fatal error
+  LogFlush ();
   std::list<std::ostream*> **pl = PeekStreamList ();
   if (*pl == 0)
     {
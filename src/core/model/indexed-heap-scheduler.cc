@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "indexed-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::IndexedHeapScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("IndexedHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (IndexedHeapScheduler);
+
+/**
+ * \ingroup scheduler
+ * The number of children of a node of the heap.
+ */
+static const uint32_t g_indexedHeapArity = 4;
+
+TypeId
+IndexedHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::IndexedHeapScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<IndexedHeapScheduler> ()
+  ;
+  return tid;
+}
+
+IndexedHeapScheduler::IndexedHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+IndexedHeapScheduler::~IndexedHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+IndexedHeapScheduler::IsLess (const HeapEntry &a, const HeapEntry &b)
+{
+  return a.ts < b.ts || (a.ts == b.ts && a.uid < b.uid);
+}
+
+void
+IndexedHeapScheduler::Place (uint32_t position, const HeapEntry &entry)
+{
+  m_heap[position] = entry;
+  m_slots[entry.slot].position = position;
+}
+
+void
+IndexedHeapScheduler::SiftUp (uint32_t position, const HeapEntry &entry)
+{
+  while (position > 0)
+    {
+      uint32_t parent = (position - 1) / g_indexedHeapArity;
+      if (!IsLess (entry, m_heap[parent]))
+        {
+          break;
+        }
+      Place (position, m_heap[parent]);
+      position = parent;
+    }
+  Place (position, entry);
+}
+
+void
+IndexedHeapScheduler::SiftDown (uint32_t position, const HeapEntry &entry)
+{
+  uint32_t size = m_heap.size ();
+  while (true)
+    {
+      uint32_t first = position * g_indexedHeapArity + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      uint32_t last = std::min (first + g_indexedHeapArity, size);
+      uint32_t smallest = first;
+      for (uint32_t child = first + 1; child < last; child++)
+        {
+          if (IsLess (m_heap[child], m_heap[smallest]))
+            {
+              smallest = child;
+            }
+        }
+      if (!IsLess (m_heap[smallest], entry))
+        {
+          break;
+        }
+      Place (position, m_heap[smallest]);
+      position = smallest;
+    }
+  Place (position, entry);
+}
+
+void
+IndexedHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint32_t slot;
+  if (m_freeSlots.empty ())
+    {
+      slot = m_slots.size ();
+      m_slots.push_back (Slot ());
+    }
+  else
+    {
+      slot = m_freeSlots.back ();
+      m_freeSlots.pop_back ();
+    }
+  m_slots[slot].impl = ev.impl;
+  m_slots[slot].context = ev.key.m_context;
+  ev.impl->SetSchedulerSlot (slot);
+
+  HeapEntry entry;
+  entry.ts = ev.key.m_ts;
+  entry.uid = ev.key.m_uid;
+  entry.slot = slot;
+  m_heap.push_back (entry);
+  SiftUp (m_heap.size () - 1, entry);
+}
+
+bool
+IndexedHeapScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_heap.empty ();
+}
+
+Scheduler::Event
+IndexedHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  const HeapEntry &entry = m_heap.front ();
+  Event ev;
+  ev.impl = m_slots[entry.slot].impl;
+  ev.key.m_ts = entry.ts;
+  ev.key.m_uid = entry.uid;
+  ev.key.m_context = m_slots[entry.slot].context;
+  return ev;
+}
+
+Scheduler::Event
+IndexedHeapScheduler::RemoveAt (uint32_t position)
+{
+  HeapEntry entry = m_heap[position];
+  Event ev;
+  ev.impl = m_slots[entry.slot].impl;
+  ev.key.m_ts = entry.ts;
+  ev.key.m_uid = entry.uid;
+  ev.key.m_context = m_slots[entry.slot].context;
+  m_slots[entry.slot].impl = 0;
+  m_freeSlots.push_back (entry.slot);
+
+  // fill the hole with the last entry
+  HeapEntry back = m_heap.back ();
+  m_heap.pop_back ();
+  if (position < m_heap.size ())
+    {
+      if (position > 0 && IsLess (back, m_heap[(position - 1) / g_indexedHeapArity]))
+        {
+          SiftUp (position, back);
+        }
+      else
+        {
+          SiftDown (position, back);
+        }
+    }
+  return ev;
+}
+
+Scheduler::Event
+IndexedHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return RemoveAt (0);
+}
+
+void
+IndexedHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint32_t slot = ev.impl->GetSchedulerSlot ();
+  NS_ASSERT (slot < m_slots.size () && m_slots[slot].impl == ev.impl);
+  uint32_t position = m_slots[slot].position;
+  NS_ASSERT (m_heap[position].uid == ev.key.m_uid);
+  RemoveAt (position);
+}
+
+bool
+IndexedHeapScheduler::IsRemoveCheap (void) const
+{
+  return true;
+}
+
+} // namespace ns3
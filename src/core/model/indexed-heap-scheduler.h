@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef INDEXED_HEAP_SCHEDULER_H
+#define INDEXED_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::IndexedHeapScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a 4-ary heap event scheduler with removal by index
+ *
+ * The heap only holds the sort keys of the events: the time stamp, the
+ * unique id, and the index of a slot, which holds the EventImpl, the
+ * context and the position of the event in the heap. A heap entry takes
+ * 16 bytes, so the four children of a node share a cache line, and a
+ * 4-ary heap is half as deep as a binary heap.
+ *
+ * The slot of an event is stored in the EventImpl, so Remove() finds the
+ * event in constant time and removes it in O(log n), like RemoveNext().
+ * The simulator therefore removes cancelled events right away, instead
+ * of keeping them in the heap until they expire. The slots are reused,
+ * so the scheduler does not allocate memory once the heap has reached
+ * its maximum size.
+ */
+class IndexedHeapScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  IndexedHeapScheduler ();
+  virtual ~IndexedHeapScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+  virtual bool IsRemoveCheap (void) const;
+
+private:
+  /**
+   * The sort key of an event in the heap.
+   */
+  struct HeapEntry
+  {
+    uint64_t ts;    /**< Event time stamp. */
+    uint32_t uid;   /**< Event unique id. */
+    uint32_t slot;  /**< Index of the slot of the event. */
+  };
+
+  /**
+   * The event of a heap entry.
+   */
+  struct Slot
+  {
+    EventImpl *impl;    /**< The event implementation. */
+    uint32_t context;   /**< Event context. */
+    uint32_t position;  /**< Position of the event in the heap. */
+  };
+
+  /**
+   * \param a A heap entry.
+   * \param b Another heap entry.
+   * \returns true if a is before b.
+   */
+  static inline bool IsLess (const HeapEntry &a, const HeapEntry &b);
+
+  /**
+   * Put an entry at a position of the heap and update its slot.
+   *
+   * \param position The position.
+   * \param entry The entry.
+   */
+  inline void Place (uint32_t position, const HeapEntry &entry);
+
+  /**
+   * Move an entry towards the root until the heap order is restored.
+   *
+   * \param position The initial position of the entry.
+   * \param entry The entry.
+   */
+  void SiftUp (uint32_t position, const HeapEntry &entry);
+
+  /**
+   * Move an entry towards the leaves until the heap order is restored.
+   *
+   * \param position The initial position of the entry.
+   * \param entry The entry.
+   */
+  void SiftDown (uint32_t position, const HeapEntry &entry);
+
+  /**
+   * Remove the entry at a position of the heap.
+   *
+   * \param position The position.
+   * \returns The removed event.
+   */
+  Event RemoveAt (uint32_t position);
+
+  std::vector<HeapEntry> m_heap;    /**< The heap. */
+  std::vector<Slot> m_slots;        /**< The slots of the events. */
+  std::vector<uint32_t> m_freeSlots; /**< The unused slots. */
+};
+
+} // namespace ns3
+
+#endif /* INDEXED_HEAP_SCHEDULER_H */
@@ -107,6 +107,10 @@
  *       std::clog << "[node " << var->GetObject<Node> ()->GetId () << "] ";
  *     }
  * \endcode
+ *
+ * Since it writes to std::clog, the context is not part of the messages
+ * captured when the logs are deferred (see LogSetDeferred()); the node
+ * id of the simulation context is, with LOG_PREFIX_NODE.
  */
 #define NS_LOG_APPEND_CONTEXT
 #endif /* NS_LOG_APPEND_CONTEXT */
@@ -153,7 +157,17 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (level))                              \
+      if (!g_log.IsEnabled (level))                             \
+        {                                                       \
+        }                                                       \
+      else if (ns3::LogStream::IsDeferred ())                   \
+        {                                                       \
+          ns3::LogRecord ns3LogRecord_                          \
+            (g_log, level, __FUNCTION__,                        \
+            ns3::LogStream::MESSAGE);                           \
+          ns3LogRecord_.Get () << msg;                          \
+        }                                                       \
+      else                                                      \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -177,7 +191,16 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (!g_log.IsEnabled (ns3::LOG_FUNCTION))                 \
+        {                                                       \
+        }                                                       \
+      else if (ns3::LogStream::IsDeferred ())                   \
+        {                                                       \
+          ns3::LogRecord ns3LogRecord_                          \
+            (g_log, ns3::LOG_FUNCTION, __FUNCTION__,            \
+            ns3::LogStream::FUNCTION);                          \
+        }                                                       \
+      else                                                      \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -214,7 +237,18 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (!g_log.IsEnabled (ns3::LOG_FUNCTION))                 \
+        {                                                       \
+        }                                                       \
+      else if (ns3::LogStream::IsDeferred ())                   \
+        {                                                       \
+          ns3::LogRecord ns3LogRecord_                          \
+            (g_log, ns3::LOG_FUNCTION, __FUNCTION__,            \
+            ns3::LogStream::FUNCTION);                          \
+          ns3::LogParameters (ns3LogRecord_.Get ())             \
+            << parameters;                                      \
+        }                                                       \
+      else                                                      \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -239,7 +273,15 @@
   NS_LOG_CONDITION                                              \
   do                                    \
     {                                   \
-      std::clog << msg << std::endl;    \
+      if (ns3::LogStream::IsDeferred ()) \
+        {                               \
+          ns3::LogRecord ns3LogRecord_; \
+          ns3LogRecord_.Get () << msg;  \
+        }                               \
+      else                              \
+        {                               \
+          std::clog << msg << std::endl; \
+        }                               \
     }                                   \
   while (false)
 
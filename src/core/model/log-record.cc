@@ -0,0 +1,667 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <sched.h>
+#include "ns3/core-config.h"
+#include "log.h"
+#include "log-record.h"
+#include "nstime.h"
+#include "simulator.h"
+#ifdef HAVE_PTHREAD_H
+#include "system-thread.h"
+#include "system-condition.h"
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogStream implementation, and the ring buffers of the deferred
+ * log messages.
+ */
+
+// No NS_LOG here: the log messages of the buffers would be recorded
+// while they are formatted.
+
+namespace ns3 {
+
+bool LogStream::m_deferred = false;
+
+namespace {
+
+const uint64_t RING_SIZE = 1 << 20;      //!< The size of the ring buffer of a thread.
+const uint64_t FORMAT_PERIOD_NS = 10000000; //!< The period of the formatter thread.
+
+/** The record prefixes. */
+enum Prefix
+{
+  PREFIX_TIME = 1,
+  PREFIX_NODE = 2,
+  PREFIX_FUNC = 4,
+  PREFIX_LEVEL = 8
+};
+
+/** The header of a record. */
+struct Header
+{
+  uint32_t size;           //!< The size of the record, a multiple of 8.
+  uint32_t length;         //!< The size of the header and the arguments, 0 for a padding.
+  uint8_t kind;            //!< The LogStream::Kind of the record.
+  uint8_t flags;           //!< The Prefix of the message.
+  uint16_t reserved;       //!< Unused.
+  int32_t level;           //!< The level of the message.
+  uint32_t node;           //!< The context of the message.
+  uint32_t reserved2;      //!< Unused.
+  int64_t time;            //!< The time step of the message.
+  const LogComponent *component; //!< The log component, or 0.
+  const char *function;    //!< The function which logged the message.
+};
+
+/**
+ * Read a value of a record.
+ *
+ * \param [in,out] p The position of the value, moved after it.
+ * \returns The value.
+ */
+template <typename T>
+T
+Get (const uint8_t *&p)
+{
+  T value;
+  std::memcpy (&value, p, sizeof (T));
+  p += sizeof (T);
+  return value;
+}
+
+/**
+ * Format a record.
+ *
+ * \param [in] os The stream.
+ * \param [in] record The record.
+ */
+void
+FormatRecord (std::ostream &os, const uint8_t *record)
+{
+  Header header;
+  std::memcpy (&header, record, sizeof (header));
+  if (header.kind != LogStream::UNCONDITIONAL)
+    {
+      if (header.flags & PREFIX_TIME)
+        {
+          os << Time (header.time).GetSeconds () << "s ";
+        }
+      if (header.flags & PREFIX_NODE)
+        {
+          if (header.node == 0xffffffff)
+            {
+              os << "-1 ";
+            }
+          else
+            {
+              os << header.node << " ";
+            }
+        }
+    }
+  if (header.kind == LogStream::MESSAGE)
+    {
+      if (header.flags & PREFIX_FUNC)
+        {
+          os << header.component->Name () << ":" << header.function << "(): ";
+        }
+      if (header.flags & PREFIX_LEVEL)
+        {
+          os << "[" << LogComponent::GetLevelLabel ((enum LogLevel) header.level) << "] ";
+        }
+    }
+  else if (header.kind == LogStream::FUNCTION)
+    {
+      os << header.component->Name () << ":" << header.function << "(";
+    }
+  LogStream::FormatArguments (os, record + sizeof (header), record + header.length);
+  if (header.kind == LogStream::FUNCTION)
+    {
+      os << ")";
+    }
+  os << '\n';
+}
+
+/**
+ * A spin lock.
+ *
+ * \param [in,out] lock The lock.
+ */
+void
+Lock (int *lock)
+{
+  while (__atomic_test_and_set (lock, __ATOMIC_ACQUIRE))
+    {
+      sched_yield ();
+    }
+}
+
+/**
+ * Release a spin lock.
+ *
+ * \param [in,out] lock The lock.
+ */
+void
+Unlock (int *lock)
+{
+  __atomic_clear (lock, __ATOMIC_RELEASE);
+}
+
+} // anonymous namespace
+
+/**
+ * \ingroup logging
+ * \brief The records of a thread.
+ *
+ * The records are captured in a LogScratch, then copied to a ring
+ * buffer.  The thread is the only producer of the ring, and publishes
+ * its records with a release store of the head; the consumers (the
+ * formatter thread, LogFlush(), or the thread itself when the ring is
+ * full) take the output lock, so that the records reach std::clog in
+ * order, and release the space of the records they have formatted with
+ * a release store of the tail.  A record which
+ * does not fit at the end of the ring is preceded by a padding record.
+ */
+class LogBuffer
+{
+public:
+  LogBuffer ();
+
+  /**
+   * \returns The buffer of the calling thread.
+   */
+  static LogBuffer *Get (void);
+
+  /**
+   * Format the records of all the buffers to std::clog.
+   */
+  static void FlushAll (void);
+
+  /**
+   * Append a record to the ring.
+   *
+   * \param [in] start The offset of the record in the scratch.
+   */
+  void Commit (std::size_t start);
+
+  LogScratch scratch;              //!< The records being captured.
+  LogStream stream;                //!< The stream of the thread.
+  uint32_t depth;                  //!< The number of records being captured.
+
+private:
+  /**
+   * Format the records of the ring to std::clog, with the output lock.
+   *
+   * \param [in] record A record which follows them, or 0.
+   */
+  void Flush (const uint8_t *record);
+  /**
+   * Format the records of the ring.
+   *
+   * \param [in] os The stream.
+   */
+  void Format (std::ostream &os);
+
+  std::vector<uint8_t> m_ring;     //!< The ring.
+  uint64_t m_head;                 //!< The end of the records, written by the thread.
+  uint64_t m_tail;                 //!< The start of the records, written by the consumers.
+};
+
+/** The buffer of the calling thread. */
+static __thread LogBuffer *g_buffer = 0;
+/** The buffers of all the threads. */
+static std::vector<LogBuffer *> *g_buffers = 0;
+/** The lock of g_buffers. */
+static int g_buffersLock = 0;
+/** The lock of the consumers of the buffers. */
+static int g_outputLock = 0;
+
+#ifdef HAVE_PTHREAD_H
+/** The formatter thread, or 0. */
+static SystemThread *g_formatter = 0;
+/** Wakes up the formatter thread; kept for the threads which log while it stops. */
+static SystemCondition *g_wakeFormatter = 0;
+/** The formatter thread runs. */
+static bool g_formatterRunning = false;
+/** The calling thread is the formatter thread. */
+static __thread bool g_isFormatter = false;
+
+/**
+ * The formatter thread: format the records periodically, until stopped.
+ */
+static void
+RunFormatter (void)
+{
+  g_isFormatter = true;
+  while (__atomic_load_n (&g_formatterRunning, __ATOMIC_ACQUIRE))
+    {
+      g_wakeFormatter->TimedWait (FORMAT_PERIOD_NS);
+      g_wakeFormatter->SetCondition (false);
+      LogFlush ();
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * Wake up the formatter thread, to make room in a full ring buffer.
+ *
+ * \returns false if the calling thread has to format the records itself.
+ */
+static bool
+WakeFormatter (void)
+{
+#ifdef HAVE_PTHREAD_H
+  if (!g_isFormatter && __atomic_load_n (&g_formatterRunning, __ATOMIC_ACQUIRE))
+    {
+      g_wakeFormatter->SetCondition (true);
+      g_wakeFormatter->Signal ();
+      return true;
+    }
+#endif /* HAVE_PTHREAD_H */
+  return false;
+}
+
+/** Format the records left at exit. */
+static void
+FlushAtExit (void)
+{
+  LogSetDeferred (false);
+}
+
+LogBuffer::LogBuffer ()
+  : stream (this),
+    depth (0),
+    m_ring (RING_SIZE),
+    m_head (0),
+    m_tail (0)
+{
+  scratch.data = 0;
+  scratch.size = 0;
+  scratch.capacity = 0;
+  scratch.Grow (4096);
+}
+
+LogBuffer *
+LogBuffer::Get (void)
+{
+  if (g_buffer == 0)
+    {
+      g_buffer = new LogBuffer ();
+      Lock (&g_buffersLock);
+      if (g_buffers == 0)
+        {
+          g_buffers = new std::vector<LogBuffer *> ();
+        }
+      g_buffers->push_back (g_buffer);
+      Unlock (&g_buffersLock);
+    }
+  return g_buffer;
+}
+
+void
+LogBuffer::FlushAll (void)
+{
+  Lock (&g_buffersLock);
+  std::vector<LogBuffer *> buffers;
+  if (g_buffers != 0)
+    {
+      buffers = *g_buffers;
+    }
+  Unlock (&g_buffersLock);
+  std::ostringstream os;
+  Lock (&g_outputLock);
+  for (std::vector<LogBuffer *>::iterator i = buffers.begin (); i != buffers.end (); i++)
+    {
+      (*i)->Format (os);
+    }
+  if (os.tellp () > 0)
+    {
+      std::clog << os.str () << std::flush;
+    }
+  Unlock (&g_outputLock);
+}
+
+void
+LogBuffer::Flush (const uint8_t *record)
+{
+  std::ostringstream os;
+  Lock (&g_outputLock);
+  Format (os);
+  if (record != 0)
+    {
+      FormatRecord (os, record);
+    }
+  std::clog << os.str () << std::flush;
+  Unlock (&g_outputLock);
+}
+
+void
+LogBuffer::Commit (std::size_t start)
+{
+  Header header;
+  std::size_t length = scratch.size - start;
+  std::memcpy (&header, scratch.data + start, sizeof (header));
+  header.length = length;
+  header.size = (length + 7) & ~7U;
+  std::memcpy (scratch.data + start, &header, sizeof (header));
+  scratch.Append (header.size - length);
+  const uint8_t *record = scratch.data + start;
+
+  if (header.size > RING_SIZE / 2)
+    {
+      // too large for the ring, formatted after the records before it
+      Flush (record);
+      scratch.size = start;
+      return;
+    }
+
+  uint64_t offset = m_head % RING_SIZE;
+  uint64_t contiguous = RING_SIZE - offset;
+  uint64_t needed = header.size + (contiguous < header.size ? contiguous : 0);
+  while (RING_SIZE - (m_head - __atomic_load_n (&m_tail, __ATOMIC_ACQUIRE)) < needed)
+    {
+      // the ring is full: the formatter thread, or this one, makes room
+      if (WakeFormatter ())
+        {
+          sched_yield ();
+        }
+      else
+        {
+          Flush (0);
+        }
+    }
+  uint64_t head = m_head;
+  if (contiguous < header.size)
+    {
+      uint32_t padding[2] = { (uint32_t) contiguous, 0 };
+      std::memcpy (&m_ring[offset], padding, sizeof (padding));
+      head += contiguous;
+      offset = 0;
+    }
+  std::memcpy (&m_ring[offset], record, header.size);
+  head += header.size;
+  __atomic_store_n (&m_head, head, __ATOMIC_RELEASE);
+  scratch.size = start;
+}
+
+void
+LogBuffer::Format (std::ostream &os)
+{
+  uint64_t head = __atomic_load_n (&m_head, __ATOMIC_ACQUIRE);
+  uint64_t tail = m_tail;
+  while (tail != head)
+    {
+      const uint8_t *record = &m_ring[tail % RING_SIZE];
+      uint32_t size[2];
+      std::memcpy (size, record, sizeof (size));
+      if (size[1] != 0)
+        {
+          FormatRecord (os, record);
+        }
+      tail += size[0];
+      __atomic_store_n (&m_tail, tail, __ATOMIC_RELEASE);
+    }
+}
+
+void
+LogScratch::Grow (std::size_t n)
+{
+  std::size_t capacity = this->capacity == 0 ? n : this->capacity;
+  while (capacity < size + n)
+    {
+      capacity *= 2;
+    }
+  data = static_cast<uint8_t *> (std::realloc (data, capacity));
+  this->capacity = capacity;
+}
+
+LogTextBuffer::int_type
+LogTextBuffer::overflow (int_type c)
+{
+  if (!traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      m_text.push_back (traits_type::to_char_type (c));
+    }
+  return traits_type::not_eof (c);
+}
+
+std::streamsize
+LogTextBuffer::xsputn (const char *s, std::streamsize n)
+{
+  m_text.append (s, n);
+  return n;
+}
+
+LogStream::LogStream (LogBuffer *buffer)
+  : std::ostream (static_cast<LogTextBuffer *> (this)),
+    m_buffer (buffer),
+    m_scratch (&buffer->scratch),
+    m_start (0)
+{
+}
+
+LogStream *
+LogStream::Begin (const LogComponent *component, int32_t level,
+                  const char *function, enum Kind kind)
+{
+  LogBuffer *buffer = LogBuffer::Get ();
+  // a message logged while the arguments of another one are evaluated
+  // is captured by its own stream, after it in the scratch
+  LogStream *stream = buffer->depth == 0 ? &buffer->stream : new LogStream (buffer);
+  buffer->depth++;
+  stream->flags (std::ios_base::dec | std::ios_base::skipws);
+  stream->width (0);
+  stream->precision (6);
+  stream->fill (' ');
+  stream->clear ();
+
+  Header header;
+  header.kind = kind;
+  header.flags = 0;
+  header.level = level;
+  header.node = 0;
+  header.time = 0;
+  header.component = component;
+  header.function = function;
+  if (kind != UNCONDITIONAL)
+    {
+      if (component->IsEnabled (LOG_PREFIX_TIME) && LogGetTimePrinter () != 0)
+        {
+          header.flags |= PREFIX_TIME;
+          header.time = Simulator::Now ().GetTimeStep ();
+        }
+      if (component->IsEnabled (LOG_PREFIX_NODE) && LogGetNodePrinter () != 0)
+        {
+          header.flags |= PREFIX_NODE;
+          header.node = Simulator::GetContext ();
+        }
+      if (component->IsEnabled (LOG_PREFIX_FUNC))
+        {
+          header.flags |= PREFIX_FUNC;
+        }
+      if (component->IsEnabled (LOG_PREFIX_LEVEL))
+        {
+          header.flags |= PREFIX_LEVEL;
+        }
+    }
+  stream->m_start = buffer->scratch.size;
+  std::memcpy (buffer->scratch.Append (sizeof (header)), &header, sizeof (header));
+  return stream;
+}
+
+void
+LogStream::End (void)
+{
+  FlushText ();
+  m_buffer->Commit (m_start);
+  m_buffer->depth--;
+  if (this != &m_buffer->stream)
+    {
+      delete this;
+    }
+}
+
+void
+LogStream::FlushText (void)
+{
+  if (m_text.empty ())
+    {
+      return;
+    }
+  std::string text;
+  text.swap (m_text);
+  PutString (text.c_str (), text.size ());
+}
+
+void
+LogStream::PutString (const char *s, std::size_t size)
+{
+  if (!m_text.empty ())
+    {
+      FlushText ();
+    }
+  uint8_t *p = m_scratch->Append (1 + 4 + size + 1);
+  uint32_t length = size;
+  p[0] = STRING;
+  std::memcpy (p + 1, &length, 4);
+  std::memcpy (p + 5, s, size);
+  p[5 + size] = 0;
+}
+
+void
+LogStream::FormatArguments (std::ostream &os, const uint8_t *p, const uint8_t *end)
+{
+  while (p < end)
+    {
+      switch (*p++)
+        {
+        case BOOL:
+          os << Get<bool> (p);
+          break;
+        case CHAR:
+          os << Get<char> (p);
+          break;
+        case SIGNED_CHAR:
+          os << Get<signed char> (p);
+          break;
+        case UNSIGNED_CHAR:
+          os << Get<unsigned char> (p);
+          break;
+        case SHORT:
+          os << Get<short> (p);
+          break;
+        case UNSIGNED_SHORT:
+          os << Get<unsigned short> (p);
+          break;
+        case INT:
+          os << Get<int> (p);
+          break;
+        case UNSIGNED_INT:
+          os << Get<unsigned int> (p);
+          break;
+        case LONG:
+          os << Get<long> (p);
+          break;
+        case UNSIGNED_LONG:
+          os << Get<unsigned long> (p);
+          break;
+        case LONG_LONG:
+          os << Get<long long> (p);
+          break;
+        case UNSIGNED_LONG_LONG:
+          os << Get<unsigned long long> (p);
+          break;
+        case FLOAT:
+          os << Get<float> (p);
+          break;
+        case DOUBLE:
+          os << Get<double> (p);
+          break;
+        case STRING:
+          {
+            uint32_t length = Get<uint32_t> (p);
+            os << (const char *) p;
+            p += length + 1;
+          }
+          break;
+        case POINTER:
+          os << Get<const void *> (p);
+          break;
+        case TIME:
+          os << Time (Get<int64_t> (p));
+          break;
+        case SEPARATOR:
+          os << ", ";
+          break;
+        default:
+          // corrupted record
+          return;
+        }
+    }
+}
+
+void
+LogSetDeferred (bool deferred)
+{
+  if (deferred == LogStream::m_deferred)
+    {
+      return;
+    }
+  if (deferred)
+    {
+      static bool registered = false;
+      if (!registered)
+        {
+          std::atexit (&FlushAtExit);
+          registered = true;
+        }
+      LogStream::m_deferred = true;
+#ifdef HAVE_PTHREAD_H
+      if (g_wakeFormatter == 0)
+        {
+          g_wakeFormatter = new SystemCondition ();
+        }
+      __atomic_store_n (&g_formatterRunning, true, __ATOMIC_RELEASE);
+      g_formatter = new SystemThread (MakeCallback (&RunFormatter));
+      g_formatter->Start ();
+#endif /* HAVE_PTHREAD_H */
+      return;
+    }
+  LogStream::m_deferred = false;
+#ifdef HAVE_PTHREAD_H
+  __atomic_store_n (&g_formatterRunning, false, __ATOMIC_RELEASE);
+  g_wakeFormatter->SetCondition (true);
+  g_wakeFormatter->Signal ();
+  g_formatter->Join ();
+  delete g_formatter;
+  g_formatter = 0;
+#endif /* HAVE_PTHREAD_H */
+  LogFlush ();
+}
+
+void
+LogFlush (void)
+{
+  LogBuffer::FlushAll ();
+}
+
+} // namespace ns3
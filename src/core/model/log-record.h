@@ -0,0 +1,527 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_LOG_RECORD_H
+#define NS3_LOG_RECORD_H
+
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup logging
+ * Capture of the deferred log messages: ns3::LogStream, ns3::LogRecord
+ * and ns3::LogParameters declarations.
+ */
+
+namespace ns3 {
+
+class LogComponent;
+class LogBuffer;
+
+/**
+ * \ingroup logging
+ * \brief The records being captured by the streams of a thread.
+ */
+struct LogScratch
+{
+  /**
+   * Extend the records.
+   *
+   * \param [in] n The number of bytes.
+   * \returns The first byte.
+   */
+  inline uint8_t *Append (std::size_t n);
+  /**
+   * Grow the capacity.
+   *
+   * \param [in] n The number of bytes which do not fit.
+   */
+  void Grow (std::size_t n);
+
+  uint8_t *data;         //!< The records.
+  std::size_t size;      //!< The size of the records.
+  std::size_t capacity;  //!< The capacity of data.
+};
+
+/**
+ * \ingroup logging
+ * \brief The text of a LogStream, formatted by the operators of std::ostream.
+ */
+class LogTextBuffer : public std::streambuf
+{
+protected:
+  /**
+   * \param [in] c A character.
+   * \returns The character.
+   */
+  virtual int_type overflow (int_type c);
+  /**
+   * \param [in] s Characters.
+   * \param [in] n The number of characters.
+   * \returns The number of characters.
+   */
+  virtual std::streamsize xsputn (const char *s, std::streamsize n);
+
+  std::string m_text;  //!< The text not yet appended to the record.
+};
+
+/**
+ * \ingroup logging
+ * \brief The stream into which the NS_LOG macros capture a message, when
+ * the logs are deferred.
+ *
+ * When the logs are deferred (see LogSetDeferred()), the NS_LOG macros
+ * stream their arguments into a LogStream of the calling thread instead
+ * of std::clog.  The stream stores the values of the arguments, tagged
+ * with their type, after the simulation time and the context (node id) of
+ * the message, in a ring buffer of the thread.  The records of the buffers
+ * are formatted later, as the macros would have formatted them, by a
+ * formatter thread, by LogFlush(), or at exit.
+ *
+ * The integers, the floating point numbers, the strings, the pointers,
+ * Time and Ptr are stored as values.  The other types are formatted right
+ * away by their operator<<, since it may depend on the current state of
+ * their object, and stored as a string; so are the values which follow a
+ * manipulator, such as std::hex or std::setw, which changes the format
+ * state of the stream.
+ */
+class LogStream : private LogTextBuffer, public std::ostream
+{
+public:
+  /** The kind of a record, which tells how it is formatted. */
+  enum Kind
+  {
+    MESSAGE,        //!< NS_LOG and the macros of the levels.
+    FUNCTION,       //!< NS_LOG_FUNCTION and NS_LOG_FUNCTION_NOARGS.
+    UNCONDITIONAL   //!< NS_LOG_UNCOND.
+  };
+
+  /** The types of the values of the arguments. */
+  enum Tag
+  {
+    BOOL = 0,
+    CHAR,
+    SIGNED_CHAR,
+    UNSIGNED_CHAR,
+    SHORT,
+    UNSIGNED_SHORT,
+    INT,
+    UNSIGNED_INT,
+    LONG,
+    UNSIGNED_LONG,
+    LONG_LONG,
+    UNSIGNED_LONG_LONG,
+    FLOAT,
+    DOUBLE,
+    STRING,              //!< The length of a string, then the null-terminated string.
+    POINTER,
+    TIME,                //!< The time step of a Time.
+    SEPARATOR            //!< The separator of the parameters of a function.
+  };
+
+  /**
+   * \returns true if the NS_LOG macros capture their messages.
+   */
+  inline static bool IsDeferred (void);
+
+  /**
+   * \returns true if the format state of the stream is not the default
+   * one, so that the values are formatted right away.
+   */
+  inline bool IsFormatted (void) const;
+
+  /**
+   * Start a record, in the stream of the calling thread.
+   *
+   * \param [in] component The log component, or 0 for NS_LOG_UNCOND.
+   * \param [in] level The level of the message.
+   * \param [in] function The name of the function which logs.
+   * \param [in] kind The kind of the record.
+   * \returns The stream.
+   */
+  static LogStream *Begin (const LogComponent *component, int32_t level,
+                           const char *function, enum Kind kind);
+
+  /**
+   * Append the record to the ring buffer of the thread.
+   */
+  void End (void);
+
+  /**
+   * Append a value.
+   *
+   * \param [in] tag The type of the value.
+   * \param [in] value The value.
+   */
+  template <typename T>
+  inline void Put (enum Tag tag, T value);
+
+  /**
+   * Append a string.
+   *
+   * \param [in] s The string.
+   * \param [in] size The length of the string.
+   */
+  void PutString (const char *s, std::size_t size);
+
+  /**
+   * Append the separator of two parameters.
+   */
+  inline void PutSeparator (void);
+
+  /**
+   * Format the arguments of a record.
+   *
+   * \param [in] os The stream.
+   * \param [in] p The first argument.
+   * \param [in] end The end of the arguments.
+   */
+  static void FormatArguments (std::ostream &os, const uint8_t *p, const uint8_t *end);
+
+private:
+  friend class LogBuffer;
+  friend void LogSetDeferred (bool deferred);
+
+  /**
+   * \param [in] buffer The buffer of the thread.
+   */
+  LogStream (LogBuffer *buffer);
+
+  /** Append the text formatted so far, as a string. */
+  void FlushText (void);
+
+  /** Not copyable. */
+  LogStream (const LogStream &);
+  /**
+   * Not copyable.
+   * \returns The stream.
+   */
+  LogStream &operator = (const LogStream &);
+
+  static bool m_deferred;            //!< The macros capture their messages.
+  LogBuffer *m_buffer;               //!< The buffer of the thread.
+  LogScratch *m_scratch;             //!< The records being captured.
+  std::size_t m_start;               //!< The offset of the record.
+};
+
+/**
+ * \ingroup logging
+ * \brief A record of an NS_LOG macro, in the LogStream of the thread.
+ */
+class LogRecord
+{
+public:
+  /**
+   * Start a record of a log component.
+   *
+   * \param [in] component The log component.
+   * \param [in] level The level of the message.
+   * \param [in] function The name of the function which logs.
+   * \param [in] kind The kind of the record.
+   */
+  LogRecord (const LogComponent &component, int32_t level,
+             const char *function, enum LogStream::Kind kind)
+    : m_stream (LogStream::Begin (&component, level, function, kind))
+  {
+  }
+  /** Start a record of NS_LOG_UNCOND. */
+  LogRecord (void)
+    : m_stream (LogStream::Begin (0, 0, 0, LogStream::UNCONDITIONAL))
+  {
+  }
+  /** Append the record to the ring buffer of the thread. */
+  ~LogRecord ()
+  {
+    m_stream->End ();
+  }
+  /**
+   * \returns The stream of the record.
+   */
+  LogStream &Get (void)
+  {
+    return *m_stream;
+  }
+
+private:
+  LogStream *m_stream;  //!< The stream of the record.
+};
+
+/**
+ * \ingroup logging
+ * \brief Insert the separators of the parameters of NS_LOG_FUNCTION in
+ * a LogStream, as ParameterLogger does in a std::ostream.
+ */
+class LogParameters
+{
+public:
+  /**
+   * \param [in] stream The stream.
+   */
+  LogParameters (LogStream &stream)
+    : m_first (true),
+      m_stream (stream)
+  {
+  }
+  /**
+   * \param [in] param A parameter.
+   * \returns This.
+   */
+  template <typename T>
+  LogParameters &operator << (T param)
+  {
+    if (m_first)
+      {
+        m_first = false;
+      }
+    else
+      {
+        m_stream.PutSeparator ();
+      }
+    m_stream << param;
+    return *this;
+  }
+
+private:
+  bool m_first;         //!< First argument flag, doesn't get `, `.
+  LogStream &m_stream;  //!< The stream.
+};
+
+/**
+ * \ingroup logging
+ * \brief How a type is stored in a LogStream; the types without a
+ * specialization are formatted by std::ostream.
+ *
+ * A specialization defines Stream and a static Put (LogStream &, T).
+ */
+template <typename T>
+struct LogValue
+{
+};
+
+/**
+ * \ingroup logging
+ * Store an argument of a log message in a LogStream.
+ *
+ * \param [in] stream The stream.
+ * \param [in] value The argument.
+ * \returns The stream.
+ */
+template <typename T>
+inline typename LogValue<T>::Stream &
+operator << (LogStream &stream, T value)
+{
+  if (stream.IsFormatted ())
+    {
+      static_cast<std::ostream &> (stream) << value;
+    }
+  else
+    {
+      LogValue<T>::Put (stream, value);
+    }
+  return stream;
+}
+
+/**
+ * \ingroup logging
+ * Store a string argument of a log message in a LogStream.
+ *
+ * \param [in] stream The stream.
+ * \param [in] s The argument.
+ * \returns The stream.
+ */
+inline LogStream &
+operator << (LogStream &stream, const std::string &s)
+{
+  if (stream.IsFormatted ())
+    {
+      static_cast<std::ostream &> (stream) << s;
+    }
+  else
+    {
+      stream.PutString (s.c_str (), s.size ());
+    }
+  return stream;
+}
+
+/**
+ * \ingroup logging
+ * Store a value of a type with its tag.
+ *
+ * \param type The type.
+ * \param tag The tag.
+ */
+#define NS_LOG_VALUE(type, tag)                                 \
+  template <>                                                   \
+  struct LogValue<type>                                         \
+  {                                                             \
+    typedef LogStream Stream;                                   \
+    static void Put (LogStream &stream, type value)             \
+    {                                                           \
+      stream.Put (LogStream::tag, value);                       \
+    }                                                           \
+  }
+
+NS_LOG_VALUE (bool, BOOL);
+NS_LOG_VALUE (char, CHAR);
+NS_LOG_VALUE (signed char, SIGNED_CHAR);
+NS_LOG_VALUE (unsigned char, UNSIGNED_CHAR);
+NS_LOG_VALUE (short, SHORT);
+NS_LOG_VALUE (unsigned short, UNSIGNED_SHORT);
+NS_LOG_VALUE (int, INT);
+NS_LOG_VALUE (unsigned int, UNSIGNED_INT);
+NS_LOG_VALUE (long, LONG);
+NS_LOG_VALUE (unsigned long, UNSIGNED_LONG);
+NS_LOG_VALUE (long long, LONG_LONG);
+NS_LOG_VALUE (unsigned long long, UNSIGNED_LONG_LONG);
+NS_LOG_VALUE (float, FLOAT);
+NS_LOG_VALUE (double, DOUBLE);
+
+#undef NS_LOG_VALUE
+
+/**
+ * \ingroup logging
+ * Store a string, as std::ostream prints the pointers to characters.
+ *
+ * \param type The type of the pointer.
+ */
+#define NS_LOG_STRING_VALUE(type)                               \
+  template <>                                                   \
+  struct LogValue<type>                                         \
+  {                                                             \
+    typedef LogStream Stream;                                   \
+    static void Put (LogStream &stream, type s)                 \
+    {                                                           \
+      stream.PutString ((const char *) s,                       \
+                        std::strlen ((const char *) s));        \
+    }                                                           \
+  }
+
+NS_LOG_STRING_VALUE (char *);
+NS_LOG_STRING_VALUE (const char *);
+NS_LOG_STRING_VALUE (signed char *);
+NS_LOG_STRING_VALUE (const signed char *);
+NS_LOG_STRING_VALUE (unsigned char *);
+NS_LOG_STRING_VALUE (const unsigned char *);
+
+#undef NS_LOG_STRING_VALUE
+
+/** Store the other pointers. */
+template <typename T>
+struct LogValue<T *>
+{
+  typedef LogStream Stream;  //!< The type of the stream.
+  /**
+   * \param [in] stream The stream.
+   * \param [in] p The pointer.
+   */
+  static void Put (LogStream &stream, T *p)
+  {
+    stream.Put (LogStream::POINTER, (const void *) p);
+  }
+};
+
+/**
+ * Apply a manipulator, such as std::hex, to the stream, rather than store
+ * it as a pointer.
+ *
+ * \param type The type of the manipulator.
+ */
+#define NS_LOG_MANIPULATOR_VALUE(type)                          \
+  template <>                                                   \
+  struct LogValue<type>                                         \
+  {                                                             \
+    typedef LogStream Stream;                                   \
+    static void Put (LogStream &stream, type manipulator)       \
+    {                                                           \
+      static_cast<std::ostream &> (stream) << manipulator;      \
+    }                                                           \
+  }
+
+/** A manipulator of std::ios_base, such as std::hex. */
+typedef std::ios_base & (*LogIosBaseManipulator)(std::ios_base &);
+/** A manipulator of std::ios. */
+typedef std::ios & (*LogIosManipulator)(std::ios &);
+/** A manipulator of std::ostream, such as std::endl. */
+typedef std::ostream & (*LogOstreamManipulator)(std::ostream &);
+
+NS_LOG_MANIPULATOR_VALUE (LogIosBaseManipulator);
+NS_LOG_MANIPULATOR_VALUE (LogIosManipulator);
+NS_LOG_MANIPULATOR_VALUE (LogOstreamManipulator);
+
+#undef NS_LOG_MANIPULATOR_VALUE
+
+} // namespace ns3
+
+
+namespace ns3 {
+
+uint8_t *
+LogScratch::Append (std::size_t n)
+{
+  if (size + n > capacity)
+    {
+      Grow (n);
+    }
+  uint8_t *p = data + size;
+  size += n;
+  return p;
+}
+
+bool
+LogStream::IsDeferred (void)
+{
+  return m_deferred;
+}
+
+bool
+LogStream::IsFormatted (void) const
+{
+  return width () != 0 || precision () != 6
+         || flags () != (std::ios_base::dec | std::ios_base::skipws)
+         || fill () != ' ';
+}
+
+template <typename T>
+void
+LogStream::Put (enum Tag tag, T value)
+{
+  if (!m_text.empty ())
+    {
+      FlushText ();
+    }
+  uint8_t *p = m_scratch->Append (1 + sizeof (T));
+  *p = tag;
+  std::memcpy (p + 1, &value, sizeof (T));
+}
+
+void
+LogStream::PutSeparator (void)
+{
+  if (!m_text.empty ())
+    {
+      FlushText ();
+    }
+  *m_scratch->Append (1) = SEPARATOR;
+}
+
+} // namespace ns3
+
+#endif /* NS3_LOG_RECORD_H */
@@ -25,6 +25,7 @@
 #include "assert.h"
 #include "ns3/core-config.h"
 #include "fatal-error.h"
+#include "simulation-context.h"
 
 #ifdef HAVE_GETENV
 #include <cstring>
@@ -45,15 +46,15 @@ namespace ns3 {
 
 /**
  * \ingroup logging
- * The LogTimePrinter.
+ * The LogTimePrinter of each SimulationContext.
  * This is private to the logging implementation.
  */
-static LogTimePrinter g_logTimePrinter = 0;
+static ContextLocal<LogTimePrinter> g_logTimePrinter;
 /**
  * \ingroup logging
- * The LogNodePrinter.
+ * The LogNodePrinter of each SimulationContext.
  */
-static LogNodePrinter g_logNodePrinter = 0;
+static ContextLocal<LogNodePrinter> g_logNodePrinter;
 
 /**
  * \ingroup logging
@@ -609,7 +610,7 @@ static void CheckEnvironmentVariables (void)
 }
 void LogSetTimePrinter (LogTimePrinter printer)
 {
-  g_logTimePrinter = printer;
+  g_logTimePrinter.Get () = printer;
   /** \internal
    *  This is the only place where we are more or less sure that all log variables
    * are registered. See \bugid{1082} for details.
@@ -618,16 +619,16 @@ void LogSetTimePrinter (LogTimePrinter printer)
 }
 LogTimePrinter LogGetTimePrinter (void)
 {
-  return g_logTimePrinter;
+  return g_logTimePrinter.Get ();
 }
 
 void LogSetNodePrinter (LogNodePrinter printer)
 {
-  g_logNodePrinter = printer;
+  g_logNodePrinter.Get () = printer;
 }
 LogNodePrinter LogGetNodePrinter (void)
 {
-  return g_logNodePrinter;
+  return g_logNodePrinter.Get ();
 }
 
 
@@ -26,6 +26,7 @@
 #include <stdint.h>
 #include <map>
 
+#include "log-record.h"
 #include "log-macros-enabled.h"
 #include "log-macros-disabled.h"
 
@@ -303,6 +304,24 @@ void LogSetNodePrinter (LogNodePrinter np);
  */
 LogNodePrinter LogGetNodePrinter (void);
 
+/**
+ * Capture the log messages in per-thread buffers, and format them later.
+ *
+ * While the logs are deferred, the NS_LOG macros store their arguments,
+ * the simulation time and the context in a buffer of the calling thread,
+ * instead of formatting them to std::clog.  The messages are formatted,
+ * as they would have been, by a formatter thread, by LogFlush(), or at
+ * exit.  This can also be enabled with the global value "LogDeferred".
+ *
+ * \param [in] deferred Capture the messages, or format them right away
+ * again (the messages captured so far are then formatted).
+ */
+void LogSetDeferred (bool deferred);
+/**
+ * Format the log messages captured so far to std::clog.
+ */
+void LogFlush (void);
+
 
 /**
  * A single log component configuration.
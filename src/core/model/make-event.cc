@@ -23,7 +23,7 @@
 /**
  * \file
  * \ingroup events
- * ns3::MakeEvent(void(*f)(void)) implementation.
+ * ns3::MakeEvent(void(*f)(void)) and ns3::GetMethodAddress() implementation.
  */
 
 namespace ns3 {
@@ -52,10 +52,53 @@ protected:
     {
       (*m_function)();
     }
+public:
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventFunctionHandler (m_function);
+    }
 private:
     F m_function;
   } *ev = new EventFunctionImpl0 (f);
   return ev;
 }
 
+const void *
+GetMethodAddress (const void *object, const void *method, std::size_t size)
+{
+#ifdef __GXX_ABI_VERSION
+  // In the Itanium C++ ABI, a pointer to a method is the address of the
+  // method, or 1 + the offset of the method in the virtual table, followed
+  // by the adjustment of this. ARM moves the virtual flag to the adjustment.
+  struct
+  {
+    uintptr_t ptr;
+    ptrdiff_t adj;
+  } pointer;
+  if (size != sizeof (pointer))
+    {
+      return 0;
+    }
+  std::memcpy (&pointer, method, sizeof (pointer));
+#if defined (__arm__) || defined (__aarch64__)
+  bool isVirtual = (pointer.adj & 1) != 0;
+  ptrdiff_t adj = pointer.adj >> 1;
+  uintptr_t offset = pointer.ptr;
+#else
+  bool isVirtual = (pointer.ptr & 1) != 0;
+  ptrdiff_t adj = pointer.adj;
+  uintptr_t offset = pointer.ptr - 1;
+#endif
+  if (!isVirtual)
+    {
+      return reinterpret_cast<const void *> (pointer.ptr);
+    }
+  const char *self = static_cast<const char *> (object) + adj;
+  const char *vtable = *reinterpret_cast<const char * const *> (self);
+  return *reinterpret_cast<const void * const *> (vtable + offset);
+#else
+  return 0;
+#endif
+}
+
 } // namespace ns3
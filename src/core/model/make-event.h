@@ -264,6 +264,8 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
 #include "event-impl.h"
 #include "type-traits.h"
 
+#include <cstring>
+
 namespace ns3 {
 
 /**
@@ -302,6 +304,54 @@ struct EventMemberImplObjTraits<T *>
   }
 };
 
+/**
+ * \ingroup events
+ * Resolve a pointer to a method to the address of the method called
+ * for an object, following the virtual table of the object if the
+ * method is virtual.
+ *
+ * \param object The object, converted to the class of the method.
+ * \param method The pointer to the method.
+ * \param size The size of the pointer to the method.
+ * \returns The address of the method, or 0 if the pointers to methods
+ *          of the compiler are not known.
+ */
+const void * GetMethodAddress (const void *object, const void *method, std::size_t size);
+
+/**
+ * \ingroup makeeventmemptr
+ * Helper for EventImpl::GetHandler() of the events made from a class method.
+ *
+ * \tparam MEM The class method function signature.
+ * \tparam OBJ The class type holding the method.
+ * \param mem_ptr Class method member function pointer
+ * \param obj Class instance.
+ * \returns The address of the method called for \p obj.
+ */
+template <typename MEM, typename OBJ>
+const void * GetEventMemberHandler (MEM mem_ptr, const OBJ &obj)
+{
+  typedef typename TypeTraits<MEM>::PointerToMemberTraits::ClassType Class;
+  const Class &object = EventMemberImplObjTraits<OBJ>::GetReference (obj);
+  return GetMethodAddress (&object, &mem_ptr, sizeof (mem_ptr));
+}
+
+/**
+ * \ingroup makeeventfnptr
+ * Helper for EventImpl::GetHandler() of the events made from a function.
+ *
+ * \tparam F The function pointer type.
+ * \param f The function pointer.
+ * \returns The address of the function.
+ */
+template <typename F>
+const void * GetEventFunctionHandler (F f)
+{
+  const void *address = 0;
+  std::memcpy (&address, &f, sizeof (address));
+  return address;
+}
+
 template <typename MEM, typename OBJ>
 EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
 {
@@ -322,6 +372,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)();
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventMemberHandler (m_function, m_obj);
+    }
     OBJ m_obj;
     MEM m_function;
   } *ev = new EventMemberImpl0 (obj, mem_ptr);
@@ -352,6 +406,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventMemberHandler (m_function, m_obj);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -383,6 +441,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventMemberHandler (m_function, m_obj);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -416,6 +478,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventMemberHandler (m_function, m_obj);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -451,6 +517,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventMemberHandler (m_function, m_obj);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -489,6 +559,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventMemberHandler (m_function, m_obj);
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -523,6 +597,10 @@ private:
     {
       (*m_function)(m_a1);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventFunctionHandler (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventFunctionImpl1 (f, a1);
@@ -553,6 +631,10 @@ private:
     {
       (*m_function)(m_a1, m_a2);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventFunctionHandler (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -586,6 +668,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventFunctionHandler (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -621,6 +707,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventFunctionHandler (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -658,6 +748,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * GetHandler (void) const
+    {
+      return GetEventFunctionHandler (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "assert.h"
+#include <stdint.h>
+#include <sched.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::MpscQueue template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup thread
+ * \brief A queue with many producer threads and one consumer thread.
+ *
+ * The items are stored in a bounded ring of cells, each with a sequence
+ * number telling whether it is free or holds an item: a producer claims
+ * a cell with a compare-and-swap on the tail, the consumer takes all the
+ * ready cells at once, without any lock.
+ *
+ * The ring is the only storage, so the memory of the queue is bounded:
+ * when it is full, Push yields the processor until the consumer has freed
+ * a cell, and TryPush fails right away. A producer must thus not push more
+ * items than the capacity while the consumer does not run, e.g. before the
+ * simulation runs. The items of a producer are popped in the order it
+ * pushed them, there is no order between the items of different producers.
+ *
+ * \tparam T The type of the items, copied in and out of the queue.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+  /**
+   * Create an empty queue.
+   *
+   * \param capacity The size of the ring, rounded up to a power of two.
+   */
+  MpscQueue (uint32_t capacity = 1024);
+  ~MpscQueue ();
+
+  /**
+   * Append an item, from any thread, waiting for a free cell if the ring
+   * is full.
+   *
+   * \param item The item.
+   */
+  void Push (const T &item);
+
+  /**
+   * Append an item, from any thread, if the ring is not full.
+   *
+   * \param item The item.
+   * \returns false if the ring is full.
+   */
+  bool TryPush (const T &item);
+
+  /**
+   * \returns true if there is no item to pop; only meaningful in the
+   *          consumer thread.
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * Append all the items of the queue to a vector, from the consumer thread.
+   *
+   * \param [in,out] items The vector.
+   * \returns The number of items appended.
+   */
+  uint32_t PopAll (std::vector<T> &items);
+
+  /**
+   * \returns The size of the ring.
+   */
+  uint32_t GetCapacity (void) const;
+
+  /**
+   * \returns The number of items, whose Push had to wait for a free cell.
+   */
+  uint64_t GetFullWaits (void) const;
+
+private:
+  /** Not copyable. */
+  MpscQueue (const MpscQueue &);
+  /**
+   * Not copyable.
+   * \returns The queue.
+   */
+  MpscQueue &operator = (const MpscQueue &);
+
+  /** A cell of the ring. */
+  struct Cell
+  {
+    /**
+     * The position of the cell, if it is free; the position + 1, if it
+     * holds an item.
+     */
+    uint32_t sequence;
+    T item;          //!< The item.
+  };
+
+  Cell *m_cells;             //!< The ring.
+  uint32_t m_mask;           //!< The size of the ring - 1.
+  uint32_t m_head;           //!< The next position to pop, consumer only.
+  /** Keep the producers' tail off the cache line of the consumer's head. */
+  char m_padding[64];
+  uint32_t m_tail;           //!< The next position to push.
+  uint64_t m_fullWaits;      //!< The number of items, which waited for a cell.
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+MpscQueue<T>::MpscQueue (uint32_t capacity)
+  : m_head (0),
+    m_tail (0),
+    m_fullWaits (0)
+{
+  NS_ASSERT (capacity > 0 && capacity <= 0x80000000U);
+  uint32_t size = 1;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  m_mask = size - 1;
+  m_cells = new Cell [size];
+  for (uint32_t i = 0; i < size; i++)
+    {
+      m_cells[i].sequence = i;
+    }
+}
+
+template <typename T>
+MpscQueue<T>::~MpscQueue ()
+{
+  delete [] m_cells;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::TryPush (const T &item)
+{
+  uint32_t pos = __atomic_load_n (&m_tail, __ATOMIC_RELAXED);
+  Cell *cell;
+  for (;;)
+    {
+      cell = &m_cells[pos & m_mask];
+      uint32_t sequence = __atomic_load_n (&cell->sequence, __ATOMIC_ACQUIRE);
+      int32_t diff = (int32_t)(sequence - pos);
+      if (diff == 0)
+        {
+          // the cell is free, claim it; on failure, pos is the new tail
+          if (__atomic_compare_exchange_n (&m_tail, &pos, pos + 1, true,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          // the cell still holds the item pushed one round before
+          return false;
+        }
+      else
+        {
+          // another producer claimed the cell
+          pos = __atomic_load_n (&m_tail, __ATOMIC_RELAXED);
+        }
+    }
+  cell->item = item;
+  __atomic_store_n (&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+template <typename T>
+void
+MpscQueue<T>::Push (const T &item)
+{
+  if (TryPush (item))
+    {
+      return;
+    }
+  __atomic_add_fetch (&m_fullWaits, 1, __ATOMIC_RELAXED);
+  do
+    {
+      sched_yield ();
+    }
+  while (!TryPush (item));
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty (void) const
+{
+  const Cell *cell = &m_cells[m_head & m_mask];
+  return __atomic_load_n (&cell->sequence, __ATOMIC_ACQUIRE) != m_head + 1;
+}
+
+template <typename T>
+uint32_t
+MpscQueue<T>::PopAll (std::vector<T> &items)
+{
+  uint32_t count = 0;
+  for (;;)
+    {
+      Cell *cell = &m_cells[m_head & m_mask];
+      if (__atomic_load_n (&cell->sequence, __ATOMIC_ACQUIRE) != m_head + 1)
+        {
+          break;
+        }
+      items.push_back (cell->item);
+      // free the cell for the next round
+      __atomic_store_n (&cell->sequence, m_head + m_mask + 1, __ATOMIC_RELEASE);
+      m_head++;
+      count++;
+    }
+  return count;
+}
+
+template <typename T>
+uint32_t
+MpscQueue<T>::GetCapacity (void) const
+{
+  return m_mask + 1;
+}
+
+template <typename T>
+uint64_t
+MpscQueue<T>::GetFullWaits (void) const
+{
+  return __atomic_load_n (&m_fullWaits, __ATOMIC_RELAXED);
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
@@ -22,6 +22,7 @@
 #include "assert.h"
 #include "abort.h"
 #include "names.h"
+#include "simulation-context.h"
 
 /**
  * \file
@@ -123,8 +124,8 @@ NamesPriv *
 NamesPriv::Get (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static NamesPriv namesPriv;
-  return &namesPriv;
+  static ContextLocal<NamesPriv> namesPriv;
+  return &namesPriv.Get ();
 }
 
 NamesPriv::NamesPriv ()
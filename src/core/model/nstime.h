@@ -25,6 +25,7 @@
 #include "attribute-helper.h"
 #include "int64x64.h"
 #include "unused.h"
+#include "log-record.h"
 #include <stdint.h>
 #include <limits>
 #include <cmath>
@@ -813,6 +814,24 @@ std::ostream & operator << (std::ostream & os, const Time & time);
  */
 std::istream & operator >> (std::istream & is, Time & time);
 
+/**
+ * \ingroup time
+ * Store a Time in a deferred log message as its time step.
+ */
+template <>
+struct LogValue<Time>
+{
+  typedef LogStream Stream;  //!< The type of the stream.
+  /**
+   * \param [in] stream The stream.
+   * \param [in] time The Time.
+   */
+  static void Put (LogStream &stream, Time time)
+  {
+    stream.Put (LogStream::TIME, time.GetTimeStep ());
+  }
+};
+
 /**
  * \ingroup time
  * \defgroup timecivil Standard Time Units.
@@ -24,6 +24,7 @@
 #include <iostream>
 #include <stdint.h>
 #include "assert.h"
+#include "log-record.h"
 
 /**
  * \file
@@ -354,6 +355,24 @@ Ptr<T> Create (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7);
 template <typename T>
 std::ostream &operator << (std::ostream &os, const Ptr<T> &p);
 
+/**
+ * \ingroup ptr
+ * Store a Ptr in a deferred log message as its pointer.
+ */
+template <typename T>
+struct LogValue<Ptr<T> >
+{
+  typedef LogStream Stream;  //!< The type of the stream.
+  /**
+   * \param [in] stream The stream.
+   * \param [in] p The Ptr.
+   */
+  static void Put (LogStream &stream, const Ptr<T> &p)
+  {
+    stream.Put (LogStream::POINTER, (const void *) PeekPointer (p));
+  }
+};
+
 /**
  * \ingroup ptr
  * Equality operator.
@@ -130,6 +130,16 @@ RandomVariableStream::GetStream(void) const
   return m_stream;
 }
 
+void
+RandomVariableStream::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      values[i] = GetValue ();
+    }
+}
+
 RngStream *
 RandomVariableStream::Peek(void) const
 {
@@ -207,6 +217,21 @@ UniformRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_min, m_max + 1);
 }
+void
+UniformRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  Peek ()->RandU01 (values, n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double v = m_min + values[i] * (m_max - m_min);
+      if (IsAntithetic ())
+        {
+          v = m_min + (m_max - v);
+        }
+      values[i] = v;
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(ConstantRandomVariable);
 
@@ -444,6 +469,27 @@ ExponentialRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_bound);
 }
+void
+ExponentialRandomVariable::GetValues (double *values, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  if (m_bound != 0)
+    {
+      // a value above the bound is drawn again
+      RandomVariableStream::GetValues (values, n);
+      return;
+    }
+  Peek ()->RandU01 (values, n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double v = values[i];
+      if (IsAntithetic ())
+        {
+          v = (1 - v);
+        }
+      values[i] = -m_mean*std::log (v);
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(ParetoRandomVariable);
 
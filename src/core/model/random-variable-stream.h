@@ -133,6 +133,17 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Fill an array with random doubles from the underlying distribution.
+   *
+   * The values are the same as those of n calls to GetValue (void),
+   * but some distributions generate them in bulk, which is faster.
+   *
+   * \param [out] values The array of random values.
+   * \param [in] n The number of values.
+   */
+  virtual void GetValues (double *values, uint32_t n);
+
 protected:
   /**
    * \brief Returns a pointer to the underlying RNG stream.
@@ -290,6 +301,14 @@ public:
    * upper bound.
    */
   virtual uint32_t GetInteger (void);
+
+  /**
+   * \brief Fill an array with random doubles from the uniform
+   * distribution with the current range, generated in bulk.
+   * \param [out] values The array of random values.
+   * \param [in] n The number of values.
+   */
+  virtual void GetValues (double *values, uint32_t n);
 private:
   /// The lower bound on values that can be returned by this RNG stream.
   double m_min;
@@ -599,6 +618,18 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  /**
+   * \brief Fill an array with random doubles from the exponential
+   * distribution with the current mean and upper bound.
+   *
+   * The uniform values are generated in bulk if there is no upper
+   * bound.
+   *
+   * \param [out] values The array of random values.
+   * \param [in] n The number of values.
+   */
+  virtual void GetValues (double *values, uint32_t n);
+
 private:
   /// The mean value of the random variables returned by this RNG stream.
   double m_mean;
@@ -30,8 +30,10 @@
 #include "assert.h"
 #include "log.h"
 #include "system-mutex.h"
+#include "mpsc-queue.h"
 
 #include <list>
+#include <vector>
 
 /**
  * \file
@@ -107,6 +109,7 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual void SetContext (uint32_t context);
 
   /** \copydoc ScheduleWithContext */
   void ScheduleRealtimeWithContext (uint32_t context, Time const &time, EventImpl *event);
@@ -172,6 +175,11 @@ private:
   uint64_t NextTs (void) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
+  /**
+   * Insert the events scheduled by the other threads in the event list.
+   * Should be called with #m_mutex locked.
+   */
+  void ProcessEventsWithContext (void);
   /** Destructor implementation. */
   virtual void DoDispose (void);
 
@@ -207,6 +215,19 @@ private:
   /** Mutex to control access to key state. */  
   mutable SystemMutex m_mutex;  
 
+  /** An event scheduled by another thread. */
+  struct EventWithContext
+  {
+    uint32_t context;   //!< The context of the event.
+    bool realtime;      //!< The timestamp is absolute, in real time.
+    uint64_t timestamp; //!< The timestamp, or the delay if not realtime.
+    EventImpl *event;   //!< The event.
+  };
+  /** The events scheduled by the other threads, lock-free. */
+  MpscQueue<struct EventWithContext> m_eventsWithContext;
+  /** The batch of events taken from #m_eventsWithContext, reused. */
+  std::vector<struct EventWithContext> m_eventsWithContextBatch;
+
   /** The synchronizer in use to track real time. */
   Ptr<Synchronizer> m_synchronizer;
 
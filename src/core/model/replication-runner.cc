@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "replication-runner.h"
+#include "simulation-context.h"
+#include "simulator.h"
+#include "system-thread.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::ReplicationRunner implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationRunner");
+
+ReplicationRunner::ReplicationRunner ()
+  : m_threads (1),
+    m_replications (0),
+    m_next (0)
+{
+  NS_LOG_FUNCTION (this);
+  long processors = sysconf (_SC_NPROCESSORS_ONLN);
+  if (processors > 1)
+    {
+      m_threads = processors;
+    }
+}
+
+void
+ReplicationRunner::SetThreads (uint32_t threads)
+{
+  NS_LOG_FUNCTION (this << threads);
+  NS_ASSERT (threads > 0);
+  m_threads = threads;
+}
+
+uint32_t
+ReplicationRunner::GetThreads (void) const
+{
+  return m_threads;
+}
+
+void
+ReplicationRunner::Run (uint32_t replications, Callback<void, uint32_t> replication)
+{
+  NS_LOG_FUNCTION (this << replications);
+  NS_ASSERT_MSG (SimulationContext::GetCurrent () == 0,
+                 "ReplicationRunner::Run called from a replication");
+  m_replications = replications;
+  m_next = 0;
+  m_replication = replication;
+
+  uint32_t threads = std::min (m_threads, replications);
+  if (threads <= 1)
+    {
+      Worker ();
+    }
+  else
+    {
+      // The threads share the replication callback, but do not copy it:
+      // the reference count of its implementation is not thread-safe.
+      std::vector<Ptr<SystemThread> > workers;
+      for (uint32_t i = 0; i < threads; i++)
+        {
+          workers.push_back (Create<SystemThread> (MakeCallback (&ReplicationRunner::Worker, this)));
+          workers.back ()->Start ();
+        }
+      for (uint32_t i = 0; i < threads; i++)
+        {
+          workers[i]->Join ();
+        }
+    }
+  m_replication = Callback<void, uint32_t> ();
+}
+
+void
+ReplicationRunner::Worker (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (true)
+    {
+      uint32_t index;
+      {
+        CriticalSection cs (m_mutex);
+        if (m_next == m_replications)
+          {
+            return;
+          }
+        index = m_next++;
+      }
+      RunReplication (index);
+    }
+}
+
+void
+ReplicationRunner::RunReplication (uint32_t index)
+{
+  SimulationContext context;
+  context.Enter ();
+  NS_LOG_LOGIC ("replication " << index);
+  m_replication (index);
+  Simulator::Destroy ();
+  // The values of the context are deleted with the context, in the context.
+  SimulationContext::Leave ();
+}
+
+} // namespace ns3
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include "callback.h"
+#include "system-mutex.h"
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::ReplicationRunner declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup thread
+ * \brief Run the independent replications of a parameter sweep on several
+ * threads of one process.
+ *
+ * Every replication runs in its own SimulationContext, so it has its own
+ * simulator, nodes, channels, random number streams and configuration. The
+ * replication callback builds the scenario, runs the simulation and stores
+ * its results, e.g. in a vector indexed by the replication. The runner
+ * destroys the simulator and the context after the callback returns:
+ * \code
+ *   void
+ *   RunOne (std::vector<double> *results, uint32_t replication)
+ *   {
+ *     RngSeedManager::SetRun (replication + 1);
+ *     ...
+ *     Simulator::Run ();
+ *     (*results)[replication] = ...;
+ *   }
+ *
+ *   std::vector<double> results (100);
+ *   ReplicationRunner runner;
+ *   runner.Run (100, MakeBoundCallback (&RunOne, &results));
+ * \endcode
+ *
+ * A replication produces the same results whatever the number of threads.
+ * The process-wide state is shared by all the replications, and must be
+ * set up before Run: the attribute defaults (Config::SetDefault), the
+ * global values, the time resolution, the log components and
+ * Packet::EnablePrinting.
+ */
+class ReplicationRunner
+{
+public:
+  /** Use one thread per online processor. */
+  ReplicationRunner ();
+
+  /**
+   * \param threads The number of threads, 1 runs the replications in the
+   *                calling thread.
+   */
+  void SetThreads (uint32_t threads);
+  /**
+   * \returns The number of threads.
+   */
+  uint32_t GetThreads (void) const;
+
+  /**
+   * Run replications, and return when all of them are done.
+   *
+   * \param replications The number of replications.
+   * \param replication The callback, which runs a replication, called
+   *                    with the index of the replication, from 0.
+   */
+  void Run (uint32_t replications, Callback<void, uint32_t> replication);
+
+private:
+  /** Run the replications until none is left. */
+  void Worker (void);
+  /**
+   * Run a replication in a new SimulationContext.
+   *
+   * \param index The index of the replication.
+   */
+  void RunReplication (uint32_t index);
+
+  uint32_t m_threads;                        //!< The number of threads.
+  uint32_t m_replications;                   //!< The number of replications.
+  uint32_t m_next;                           //!< The next replication to run.
+  Callback<void, uint32_t> m_replication;    //!< Run a replication.
+  SystemMutex m_mutex;                       //!< Protect m_next.
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
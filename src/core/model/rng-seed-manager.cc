@@ -23,6 +23,7 @@
 #include "integer.h"
 #include "config.h"
 #include "log.h"
+#include "simulation-context.h"
 
 /**
  * \file
@@ -37,9 +38,30 @@ NS_LOG_COMPONENT_DEFINE ("RngSeedManager");
 /**
  * \relates RngSeedManager
  * The next random number generator stream number to use
- * for automatic assignment.
+ * for automatic assignment, in each SimulationContext.
  */
-static uint64_t g_nextStreamIndex = 0;
+static ContextLocal<uint64_t> g_nextStreamIndex;
+/**
+ * \relates RngSeedManager
+ * The seed and run number of a SimulationContext, which override
+ * the global values.
+ */
+struct RngContextSettings
+{
+  RngContextSettings ()
+    : hasSeed (false), seed (0), hasRun (false), run (0)
+  {}
+  bool hasSeed;   //!< The seed is set.
+  uint32_t seed;  //!< The seed.
+  bool hasRun;    //!< The run number is set.
+  uint64_t run;   //!< The run number.
+};
+/**
+ * \relates RngSeedManager
+ * The seed and run number of each SimulationContext, the process-wide
+ * context uses the global values.
+ */
+static ContextLocal<RngContextSettings> g_rngSettings;
 /**
  * \relates RngSeedManager
  * The random number generator seed number global value.
@@ -65,6 +87,11 @@ static ns3::GlobalValue g_rngRun ("RngRun",
 uint32_t RngSeedManager::GetSeed (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  RngContextSettings &settings = g_rngSettings.Get ();
+  if (settings.hasSeed)
+    {
+      return settings.seed;
+    }
   IntegerValue seedValue;
   g_rngSeed.GetValue (seedValue);
   return seedValue.Get ();
@@ -73,18 +100,37 @@ void
 RngSeedManager::SetSeed (uint32_t seed)
 {
   NS_LOG_FUNCTION (seed);
+  if (SimulationContext::GetCurrent () != 0)
+    {
+      RngContextSettings &settings = g_rngSettings.Get ();
+      settings.hasSeed = true;
+      settings.seed = seed;
+      return;
+    }
   Config::SetGlobal ("RngSeed", IntegerValue(seed));
 }
 
 void RngSeedManager::SetRun (uint64_t run)
 {
   NS_LOG_FUNCTION (run);
+  if (SimulationContext::GetCurrent () != 0)
+    {
+      RngContextSettings &settings = g_rngSettings.Get ();
+      settings.hasRun = true;
+      settings.run = run;
+      return;
+    }
   Config::SetGlobal ("RngRun", IntegerValue (run));
 }
 
 uint64_t RngSeedManager::GetRun ()
 {
   NS_LOG_FUNCTION_NOARGS ();
+  RngContextSettings &settings = g_rngSettings.Get ();
+  if (settings.hasRun)
+    {
+      return settings.run;
+    }
   IntegerValue value;
   g_rngRun.GetValue (value);
   int run = value.Get();
@@ -94,8 +140,8 @@ uint64_t RngSeedManager::GetRun ()
 uint64_t RngSeedManager::GetNextStreamIndex (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  uint64_t next = g_nextStreamIndex;
-  g_nextStreamIndex++;
+  uint64_t next = g_nextStreamIndex.Get ();
+  g_nextStreamIndex.Get ()++;
   return next;
 }
 
@@ -40,6 +40,8 @@ public:
    * Note, while the underlying RNG takes six integer values as a seed;
    * it is sufficient to set these all to the same integer, so we provide
    * a simpler interface here that just takes one integer.
+   *
+   * In a SimulationContext, this only sets the seed of that context.
    */
   static void SetSeed (uint32_t seed);
 
@@ -71,6 +73,8 @@ public:
    * ./simulation 1
    * ...Results for run 1:...
    * \endcode
+   *
+   * In a SimulationContext, this only sets the run number of that context.
    */
   static void SetRun (uint64_t run);
   /**
@@ -20,6 +20,7 @@
 //   - Mathieu Lacage <mathieu.lacage@gmail.com>
 //
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 #include "rng-stream.h"
@@ -243,14 +244,105 @@ void PowerOfTwoMatrix (int n, Matrix a1p, Matrix a2p)
     }
 }
 
+// The bulk generation: a block is made of "lanes" consecutive chunks
+// of "laneLength" numbers, which are advanced in lockstep.
+const uint32_t lanes = 8;
+const uint32_t laneLength = 32;
+const uint32_t block = lanes * laneLength;
+
+//-------------------------------------------------------------------------
+// Return v MOD m for an integer v, |v| < 2^53.  The quotient is computed
+// with the inverse of m, which may round it one off: the rest is
+// corrected both ways, without branches, so that the loops over the
+// lanes are vectorized.  Every intermediate value is an integer below
+// 2^53, hence the result is exact, the same as with a division.
+//
+inline double LaneModM (double v, double m, double inv)
+{
+  v -= static_cast<int32_t> (v * inv) * m;
+  v += (v < 0.0) ? m : 0.0;
+  return v - ((v >= m) ? m : 0.0);
+}
+
+//-------------------------------------------------------------------------
+// Return (a*s + c) MOD m; 0 <= a, s < m and -m < c < m: the same result
+// as MultModM.
+//
+inline double LaneMultModM (double a, double s, double c, double m, double inv)
+{
+  double a1 = static_cast<int32_t> (a / two17);
+  double a0 = a - a1 * two17;
+  double v = LaneModM (a1 * s, m, inv);
+  return LaneModM (v * two17 + a0 * s + c, m, inv);
+}
+
+// The transition matrices of the two MRG components raised to the
+// powers l*laneLength, lane by lane: a block starts each lane at l
+// chunks ahead of the state of the stream.
+struct LaneJumps
+{
+  double a1[3][3][lanes];
+  double a2[3][3][lanes];
+};
+struct LaneJumps LaneJumpConstants (void)
+{
+  struct LaneJumps jumps;
+  Matrix chunk1, chunk2, power1, power2;
+  for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+        {
+          chunk1[i][j] = chunk2[i][j] = power1[i][j] = power2[i][j] = (i == j);
+        }
+    }
+  for (uint32_t i = 0; i < laneLength; i++)
+    {
+      MatMatModM (A1p0, chunk1, chunk1, m1);
+      MatMatModM (A2p0, chunk2, chunk2, m2);
+    }
+  for (uint32_t l = 0; l < lanes; l++)
+    {
+      for (int i = 0; i < 3; i++)
+        {
+          for (int j = 0; j < 3; j++)
+            {
+              jumps.a1[i][j][l] = power1[i][j];
+              jumps.a2[i][j][l] = power2[i][j];
+            }
+        }
+      MatMatModM (chunk1, power1, power1, m1);
+      MatMatModM (chunk2, power2, power2, m2);
+    }
+  return jumps;
+}
+
+//-------------------------------------------------------------------------
+// Compute the start states of the lanes, x[i][l] = (a[.][.][l] * s)[i]
+// MOD m.
+//
+void LaneJump (const double a[3][3][lanes], const double s[3],
+               double x[3][lanes], double m)
+{
+  const double inv = 1.0 / m;
+  for (int i = 0; i < 3; ++i)
+    {
+      for (uint32_t l = 0; l < lanes; ++l)
+        {
+          double v = LaneMultModM (a[i][0][l], s[0], 0.0, m, inv);
+          v = LaneMultModM (a[i][1][l], s[1], v, m, inv);
+          x[i][l] = LaneMultModM (a[i][2][l], s[2], v, m, inv);
+        }
+    }
+}
+
 } // end of anonymous namespace
 
 
 namespace ns3 {
 //-------------------------------------------------------------------------
-// Generate the next random number.
+// Generate the next random number with the recurrence.
 //
-double RngStream::RandU01 ()
+double RngStream::Next (void)
 {
   int32_t k;
   double p1, p2, u;
@@ -281,7 +373,81 @@ double RngStream::RandU01 ()
   return u;
 }
 
+//-------------------------------------------------------------------------
+// Generate the next block of random numbers: Next (), lane by lane.
+//
+void RngStream::NextBlock (double *values)
+{
+  static const struct LaneJumps jumps = LaneJumpConstants ();
+  const double inv1 = 1.0 / m1;
+  const double inv2 = 1.0 / m2;
+  double x[6][lanes];
+  LaneJump (jumps.a1, m_currentState, x, m1);
+  LaneJump (jumps.a2, &m_currentState[3], &x[3], m2);
+
+  for (uint32_t i = 0; i < laneLength; ++i)
+    {
+      for (uint32_t l = 0; l < lanes; ++l)
+        {
+          /* Component 1 */
+          double p1 = LaneModM (a12 * x[1][l] - a13n * x[0][l], m1, inv1);
+          x[0][l] = x[1][l]; x[1][l] = x[2][l]; x[2][l] = p1;
+
+          /* Component 2 */
+          double p2 = LaneModM (a21 * x[5][l] - a23n * x[3][l], m2, inv2);
+          x[3][l] = x[4][l]; x[4][l] = x[5][l]; x[5][l] = p2;
+
+          /* Combination */
+          values[l * laneLength + i] = ((p1 > p2) ? (p1 - p2) : (p1 - p2 + m1)) * norm;
+        }
+    }
+
+  // the last lane ends where the block ends
+  for (int i = 0; i < 6; ++i)
+    {
+      m_currentState[i] = x[i][lanes - 1];
+    }
+}
+
+double RngStream::RandU01Slow (void)
+{
+  if (m_buffer == 0)
+    {
+      // most streams draw a few numbers: generate them one by one
+      if (++m_draws < block)
+        {
+          return Next ();
+        }
+      m_buffer = new double[block];
+    }
+  NextBlock (m_buffer);
+  m_next = 1;
+  m_available = block;
+  return m_buffer[0];
+}
+
+void RngStream::RandU01 (double *values, uint32_t n)
+{
+  uint32_t i = 0;
+  while (i < n && m_next < m_available)
+    {
+      values[i++] = m_buffer[m_next++];
+    }
+  for (; n - i >= block; i += block)
+    {
+      NextBlock (values + i);
+    }
+  for (; i < n; ++i)
+    {
+      values[i] = RandU01 ();
+    }
+}
+
 RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
+  : m_buffer (0),
+    m_next (0),
+    m_available (0),
+    m_draws (0)
 {
   if (seedNumber >= m1 || seedNumber >= m2 || seedNumber == 0)
     {
@@ -296,11 +462,25 @@ RngStream::RngStream (uint32_t seedNumber, uint64_t stream, uint64_t substream)
 }
 
 RngStream::RngStream(const RngStream& r)
+  : m_buffer (0),
+    m_next (r.m_next),
+    m_available (r.m_available),
+    m_draws (r.m_draws)
 {
   for (int i = 0; i < 6; ++i)
     {
       m_currentState[i] = r.m_currentState[i];
     }
+  if (r.m_buffer != 0)
+    {
+      m_buffer = new double[block];
+      std::copy (r.m_buffer, r.m_buffer + block, m_buffer);
+    }
+}
+
+RngStream::~RngStream ()
+{
+  delete [] m_buffer;
 }
 
 void 
@@ -40,18 +40,65 @@ class RngStream
 public:
   RngStream (uint32_t seed, uint64_t stream, uint64_t substream);
   RngStream (const RngStream&);
+  ~RngStream ();
   /**
    * Generate the next random number for this stream.
    * Uniformly distributed between 0 and 1.
    */
-  double RandU01 (void);
+  inline double RandU01 (void);
+  /**
+   * Generate the next n random numbers for this stream, the same numbers
+   * as n calls to RandU01 (void).
+   *
+   * The numbers are generated by blocks of consecutive chunks: the
+   * start of each chunk is computed by jumping ahead in the stream, and
+   * the chunks are advanced in lockstep, so that the compiler can
+   * vectorize the recurrence.
+   *
+   * \param [out] values The random numbers.
+   * \param [in] n The number of random numbers.
+   */
+  void RandU01 (double *values, uint32_t n);
 
 private:
+  // not implemented
+  RngStream &operator = (const RngStream &);
   void AdvanceNthBy (uint64_t nth, int by, double state[6]);
+  /**
+   * Generate the next random number with the recurrence, or from a new
+   * buffer of numbers if this stream has drawn enough numbers.
+   * \returns The next random number.
+   */
+  double RandU01Slow (void);
+  /** \returns The next random number, computed with the recurrence. */
+  double Next (void);
+  /**
+   * Generate the next block of random numbers.
+   * \param [out] values The random numbers of the block.
+   */
+  void NextBlock (double *values);
 
   double m_currentState[6];
+  /**
+   * The numbers generated in advance, allocated when this stream has
+   * drawn a block of numbers one by one, or 0.
+   */
+  double *m_buffer;
+  uint32_t m_next;       //!< The index of the next number of m_buffer.
+  uint32_t m_available;  //!< The number of numbers of m_buffer.
+  uint32_t m_draws;      //!< The number of numbers drawn one by one.
 };
 
+double
+RngStream::RandU01 (void)
+{
+  if (m_next < m_available)
+    {
+      return m_buffer[m_next++];
+    }
+  return RandU01Slow ();
+}
+
 } // namespace ns3
 
 #endif
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "scheduler-trace.h"
+#include "abort.h"
+#include "log.h"
+#include <cstring>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of the ns3::SchedulerTraceWriter and
+ * ns3::SchedulerTraceReader classes.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SchedulerTrace");
+
+/**
+ * \ingroup scheduler
+ * The magic at the start of a scheduler trace file.
+ */
+static const char g_schedulerTraceMagic[8] = { 'n', 's', '3', 's', 'c', 'h', 'e', 'd' };
+
+/**
+ * \ingroup scheduler
+ * The version of the format of scheduler trace files.
+ */
+static const uint32_t g_schedulerTraceVersion = 1;
+
+SchedulerTraceWriter::SchedulerTraceWriter (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_UNLESS (m_file.good (), "Cannot create scheduler trace file " << filename);
+  m_file.write (g_schedulerTraceMagic, sizeof (g_schedulerTraceMagic));
+  m_file.write ((const char *)&g_schedulerTraceVersion, sizeof (g_schedulerTraceVersion));
+}
+
+SchedulerTraceWriter::~SchedulerTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  m_file.close ();
+}
+
+void
+SchedulerTraceWriter::Write (uint8_t operation, uint32_t uid)
+{
+  m_file.put (operation);
+  m_file.write ((const char *)&uid, sizeof (uid));
+}
+
+void
+SchedulerTraceWriter::RecordInsert (uint32_t uid, uint64_t delay)
+{
+  Write (SchedulerTraceRecord::INSERT, uid);
+  m_file.write ((const char *)&delay, sizeof (delay));
+}
+
+void
+SchedulerTraceWriter::RecordExecute (uint32_t uid)
+{
+  Write (SchedulerTraceRecord::EXECUTE, uid);
+}
+
+void
+SchedulerTraceWriter::RecordCancel (uint32_t uid)
+{
+  Write (SchedulerTraceRecord::CANCEL, uid);
+}
+
+void
+SchedulerTraceWriter::RecordRemove (uint32_t uid)
+{
+  Write (SchedulerTraceRecord::REMOVE, uid);
+}
+
+SchedulerTraceReader::SchedulerTraceReader (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (m_file.good (), "Cannot open scheduler trace file " << filename);
+  char magic[sizeof (g_schedulerTraceMagic)];
+  uint32_t version = 0;
+  m_file.read (magic, sizeof (magic));
+  m_file.read ((char *)&version, sizeof (version));
+  NS_ABORT_MSG_UNLESS (m_file.good ()
+                       && std::memcmp (magic, g_schedulerTraceMagic, sizeof (magic)) == 0,
+                       filename << " is not a scheduler trace file");
+  NS_ABORT_MSG_UNLESS (version == g_schedulerTraceVersion,
+                       "Unsupported version " << version << " of scheduler trace file " << filename);
+}
+
+SchedulerTraceReader::~SchedulerTraceReader ()
+{
+  NS_LOG_FUNCTION (this);
+  m_file.close ();
+}
+
+bool
+SchedulerTraceReader::Read (SchedulerTraceRecord &record)
+{
+  int operation = m_file.get ();
+  if (operation == std::char_traits<char>::eof ())
+    {
+      return false;
+    }
+  record.operation = operation;
+  m_file.read ((char *)&record.uid, sizeof (record.uid));
+  record.delay = 0;
+  if (record.operation == SchedulerTraceRecord::INSERT)
+    {
+      m_file.read ((char *)&record.delay, sizeof (record.delay));
+    }
+  NS_ABORT_MSG_UNLESS (m_file.good () && record.operation <= SchedulerTraceRecord::REMOVE,
+                       "Corrupted scheduler trace file");
+  return true;
+}
+
+} // namespace ns3
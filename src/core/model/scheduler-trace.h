@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SCHEDULER_TRACE_H
+#define SCHEDULER_TRACE_H
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of the ns3::SchedulerTraceWriter and
+ * ns3::SchedulerTraceReader classes.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief An operation of the simulator on its scheduler.
+ *
+ * A scheduler trace is the sequence of the operations of a simulation
+ * on its event list. It does not depend on the scheduler, so it can be
+ * replayed on any scheduler, see utils/bench-scheduler-replay.cc.
+ *
+ * The time of an operation is not recorded: it is the time stamp of the
+ * last executed event, or zero before the first one.
+ */
+struct SchedulerTraceRecord
+{
+  /** The kinds of operations. */
+  enum Operation
+  {
+    INSERT = 0,   //!< An event is scheduled after delay
+    EXECUTE = 1,  //!< The next event is executed
+    CANCEL = 2,   //!< An event is cancelled, see Simulator::Cancel
+    REMOVE = 3    //!< An event is removed, see Simulator::Remove
+  };
+  uint8_t operation;  //!< The operation
+  uint32_t uid;       //!< The unique id of the event
+  uint64_t delay;     //!< The delay of an INSERT, in time steps
+};
+
+/**
+ * \ingroup scheduler
+ * \brief Write the operations of a simulator to a scheduler trace file.
+ *
+ * The file starts with an 8-byte magic and a 32-bit version. Every record
+ * is an operation byte and a 32-bit uid, followed by a 64-bit delay for
+ * INSERT records, i.e. 5 or 13 bytes, in the native byte order.
+ */
+class SchedulerTraceWriter
+{
+public:
+  /**
+   * Create the file, and write its header.
+   *
+   * \param filename The name of the file.
+   */
+  SchedulerTraceWriter (std::string filename);
+  ~SchedulerTraceWriter ();
+
+  /**
+   * \param uid The unique id of the scheduled event.
+   * \param delay The delay of the event, in time steps.
+   */
+  void RecordInsert (uint32_t uid, uint64_t delay);
+  /**
+   * \param uid The unique id of the executed event.
+   */
+  void RecordExecute (uint32_t uid);
+  /**
+   * \param uid The unique id of the cancelled event.
+   */
+  void RecordCancel (uint32_t uid);
+  /**
+   * \param uid The unique id of the removed event.
+   */
+  void RecordRemove (uint32_t uid);
+
+private:
+  /**
+   * Write a record without delay.
+   *
+   * \param operation The operation.
+   * \param uid The unique id of the event.
+   */
+  void Write (uint8_t operation, uint32_t uid);
+
+  std::ofstream m_file;  //!< The trace file.
+};
+
+/**
+ * \ingroup scheduler
+ * \brief Read the records of a scheduler trace file.
+ */
+class SchedulerTraceReader
+{
+public:
+  /**
+   * Open a file and check its header.
+   *
+   * \param filename The name of the file.
+   */
+  SchedulerTraceReader (std::string filename);
+  ~SchedulerTraceReader ();
+
+  /**
+   * Read the next record.
+   *
+   * \param [out] record The record.
+   * \returns false at the end of the file.
+   */
+  bool Read (SchedulerTraceRecord &record);
+
+private:
+  std::ifstream m_file;  //!< The trace file.
+};
+
+} // namespace ns3
+
+#endif /* SCHEDULER_TRACE_H */
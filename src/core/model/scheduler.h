@@ -119,6 +119,14 @@ public:
    * This methods cannot be invoked if the list is empty.
    */
   virtual void Remove (const Event &ev) = 0;
+  /**
+   * \returns true if Remove() costs about as much as RemoveNext().
+   *
+   * If true, the simulator removes cancelled events from the event list
+   * right away, instead of keeping them in the list until they expire.
+   * The default implementation returns false.
+   */
+  virtual bool IsRemoveCheap (void) const;
 };
 
 /* Note the invariants which this function must provide:
@@ -142,6 +142,67 @@ private:
   mutable uint32_t m_count;
 };
 
+/**
+ * \ingroup ptr
+ * \brief A reference counting class for objects shared by threads
+ *
+ * This template is a SimpleRefCount, whose reference count is updated
+ * atomically. It is meant for the objects, which are created once and
+ * then used by the simulations of several threads at the same time, see
+ * SimulationContext: the attribute values, accessors and checkers of the
+ * TypeIds, or a SpectrumModel. The other objects of a simulation are only
+ * used by its thread, and keep the cheaper SimpleRefCount.
+ *
+ * \tparam T The typename of the subclass, see SimpleRefCount.
+ * \tparam PARENT The typename of the parent of this template.
+ * \tparam DELETER The typename of the class which deletes the object.
+ */
+template <typename T, typename PARENT = empty, typename DELETER = DefaultDeleter<T> >
+class SharedRefCount : public PARENT
+{
+public:
+  /** Constructor */
+  SharedRefCount ()
+    : m_count (1)
+  {}
+  /** Copy constructor */
+  SharedRefCount (const SharedRefCount &o)
+    : m_count (1)
+  {}
+  /**
+   * Assignment
+   * \returns This object.
+   */
+  SharedRefCount &operator = (const SharedRefCount &o)
+  {
+    return *this;
+  }
+  /** \copydoc SimpleRefCount::Ref */
+  inline void Ref (void) const
+  {
+    NS_ASSERT (m_count < std::numeric_limits<uint32_t>::max());
+    __sync_add_and_fetch (&m_count, 1);
+  }
+  /** \copydoc SimpleRefCount::Unref */
+  inline void Unref (void) const
+  {
+    if (__sync_sub_and_fetch (&m_count, 1) == 0)
+      {
+        DELETER::Delete (static_cast<T*> (const_cast<SharedRefCount *> (this)));
+      }
+  }
+  /** \copydoc SimpleRefCount::GetReferenceCount */
+  inline uint32_t GetReferenceCount (void) const
+  {
+    return m_count;
+  }
+  /** Noop */
+  static void Cleanup (void) {}
+private:
+  /** The reference count. */
+  mutable uint32_t m_count;
+};
+
 } // namespace ns3
 
 #endif /* SIMPLE_REF_COUNT_H */
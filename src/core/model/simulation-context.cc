@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "simulation-context.h"
+#include "assert.h"
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::SimulationContext implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * The context of the calling thread, 0 for the process-wide context.
+ */
+static __thread SimulationContext *g_currentContext = 0;
+
+/**
+ * \ingroup core
+ * The number of ContextLocal variables.
+ */
+static uint32_t g_contextLocalVariables = 0;
+
+SimulationContext::SimulationContext ()
+{
+}
+
+SimulationContext::~SimulationContext ()
+{
+  // The destructors of the values run in this context, and may use other
+  // variables of the context, even create them again.
+  SimulationContext *previous = g_currentContext;
+  g_currentContext = this;
+  while (!m_order.empty ())
+    {
+      uint32_t index = m_order.back ();
+      m_order.pop_back ();
+      Slot slot = m_slots[index];
+      m_slots[index].value = 0;
+      slot.destroy (slot.value);
+    }
+  g_currentContext = previous == this ? 0 : previous;
+}
+
+void
+SimulationContext::Enter (void)
+{
+  g_currentContext = this;
+}
+
+void
+SimulationContext::Leave (void)
+{
+  g_currentContext = 0;
+}
+
+SimulationContext *
+SimulationContext::GetCurrent (void)
+{
+  return g_currentContext;
+}
+
+uint32_t
+SimulationContext::AllocateIndex (void)
+{
+  // Function-local ContextLocal variables may be constructed by several
+  // threads at once.
+  return __sync_fetch_and_add (&g_contextLocalVariables, 1);
+}
+
+void
+SimulationContext::Set (uint32_t index, void *value, void (*destroy)(void *))
+{
+  NS_ASSERT (Peek (index) == 0);
+  if (index >= m_slots.size ())
+    {
+      Slot empty = { 0, 0 };
+      m_slots.resize (index + 1, empty);
+    }
+  m_slots[index].value = value;
+  m_slots[index].destroy = destroy;
+  m_order.push_back (index);
+}
+
+} // namespace ns3
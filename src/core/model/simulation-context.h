@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SIMULATION_CONTEXT_H
+#define SIMULATION_CONTEXT_H
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::SimulationContext declaration and ns3::ContextLocal template
+ * implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief The state of a simulation, which would otherwise be process-wide.
+ *
+ * The simulator implementation, the node list, the random number streams
+ * and the other singletons of a simulation are stored in ContextLocal
+ * variables. A thread, which has entered a SimulationContext, sees the
+ * values of that context; the other threads see the process-wide values.
+ * Several threads can thus run independent simulations at the same time,
+ * each in its own context, see ReplicationRunner.
+ *
+ * A context is used by one thread at a time. Deleting a context deletes
+ * its values, the simulation must have been destroyed before.
+ */
+class SimulationContext
+{
+public:
+  SimulationContext ();
+  ~SimulationContext ();
+
+  /**
+   * Make this context the context of the calling thread.
+   */
+  void Enter (void);
+
+  /**
+   * Return the calling thread to the process-wide context.
+   */
+  static void Leave (void);
+
+  /**
+   * \returns The context of the calling thread, or 0 for the process-wide
+   *          context.
+   */
+  static SimulationContext *GetCurrent (void);
+
+  /**
+   * \returns A new index of a ContextLocal variable.
+   */
+  static uint32_t AllocateIndex (void);
+
+  /**
+   * \param index The index of a ContextLocal variable.
+   * \returns The value of the variable in this context, or 0 if it was not
+   *          created yet.
+   */
+  inline void *Peek (uint32_t index) const;
+
+  /**
+   * Store the value of a ContextLocal variable in this context.
+   *
+   * \param index The index of the variable.
+   * \param value The value.
+   * \param destroy The function, which deletes the value with the context.
+   */
+  void Set (uint32_t index, void *value, void (*destroy)(void *));
+
+private:
+  /** The value of a variable in a context. */
+  struct Slot
+  {
+    void *value;                 //!< The value, or 0.
+    void (*destroy)(void *);     //!< Delete the value.
+  };
+  std::vector<Slot> m_slots;     //!< The values, by index.
+  std::vector<uint32_t> m_order; //!< The indices, in creation order.
+};
+
+/**
+ * \ingroup core
+ * \brief A variable with one value per SimulationContext.
+ *
+ * The value of the process-wide context is a member of the variable, the
+ * value of another context is created from the initial value the first
+ * time it is used in that context.
+ *
+ * \tparam T The type of the variable.
+ */
+template <typename T>
+class ContextLocal
+{
+public:
+  /** Create a variable, value-initialized in every context. */
+  ContextLocal ();
+  /**
+   * Create a variable.
+   *
+   * \param initial The initial value in every context.
+   */
+  ContextLocal (const T &initial);
+
+  /**
+   * \returns The value of the variable in the context of the calling thread.
+   */
+  inline T &Get (void);
+
+private:
+  /**
+   * Delete a value of another context.
+   *
+   * \param value The value.
+   */
+  static void Destroy (void *value);
+
+  uint32_t m_index;  //!< The index of the variable.
+  T m_initial;       //!< The initial value.
+  T m_process;       //!< The value of the process-wide context.
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+void *
+SimulationContext::Peek (uint32_t index) const
+{
+  return index < m_slots.size () ? m_slots[index].value : 0;
+}
+
+template <typename T>
+ContextLocal<T>::ContextLocal ()
+  : m_index (SimulationContext::AllocateIndex ()),
+    m_initial (),
+    m_process ()
+{
+}
+
+template <typename T>
+ContextLocal<T>::ContextLocal (const T &initial)
+  : m_index (SimulationContext::AllocateIndex ()),
+    m_initial (initial),
+    m_process (initial)
+{
+}
+
+template <typename T>
+T &
+ContextLocal<T>::Get (void)
+{
+  SimulationContext *context = SimulationContext::GetCurrent ();
+  if (context == 0)
+    {
+      return m_process;
+    }
+  T *value = static_cast<T *> (context->Peek (m_index));
+  if (value == 0)
+    {
+      value = new T (m_initial);
+      context->Set (m_index, value, &ContextLocal<T>::Destroy);
+    }
+  return *value;
+}
+
+template <typename T>
+void
+ContextLocal<T>::Destroy (void *value)
+{
+  delete static_cast<T *> (value);
+}
+
+} // namespace ns3
+
+#endif /* SIMULATION_CONTEXT_H */
@@ -38,6 +38,8 @@ namespace ns3 {
  *
  * For a singleton with a lifetime bounded by the process,
  * not the simulation run, see Singleton.
+ *
+ * Every SimulationContext has its own instance.
  */
 template <typename T>
 class SimulationSingleton
@@ -99,6 +101,7 @@ private:
  ********************************************************************/
 
 #include "simulator.h"
+#include "simulation-context.h"
 
 namespace ns3 {
 
@@ -114,7 +117,8 @@ template <typename T>
 T **
 SimulationSingleton<T>::GetObject (void)
 {
-  static T *pobject = 0;
+  static ContextLocal<T *> object;
+  T *&pobject = object.Get ();
   if (pobject == 0)
     {
       pobject = new T ();
@@ -227,6 +227,15 @@ public:
    * \return The current simulation context
    */
   virtual uint32_t GetContext (void) const = 0;
+  /**
+   * Set the context of the event which is currently running.
+   *
+   * Events scheduled with Schedule() from now on inherit the new
+   * context. The next event sets the context again.
+   *
+   * \param context The new simulation context.
+   */
+  virtual void SetContext (uint32_t context) = 0;
 };
 
 } // namespace ns3
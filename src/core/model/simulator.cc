@@ -23,11 +23,13 @@
 #include "scheduler.h"
 #include "map-scheduler.h"
 #include "event-impl.h"
+#include "simulation-context.h"
 
 #include "ptr.h"
 #include "string.h"
 #include "object-factory.h"
 #include "global-value.h"
+#include "boolean.h"
 #include "assert.h"
 #include "log.h"
 
@@ -106,15 +108,40 @@ NodePrinter (std::ostream &os)
     }
 }
 
+/**
+ * \ingroup logging
+ * Capture the log messages, and format them later (see LogSetDeferred()).
+ */
+static GlobalValue g_logDeferred ("LogDeferred",
+                                  "Capture the log messages in per-thread buffers, and format them "
+                                  "in a thread, at LogFlush () or at exit",
+                                  BooleanValue (false),
+                                  MakeBooleanChecker ());
+
+/**
+ * \ingroup logging
+ * Defer the logs if the global value "LogDeferred" is set.
+ */
+static void
+CheckLogDeferred (void)
+{
+  BooleanValue deferred;
+  g_logDeferred.GetValue (deferred);
+  if (deferred.Get ())
+    {
+      LogSetDeferred (true);
+    }
+}
+
 /**
  * \ingroup simulator
- * \brief Get the static SimulatorImpl instance.
+ * \brief Get the SimulatorImpl instance of the SimulationContext.
  * \return The SimulatorImpl instance pointer.
  */
 static SimulatorImpl **PeekImpl (void)
 {
-  static SimulatorImpl *impl = 0;
-  return &impl;
+  static ContextLocal<SimulatorImpl *> impl;
+  return &impl.Get ();
 }
 
 /**
@@ -156,6 +183,7 @@ static SimulatorImpl * GetImpl (void)
 //
       LogSetTimePrinter (&TimePrinter);
       LogSetNodePrinter (&NodePrinter);
+      CheckLogDeferred ();
     }
   return *pimpl;
 }
@@ -180,6 +208,8 @@ Simulator::Destroy (void)
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
+  // the events of the simulation are gone, return their memory
+  EventImpl::ReleasePool ();
 }
 
 void
@@ -345,6 +375,13 @@ Simulator::GetContext (void)
   return GetImpl ()->GetContext ();
 }
 
+void
+Simulator::SetContext (uint32_t context)
+{
+  NS_LOG_FUNCTION (context);
+  GetImpl ()->SetContext (context);
+}
+
 uint32_t
 Simulator::GetSystemId (void)
 {
@@ -384,6 +421,7 @@ Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
 //
   LogSetTimePrinter (&TimePrinter);
   LogSetNodePrinter (&NodePrinter);
+  CheckLogDeferred ();
 }
 
 Ptr<SimulatorImpl>
@@ -747,6 +747,11 @@ public:
   /** \copydoc SimulatorImpl::GetContext */
   static uint32_t GetContext (void);
 
+  /** \copydoc SimulatorImpl::SetContext
+   * Only meant for events which do the work of several contexts.
+   */
+  static void SetContext (uint32_t context);
+
   /** \copydoc SimulatorImpl::Schedule */
   static EventId Schedule (Time const &time, const Ptr<EventImpl> &event);
 
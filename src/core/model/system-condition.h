@@ -59,9 +59,8 @@ class SystemConditionPrivate;
  * condition to become true; but the TimedWait has a timeout.
  *
  * The condition underlying this class is a simple boolean variable.  It is
- * set to false in each call to Wait and TimedWait.  It is set to true in each
- * call to Signal and Broadcast.  This is a fairly simple-minded condition
- * designed for 
+ * set with SetCondition, and left unchanged by Wait and TimedWait.  This is a
+ * fairly simple-minded condition designed for 
  *
  * A typical use case will be to call Wait() or TimedWait() in one thread
  * context and put the processor to sleep until an event happens somewhere 
@@ -99,7 +98,9 @@ public:
   void Broadcast (void);
 
   /**
-   * Wait, possibly forever, for the condition to be true.
+   * Wait, possibly forever, for the condition to be true.  The condition is
+   * not reset, so a caller which sets it to false before checking what it
+   * waits for does not miss a Signal sent in between.
    */
   void Wait (void);
 	
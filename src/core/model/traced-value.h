@@ -274,6 +274,26 @@ std::ostream& operator << (std::ostream& os, const TracedValue<T>& rhs)
   return os<<rhs.Get ();
 }
 
+/**
+ * Store the underlying value of a TracedValue in a deferred log message,
+ * rather than shifting the LogStream by it.
+ *
+ * \tparam T The underlying type of the TracedValue.
+ */
+template <typename T>
+struct LogValue<TracedValue<T> >
+{
+  typedef LogStream Stream;  //!< The type of the stream.
+  /**
+   * \param stream The stream.
+   * \param value The TracedValue.
+   */
+  static void Put (LogStream &stream, const TracedValue<T> &value)
+  {
+    stream << value.Get ();
+  }
+};
+
 /**
  * Boolean operator for TracedValue.
  * \tparam T The underlying type held by the left-hand argument.
@@ -23,6 +23,7 @@
 #include "singleton.h"
 #include "trace-source-accessor.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <sstream>
@@ -52,6 +53,13 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
  * Information records are stored in a vector.  Name and hash lookup
  * are performed by maps to the vector index.
  *
+ * Every record also has an index of the attributes and of the trace
+ * sources of the type and of its parents, sorted by the hash of their
+ * names, so that a lookup by name is a binary search instead of a walk up
+ * the parent chain.  The indexes are updated when an attribute, a trace
+ * source or a parent is registered, for the type and the types derived
+ * from it; the lookups only read them.
+ *
  * \internal
  * <b>Hash Chaining</b>
  *
@@ -115,11 +123,30 @@ public:
   uint32_t GetTraceSourceN (uint16_t uid) const;
   struct TypeId::TraceSourceInformation GetTraceSource(uint16_t uid, uint32_t i) const;
   bool MustHideFromDocumentation (uint16_t uid) const;
+  const struct TypeId::AttributeInformation *LookupAttribute (uint16_t uid, const std::string &name) const;
+  const struct TypeId::TraceSourceInformation *LookupTraceSource (uint16_t uid, const std::string &name) const;
 
 private:
   bool HasTraceSource (uint16_t uid, std::string name);
   bool HasAttribute (uint16_t uid, std::string name);
   static TypeId::hash_t Hasher (const std::string name);
+  static uint32_t HashName (const std::string &name);
+
+  /** An entry of the index of the attributes or trace sources of a type. */
+  struct IndexEntry
+  {
+    uint32_t hash;  //!< The HashName of the name.
+    uint16_t uid;   //!< The type, or the parent, which registered it.
+    uint32_t i;     //!< Its position in the vector of this type.
+    /**
+     * \param o The other entry.
+     * \returns true if the hash of this entry is lower.
+     */
+    bool operator < (const IndexEntry &o) const
+    {
+      return hash < o.hash;
+    }
+  };
 
   struct IidInformation {
     std::string name;
@@ -132,14 +159,29 @@ private:
     bool mustHideFromDocumentation;
     std::vector<struct TypeId::AttributeInformation> attributes;
     std::vector<struct TypeId::TraceSourceInformation> traceSources;
+    /** The attributes of the type and of its parents. */
+    std::vector<IndexEntry> attributeIndex;
+    /** The trace sources of the type and of its parents. */
+    std::vector<IndexEntry> traceSourceIndex;
   };
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
 
   struct IidManager::IidInformation *LookupInformation (uint16_t uid) const;
 
+  template <typename T>
+  void UpdateIndex (uint16_t uid,
+                    std::vector<T> IidInformation::*entries,
+                    std::vector<IndexEntry> IidInformation::*index);
+  void UpdateIndexes (uint16_t uid);
+  template <typename T>
+  const T *LookupIndex (uint16_t uid, const std::string &name,
+                        std::vector<T> IidInformation::*entries,
+                        std::vector<IndexEntry> IidInformation::*index) const;
+
   std::vector<struct IidInformation> m_information;
 
-  typedef std::map<std::string, uint16_t> namemap_t;
+  /** The uids, by HashName of their names. */
+  typedef std::multimap<uint32_t, uint16_t> namemap_t;
   namemap_t m_namemap;
 
   typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
@@ -163,13 +205,26 @@ IidManager::Hasher (const std::string name)
   static ns3::Hasher hasher ( Create<Hash::Function::Murmur3> () );
   return hasher.clear ().GetHash32 (name);
 }
+
+  //static
+uint32_t
+IidManager::HashName (const std::string &name)
+{
+  // FNV-1a: short, and without state, unlike Hasher, for the lookups
+  uint32_t hash = 2166136261U;
+  for (std::string::const_iterator i = name.begin (); i != name.end (); i++)
+    {
+      hash = (hash ^ (uint8_t)*i) * 16777619U;
+    }
+  return hash;
+}
   
 uint16_t
 IidManager::AllocateUid (std::string name)
 {
   NS_LOG_FUNCTION (this << name);
   // Type names are definitive: equal names are equal types
-  NS_ASSERT_MSG (m_namemap.count (name) == 0,
+  NS_ASSERT_MSG (GetUid (name) == 0,
                  "Trying to allocate twice the same uid: " << name);
   
   TypeId::hash_t hash = Hasher (name) & (~HashChainFlag);
@@ -230,7 +285,7 @@ IidManager::AllocateUid (std::string name)
   NS_ASSERT (uid <= 0xffff);
 
   // Add to both maps:
-  m_namemap.insert (std::make_pair (name, uid));
+  m_namemap.insert (std::make_pair (HashName (name), uid));
   m_hashmap.insert (std::make_pair (hash, uid));
   return uid;
 }
@@ -250,6 +305,7 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  UpdateIndexes (uid);
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -290,15 +346,16 @@ uint16_t
 IidManager::GetUid (std::string name) const
 {
   NS_LOG_FUNCTION (this << name);
-  namemap_t::const_iterator it = m_namemap.find (name);
-  if (it != m_namemap.end ())
+  std::pair<namemap_t::const_iterator, namemap_t::const_iterator> range;
+  range = m_namemap.equal_range (HashName (name));
+  for (namemap_t::const_iterator it = range.first; it != range.second; it++)
     {
-      return it->second;
-    }
-  else
-    {
-      return 0;
+      if (LookupInformation (it->second)->name == name)
+        {
+          return it->second;
+        }
     }
+  return 0;
 }
 uint16_t 
 IidManager::GetUid (TypeId::hash_t hash) const
@@ -387,27 +444,7 @@ IidManager::HasAttribute (uint16_t uid,
                           std::string name)
 {
   NS_LOG_FUNCTION (this << uid << name);
-  struct IidInformation *information  = LookupInformation (uid);
-  while (true)
-    {
-      for (std::vector<struct TypeId::AttributeInformation>::const_iterator i = information->attributes.begin ();
-           i != information->attributes.end (); ++i)
-        {
-          if (i->name == name)
-            {
-              return true;
-            }
-        }
-      struct IidInformation *parent = LookupInformation (information->parent);
-      if (parent == information)
-        {
-          // top of inheritance tree
-          return false;
-        }
-      // check parent
-      information = parent;
-    }
-  return false;
+  return LookupAttribute (uid, name) != 0;
 }
 
 void 
@@ -435,6 +472,7 @@ IidManager::AddAttribute (uint16_t uid,
   info.accessor = accessor;
   info.checker = checker;
   information->attributes.push_back (info);
+  UpdateIndexes (uid);
 }
 void 
 IidManager::SetAttributeInitialValue(uint16_t uid,
@@ -470,27 +508,7 @@ IidManager::HasTraceSource (uint16_t uid,
                             std::string name)
 {
   NS_LOG_FUNCTION (this << uid << name);
-  struct IidInformation *information  = LookupInformation (uid);
-  while (true)
-    {
-      for (std::vector<struct TypeId::TraceSourceInformation>::const_iterator i = information->traceSources.begin ();
-           i != information->traceSources.end (); ++i)
-        {
-          if (i->name == name)
-            {
-              return true;
-            }
-        }
-      struct IidInformation *parent = LookupInformation (information->parent);
-      if (parent == information)
-        {
-          // top of inheritance tree
-          return false;
-        }
-      // check parent
-      information = parent;
-    }
-  return false;
+  return LookupTraceSource (uid, name) != 0;
 }
 
 void 
@@ -513,6 +531,7 @@ IidManager::AddTraceSource (uint16_t uid,
   source.accessor = accessor;
   source.callback = callback;
   information->traceSources.push_back (source);
+  UpdateIndexes (uid);
 }
 uint32_t 
 IidManager::GetTraceSourceN (uint16_t uid) const
@@ -537,6 +556,94 @@ IidManager::MustHideFromDocumentation (uint16_t uid) const
   return information->mustHideFromDocumentation;
 }
 
+template <typename T>
+void
+IidManager::UpdateIndex (uint16_t uid,
+                         std::vector<T> IidInformation::*entries,
+                         std::vector<IndexEntry> IidInformation::*index)
+{
+  NS_LOG_FUNCTION (this << uid);
+  struct IidInformation *information = LookupInformation (uid);
+  const std::vector<T> &own = information->*entries;
+  std::vector<IndexEntry> &result = information->*index;
+  result.clear ();
+  for (uint32_t i = 0; i < own.size (); i++)
+    {
+      IndexEntry entry = { HashName (own[i].name), uid, i };
+      result.push_back (entry);
+    }
+  if (information->parent != 0 && information->parent != uid)
+    {
+      // the entries of the parents, unless this type has one of the
+      // same name, which is found first by a walk up the parent chain
+      const std::vector<IndexEntry> &inherited = LookupInformation (information->parent)->*index;
+      for (std::vector<IndexEntry>::const_iterator j = inherited.begin (); j != inherited.end (); j++)
+        {
+          const std::string &name = (LookupInformation (j->uid)->*entries)[j->i].name;
+          bool overridden = false;
+          for (uint32_t i = 0; i < own.size () && !overridden; i++)
+            {
+              overridden = result[i].hash == j->hash && own[i].name == name;
+            }
+          if (!overridden)
+            {
+              result.push_back (*j);
+            }
+        }
+    }
+  std::stable_sort (result.begin (), result.end ());
+}
+
+void
+IidManager::UpdateIndexes (uint16_t uid)
+{
+  NS_LOG_FUNCTION (this << uid);
+  UpdateIndex (uid, &IidInformation::attributes, &IidInformation::attributeIndex);
+  UpdateIndex (uid, &IidInformation::traceSources, &IidInformation::traceSourceIndex);
+  // the types derived from this one inherit the new entries
+  for (uint32_t i = 1; i <= m_information.size (); i++)
+    {
+      if (i != uid && m_information[i-1].parent == uid)
+        {
+          UpdateIndexes (i);
+        }
+    }
+}
+
+template <typename T>
+const T *
+IidManager::LookupIndex (uint16_t uid, const std::string &name,
+                         std::vector<T> IidInformation::*entries,
+                         std::vector<IndexEntry> IidInformation::*index) const
+{
+  const std::vector<IndexEntry> &entryIndex = LookupInformation (uid)->*index;
+  IndexEntry key = { HashName (name), 0, 0 };
+  for (std::vector<IndexEntry>::const_iterator i = std::lower_bound (entryIndex.begin (), entryIndex.end (), key);
+       i != entryIndex.end () && i->hash == key.hash; i++)
+    {
+      const T *entry = &(LookupInformation (i->uid)->*entries)[i->i];
+      if (entry->name == name)
+        {
+          return entry;
+        }
+    }
+  return 0;
+}
+
+const struct TypeId::AttributeInformation *
+IidManager::LookupAttribute (uint16_t uid, const std::string &name) const
+{
+  NS_LOG_FUNCTION (this << uid << name);
+  return LookupIndex (uid, name, &IidInformation::attributes, &IidInformation::attributeIndex);
+}
+
+const struct TypeId::TraceSourceInformation *
+IidManager::LookupTraceSource (uint16_t uid, const std::string &name) const
+{
+  NS_LOG_FUNCTION (this << uid << name);
+  return LookupIndex (uid, name, &IidInformation::traceSources, &IidInformation::traceSourceIndex);
+}
+
 } // namespace ns3
 
 namespace ns3 {
@@ -616,22 +723,14 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-          if (tmp.name == name)
-            {
-              *info = tmp;
-              return true;
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return false;
+  const struct TypeId::AttributeInformation *found;
+  found = Singleton<IidManager>::Get ()->LookupAttribute (m_tid, name);
+  if (found == 0)
+    {
+      return false;
+    }
+  *info = *found;
+  return true;
 }
 
 TypeId 
@@ -842,21 +941,13 @@ Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName (std::string name) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetTraceSourceN (); i++)
-        {
-          struct TypeId::TraceSourceInformation info = tid.GetTraceSource (i);
-          if (info.name == name)
-            {
-              return info.accessor;
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return 0;
+  const struct TypeId::TraceSourceInformation *found;
+  found = Singleton<IidManager>::Get ()->LookupTraceSource (m_tid, name);
+  if (found == 0)
+    {
+      return 0;
+    }
+  return found->accessor;
 }
 
 uint16_t 
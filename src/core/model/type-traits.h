@@ -151,6 +151,7 @@ private:
     enum { IsPointerToMember = 1};                //!< Pointer to member value
     enum { nArgs = 0};                            //!< Number of arguments
     typedef U ReturnType;                         //!< Return type
+    typedef V ClassType;                          //!< Class type
   };
   template <typename U, typename V> 
   struct PtrToMemberTraits <U (V::*) (void) const>//!< Pointer to const member type traits
@@ -158,6 +159,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    
     enum { nArgs = 0};				  //!< Number of arguments	    
     typedef U ReturnType;			  //!< Return type		    
+    typedef V ClassType;			  //!< Class type
   };
   template <typename U, typename V,typename W1> 
   struct PtrToMemberTraits <U (V::*) (W1)>        //!< Pointer to member type traits
@@ -165,6 +167,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    
     enum { nArgs = 1};				  //!< Number of arguments	    
     typedef U ReturnType;			  //!< Return type		    
+    typedef V ClassType;			  //!< Class type
     typedef W1 Arg1Type;                          //!< First argument type
   };
   template <typename U, typename V,typename W1> 
@@ -173,6 +176,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    	  
     enum { nArgs = 1};				  //!< Number of arguments	    	  
     typedef U ReturnType;			  //!< Return type		    	  
+    typedef V ClassType;			  //!< Class type
     typedef W1 Arg1Type;                          //!< First argument type
   };
   template <typename U, typename V,typename W1, typename W2> 
@@ -181,6 +185,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    
     enum { nArgs = 2};				  //!< Number of arguments	    
     typedef U ReturnType;			  //!< Return type		    
+    typedef V ClassType;			  //!< Class type
     typedef W1 Arg1Type;			  //!< First argument type	    
     typedef W2 Arg2Type;			  //!< Second argument type	    
   };
@@ -190,6 +195,7 @@ private:
     enum { IsPointerToMember = 1};		     //!< Pointer to member value	    	  
     enum { nArgs = 2};				     //!< Number of arguments	    	  
     typedef U ReturnType;			     //!< Return type		    	  
+    typedef V ClassType;			     //!< Class type
     typedef W1 Arg1Type;			     //!< First argument type		  
     typedef W2 Arg2Type;			     //!< Second argument type		  
   };
@@ -201,6 +207,7 @@ private:
     enum { IsPointerToMember = 1};		  //!< Pointer to member value	    
     enum { nArgs = 3};				  //!< Number of arguments	    
     typedef U ReturnType;			  //!< Return type		    
+    typedef V ClassType;			  //!< Class type
     typedef W1 Arg1Type;			  //!< First argument type	    
     typedef W2 Arg2Type;			  //!< Second argument type	    
     typedef W3 Arg3Type;			  //!< Third argument type	    
@@ -213,6 +220,7 @@ private:
     enum { IsPointerToMember = 1};			//!< Pointer to member value	     
     enum { nArgs = 3};					//!< Number of arguments	    	     
     typedef U ReturnType;				//!< Return type		    	     
+    typedef V ClassType;				//!< Class type
     typedef W1 Arg1Type;				//!< First argument type		     
     typedef W2 Arg2Type;				//!< Second argument type		     
     typedef W3 Arg3Type;				//!< Third argument type		     
@@ -225,6 +233,7 @@ private:
     enum { IsPointerToMember = 1};		     //!< Pointer to member value	    
     enum { nArgs = 4};				     //!< Number of arguments	    
     typedef U ReturnType;			     //!< Return type		    
+    typedef V ClassType;			     //!< Class type
     typedef W1 Arg1Type;			     //!< First argument type	    
     typedef W2 Arg2Type;			     //!< Second argument type	    
     typedef W3 Arg3Type;			     //!< Third argument type	    
@@ -238,6 +247,7 @@ private:
     enum { IsPointerToMember = 1};			   //!< Pointer to member value	     	
     enum { nArgs = 4};					   //!< Number of arguments	    	
     typedef U ReturnType;				   //!< Return type		    	
+    typedef V ClassType;				   //!< Class type
     typedef W1 Arg1Type;				   //!< First argument type		
     typedef W2 Arg2Type;				   //!< Second argument type		
     typedef W3 Arg3Type;				   //!< Third argument type		
@@ -252,6 +262,7 @@ private:
     enum { IsPointerToMember = 1};			//!< Pointer to member value      
     enum { nArgs = 5};					//!< Number of arguments	       
     typedef U ReturnType;				//!< Return type		       
+    typedef V ClassType;				//!< Class type
     typedef W1 Arg1Type;				//!< First argument type	       
     typedef W2 Arg2Type;				//!< Second argument type	       
     typedef W3 Arg3Type;				//!< Third argument type	       
@@ -267,6 +278,7 @@ private:
     enum { IsPointerToMember = 1};			      //!< Pointer to member value	     	   
     enum { nArgs = 5};					      //!< Number of arguments	    	   
     typedef U ReturnType;				      //!< Return type		    	   
+    typedef V ClassType;				      //!< Class type
     typedef W1 Arg1Type;				      //!< First argument type		   
     typedef W2 Arg2Type;				      //!< Second argument type		   
     typedef W3 Arg3Type;				      //!< Third argument type		   
@@ -282,6 +294,7 @@ private:
     enum { IsPointerToMember = 1};			   //!< Pointer to member value      
     enum { nArgs = 6};					   //!< Number of arguments	  
     typedef U ReturnType;				   //!< Return type		  
+    typedef V ClassType;				   //!< Class type
     typedef W1 Arg1Type;				   //!< First argument type	  
     typedef W2 Arg2Type;				   //!< Second argument type	  
     typedef W3 Arg3Type;				   //!< Third argument type	  
@@ -298,6 +311,7 @@ private:
     enum { IsPointerToMember = 1};				 //!< Pointer to member value	      
     enum { nArgs = 6};						 //!< Number of arguments	    	      
     typedef U ReturnType;					 //!< Return type		    	      
+    typedef V ClassType;					 //!< Class type
     typedef W1 Arg1Type;					 //!< First argument type		      
     typedef W2 Arg2Type;					 //!< Second argument type		      
     typedef W3 Arg3Type;					 //!< Third argument type		      
@@ -124,7 +124,9 @@ void
 SystemConditionPrivate::SetCondition (bool condition)
 {
   NS_LOG_FUNCTION (this << condition);
+  pthread_mutex_lock (&m_mutex);
   m_condition = condition;
+  pthread_mutex_unlock (&m_mutex);
 }
 	
 bool
@@ -160,7 +162,6 @@ SystemConditionPrivate::Wait (void)
   NS_LOG_FUNCTION (this);
 
   pthread_mutex_lock (&m_mutex);
-  m_condition = false;
   while (m_condition == false)
     {
       pthread_cond_wait (&m_cond, &m_mutex);
@@ -721,6 +721,75 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+// ===========================================================================
+// Test for the resolution of the compiled paths: the matches are in the
+// order of the indexes, and a cached path still sees the objects added
+// after it was first resolved.
+// ===========================================================================
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  CompiledPathConfigTestCase ();
+  virtual ~CompiledPathConfigTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check the matches of a path resolved several times")
+{
+}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Names::Add ("CompiledPathRoot", root);
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeB (objects.back ());
+    }
+
+  Config::MatchContainer matches = Config::LookupMatches ("/Names/CompiledPathRoot/NodesB/3|[0-1]");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 3, "Wrong number of matches");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objects[0], "Matches not in the order of the indexes");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (1), objects[1], "Matches not in the order of the indexes");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (2), objects[3], "Matches not in the order of the indexes");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (2), "/Names/CompiledPathRoot/NodesB/3/", "Wrong matched path");
+
+  matches = Config::LookupMatches ("/Names/CompiledPathRoot/NodesB/7");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 0, "Index out of the vector matched");
+  matches = Config::LookupMatches ("/Names/CompiledPathRoot/NodesB/x");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 0, "Invalid index matched");
+
+  matches = Config::LookupMatches ("/Names/CompiledPathRoot/NodesB/*");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 4, "Wrong number of matches");
+  for (uint32_t i = 4; i < 8; i++)
+    {
+      objects.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeB (objects.back ());
+    }
+  matches = Config::LookupMatches ("/Names/CompiledPathRoot/NodesB/*");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 8, "The objects added are not matched");
+  matches = Config::LookupMatches ("/Names/CompiledPathRoot/NodesB/7");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "The object added is not matched");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objects[7], "Wrong object matched");
+
+  Config::Set ("/Names/CompiledPathRoot/NodesB/[2-5]/A", IntegerValue (-3));
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      IntegerValue iv;
+      objects[i]->GetAttribute ("A", iv);
+      int64_t expected = (i >= 2 && i <= 5) ? -3 : 10;
+      NS_TEST_ASSERT_MSG_EQ (iv.Get (), expected, "Object Attribute \"A\" of " << i);
+    }
+
+  Names::Clear ();
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -737,6 +806,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new CompiledPathConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/make-event.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * \ingroup tests
+ * A class with a virtual handler.
+ */
+class EventProfilerTestBase
+{
+public:
+  virtual ~EventProfilerTestBase ()
+  {
+  }
+  /** A virtual handler. */
+  virtual void Handle (void)
+  {
+  }
+};
+
+/**
+ * \ingroup tests
+ * Another class with a virtual handler.
+ */
+class EventProfilerTestOther
+{
+public:
+  EventProfilerTestOther ()
+    : m_handled (0)
+  {
+  }
+  virtual ~EventProfilerTestOther ()
+  {
+  }
+  /**
+   * A virtual handler.
+   * \param n The number of calls.
+   */
+  virtual void HandleOther (uint32_t n)
+  {
+    m_handled += n;
+  }
+  uint32_t m_handled;  //!< The number of calls.
+};
+
+/**
+ * \ingroup tests
+ * A class which overrides the handlers of two bases.
+ */
+class EventProfilerTestDerived : public EventProfilerTestBase, public EventProfilerTestOther
+{
+public:
+  virtual void Handle (void)
+  {
+  }
+  virtual void HandleOther (uint32_t n)
+  {
+    m_handled += 2 * n;
+  }
+};
+
+/**
+ * \ingroup tests
+ * A function handler.
+ */
+void
+EventProfilerTestFunction (uint32_t n)
+{
+}
+
+/**
+ * \ingroup tests
+ * Check that the events return the handler which they call.
+ */
+class EventProfilerHandlerTestCase : public TestCase
+{
+public:
+  EventProfilerHandlerTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \param event An event.
+   * \returns The handler of the event.
+   */
+  const void * GetHandler (EventImpl *event);
+};
+
+EventProfilerHandlerTestCase::EventProfilerHandlerTestCase ()
+  : TestCase ("Check that the handlers of the events are the overriding methods")
+{
+}
+
+const void *
+EventProfilerHandlerTestCase::GetHandler (EventImpl *event)
+{
+  const void *handler = event->GetHandler ();
+  event->Unref ();
+  return handler;
+}
+
+void
+EventProfilerHandlerTestCase::DoRun (void)
+{
+  EventProfilerTestBase base;
+  EventProfilerTestDerived derived;
+  EventProfilerTestBase *derivedBase = &derived;
+  EventProfilerTestOther *derivedOther = &derived;
+
+  const void *baseHandle = GetHandler (MakeEvent (&EventProfilerTestBase::Handle, &base));
+  const void *derivedHandle = GetHandler (MakeEvent (&EventProfilerTestDerived::Handle, &derived));
+  NS_TEST_ASSERT_MSG_NE (baseHandle, 0, "No handler");
+  NS_TEST_ASSERT_MSG_NE (derivedHandle, 0, "No handler");
+  NS_TEST_ASSERT_MSG_NE (baseHandle, derivedHandle, "The overriding method is not the handler");
+  NS_TEST_ASSERT_MSG_EQ (GetHandler (MakeEvent (&EventProfilerTestBase::Handle, derivedBase)),
+                         derivedHandle, "The virtual method of the base is not resolved");
+
+  // the method of the second base is reached through a thunk, which
+  // adjusts this, and is merged with the method by the reports
+  EventProfilerTestOther other;
+  const void *otherHandle = GetHandler (MakeEvent (&EventProfilerTestOther::HandleOther, &other, 1));
+  const void *thunk = GetHandler (MakeEvent (&EventProfilerTestOther::HandleOther, derivedOther, 1));
+  NS_TEST_ASSERT_MSG_NE (thunk, 0, "No handler");
+  NS_TEST_ASSERT_MSG_NE (thunk, otherHandle, "The virtual method of the second base is not resolved");
+  NS_TEST_ASSERT_MSG_NE (GetHandler (MakeEvent (&EventProfilerTestDerived::HandleOther, &derived, 1)), 0,
+                         "No handler");
+  EventImpl *event = MakeEvent (&EventProfilerTestOther::HandleOther, &derived, 1);
+  event->Invoke ();
+  event->Unref ();
+  NS_TEST_ASSERT_MSG_EQ (derived.m_handled, 2, "The overriding method was not called");
+
+  NS_TEST_ASSERT_MSG_NE (GetHandler (MakeEvent (&EventProfilerTestFunction, 1)), 0, "No handler");
+  NS_TEST_ASSERT_MSG_NE (GetHandler (MakeEvent (&Simulator::Stop)), 0, "No handler");
+}
+
+/**
+ * \ingroup tests
+ * Check the profile of a simulation.
+ */
+class EventProfilerReportTestCase : public TestCase
+{
+public:
+  EventProfilerReportTestCase ();
+  virtual void DoRun (void);
+};
+
+EventProfilerReportTestCase::EventProfilerReportTestCase ()
+  : TestCase ("Check the events of the profile of a simulation")
+{
+}
+
+void
+EventProfilerReportTestCase::DoRun (void)
+{
+  std::string report = CreateTempDirFilename ("event-profile.txt");
+  std::string folded = CreateTempDirFilename ("event-profile.folded");
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFile", StringValue (report));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFoldedFile", StringValue (folded));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileSamplePeriod", UintegerValue (3));
+
+  EventProfilerTestDerived derived;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::ScheduleWithContext (7, Seconds (i), &EventProfilerTestOther::HandleOther,
+                                      &derived, 1);
+    }
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Simulator::ScheduleWithContext (8, Seconds (i), &EventProfilerTestDerived::HandleOther,
+                                      &derived, 1);
+    }
+  Simulator::Cancel (Simulator::Schedule (Seconds (1), &EventProfilerTestFunction, 1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFile", StringValue (""));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileFoldedFile", StringValue (""));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::ProfileSamplePeriod", UintegerValue (1));
+  NS_TEST_ASSERT_MSG_EQ (derived.m_handled, 28, "Events lost");
+
+  // "ns %  events  ns/event  context  handler", after the totals by handler
+  std::ifstream is (report.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (is.good (), true, "No report");
+  std::string line;
+  std::string handler;
+  uint32_t handlers = 0;
+  uint32_t contexts = 0;
+  bool byContext = false;
+  while (std::getline (is, line))
+    {
+      NS_TEST_ASSERT_MSG_EQ (line.find ("EventProfilerTestFunction"), std::string::npos,
+                             "Cancelled event profiled");
+      if (line.find ("# by handler and context") == 0)
+        {
+          byContext = true;
+        }
+      if (line[0] == '#')
+        {
+          continue;
+        }
+      if (!byContext)
+        {
+          handlers++;
+          continue;
+        }
+      std::istringstream iss (line);
+      double ns, percent, nsPerEvent;
+      uint32_t events, context;
+      iss >> ns >> percent >> events >> nsPerEvent >> context >> std::ws;
+      std::getline (iss, handler);
+      NS_TEST_ASSERT_MSG_EQ (handler.find ("EventProfilerTestDerived::HandleOther"), 0,
+                             "Wrong handler " << handler);
+      NS_TEST_ASSERT_MSG_EQ (events, (context == 7 ? 10u : 4u), "Wrong events in context " << context);
+      contexts++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (handlers, 1, "The handlers of the events are not merged");
+  NS_TEST_ASSERT_MSG_EQ (contexts, 2, "Wrong contexts");
+
+  std::ifstream fs (folded.c_str ());
+  std::getline (fs, line);
+  NS_TEST_ASSERT_MSG_EQ (line.find (handler + ";node 7 "), 0, "Wrong folded stack " << line);
+  std::getline (fs, line);
+  NS_TEST_ASSERT_MSG_EQ (line.find (handler + ";node 8 "), 0, "Wrong folded stack " << line);
+}
+
+/**
+ * \ingroup tests
+ * The EventProfiler test suite.
+ */
+class EventProfilerTestSuite : public TestSuite
+{
+public:
+  EventProfilerTestSuite ()
+    : TestSuite ("event-profiler", UNIT)
+  {
+    AddTestCase (new EventProfilerHandlerTestCase, TestCase::QUICK);
+    AddTestCase (new EventProfilerReportTestCase, TestCase::QUICK);
+  }
+};
+
+static EventProfilerTestSuite g_eventProfilerTestSuite; //!< Static variable for test initialization
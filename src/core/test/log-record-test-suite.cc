@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LogRecordTest");
+
+/**
+ * \ingroup tests
+ * A type without a LogValue, formatted by its operator<<.
+ */
+struct LogRecordTestPoint
+{
+  int x;  //!< The abscissa.
+  int y;  //!< The ordinate.
+};
+
+/**
+ * \param [in] os The stream.
+ * \param [in] p The point.
+ * \returns The stream.
+ */
+std::ostream &
+operator << (std::ostream &os, const LogRecordTestPoint &p)
+{
+  return os << "(" << p.x << "," << p.y << ")";
+}
+
+/**
+ * \ingroup tests
+ * Check that the deferred log messages are formatted as the immediate ones.
+ */
+class LogRecordTestCase : public TestCase
+{
+public:
+  LogRecordTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Log messages of all the kinds.
+   *
+   * \param [in] i A parameter.
+   */
+  void Log (uint32_t i);
+
+  /**
+   * Run the messages of a simulation.
+   *
+   * \param [in] deferred Defer the logs.
+   * \returns The output.
+   */
+  std::string Run (bool deferred);
+
+  Ptr<Object> m_object;  //!< An object, at the same address in both runs.
+};
+
+LogRecordTestCase::LogRecordTestCase ()
+  : TestCase ("Check that the deferred log messages are formatted as the immediate ones")
+{
+}
+
+void
+LogRecordTestCase::Log (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i << "text" << std::string ("string"));
+  NS_LOG_FUNCTION_NOARGS ();
+  int16_t s = -3;
+  uint8_t c = 'c';
+  bool b = true;
+  LogRecordTestPoint point = { 1, -2 };
+  NS_LOG_DEBUG ("integers " << s << " " << i << " " << -5000000000LL << " " << c << ' ' << b);
+  NS_LOG_INFO ("doubles " << 1.0 / 3 << " " << 1e300 << " " << 2.5f);
+  NS_LOG_LOGIC ("time " << Simulator::Now () << " " << Seconds (2.5) << " " << NanoSeconds (-7));
+  NS_LOG_WARN ("pointers " << PeekPointer (m_object) << " " << m_object << " " << (void *) 0);
+  NS_LOG_ERROR ("point " << point << " " << i << " level " << LOG_DEBUG);
+  NS_LOG_DEBUG ("format " << std::hex << i + 254 << " " << std::setw (6) << std::setfill ('0')
+                          << i << " " << std::fixed << std::setprecision (2) << 1.0 / 3
+                          << std::dec << std::setfill (' ') << std::setprecision (6)
+                          << std::resetiosflags (std::ios_base::fixed));
+  NS_LOG_DEBUG ("default format again " << i + 254 << " " << 1.0 / 3);
+  NS_LOG_UNCOND ("unconditional " << i << std::endl << "two lines");
+}
+
+std::string
+LogRecordTestCase::Run (bool deferred)
+{
+  std::ostringstream os;
+  std::streambuf *clog = std::clog.rdbuf (os.rdbuf ());
+  LogComponentEnable ("LogRecordTest", (enum LogLevel) (LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+  LogSetDeferred (deferred);
+  Simulator::ScheduleWithContext (3, Seconds (1.5), &LogRecordTestCase::Log, this, 7);
+  Simulator::Schedule (Seconds (2), &LogRecordTestCase::Log, this, 8);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Log (9);
+  LogSetDeferred (false);
+  LogComponentDisable ("LogRecordTest", (enum LogLevel) (LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+  std::clog.rdbuf (clog);
+  return os.str ();
+}
+
+void
+LogRecordTestCase::DoRun (void)
+{
+  m_object = CreateObject<Object> ();
+  std::string immediate = Run (false);
+  std::string deferred = Run (true);
+  NS_TEST_ASSERT_MSG_EQ (deferred, immediate, "The deferred messages are not formatted as the immediate ones");
+  NS_TEST_ASSERT_MSG_EQ (LogStream::IsDeferred (), false, "The logs are still deferred");
+  m_object = 0;
+}
+
+/**
+ * \ingroup tests
+ * Check that the messages which do not fit in the ring buffer are kept,
+ * in order.
+ */
+class LogRecordFullTestCase : public TestCase
+{
+public:
+  LogRecordFullTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogRecordFullTestCase::LogRecordFullTestCase ()
+  : TestCase ("Check that the messages which do not fit in the ring buffer are kept, in order")
+{
+}
+
+void
+LogRecordFullTestCase::DoRun (void)
+{
+  std::string large (800000, 'x');
+  std::ostringstream expected;
+  std::ostringstream os;
+  std::streambuf *clog = std::clog.rdbuf (os.rdbuf ());
+  LogComponentEnable ("LogRecordTest", LOG_LEVEL_DEBUG);
+  LogSetDeferred (true);
+  for (uint32_t i = 0; i < 50000; i++)
+    {
+      NS_LOG_DEBUG ("message " << i << " of the full ring buffer");
+      expected << "message " << i << " of the full ring buffer" << std::endl;
+      if (i == 30000)
+        {
+          NS_LOG_DEBUG (large);
+          expected << large << std::endl;
+        }
+    }
+  LogSetDeferred (false);
+  LogComponentDisable ("LogRecordTest", LOG_LEVEL_ALL);
+  std::clog.rdbuf (clog);
+#ifdef NS3_LOG_ENABLE
+  NS_TEST_ASSERT_MSG_EQ ((os.str () == expected.str ()), true, "Lost or reordered messages");
+#endif /* NS3_LOG_ENABLE */
+}
+
+/**
+ * \ingroup tests
+ * The deferred logs test suite.
+ */
+class LogRecordTestSuite : public TestSuite
+{
+public:
+  LogRecordTestSuite ()
+    : TestSuite ("log-record", UNIT)
+  {
+    AddTestCase (new LogRecordTestCase (), TestCase::QUICK);
+    AddTestCase (new LogRecordFullTestCase (), TestCase::QUICK);
+  }
+};
+
+static LogRecordTestSuite g_logRecordTestSuite; //!< Static variable for test initialization
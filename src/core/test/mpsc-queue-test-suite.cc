@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/system-thread.h"
+
+#include <sched.h>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup tests
+ * An item of the queue: the producer, and its sequence number.
+ */
+struct MpscQueueTestItem
+{
+  uint32_t producer;  //!< The producer.
+  uint32_t sequence;  //!< The sequence number of the item of the producer.
+};
+
+/**
+ * \ingroup tests
+ * Check the queue with one thread.
+ */
+class MpscQueueSingleThreadTestCase : public TestCase
+{
+public:
+  MpscQueueSingleThreadTestCase ();
+  virtual void DoRun (void);
+};
+
+MpscQueueSingleThreadTestCase::MpscQueueSingleThreadTestCase ()
+  : TestCase ("Check the order of the items of one producer, and that the ring is bounded")
+{
+}
+
+void
+MpscQueueSingleThreadTestCase::DoRun (void)
+{
+  MpscQueue<uint32_t> queue (5);
+  NS_TEST_ASSERT_MSG_EQ (queue.GetCapacity (), 8, "The capacity is not rounded to a power of two");
+  NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "A new queue is not empty");
+
+  std::vector<uint32_t> items;
+  uint32_t next = 0;
+  for (uint32_t round = 0; round < 4; round++)
+    {
+      // fill the ring, then drain everything
+      for (uint32_t i = 0; i < 8; i++)
+        {
+          queue.Push (next++);
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), false, "The queue is empty after a push");
+      NS_TEST_ASSERT_MSG_EQ (queue.TryPush (next), false, "An item was pushed to the full ring");
+      NS_TEST_ASSERT_MSG_EQ (queue.PopAll (items), 8, "Wrong number of items popped");
+      NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "The queue is not empty after PopAll");
+      // a few items, which fit in the ring
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (queue.TryPush (next++), true, "An item was not pushed");
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue.PopAll (items), 3, "Wrong number of items popped");
+    }
+  NS_TEST_ASSERT_MSG_EQ (queue.GetFullWaits (), 0, "A push waited for a cell");
+  NS_TEST_ASSERT_MSG_EQ (items.size (), next, "Items were lost");
+  for (uint32_t i = 0; i < items.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (items[i], i, "The items are not in order");
+    }
+}
+
+/**
+ * \ingroup tests
+ * Check the queue with several producer threads.
+ */
+class MpscQueueThreadsTestCase : public TestCase
+{
+public:
+  MpscQueueThreadsTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Push the items of a producer.
+   *
+   * \param test The test case.
+   * \param producer The producer.
+   */
+  static void Produce (MpscQueueThreadsTestCase *test, uint32_t producer);
+
+  MpscQueue<MpscQueueTestItem> m_queue;  //!< The queue.
+  uint32_t m_producers;                  //!< The number of producers.
+  uint32_t m_items;                      //!< The number of items per producer.
+};
+
+MpscQueueThreadsTestCase::MpscQueueThreadsTestCase ()
+  : TestCase ("Check that the items of concurrent producers are popped once, in order"),
+    m_queue (16),
+    m_producers (4),
+    m_items (20000)
+{
+}
+
+void
+MpscQueueThreadsTestCase::Produce (MpscQueueThreadsTestCase *test, uint32_t producer)
+{
+  for (uint32_t i = 0; i < test->m_items; i++)
+    {
+      MpscQueueTestItem item = { producer, i };
+      test->m_queue.Push (item);
+      if (i % 64 == 0)
+        {
+          sched_yield ();
+        }
+    }
+}
+
+void
+MpscQueueThreadsTestCase::DoRun (void)
+{
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&MpscQueueThreadsTestCase::Produce, this, i)));
+    }
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads[i]->Start ();
+    }
+
+  std::vector<uint32_t> next (m_producers, 0);
+  std::vector<MpscQueueTestItem> items;
+  uint32_t total = 0;
+  while (total < m_producers * m_items)
+    {
+      items.clear ();
+      total += m_queue.PopAll (items);
+      for (uint32_t i = 0; i < items.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_LT (items[i].producer, m_producers, "Corrupted item");
+          NS_TEST_ASSERT_MSG_EQ (items[i].sequence, next[items[i].producer],
+                                 "Item of producer " << items[i].producer << " out of order");
+          next[items[i].producer] = items[i].sequence + 1;
+        }
+      if (items.empty ())
+        {
+          sched_yield ();
+        }
+    }
+
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads[i]->Join ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_queue.IsEmpty (), true, "Items left in the queue");
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (next[i], m_items, "Items of producer " << i << " lost");
+    }
+}
+
+/**
+ * \ingroup tests
+ * The MpscQueue test suite.
+ */
+class MpscQueueTestSuite : public TestSuite
+{
+public:
+  MpscQueueTestSuite ()
+    : TestSuite ("mpsc-queue", UNIT)
+  {
+    AddTestCase (new MpscQueueSingleThreadTestCase, TestCase::QUICK);
+    AddTestCase (new MpscQueueThreadsTestCase, TestCase::QUICK);
+  }
+};
+
+static MpscQueueTestSuite g_mpscQueueTestSuite; //!< Static variable for test initialization
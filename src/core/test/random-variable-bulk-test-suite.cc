@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/rng-stream.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup tests
+ * Check that the numbers generated in bulk by a RngStream are the
+ * numbers generated one by one.
+ */
+class RngStreamBulkTestCase : public TestCase
+{
+public:
+  RngStreamBulkTestCase ();
+  virtual void DoRun (void);
+};
+
+RngStreamBulkTestCase::RngStreamBulkTestCase ()
+  : TestCase ("Check that the bulk numbers of a RngStream are its scalar numbers")
+{
+}
+
+void
+RngStreamBulkTestCase::DoRun (void)
+{
+  RngStream scalar (12345, 3, 7);
+  RngStream bulk (12345, 3, 7);
+
+  // sizes across the blocks and the chunks of the bulk generation,
+  // with a few numbers drawn one by one in between
+  const uint32_t sizes[] = { 1, 7, 32, 33, 256, 257, 600, 0, 5, 1000, 511, 3 };
+  std::vector<double> values;
+  uint32_t index = 0;
+  for (uint32_t i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++)
+    {
+      values.resize (sizes[i] + 1);
+      bulk.RandU01 (&values[0], sizes[i]);
+      for (uint32_t j = 0; j < sizes[i]; j++, index++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (values[j], scalar.RandU01 (), "Wrong bulk number " << index);
+        }
+      for (uint32_t j = 0; j < i * 50; j++, index++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (bulk.RandU01 (), scalar.RandU01 (), "Wrong scalar number " << index);
+        }
+    }
+
+  // a copy continues the stream, with the numbers generated in advance
+  RngStream copy (bulk);
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      double u = scalar.RandU01 ();
+      NS_TEST_ASSERT_MSG_EQ (bulk.RandU01 (), u, "Wrong number after a copy");
+      NS_TEST_ASSERT_MSG_EQ (copy.RandU01 (), u, "Wrong number of the copy");
+    }
+}
+
+/**
+ * \ingroup tests
+ * Check that the values of RandomVariableStream::GetValues are the
+ * values of GetValue.
+ */
+class RandomVariableBulkTestCase : public TestCase
+{
+public:
+  RandomVariableBulkTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Compare the values of two random variables of the same stream.
+   * \param scalar The random variable drawn with GetValue.
+   * \param bulk The random variable drawn with GetValues.
+   * \param name The name of the random variable.
+   */
+  void Compare (Ptr<RandomVariableStream> scalar, Ptr<RandomVariableStream> bulk, std::string name);
+};
+
+RandomVariableBulkTestCase::RandomVariableBulkTestCase ()
+  : TestCase ("Check that the bulk values of a random variable are its scalar values")
+{
+}
+
+void
+RandomVariableBulkTestCase::Compare (Ptr<RandomVariableStream> scalar, Ptr<RandomVariableStream> bulk,
+                                     std::string name)
+{
+  scalar->SetStream (11);
+  bulk->SetStream (11);
+  std::vector<double> values (333);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      bulk->GetValues (&values[0], values.size ());
+      for (uint32_t j = 0; j < values.size (); j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (values[j], scalar->GetValue (), "Wrong bulk value of " << name);
+        }
+      NS_TEST_ASSERT_MSG_EQ (bulk->GetValue (), scalar->GetValue (), "Wrong value of " << name);
+    }
+}
+
+void
+RandomVariableBulkTestCase::DoRun (void)
+{
+  Compare (CreateObjectWithAttributes<UniformRandomVariable> ("Min", DoubleValue (-2), "Max", DoubleValue (5)),
+           CreateObjectWithAttributes<UniformRandomVariable> ("Min", DoubleValue (-2), "Max", DoubleValue (5)),
+           "uniform");
+  Compare (CreateObjectWithAttributes<UniformRandomVariable> ("Antithetic", BooleanValue (true)),
+           CreateObjectWithAttributes<UniformRandomVariable> ("Antithetic", BooleanValue (true)),
+           "antithetic uniform");
+  Compare (CreateObjectWithAttributes<ExponentialRandomVariable> ("Mean", DoubleValue (3), "Bound", DoubleValue (0)),
+           CreateObjectWithAttributes<ExponentialRandomVariable> ("Mean", DoubleValue (3), "Bound", DoubleValue (0)),
+           "exponential");
+  Compare (CreateObjectWithAttributes<ExponentialRandomVariable> ("Mean", DoubleValue (3), "Bound", DoubleValue (4)),
+           CreateObjectWithAttributes<ExponentialRandomVariable> ("Mean", DoubleValue (3), "Bound", DoubleValue (4)),
+           "bounded exponential");
+  Compare (CreateObject<NormalRandomVariable> (), CreateObject<NormalRandomVariable> (), "normal");
+}
+
+/**
+ * \ingroup tests
+ * The bulk random numbers test suite.
+ */
+class RandomVariableBulkTestSuite : public TestSuite
+{
+public:
+  RandomVariableBulkTestSuite ()
+    : TestSuite ("random-variable-bulk", UNIT)
+  {
+    AddTestCase (new RngStreamBulkTestCase, TestCase::QUICK);
+    AddTestCase (new RandomVariableBulkTestCase, TestCase::QUICK);
+  }
+};
+
+static RandomVariableBulkTestSuite g_randomVariableBulkTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/replication-runner.h"
+#include "ns3/simulation-context.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/names.h"
+#include "ns3/nstime.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup tests
+ * The result of a replication.
+ */
+struct ReplicationResult
+{
+  double sum;        //!< The sum of the random values.
+  uint32_t events;   //!< The number of executed events.
+  int64_t end;       //!< The time of the last event, in time steps.
+  uint32_t run;      //!< The run number seen by the replication.
+};
+
+/**
+ * \ingroup tests
+ * A replication: a chain of events with random delays.
+ */
+class ReplicationModel
+{
+public:
+  /**
+   * \param result The result of the replication.
+   */
+  ReplicationModel (ReplicationResult *result);
+  /** Execute an event, and schedule the next one. */
+  void Step (void);
+
+private:
+  Ptr<UniformRandomVariable> m_random;  //!< The random delays.
+  ReplicationResult *m_result;          //!< The result.
+};
+
+ReplicationModel::ReplicationModel (ReplicationResult *result)
+  : m_random (CreateObject<UniformRandomVariable> ()),
+    m_result (result)
+{
+  // The names are per context, every replication can use the same name.
+  Names::Add ("random", m_random);
+  m_result->sum = 0;
+  m_result->events = 0;
+}
+
+void
+ReplicationModel::Step (void)
+{
+  double value = m_random->GetValue (0, 10);
+  m_result->sum += value;
+  m_result->events++;
+  m_result->end = Simulator::Now ().GetTimeStep ();
+  if (m_result->events < 1000)
+    {
+      Simulator::Schedule (MicroSeconds (value), &ReplicationModel::Step, this);
+    }
+}
+
+/**
+ * \ingroup tests
+ * Run a replication.
+ *
+ * \param results The results of all the replications.
+ * \param replication The index of the replication.
+ */
+static void
+RunReplication (std::vector<ReplicationResult> *results, uint32_t replication)
+{
+  ReplicationResult &result = (*results)[replication];
+  RngSeedManager::SetRun (replication + 1);
+  result.run = RngSeedManager::GetRun ();
+  ReplicationModel model (&result);
+  Simulator::Schedule (Seconds (1), &ReplicationModel::Step, &model);
+  Simulator::Run ();
+}
+
+/**
+ * \ingroup tests
+ * Check that the replications give the same results with one and with
+ * several threads, and do not change the process-wide state.
+ */
+class ReplicationRunnerTestCase : public TestCase
+{
+public:
+  ReplicationRunnerTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Run the replications.
+   *
+   * \param threads The number of threads.
+   * \returns The results of the replications.
+   */
+  std::vector<ReplicationResult> Run (uint32_t threads);
+};
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase ()
+  : TestCase ("Check that replications run in parallel give the sequential results")
+{
+}
+
+std::vector<ReplicationResult>
+ReplicationRunnerTestCase::Run (uint32_t threads)
+{
+  std::vector<ReplicationResult> results (16);
+  ReplicationRunner runner;
+  runner.SetThreads (threads);
+  runner.Run (results.size (), MakeBoundCallback (&RunReplication, &results));
+  return results;
+}
+
+void
+ReplicationRunnerTestCase::DoRun (void)
+{
+  uint32_t run = RngSeedManager::GetRun ();
+
+  std::vector<ReplicationResult> sequential = Run (1);
+  std::vector<ReplicationResult> parallel = Run (4);
+
+  NS_TEST_ASSERT_MSG_EQ (SimulationContext::GetCurrent (), 0, "The caller left the process-wide context");
+  NS_TEST_ASSERT_MSG_EQ (RngSeedManager::GetRun (), run, "The replications changed the process-wide run");
+  NS_TEST_ASSERT_MSG_EQ (Names::Find<UniformRandomVariable> ("random"), 0, "The replications added process-wide names");
+  for (uint32_t i = 0; i < sequential.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (sequential[i].run, i + 1, "Wrong run of replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (sequential[i].events, 1000, "Wrong number of events of replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].run, sequential[i].run, "Different runs of replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].events, sequential[i].events, "Different events of replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].sum, sequential[i].sum, "Different values of replication " << i);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].end, sequential[i].end, "Different end of replication " << i);
+    }
+  NS_TEST_ASSERT_MSG_NE (sequential[0].sum, sequential[1].sum, "The replications use the same streams");
+}
+
+/**
+ * \ingroup tests
+ * The ReplicationRunner test suite.
+ */
+class ReplicationRunnerTestSuite : public TestSuite
+{
+public:
+  ReplicationRunnerTestSuite ()
+    : TestSuite ("replication-runner", UNIT)
+  {
+    AddTestCase (new ReplicationRunnerTestCase, TestCase::QUICK);
+  }
+};
+
+static ReplicationRunnerTestSuite g_replicationRunnerTestSuite; //!< Static variable for test initialization
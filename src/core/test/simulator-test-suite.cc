@@ -21,8 +21,14 @@
 #include "ns3/simulator.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/indexed-heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/make-event.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/scheduler-trace.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -459,6 +465,227 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+private:
+  virtual void DoRun (void);
+  void Record (uint64_t value, std::string tag);
+  void Chain (uint32_t remaining, uint64_t a, uint64_t b);
+
+  uint64_t m_sum;
+  std::string m_tags;
+  uint32_t m_chained;
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check the reuse of the memory of events")
+{
+}
+
+void
+SimulatorEventPoolTestCase::Record (uint64_t value, std::string tag)
+{
+  m_sum += value;
+  m_tags += tag;
+}
+
+void
+SimulatorEventPoolTestCase::Chain (uint32_t remaining, uint64_t a, uint64_t b)
+{
+  m_chained++;
+  NS_TEST_EXPECT_MSG_EQ (a + b, remaining * 3, "Corrupted event arguments");
+  if (remaining > 0)
+    {
+      Simulator::Schedule (NanoSeconds (1), &SimulatorEventPoolTestCase::Chain, this,
+                           remaining - 1, (uint64_t)(remaining - 1), (uint64_t)(2 * (remaining - 1)));
+    }
+}
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  m_sum = 0;
+  m_tags = "";
+  m_chained = 0;
+
+  // the memory of a destroyed event is reused by the next event of the
+  // same size
+  EventImpl *first = MakeEvent (&SimulatorEventPoolTestCase::Record, this, (uint64_t)1, std::string ("a"));
+  first->Invoke ();
+  first->Unref ();
+  EventImpl *second = MakeEvent (&SimulatorEventPoolTestCase::Record, this, (uint64_t)2, std::string ("b"));
+  NS_TEST_EXPECT_MSG_EQ (second, first, "Memory of the destroyed event not reused");
+  second->Invoke ();
+  second->Unref ();
+  NS_TEST_EXPECT_MSG_EQ (m_sum, 3, "Wrong event arguments");
+  NS_TEST_EXPECT_MSG_EQ (m_tags, "ab", "Wrong event arguments");
+
+  // events with pooled memory run correctly
+  Simulator::Schedule (NanoSeconds (1), &SimulatorEventPoolTestCase::Chain, this,
+                       (uint32_t)1000, (uint64_t)1000, (uint64_t)2000);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_chained, 1001, "Wrong number of events");
+
+  // and without pool
+  EventImpl::DisablePool ();
+  m_chained = 0;
+  Simulator::Schedule (NanoSeconds (1), &SimulatorEventPoolTestCase::Chain, this,
+                       (uint32_t)1000, (uint64_t)1000, (uint64_t)2000);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  EventImpl::EnablePool ();
+  NS_TEST_EXPECT_MSG_EQ (m_chained, 1001, "Wrong number of events without pool");
+}
+
+class SimulatorCancelTestCase : public TestCase
+{
+public:
+  SimulatorCancelTestCase (ObjectFactory schedulerFactory);
+private:
+  virtual void DoRun (void);
+  void Fire (uint32_t i);
+
+  std::vector<EventId> m_ids;
+  std::vector<bool> m_cancelled;
+  std::vector<bool> m_ran;
+  uint64_t m_lastTs;
+  uint32_t m_lastUid;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorCancelTestCase::SimulatorCancelTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check the order of events with many cancellations with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorCancelTestCase::Fire (uint32_t i)
+{
+  uint64_t ts = Simulator::Now ().GetTimeStep ();
+  uint32_t uid = m_ids[i].GetUid ();
+  NS_TEST_EXPECT_MSG_EQ ((ts > m_lastTs || (ts == m_lastTs && uid > m_lastUid)), true,
+                         "Events run out of order");
+  m_lastTs = ts;
+  m_lastUid = uid;
+  m_ran[i] = true;
+  // cancel a later event from within the run, like a timeout
+  if (i % 3 == 1 && i + 1 < m_ids.size () && !m_ids[i + 1].IsExpired ())
+    {
+      m_cancelled[i + 1] = true;
+      Simulator::Cancel (m_ids[i + 1]);
+    }
+}
+
+void
+SimulatorCancelTestCase::DoRun (void)
+{
+  const uint32_t n = 2000;
+  Simulator::SetScheduler (m_schedulerFactory);
+  m_ids.assign (n, EventId ());
+  m_cancelled.assign (n, false);
+  m_ran.assign (n, false);
+  m_lastTs = 0;
+  m_lastUid = 0;
+
+  // a deterministic sequence of times, with many ties
+  uint32_t x = 12345;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      x = x * 1103515245 + 12345;
+      m_ids[i] = Simulator::Schedule (NanoSeconds ((x >> 16) % 500),
+                                      &SimulatorCancelTestCase::Fire, this, i);
+    }
+  for (uint32_t i = 0; i < n; i += 3)
+    {
+      m_cancelled[i] = true;
+      Simulator::Cancel (m_ids[i]);
+      NS_TEST_EXPECT_MSG_EQ (m_ids[i].IsExpired (), true, "Cancelled event not expired");
+    }
+  for (uint32_t i = 2; i < n; i += 7)
+    {
+      if (!m_cancelled[i])
+        {
+          m_cancelled[i] = true;
+          Simulator::Remove (m_ids[i]);
+        }
+    }
+  Simulator::Run ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_ran[i], !m_cancelled[i], "Wrong event " << i << " run");
+    }
+  Simulator::Destroy ();
+}
+
+class SimulatorSchedulerTraceTestCase : public TestCase
+{
+public:
+  SimulatorSchedulerTraceTestCase ();
+private:
+  virtual void DoRun (void);
+  void Event (void);
+
+  EventId m_timeout;
+};
+
+SimulatorSchedulerTraceTestCase::SimulatorSchedulerTraceTestCase ()
+  : TestCase ("Check the recording of scheduler traces")
+{
+}
+
+void
+SimulatorSchedulerTraceTestCase::Event (void)
+{
+  m_timeout.Cancel ();
+}
+
+void
+SimulatorSchedulerTraceTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("scheduler-trace.bin");
+  Ptr<DefaultSimulatorImpl> impl = DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "Not the default simulator implementation");
+  impl->SetSchedulerTraceFile (filename);
+  // Simulator::Destroy closes the file
+  impl = 0;
+
+  EventId a = Simulator::Schedule (NanoSeconds (10), &SimulatorSchedulerTraceTestCase::Event, this);
+  EventId b = Simulator::Schedule (NanoSeconds (5), &SimulatorSchedulerTraceTestCase::Event, this);
+  m_timeout = Simulator::Schedule (NanoSeconds (20), &SimulatorSchedulerTraceTestCase::Event, this);
+  EventId c = Simulator::Schedule (NanoSeconds (30), &SimulatorSchedulerTraceTestCase::Event, this);
+  Simulator::Remove (c);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // operation, uid, delay
+  const uint64_t expected[][3] = {
+    { SchedulerTraceRecord::INSERT, a.GetUid (), 10 },
+    { SchedulerTraceRecord::INSERT, b.GetUid (), 5 },
+    { SchedulerTraceRecord::INSERT, m_timeout.GetUid (), 20 },
+    { SchedulerTraceRecord::INSERT, c.GetUid (), 30 },
+    { SchedulerTraceRecord::REMOVE, c.GetUid (), 0 },
+    { SchedulerTraceRecord::EXECUTE, b.GetUid (), 0 },
+    { SchedulerTraceRecord::CANCEL, m_timeout.GetUid (), 0 },
+    { SchedulerTraceRecord::EXECUTE, a.GetUid (), 0 }
+  };
+  const uint32_t n = sizeof (expected) / sizeof (expected[0]);
+  SchedulerTraceReader reader (filename);
+  SchedulerTraceRecord record;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (reader.Read (record), true, "Missing record " << i);
+      NS_TEST_EXPECT_MSG_EQ ((uint32_t)record.operation, expected[i][0], "Wrong operation of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.uid, expected[i][1], "Wrong uid of record " << i);
+      NS_TEST_EXPECT_MSG_EQ (record.delay, expected[i][2], "Wrong delay of record " << i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (reader.Read (record), false, "Too many records");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -473,7 +700,15 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (HeapScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (IndexedHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (MapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (IndexedHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorCancelTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolTestCase, TestCase::QUICK);
+    AddTestCase (new SimulatorSchedulerTraceTestCase, TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -23,6 +23,7 @@
 #include <ctime>
 
 #include "ns3/type-id.h"
+#include "ns3/integer.h"
 #include "ns3/test.h"
 #include "ns3/log.h"
 
@@ -188,6 +189,80 @@ CollisionTestCase::DoRun (void)
 }
   
   
+//----------------------------
+//
+// Lookup of the attributes of the parents
+
+class InheritedLookupTestCase : public TestCase
+{
+public:
+  InheritedLookupTestCase ();
+  virtual ~InheritedLookupTestCase ();
+private:
+  virtual void DoRun (void);
+  /**
+   * Look up an attribute.
+   *
+   * \param tid The type.
+   * \param name The name of the attribute.
+   * \returns The initial value of the attribute, or "" if not found.
+   */
+  std::string Lookup (TypeId tid, std::string name) const;
+};
+
+InheritedLookupTestCase::InheritedLookupTestCase ()
+  : TestCase ("Check the lookup of the attributes of the parents, registered before and after")
+{
+}
+
+InheritedLookupTestCase::~InheritedLookupTestCase ()
+{
+}
+
+std::string
+InheritedLookupTestCase::Lookup (TypeId tid, std::string name) const
+{
+  struct TypeId::AttributeInformation info;
+  if (!tid.LookupAttributeByName (name, &info))
+    {
+      return "";
+    }
+  return info.initialValue->SerializeToString (0);
+}
+
+void
+InheritedLookupTestCase::DoRun (void)
+{
+  Ptr<const AttributeAccessor> accessor;
+  Ptr<const AttributeChecker> checker;
+  TypeId parent = TypeId ("InheritedLookupParent")
+    .SetParent (TypeId::LookupByName ("ns3::Object"))
+    .AddAttribute ("A", "", IntegerValue (1), accessor, checker);
+  TypeId child = TypeId ("InheritedLookupChild")
+    .SetParent (parent)
+    .AddAttribute ("B", "", IntegerValue (2), accessor, checker);
+  TypeId grandChild = TypeId ("InheritedLookupGrandChild")
+    .SetParent (child);
+
+  NS_TEST_ASSERT_MSG_EQ (Lookup (grandChild, "A"), "1", "Attribute of the grand parent not found");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (grandChild, "B"), "2", "Attribute of the parent not found");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (grandChild, "C"), "", "Missing attribute found");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (parent, "B"), "", "Attribute of a child found on the parent");
+
+  // attributes registered on the parent after the children
+  parent.AddAttribute ("C", "", IntegerValue (3), accessor, checker);
+  parent.AddAttribute ("B", "", IntegerValue (4), accessor, checker);
+  NS_TEST_ASSERT_MSG_EQ (Lookup (grandChild, "C"), "3", "Attribute added to the grand parent not found");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (grandChild, "B"), "2", "Attribute of the parent not found first");
+  NS_TEST_ASSERT_MSG_EQ (Lookup (parent, "B"), "4", "Attribute added to the parent not found");
+
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByName ("InheritedLookupChild"), child, "Type not found by name");
+  TypeId tid;
+  NS_TEST_ASSERT_MSG_EQ (TypeId::LookupByNameFailSafe ("InheritedLookupNone", &tid), false,
+                         "Missing type found by name");
+}
+
+
 //----------------------------
 //
 // Performance test
@@ -298,6 +373,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   // as chained.
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
+  AddTestCase (new InheritedLookupTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;  
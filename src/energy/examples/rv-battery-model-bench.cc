@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/node.h"
+#include "ns3/simple-device-energy-model.h"
+#include "ns3/rv-battery-model.h"
+#include "ns3/energy-source-container.h"
+
+#include <iostream>
+#include <iomanip>
+
+using namespace ns3;
+
+/**
+ * Benchmark of the RvBatteryModel over a battery lifetime of simulated years.
+ *
+ * A single device draws a duty-cycled load, like a sensor node which wakes up
+ * once per period. Every simulated month, the wall clock time spent for that
+ * month is printed. As every sample of the battery model costs the same,
+ * independent of the length of the load history, the time per month stays
+ * constant, i.e. the run time is linear in the simulated time.
+ */
+
+static SystemWallClockMs g_wallClock;
+static int64_t g_lastElapsedMs = 0;
+
+static void
+SetLoad (Ptr<SimpleDeviceEnergyModel> device, double currentA)
+{
+  device->SetCurrentA (currentA);
+}
+
+static void
+ScheduleDutyCycle (Ptr<SimpleDeviceEnergyModel> device, Time period, Time activeTime,
+                   double activeCurrentA, double sleepCurrentA)
+{
+  SetLoad (device, activeCurrentA);
+  Simulator::Schedule (activeTime, &SetLoad, device, sleepCurrentA);
+  Simulator::Schedule (period, &ScheduleDutyCycle, device, period, activeTime,
+                       activeCurrentA, sleepCurrentA);
+}
+
+static void
+Report (Ptr<RvBatteryModel> battery, Time interval)
+{
+  int64_t elapsedMs = g_wallClock.End ();
+  std::cout << std::setw (10) << Simulator::Now ().GetDays ()
+            << std::setw (16) << battery->GetBatteryLevel ()
+            << std::setw (12) << elapsedMs - g_lastElapsedMs
+            << std::setw (12) << elapsedMs << std::endl;
+  g_lastElapsedMs = elapsedMs;
+  if (battery->GetLifetime ().IsZero ())
+    {
+      Simulator::Schedule (interval, &Report, battery, interval);
+    }
+  else
+    {
+      std::cout << "Battery lifetime: " << battery->GetLifetime ().GetDays () << " days" << std::endl;
+      Simulator::Stop ();
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  double years = 3;
+  Time samplingInterval = Seconds (60);
+  Time period = Seconds (600);
+  Time activeTime = Seconds (1);
+  double activeCurrentA = 0.020;
+  double sleepCurrentA = 0.00001;
+
+  CommandLine cmd;
+  cmd.AddValue ("years", "Maximum simulated time, in years", years);
+  cmd.AddValue ("samplingInterval", "Sampling interval of the battery model", samplingInterval);
+  cmd.AddValue ("period", "Duty cycle period", period);
+  cmd.AddValue ("activeTime", "Active time per period", activeTime);
+  cmd.AddValue ("activeCurrent", "Current while active, in A", activeCurrentA);
+  cmd.AddValue ("sleepCurrent", "Current while sleeping, in A", sleepCurrentA);
+  cmd.Parse (argc, argv);
+
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<SimpleDeviceEnergyModel> device = CreateObject<SimpleDeviceEnergyModel> ();
+  Ptr<EnergySourceContainer> sources = CreateObject<EnergySourceContainer> ();
+  Ptr<RvBatteryModel> battery = CreateObject<RvBatteryModel> ();
+  battery->SetAttribute ("RvBatteryModelPeriodicEnergyUpdateInterval", TimeValue (samplingInterval));
+  sources->Add (battery);
+  battery->SetNode (node);
+  device->SetEnergySource (battery);
+  battery->AppendDeviceEnergyModel (device);
+  device->SetNode (node);
+  node->AggregateObject (sources);
+
+  Simulator::ScheduleNow (&ScheduleDutyCycle, device, period, activeTime,
+                          activeCurrentA, sleepCurrentA);
+  Time month = Days (365.0 / 12);
+  Simulator::Schedule (month, &Report, battery, month);
+
+  std::cout << std::setw (10) << "day"
+            << std::setw (16) << "battery level"
+            << std::setw (12) << "month [ms]"
+            << std::setw (12) << "total [ms]" << std::endl;
+
+  g_wallClock.Start ();
+  Simulator::Stop (Days (365 * years));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  return 0;
+}
@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
 
@@ -66,6 +67,15 @@ BasicEnergySource::GetTypeId (void)
                    MakeTimeAccessor (&BasicEnergySource::SetEnergyUpdateInterval,
                                      &BasicEnergySource::GetEnergyUpdateInterval),
                    MakeTimeChecker ())
+    .AddAttribute ("LazyEnergyUpdate",
+                   "If true, the remaining energy is only updated when the total "
+                   "current changes or when it is queried, and a single event is "
+                   "scheduled at the predicted threshold crossing instead of "
+                   "updating every PeriodicEnergyUpdateInterval. The "
+                   "RemainingEnergy trace then fires on these updates only.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&BasicEnergySource::m_lazyUpdate),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RemainingEnergy",
                      "Remaining energy at BasicEnergySource.",
                      MakeTraceSourceAccessor (&BasicEnergySource::m_remainingEnergyJ),
@@ -79,6 +89,7 @@ BasicEnergySource::BasicEnergySource ()
   NS_LOG_FUNCTION (this);
   m_lastUpdateTime = Seconds (0.0);
   m_depleted = false;
+  m_predictedCurrentA = 0.0;
 }
 
 BasicEnergySource::~BasicEnergySource ()
@@ -165,7 +176,10 @@ BasicEnergySource::UpdateEnergySource (void)
       return;
     }
 
-  m_energyUpdateEvent.Cancel ();
+  if (!m_lazyUpdate)
+    {
+      m_energyUpdateEvent.Cancel ();
+    }
 
   CalculateRemainingEnergy ();
 
@@ -183,11 +197,53 @@ BasicEnergySource::UpdateEnergySource (void)
       HandleEnergyRechargedEvent ();
     }
 
+  if (m_lazyUpdate)
+    {
+      // the pending prediction stays valid as long as the current is the same
+      if (!m_energyUpdateEvent.IsRunning ()
+          || CalculateTotalCurrent () != m_predictedCurrentA)
+        {
+          ScheduleThresholdEvent ();
+        }
+      return;
+    }
+
   m_energyUpdateEvent = Simulator::Schedule (m_energyUpdateInterval,
                                              &BasicEnergySource::UpdateEnergySource,
                                              this);
 }
 
+void
+BasicEnergySource::NotifyCurrentChanged (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_lazyUpdate && !Simulator::IsFinished ()
+      && CalculateTotalCurrent () != m_predictedCurrentA)
+    {
+      // the energy up to now has been integrated by the preceding call to
+      // UpdateEnergySource
+      ScheduleThresholdEvent ();
+    }
+}
+
+void
+BasicEnergySource::DrainEnergy (double energyJ)
+{
+  NS_LOG_FUNCTION (this << energyJ);
+  NS_ASSERT (energyJ >= 0);
+  // account the energy drawn by the device models up to now
+  CalculateRemainingEnergy ();
+  m_lastUpdateTime = Simulator::Now ();
+  consumed_Energy += energyJ;
+  m_remainingEnergyJ = std::max (m_remainingEnergyJ.Get () - energyJ, 0.0);
+  if (m_lazyUpdate)
+    {
+      // the pending threshold event was predicted for the old remaining energy
+      Simulator::Remove (m_energyUpdateEvent);
+    }
+  UpdateEnergySource ();
+}
+
 /*
  * Private functions start here.
  */
@@ -249,4 +305,46 @@ BasicEnergySource::CalculateRemainingEnergy (void)
   NS_LOG_DEBUG ("BasicEnergySource:Remaining energy = " << m_remainingEnergyJ);
 }
 
+void
+BasicEnergySource::ScheduleThresholdEvent (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // cancelled events would pile up in the scheduler until the far away
+  // threshold time is reached, so remove them
+  Simulator::Remove (m_energyUpdateEvent);
+
+  double totalCurrentA = CalculateTotalCurrent ();
+  m_predictedCurrentA = totalCurrentA;
+  double powerW = totalCurrentA * m_supplyVoltageV;
+
+  double thresholdJ;
+  if (!m_depleted && powerW > 0)
+    {
+      thresholdJ = m_lowBatteryTh * m_initialEnergyJ;
+    }
+  else if (m_depleted && powerW < 0)
+    {
+      thresholdJ = m_highBatteryTh * m_initialEnergyJ;
+    }
+  else
+    {
+      return; // no threshold is crossed at this current
+    }
+
+  // the remaining energy changes linearly until the current changes again
+  double delayS = (m_remainingEnergyJ - thresholdJ) / powerW;
+  Time maxDelay = Simulator::GetMaximumSimulationTime () - Simulator::Now ();
+  if (delayS >= maxDelay.GetSeconds ())
+    {
+      return;
+    }
+  // round up, so that the threshold has been crossed when the event fires
+  Time delay = Seconds (std::max (delayS, 0.0)) + TimeStep (1);
+  NS_LOG_DEBUG ("BasicEnergySource:Threshold crossed in " << delay.GetSeconds () << "s");
+  m_energyUpdateEvent = Simulator::Schedule (delay,
+                                             &BasicEnergySource::UpdateEnergySource,
+                                             this);
+}
+
 } // namespace ns3
@@ -76,6 +76,22 @@ public:
    */
   virtual void UpdateEnergySource (void);
 
+  /**
+   * Implements NotifyCurrentChanged. In lazy update mode, the threshold event
+   * is predicted again from the new total current.
+   */
+  virtual void NotifyCurrentChanged (void);
+
+  /**
+   * \param energyJ Energy to draw from the source, in Joules.
+   *
+   * Draws energy from the source at once, in addition to the energy drawn by
+   * the device models. This fast-forwards the source over a period that was
+   * not simulated. The energy drawn by the device models up to now is
+   * accounted first, and the battery thresholds are checked afterwards.
+   */
+  void DrainEnergy (double energyJ);
+
   /**
    * \param initialEnergyJ Initial energy, in Joules
    *
@@ -137,6 +153,14 @@ private:
    */
   void CalculateRemainingEnergy (void);
 
+  /**
+   * Used in lazy update mode instead of the periodic update. Predicts when the
+   * remaining energy crosses the low battery threshold (or the high battery
+   * threshold, if the source is depleted and being recharged) at the present
+   * total current and schedules a single update at that instant.
+   */
+  void ScheduleThresholdEvent (void);
+
 private:
   double m_initialEnergyJ;                // initial energy, in Joules
   double m_supplyVoltageV;                // supply voltage, in Volts
@@ -148,6 +172,8 @@ private:
   EventId m_energyUpdateEvent;            // energy update event
   Time m_lastUpdateTime;                  // last update time
   Time m_energyUpdateInterval;            // energy update interval
+  bool m_lazyUpdate;                      // update on current changes only, instead of periodically
+  double m_predictedCurrentA;             // total current the pending threshold event was predicted for
 
   double consumed_Energy;
 
@@ -52,6 +52,12 @@ EnergySource::~EnergySource ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+EnergySource::NotifyCurrentChanged (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
 void
 EnergySource::SetNode (Ptr<Node> node)
 {
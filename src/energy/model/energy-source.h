@@ -120,6 +120,15 @@ public:
    */
   virtual void UpdateEnergySource (void) = 0;
 
+  /**
+   * Called by DeviceEnergyModels right after the current they draw has
+   * changed, i.e. after the state change that UpdateEnergySource was called
+   * for. Energy sources which do not poll the total current can use it to
+   * update predictions that depend on the current. The default implementation
+   * does nothing.
+   */
+  virtual void NotifyCurrentChanged (void);
+
   /**
    * \brief Sets pointer to node containing this EnergySource.
    *
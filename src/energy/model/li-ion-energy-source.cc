@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
 
@@ -103,6 +104,15 @@ LiIonEnergySource::GetTypeId (void)
                    MakeTimeAccessor (&LiIonEnergySource::SetEnergyUpdateInterval,
                                      &LiIonEnergySource::GetEnergyUpdateInterval),
                    MakeTimeChecker ())
+    .AddAttribute ("LazyEnergyUpdate",
+                   "If true, the remaining energy is only updated when the total "
+                   "current changes or when it is queried, integrating the "
+                   "discharge curve exactly, and a single event is scheduled at "
+                   "the predicted depletion instead of updating every "
+                   "PeriodicEnergyUpdateInterval.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LiIonEnergySource::m_lazyUpdate),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RemainingEnergy",
                      "Remaining energy at BasicEnergySource.",
                      MakeTraceSourceAccessor (&LiIonEnergySource::m_remainingEnergyJ),
@@ -113,7 +123,8 @@ LiIonEnergySource::GetTypeId (void)
 
 LiIonEnergySource::LiIonEnergySource ()
   : m_drainedCapacity (0.0),
-    m_lastUpdateTime (Seconds (0.0))
+    m_lastUpdateTime (Seconds (0.0)),
+    m_predictedCurrentA (0.0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -222,7 +233,10 @@ LiIonEnergySource::UpdateEnergySource (void)
       return;
     }
 
-  m_energyUpdateEvent.Cancel ();
+  if (!m_lazyUpdate)
+    {
+      m_energyUpdateEvent.Cancel ();
+    }
 
   CalculateRemainingEnergy ();
 
@@ -230,15 +244,46 @@ LiIonEnergySource::UpdateEnergySource (void)
 
   if (m_remainingEnergyJ <= m_lowBatteryTh * m_initialEnergyJ)
     {
+      Simulator::Remove (m_energyUpdateEvent);
       HandleEnergyDrainedEvent ();
       return; // stop periodic update
     }
 
+  if (m_lazyUpdate)
+    {
+      // the pending prediction stays valid as long as the current is the same
+      if (!m_energyUpdateEvent.IsRunning ()
+          || CalculateTotalCurrent () != m_predictedCurrentA)
+        {
+          ScheduleDepletionEvent ();
+        }
+      return;
+    }
+
   m_energyUpdateEvent = Simulator::Schedule (m_energyUpdateInterval,
                                              &LiIonEnergySource::UpdateEnergySource,
                                              this);
 }
 
+void
+LiIonEnergySource::NotifyCurrentChanged (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_lazyUpdate || Simulator::IsFinished ()
+      || m_remainingEnergyJ <= m_lowBatteryTh * m_initialEnergyJ)
+    {
+      return;
+    }
+  double totalCurrentA = CalculateTotalCurrent ();
+  if (totalCurrentA != m_predictedCurrentA)
+    {
+      // the energy up to now has been integrated by the preceding call to
+      // UpdateEnergySource
+      m_supplyVoltageV = GetVoltage (totalCurrentA);
+      ScheduleDepletionEvent ();
+    }
+}
+
 /*
  * Private functions start here.
  */
@@ -280,10 +325,19 @@ LiIonEnergySource::CalculateRemainingEnergy (void)
   double totalCurrentA = CalculateTotalCurrent ();
   Time duration = Simulator::Now () - m_lastUpdateTime;
   NS_ASSERT (duration.GetSeconds () >= 0);
-  // energy = current * voltage * time
-  double energyToDecreaseJ = totalCurrentA * m_supplyVoltageV * duration.GetSeconds ();
+  double drainedCapacity = totalCurrentA * duration.GetSeconds () / 3600;
+  double energyToDecreaseJ;
+  if (m_lazyUpdate)
+    {
+      energyToDecreaseJ = GetDrainedEnergy (totalCurrentA, m_drainedCapacity, drainedCapacity);
+    }
+  else
+    {
+      // energy = current * voltage * time
+      energyToDecreaseJ = totalCurrentA * m_supplyVoltageV * duration.GetSeconds ();
+    }
   m_remainingEnergyJ -= energyToDecreaseJ;
-  m_drainedCapacity += (totalCurrentA * duration.GetSeconds () / 3600);
+  m_drainedCapacity += drainedCapacity;
   // update the supply voltage
   m_supplyVoltageV = GetVoltage (totalCurrentA);
   NS_LOG_DEBUG ("LiIonEnergySource:Remaining energy = " << m_remainingEnergyJ);
@@ -295,7 +349,13 @@ LiIonEnergySource::GetVoltage (double i) const
   NS_LOG_FUNCTION (this << i);
 
   // integral of i in dt, drained capacity in Ah
-  double it = m_drainedCapacity;
+  return GetVoltage (i, m_drainedCapacity);
+}
+
+double
+LiIonEnergySource::GetVoltage (double i, double it) const
+{
+  NS_LOG_FUNCTION (this << i << it);
 
   // empirical factors
   double A = m_eFull - m_eExp;
@@ -317,4 +377,79 @@ LiIonEnergySource::GetVoltage (double i) const
   return V;
 }
 
+double
+LiIonEnergySource::GetDrainedEnergy (double i, double q0, double dq) const
+{
+  NS_LOG_FUNCTION (this << i << q0 << dq);
+
+  // same factors as in GetVoltage
+  double A = m_eFull - m_eExp;
+  double B = 3 / m_qExp;
+  double K = std::abs ( (m_eFull - m_eNom + A * (std::exp (-B * m_qNom) - 1)) * (m_qRated - m_qNom) / m_qNom);
+  double E0 = m_eFull + K + m_internalResistance * m_typCurrent - A;
+
+  // integral of V over [q0, q0 + dq], written with log1p and expm1 so that
+  // short intervals do not lose precision
+  double integral = (E0 - m_internalResistance * i) * dq
+    + K * m_qRated * std::log1p (-dq / (m_qRated - q0))
+    - A / B * std::exp (-B * q0) * std::expm1 (-B * dq);
+
+  // V * Ah to Joules
+  return integral * 3600;
+}
+
+void
+LiIonEnergySource::ScheduleDepletionEvent (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // cancelled events would pile up in the scheduler until the far away
+  // depletion time is reached, so remove them
+  Simulator::Remove (m_energyUpdateEvent);
+
+  double totalCurrentA = CalculateTotalCurrent ();
+  m_predictedCurrentA = totalCurrentA;
+  if (totalCurrentA <= 0)
+    {
+      return;
+    }
+
+  // The drained energy grows with the drained capacity as long as the cell
+  // voltage is positive, so bisect on the capacity for the threshold. Beyond
+  // zero voltage the model is not meaningful, hence the search stops there.
+  double energyToThresholdJ = m_remainingEnergyJ - m_lowBatteryTh * m_initialEnergyJ;
+  double low = 0;
+  double high = m_qRated - m_drainedCapacity;
+  for (int k = 0; k < 64 && high - low > 0; k++)
+    {
+      double mid = low + (high - low) / 2;
+      if (GetVoltage (totalCurrentA, m_drainedCapacity + mid) > 0
+          && GetDrainedEnergy (totalCurrentA, m_drainedCapacity, mid) < energyToThresholdJ)
+        {
+          low = mid;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+  if (GetDrainedEnergy (totalCurrentA, m_drainedCapacity, high) < energyToThresholdJ)
+    {
+      return; // the cell voltage collapses before
+    }
+
+  double delayS = high * 3600 / totalCurrentA;
+  Time maxDelay = Simulator::GetMaximumSimulationTime () - Simulator::Now ();
+  if (delayS >= maxDelay.GetSeconds ())
+    {
+      return;
+    }
+  // round up, so that the threshold has been reached when the event fires
+  Time delay = Seconds (delayS) + TimeStep (1);
+  NS_LOG_DEBUG ("LiIonEnergySource:Depletion in " << delay.GetSeconds () << "s");
+  m_energyUpdateEvent = Simulator::Schedule (delay,
+                                             &LiIonEnergySource::UpdateEnergySource,
+                                             this);
+}
+
 } // namespace ns3
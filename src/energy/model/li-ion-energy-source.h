@@ -139,6 +139,13 @@ public:
    */
   virtual void UpdateEnergySource (void);
 
+  /**
+   * Implements NotifyCurrentChanged. In lazy update mode, the supply voltage
+   * is updated for the new total current and the depletion event is
+   * predicted again.
+   */
+  virtual void NotifyCurrentChanged (void);
+
   /**
    * \param interval Energy update interval.
    *
@@ -180,6 +187,32 @@ private:
    */
   double GetVoltage (double current) const;
 
+  /**
+   * \param current the actual discharge current value.
+   * \param capacity the drained capacity, in Ah.
+   * \return the cell voltage at the given drained capacity.
+   */
+  double GetVoltage (double current, double capacity) const;
+
+  /**
+   * \param current the constant discharge current, in A
+   * \param capacity the drained capacity at the start, in Ah
+   * \param delta the capacity drained during the discharge, in Ah
+   * \return the energy drained, in Joules
+   *
+   * Integrates the cell voltage in closed form over the drained capacity,
+   * i.e. the limit of the periodic update for an infinitely small interval.
+   * Used in lazy update mode.
+   */
+  double GetDrainedEnergy (double current, double capacity, double delta) const;
+
+  /**
+   * Used in lazy update mode instead of the periodic update. Predicts when the
+   * remaining energy reaches the low battery threshold at the present total
+   * current and schedules a single update at that instant.
+   */
+  void ScheduleDepletionEvent (void);
+
 private:
   double m_initialEnergyJ;                // initial energy, in Joules
   TracedValue<double> m_remainingEnergyJ; // remaining energy, in Joules
@@ -189,6 +222,8 @@ private:
   EventId m_energyUpdateEvent;            // energy update event
   Time m_lastUpdateTime;                  // last update time
   Time m_energyUpdateInterval;            // energy update interval
+  bool m_lazyUpdate;                      // update on current changes only, instead of periodically
+  double m_predictedCurrentA;             // total current the pending depletion event was predicted for
   double m_eFull;                         // initial voltage of the cell, in Volts
   double m_eNom;                          // nominal voltage of the cell, in Volts
   double m_eExp;                          // cell voltage at the end of the exponential zone, in Volts
@@ -96,7 +96,9 @@ RvBatteryModel::RvBatteryModel ()
 {
   NS_LOG_FUNCTION (this);
   m_lastSampleTime = Simulator::Now ();
-  m_timeStamps.push_back (m_lastSampleTime);
+  m_firstSampleTime = m_lastSampleTime;
+  m_intervalStart = m_lastSampleTime;
+  m_consumedCharge = 0.0;
   m_previousLoad = -1.0;
   m_batteryLevel = 1; // fully charged
   m_lifetime = Seconds (0.0);
@@ -175,7 +177,7 @@ RvBatteryModel::UpdateEnergySource (void)
   // check if battery level is below the low battery threshold.
   if (m_batteryLevel <= m_lowBatteryTh)
     {
-      m_lifetime = Simulator::Now () - m_timeStamps[0];
+      m_lifetime = Simulator::Now () - m_firstSampleTime;
       NS_LOG_DEBUG ("RvBatteryModel:Battery level below threshold!");
       HandleEnergyDrainedEvent ();
     }
@@ -280,7 +282,9 @@ void
 RvBatteryModel::SetNumOfTerms (int num)
 {
   NS_LOG_FUNCTION (this << num);
+  NS_ASSERT (num >= 0);
   m_numOfTerms = num;
+  m_diffusionTerms.assign (num, 0.0);
 }
 
 int
@@ -322,64 +326,64 @@ RvBatteryModel::Discharge (double load, Time t)
 {
   NS_LOG_FUNCTION (this << load << t);
 
-  // record only when load changes
+  // start a new interval only when load changes; the first interval, with the
+  // initial load of -1, has zero length and adds nothing
   if (load != m_previousLoad)
     {
-      m_load.push_back (load);
+      CloseLoadInterval (m_lastSampleTime);
       m_previousLoad = load;
-      m_timeStamps[m_timeStamps.size () - 1] = m_lastSampleTime;
-      m_timeStamps.push_back (t);
-    }
-  else
-    {
-      if  (!m_timeStamps.empty())
-      {
-        m_timeStamps[m_timeStamps.size () - 1] = t;
-      }
     }
 
   m_lastSampleTime = t;
 
-  // calculate alpha for new t
-  NS_ASSERT (m_load.size () == m_timeStamps.size () - 1); // size must be equal
-  double calculatedAlpha = 0.0;
-  if (m_timeStamps.size () == 1)
-    {
-      // constant load
-      calculatedAlpha = m_load[0] * RvModelAFunction (t, t, Seconds (0.0),
-                                                      m_beta);
-    }
-  else
+  // calculate alpha for new t, everything is in minutes
+  double delta = (t - m_intervalStart).GetSeconds () / 60;
+  CalculateDecayFactors (delta, m_decayFactors);
+  double sum = 0.0;
+  for (int m = 1; m <= m_numOfTerms; m++)
     {
-      // changing load
-      for (uint64_t i = 1; i < m_timeStamps.size (); i++)
-        {
-          calculatedAlpha += m_load[i - 1] * RvModelAFunction (t, m_timeStamps[i],
-                                                               m_timeStamps[i - 1],
-                                                               m_beta);
-        }
+      double square = m_beta * m_beta * m * m;
+      double factor = m_decayFactors[m - 1];
+      sum += (m_diffusionTerms[m - 1] * factor + load * (1 - factor)) / square;
     }
 
-  return calculatedAlpha;
+  return m_consumedCharge + load * delta + 2 * sum;
 }
 
-double
-RvBatteryModel::RvModelAFunction (Time t, Time sk, Time sk_1, double beta)
+void
+RvBatteryModel::CloseLoadInterval (Time t)
 {
-  NS_LOG_FUNCTION (this << t << sk << sk_1 << beta);
+  NS_LOG_FUNCTION (this << t);
 
   // everything is in minutes
-  double firstDelta = (t.GetSeconds () - sk.GetSeconds ()) / 60;
-  double secondDelta = (t.GetSeconds () - sk_1.GetSeconds ()) / 60;
-  double delta = (sk.GetSeconds () - sk_1.GetSeconds ()) / 60;
+  double delta = (t - m_intervalStart).GetSeconds () / 60;
+  CalculateDecayFactors (delta, m_decayFactors);
+  m_consumedCharge += m_previousLoad * delta;
+  for (int m = 1; m <= m_numOfTerms; m++)
+    {
+      double factor = m_decayFactors[m - 1];
+      m_diffusionTerms[m - 1] = m_diffusionTerms[m - 1] * factor + m_previousLoad * (1 - factor);
+    }
+  m_intervalStart = t;
+}
 
-  double sum = 0.0;
+void
+RvBatteryModel::CalculateDecayFactors (double delta, std::vector<double> &factors) const
+{
+  NS_LOG_FUNCTION (this << delta);
+
+  factors.resize (m_numOfTerms);
+  // exp (-beta^2 * m^2 * delta) = q^(m^2), and (m+1)^2 = m^2 + 2m + 1
+  double q = std::exp (-m_beta * m_beta * delta);
+  double step = q;    // q^(2m-1)
+  double factor = 1;  // q^((m-1)^2)
+  double qSquare = q * q;
   for (int m = 1; m <= m_numOfTerms; m++)
     {
-      double square = beta * beta * m * m;
-      sum += (std::exp (-square * (firstDelta)) - std::exp (-square * (secondDelta))) / square;
+      factor *= step;
+      step *= qSquare;
+      factors[m - 1] = factor;
     }
-  return delta + 2 * sum;
 }
 
 } // namespace ns3
@@ -25,6 +25,7 @@
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "energy-source.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -198,22 +199,36 @@ private:
    * value to determine if the battery is dead. It will also update the battery
    * level.
    *
+   * The load is assumed to have been drawn since the previous sample. Instead
+   * of recording the whole load profile, the function carries the value of
+   * each term of the infinite sum forward: between two samples, every term
+   * decays by a known factor, so each call costs O(number of terms) and the
+   * memory does not grow with the simulated time.
+   *
    * Note that the load value passed to Discharge has to be in mA.
    */
   double Discharge (double load, Time t);
 
   /**
-   * \brief RV model A function.
+   * \brief Closes the current constant load interval at the given time.
+   *
+   * \param t End of the interval.
+   *
+   * Adds the consumed charge and the diffusion terms of the interval to the
+   * state carried forward, and starts a new interval at t.
+   */
+  void CloseLoadInterval (Time t);
+
+  /**
+   * \brief Computes the decay factors exp (-beta^2 * m^2 * delta) of all terms.
    *
-   * \param t Current time.
-   * \param sk Time stamp in array position k
-   * \param sk_1 Time stamp in array position k-1
-   * \param beta Beta value used by the battery model.
-   * \returns Result of A function.
+   * \param delta Elapsed time, in minutes.
+   * \param factors Filled with the factor of term m at index m - 1.
    *
-   * This function computes alpha value using the recorded load profile.
+   * The factors are obtained with a single call to exp, as the factor of term
+   * m is the factor of term 1 to the power of m^2.
    */
-  double RvModelAFunction (Time t, Time sk, Time sk_1, double beta);
+  void CalculateDecayFactors (double delta, std::vector<double> &factors) const;
 
 private:
   double m_openCircuitVoltage;
@@ -222,9 +237,16 @@ private:
   double m_beta;  // beta value of RV model, in second^-1
 
   double m_previousLoad;  // load value (total current) of previous sampling
-  std::vector<double> m_load;     // load profile
-  std::vector<Time> m_timeStamps; // time stamps of load profile
+  Time m_firstSampleTime; // start of the load profile
   Time m_lastSampleTime;
+  Time m_intervalStart;   // start of the current constant load interval
+  double m_consumedCharge; // charge consumed before the current interval, in mA * minutes
+  /**
+   * Sum of term m of the infinite sum over all intervals before the current
+   * one, evaluated at m_intervalStart and stored at index m - 1.
+   */
+  std::vector<double> m_diffusionTerms;
+  std::vector<double> m_decayFactors; // scratch space for CalculateDecayFactors
 
   int m_numOfTerms; // # of terms for infinite sum in battery level estimation
 
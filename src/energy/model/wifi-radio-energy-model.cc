@@ -312,6 +312,7 @@ WifiRadioEnergyModel::ChangeState (int newState)
     {
       // update current state & last update time stamp
       SetWifiRadioState ((WifiPhy::State) newState);
+      m_source->NotifyCurrentChanged ();
 
       // some debug message
       NS_LOG_DEBUG ("WifiRadioEnergyModel:Total energy consumption is " <<
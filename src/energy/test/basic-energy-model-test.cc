@@ -29,6 +29,8 @@
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/simple-device-energy-model.h"
 #include "ns3/config.h"
 #include "ns3/string.h"
 #include "ns3/yans-wifi-helper.h"
@@ -374,6 +376,129 @@ BasicEnergyDepletionTest::DepletionTestCase (double simTimeS,
 
 // -------------------------------------------------------------------------- //
 
+/**
+ * Simple device energy model which records when the energy is depleted.
+ */
+class DepletionRecordingEnergyModel : public SimpleDeviceEnergyModel
+{
+public:
+  DepletionRecordingEnergyModel ()
+    : m_depletionTime (Seconds (-1.0))
+  {
+  }
+
+  virtual void HandleEnergyDepletion (void)
+  {
+    m_depletionTime = Simulator::Now ();
+  }
+
+  Time m_depletionTime; // time of the depletion, negative if not depleted
+};
+
+/**
+ * Test case comparing the lazy update mode of BasicEnergySource with the
+ * periodic update mode.
+ */
+class BasicEnergyLazyUpdateTest : public TestCase
+{
+public:
+  BasicEnergyLazyUpdateTest ();
+  virtual ~BasicEnergyLazyUpdateTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * Counts the updates of the remaining energy.
+   *
+   * \param oldValue previous remaining energy
+   * \param newValue new remaining energy
+   */
+  void RemainingEnergyUpdated (double oldValue, double newValue);
+
+  /**
+   * \param source the source to query
+   * \param remainingEnergyJ the remaining energy, set at the time of the call
+   */
+  static void QueryRemainingEnergy (Ptr<BasicEnergySource> source, double *remainingEnergyJ);
+
+  uint32_t m_updates; // number of updates of the remaining energy
+};
+
+BasicEnergyLazyUpdateTest::BasicEnergyLazyUpdateTest ()
+  : TestCase ("Basic energy source lazy update test case")
+{
+}
+
+BasicEnergyLazyUpdateTest::~BasicEnergyLazyUpdateTest ()
+{
+}
+
+void
+BasicEnergyLazyUpdateTest::RemainingEnergyUpdated (double oldValue, double newValue)
+{
+  m_updates++;
+}
+
+void
+BasicEnergyLazyUpdateTest::QueryRemainingEnergy (Ptr<BasicEnergySource> source,
+                                                 double *remainingEnergyJ)
+{
+  *remainingEnergyJ = source->GetRemainingEnergy ();
+}
+
+void
+BasicEnergyLazyUpdateTest::DoRun (void)
+{
+  double remainingEnergyJ[2];
+  double depletionTimeS[2];
+  uint32_t updates[2];
+
+  for (int lazy = 0; lazy < 2; lazy++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<BasicEnergySource> source = CreateObject<BasicEnergySource> ();
+      source->SetAttribute ("BasicEnergySourceInitialEnergyJ", DoubleValue (10.0));
+      source->SetAttribute ("BasicEnergySupplyVoltageV", DoubleValue (3.0));
+      source->SetAttribute ("LazyEnergyUpdate", BooleanValue (lazy == 1));
+      Ptr<DepletionRecordingEnergyModel> model = CreateObject<DepletionRecordingEnergyModel> ();
+      source->SetNode (node);
+      model->SetEnergySource (source);
+      source->AppendDeviceEnergyModel (model);
+      node->AggregateObject (source);
+
+      m_updates = 0;
+      source->TraceConnectWithoutContext ("RemainingEnergy",
+                                          MakeCallback (&BasicEnergyLazyUpdateTest::RemainingEnergyUpdated, this));
+
+      // 15 mW for 100 s, then 90 mW until the low battery threshold of 1 J
+      model->SetCurrentA (0.005);
+      Simulator::Schedule (Seconds (100.0), &SimpleDeviceEnergyModel::SetCurrentA, model, 0.03);
+      Simulator::Schedule (Seconds (150.0), &BasicEnergyLazyUpdateTest::QueryRemainingEnergy,
+                           source, &remainingEnergyJ[lazy]);
+      Simulator::Stop (Seconds (200.0));
+      Simulator::Run ();
+      depletionTimeS[lazy] = model->m_depletionTime.GetSeconds ();
+      updates[lazy] = m_updates;
+      Simulator::Destroy ();
+    }
+
+  double expectedDepletionS = 100.0 + 7.5 / 0.09;
+  NS_TEST_ASSERT_MSG_EQ_TOL (remainingEnergyJ[1], 10.0 - 1.5 - 50 * 0.09, 1.0e-9,
+                             "Incorrect remaining energy in lazy mode!");
+  NS_TEST_ASSERT_MSG_EQ_TOL (remainingEnergyJ[1], remainingEnergyJ[0], 1.0e-9,
+                             "Lazy and periodic remaining energy differ!");
+  NS_TEST_ASSERT_MSG_EQ_TOL (depletionTimeS[1], expectedDepletionS, 1.0e-6,
+                             "Incorrect depletion time in lazy mode!");
+  // the periodic update notices the depletion at the next update
+  NS_TEST_ASSERT_MSG_EQ_TOL (depletionTimeS[0], std::ceil (expectedDepletionS), 1.0e-9,
+                             "Incorrect depletion time in periodic mode!");
+  NS_TEST_ASSERT_MSG_LT (updates[1] * 20, updates[0],
+                         "Lazy mode does not save updates!");
+}
+
+// -------------------------------------------------------------------------- //
+
 /**
  * Unit test suite for energy model. Although the test suite involves 2 modules
  * it is still considered a unit test. Because a DeviceEnergyModel cannot live
@@ -390,6 +515,7 @@ BasicEnergyModelTestSuite::BasicEnergyModelTestSuite ()
 {
   AddTestCase (new BasicEnergyUpdateTest, TestCase::QUICK);
   AddTestCase (new BasicEnergyDepletionTest, TestCase::QUICK);
+  AddTestCase (new BasicEnergyLazyUpdateTest, TestCase::QUICK);
 }
 
 // create an instance of the test suite
@@ -24,6 +24,8 @@
 #include "ns3/li-ion-energy-source.h"
 #include "ns3/node.h"
 #include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
 
 using namespace ns3;
 
@@ -78,6 +80,93 @@ LiIonEnergyTestCase::DoRun ()
                              "Incorrect consumed energy!");
 }
 
+/**
+ * Simple device energy model which records when the energy is depleted.
+ */
+class LiIonDepletionRecordingEnergyModel : public SimpleDeviceEnergyModel
+{
+public:
+  LiIonDepletionRecordingEnergyModel ()
+    : m_depletionTime (Seconds (-1.0))
+  {
+  }
+
+  virtual void HandleEnergyDepletion (void)
+  {
+    if (m_depletionTime.IsNegative ())
+      {
+        m_depletionTime = Simulator::Now ();
+      }
+  }
+
+  Time m_depletionTime; // time of the first depletion, negative if not depleted
+};
+
+class LiIonLazyUpdateTestCase : public TestCase
+{
+public:
+  LiIonLazyUpdateTestCase ();
+
+  void DoRun (void);
+
+  static void QueryRemainingEnergy (Ptr<LiIonEnergySource> source, double *remainingEnergyJ);
+};
+
+LiIonLazyUpdateTestCase::LiIonLazyUpdateTestCase ()
+  : TestCase ("Li-Ion energy source lazy update test case")
+{
+}
+
+void
+LiIonLazyUpdateTestCase::QueryRemainingEnergy (Ptr<LiIonEnergySource> source,
+                                               double *remainingEnergyJ)
+{
+  *remainingEnergyJ = source->GetRemainingEnergy ();
+}
+
+void
+LiIonLazyUpdateTestCase::DoRun ()
+{
+  double remainingEnergyJ[2];
+  double voltageV[2];
+  double depletionTimeS[2];
+
+  for (int lazy = 0; lazy < 2; lazy++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<LiIonDepletionRecordingEnergyModel> sem = CreateObject<LiIonDepletionRecordingEnergyModel> ();
+      Ptr<LiIonEnergySource> es = CreateObject<LiIonEnergySource> ();
+      es->SetAttribute ("LiIonEnergyLowBatteryThreshold", DoubleValue (0.5));
+      es->SetAttribute ("LazyEnergyUpdate", BooleanValue (lazy == 1));
+
+      es->SetNode (node);
+      sem->SetEnergySource (es);
+      es->AppendDeviceEnergyModel (sem);
+      node->AggregateObject (es);
+
+      // discharge at 0.5 A for 1000 seconds, then at 2 A until depleted
+      sem->SetCurrentA (0.5);
+      Simulator::Schedule (Seconds (1000.0), &SimpleDeviceEnergyModel::SetCurrentA, sem, 2.0);
+      Simulator::Schedule (Seconds (1500.0), &LiIonLazyUpdateTestCase::QueryRemainingEnergy,
+                           es, &remainingEnergyJ[lazy]);
+      Simulator::Stop (Seconds (3000.0));
+      Simulator::Run ();
+      voltageV[lazy] = es->GetSupplyVoltage ();
+      depletionTimeS[lazy] = sem->m_depletionTime.GetSeconds ();
+      Simulator::Destroy ();
+    }
+
+  // the periodic update uses the voltage of the previous update for a whole
+  // interval, the lazy update integrates the discharge curve exactly
+  NS_TEST_ASSERT_MSG_EQ_TOL (remainingEnergyJ[1], remainingEnergyJ[0], 1.0,
+                             "Lazy and periodic remaining energy differ!");
+  NS_TEST_ASSERT_MSG_EQ_TOL (voltageV[1], voltageV[0], 1.0e-3,
+                             "Lazy and periodic voltage differ!");
+  NS_TEST_ASSERT_MSG_GT (depletionTimeS[1], 1500.0, "Not depleted at 2 A!");
+  NS_TEST_ASSERT_MSG_EQ_TOL (depletionTimeS[1], depletionTimeS[0], 1.0,
+                             "Lazy and periodic depletion time differ!");
+}
+
 class LiIonEnergySourceTestSuite : public TestSuite
 {
 public:
@@ -88,6 +177,7 @@ LiIonEnergySourceTestSuite::LiIonEnergySourceTestSuite ()
   : TestSuite ("li-ion-energy-source", UNIT)
 {
   AddTestCase (new LiIonEnergyTestCase, TestCase::QUICK);
+  AddTestCase (new LiIonLazyUpdateTestCase, TestCase::QUICK);
 }
 
 // create an instance of the test suite
@@ -0,0 +1,215 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <ns3/core-module.h>
+#include <ns3/lr-wpan-module.h>
+#include <ns3/replication-runner.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/basic-energy-source.h>
+#include <ns3/basic-energy-source-helper.h>
+#include <ns3/lr-wpan-radio-energy-model-helper.h>
+#include <ns3/node-container.h>
+#include <ns3/net-device-container.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace ns3;
+
+//
+// Parameter sweep of the energy consumption of two ContikiMAC nodes, one
+// sending a packet to the other each second, over the payload size, JRB
+// on/off and the run number. The replications run in parallel in this
+// process, see ReplicationRunner; --verify runs them again on one thread
+// and checks that the results are the same.
+//
+
+/**
+ * A point of the sweep.
+ */
+struct SweepPoint
+{
+  uint32_t payload;   //!< The payload size, in bytes.
+  bool jrb;           //!< JRB enabled.
+  uint32_t run;       //!< The run number.
+  double receiver;    //!< The energy consumed by the receiver, in J.
+  double sender;      //!< The energy consumed by the sender, in J.
+};
+
+/**
+ * Simulate a point of the sweep.
+ *
+ * \param points The points of the sweep.
+ * \param duration The simulated time, in seconds.
+ * \param index The index of the point.
+ */
+static void
+Simulate (std::vector<SweepPoint> *points, uint32_t duration, uint32_t index)
+{
+  SweepPoint &point = (*points)[index];
+  RngSeedManager::SetRun (point.run);
+  if (point.jrb)
+    {
+      LrWpanPhy::EnableJRB ();
+    }
+  else
+    {
+      LrWpanPhy::DisableJRB ();
+    }
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<LrWpanNetDevice> dev = CreateObject<LrWpanNetDevice> ();
+      dev->SetMac (CreateObject<LrWpanContikiMac> ());
+      dev->SetAddress (i == 0 ? Mac16Address ("00:01") : Mac16Address ("00:02"));
+      dev->SetChannel (channel);
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (0, 10 * i, 0));
+      dev->GetPhy ()->SetMobility (mobility);
+      nodes.Get (i)->AddDevice (dev);
+      devices.Add (dev);
+    }
+
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Set ("BasicEnergySupplyVoltageV", DoubleValue (1.2));
+  sourceHelper.Set ("BasicEnergySourceInitialEnergyJ", DoubleValue (11232.0));
+  EnergySourceContainer sources = sourceHelper.Install (nodes);
+  LrWpanRadioEnergyModelHelper radioHelper;
+  radioHelper.Install (devices, sources);
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstPanId = 0;
+  params.m_dstAddr = Mac16Address ("00:01");
+  params.m_msduHandle = 0;
+  params.m_txOptions = TX_OPTION_NONE;
+  Ptr<LrWpanMac> mac = DynamicCast<LrWpanNetDevice> (devices.Get (1))->GetMac ();
+  for (uint32_t i = 0; i < duration; i++)
+    {
+      Simulator::Schedule (Seconds (i), &LrWpanMac::McpsDataRequest, mac, params,
+                           Create<Packet> (point.payload));
+    }
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+
+  point.receiver = DynamicCast<BasicEnergySource> (sources.Get (0))->GetConsumedEnergy ();
+  point.sender = DynamicCast<BasicEnergySource> (sources.Get (1))->GetConsumedEnergy ();
+}
+
+/**
+ * Run the sweep.
+ *
+ * \param points The points of the sweep.
+ * \param duration The simulated time, in seconds.
+ * \param threads The number of threads.
+ * \returns The wall clock time, in seconds.
+ */
+static double
+Sweep (std::vector<SweepPoint> &points, uint32_t duration, uint32_t threads)
+{
+  ReplicationRunner runner;
+  if (threads > 0)
+    {
+      runner.SetThreads (threads);
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  runner.Run (points.size (), MakeBoundCallback (&Simulate, &points, duration));
+  double elapsed = clock.End () / 1000.0;
+  std::cout << points.size () << " runs on " << runner.GetThreads () << " threads: "
+            << elapsed << " s" << std::endl;
+  return elapsed;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t runs = 10;
+  uint32_t duration = 100;
+  uint32_t threads = 0;
+  bool verify = false;
+
+  CommandLine cmd;
+  cmd.AddValue ("runs", "number of runs per payload size and JRB setting", runs);
+  cmd.AddValue ("duration", "simulated time of a run, in seconds", duration);
+  cmd.AddValue ("threads", "number of threads, 0 for one per processor", threads);
+  cmd.AddValue ("verify", "run the sweep again on one thread, and compare", verify);
+  cmd.Parse (argc, argv);
+
+  // process-wide settings, before the sweep
+  PacketMetadata::Enable ();
+
+  const uint32_t payloads[] = { 10, 50, 100 };
+  std::vector<SweepPoint> points;
+  for (uint32_t p = 0; p < sizeof (payloads) / sizeof (payloads[0]); p++)
+    {
+      for (uint32_t jrb = 0; jrb < 2; jrb++)
+        {
+          for (uint32_t run = 1; run <= runs; run++)
+            {
+              SweepPoint point = { payloads[p], jrb == 1, run, 0, 0 };
+              points.push_back (point);
+            }
+        }
+    }
+
+  double parallel = Sweep (points, duration, threads);
+
+  std::cout << std::endl << std::setw (10) << "Payload" << std::setw (6) << "JRB"
+            << std::setw (16) << "Receiver (J)" << std::setw (16) << "Sender (J)" << std::endl;
+  for (uint32_t i = 0; i < points.size (); i += runs)
+    {
+      double receiver = 0;
+      double sender = 0;
+      for (uint32_t j = i; j < i + runs; j++)
+        {
+          receiver += points[j].receiver;
+          sender += points[j].sender;
+        }
+      std::cout << std::setw (10) << points[i].payload << std::setw (6) << points[i].jrb
+                << std::setw (16) << receiver / runs << std::setw (16) << sender / runs << std::endl;
+    }
+  std::cout << std::endl;
+
+  if (verify)
+    {
+      std::vector<SweepPoint> sequential = points;
+      double elapsed = Sweep (sequential, duration, 1);
+      std::cout << "speedup: " << elapsed / parallel << std::endl;
+      for (uint32_t i = 0; i < points.size (); i++)
+        {
+          if (points[i].receiver != sequential[i].receiver || points[i].sender != sequential[i].sender)
+            {
+              std::cout << "different results for payload " << points[i].payload << ", JRB "
+                        << points[i].jrb << ", run " << points[i].run << std::endl;
+              return 1;
+            }
+        }
+      std::cout << "same results on one thread" << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,103 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <ns3/core-module.h>
+#include <ns3/lr-wpan-error-model.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+
+using namespace ns3;
+
+//
+// Micro-benchmark of LrWpanErrorModel::GetChunkSuccessRate, comparing the
+// exact formula with the lookup table. The SNR values are spread over the
+// range seen by a receiver, the chunk sizes over the sizes of the chunks
+// checked by LrWpanPhy::CheckInterference.
+//
+
+static double
+Run (Ptr<LrWpanErrorModel> model, const std::vector<double> &snrs,
+     const std::vector<uint32_t> &nbits, uint32_t rounds, double *checksum)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  double sum = 0.0;
+  for (uint32_t r = 0; r < rounds; r++)
+    {
+      for (uint32_t i = 0; i < snrs.size (); i++)
+        {
+          sum += model->GetChunkSuccessRate (snrs[i], nbits[i]);
+        }
+    }
+  int64_t elapsedMs = clock.End ();
+  *checksum = sum;
+  return 1.0e6 * elapsedMs / (static_cast<double> (rounds) * snrs.size ());
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t samples = 10000;
+  uint32_t rounds = 100;
+  double minSnr = -10; // dB
+  double maxSnr = 20;
+
+  CommandLine cmd;
+  cmd.AddValue ("samples", "Number of distinct (SNR, chunk size) samples", samples);
+  cmd.AddValue ("rounds", "Number of evaluations of every sample", rounds);
+  cmd.AddValue ("minSnr", "Minimum SNR, in dB", minSnr);
+  cmd.AddValue ("maxSnr", "Maximum SNR, in dB", maxSnr);
+  cmd.Parse (argc, argv);
+
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  std::vector<double> snrs (samples);
+  std::vector<uint32_t> nbits (samples);
+  for (uint32_t i = 0; i < samples; i++)
+    {
+      snrs[i] = pow (10.0, uniform->GetValue (minSnr, maxSnr) / 10.0);
+      nbits[i] = uniform->GetInteger (1, 1016);
+    }
+
+  Ptr<LrWpanErrorModel> exact = CreateObject<LrWpanErrorModel> ();
+  Ptr<LrWpanErrorModel> lookup = CreateObject<LrWpanErrorModel> ();
+  lookup->SetAttribute ("UseLookupTable", BooleanValue (true));
+  // Build the shared table outside of the measurement.
+  lookup->GetChunkSuccessRate (1.0, 1);
+
+  double maxError = 0.0;
+  for (uint32_t i = 0; i < samples; i++)
+    {
+      maxError = std::max (maxError, std::abs (lookup->GetChunkSuccessRate (snrs[i], nbits[i])
+                                               - exact->GetChunkSuccessRate (snrs[i], nbits[i])));
+    }
+
+  double exactSum;
+  double lookupSum;
+  double exactNs = Run (exact, snrs, nbits, rounds, &exactSum);
+  double lookupNs = Run (lookup, snrs, nbits, rounds, &lookupSum);
+
+  std::cout << std::setw (10) << "model" << std::setw (14) << "ns per call"
+            << std::setw (18) << "sum" << std::endl;
+  std::cout << std::setw (10) << "exact" << std::setw (14) << exactNs
+            << std::setw (18) << exactSum << std::endl;
+  std::cout << std::setw (10) << "lookup" << std::setw (14) << lookupNs
+            << std::setw (18) << lookupSum << std::endl;
+  std::cout << "Maximum chunk success rate error: " << maxError << std::endl;
+
+  return 0;
+}
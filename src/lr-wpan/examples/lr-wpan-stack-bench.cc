@@ -0,0 +1,177 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <ns3/core-module.h>
+#include <ns3/lr-wpan-module.h>
+#include <ns3/node.h>
+#include <ns3/single-model-spectrum-channel.h>
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+//
+// Startup micro-benchmark of the TypeId lookups. It first builds LrWpan
+// stacks the way a topology helper does: a Node, an LrWpanNetDevice from an
+// ObjectFactory with attributes, attached to a channel, with a trace sink
+// on its PHY and MAC. Then it times the lookups by name of the TypeIds,
+// attributes and trace sources of the types of a stack, including the
+// inherited ones and some misses.
+//
+
+static void
+TrxState (Time time, LrWpanPhyEnumeration oldState, LrWpanPhyEnumeration newState)
+{
+}
+
+static void
+MacTx (Ptr<const Packet> packet)
+{
+}
+
+/**
+ * Time a lookup function over names.
+ *
+ * \param tids The TypeIds of the names.
+ * \param names The names.
+ * \param rounds The number of lookups of every name.
+ * \param lookup The lookup function.
+ * \returns The time per lookup, in ns.
+ */
+template <typename LOOKUP>
+static double
+TimeLookups (const std::vector<TypeId> &tids, const std::vector<std::string> &names,
+             uint32_t rounds, LOOKUP lookup)
+{
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint32_t found = 0;
+  for (uint32_t r = 0; r < rounds; r++)
+    {
+      for (uint32_t i = 0; i < names.size (); i++)
+        {
+          found += lookup (tids[i], names[i]);
+        }
+    }
+  int64_t elapsedMs = clock.End ();
+  NS_ABORT_IF (found == 0);
+  return 1.0e6 * elapsedMs / (static_cast<double> (rounds) * names.size ());
+}
+
+static uint32_t
+LookupByName (TypeId tid, const std::string &name)
+{
+  TypeId found;
+  return TypeId::LookupByNameFailSafe (name, &found);
+}
+
+static uint32_t
+LookupAttributeByName (TypeId tid, const std::string &name)
+{
+  struct TypeId::AttributeInformation info;
+  return tid.LookupAttributeByName (name, &info);
+}
+
+static uint32_t
+LookupTraceSourceByName (TypeId tid, const std::string &name)
+{
+  return tid.LookupTraceSourceByName (name) != 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t stacks = 100000;
+  uint32_t rounds = 10000;
+
+  CommandLine cmd;
+  cmd.AddValue ("stacks", "Number of LrWpan stacks to build", stacks);
+  cmd.AddValue ("rounds", "Number of lookups of every name", rounds);
+  cmd.Parse (argc, argv);
+
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  ObjectFactory factory ("ns3::LrWpanNetDevice");
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < stacks; i++)
+    {
+      factory.Set ("UseAcks", BooleanValue (true));
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<LrWpanNetDevice> dev = factory.Create<LrWpanNetDevice> ();
+      dev->SetChannel (channel);
+      dev->GetMac ()->SetAttribute ("PanId", UintegerValue (i % 0xfffe));
+      dev->GetPhy ()->TraceConnectWithoutContext ("TrxState", MakeCallback (&TrxState));
+      dev->GetMac ()->TraceConnectWithoutContext ("MacTx", MakeCallback (&MacTx));
+      node->AddDevice (dev);
+    }
+  double stackUs = 1.0e3 * clock.End () / stacks;
+
+  // The names of the types of a stack, their attributes and trace
+  // sources, and of their parents.
+  const char *types[] = { "ns3::Node", "ns3::LrWpanNetDevice", "ns3::LrWpanPhy",
+                          "ns3::LrWpanMac", "ns3::LrWpanCsmaCa" };
+  std::vector<TypeId> typeTids;
+  std::vector<std::string> typeNames;
+  std::vector<TypeId> attributeTids;
+  std::vector<std::string> attributeNames;
+  std::vector<TypeId> traceTids;
+  std::vector<std::string> traceNames;
+  for (uint32_t i = 0; i < sizeof (types) / sizeof (types[0]); i++)
+    {
+      TypeId tid = TypeId::LookupByName (types[i]);
+      for (TypeId parent = tid; ; parent = parent.GetParent ())
+        {
+          typeTids.push_back (tid);
+          typeNames.push_back (parent.GetName ());
+          for (uint32_t j = 0; j < parent.GetAttributeN (); j++)
+            {
+              attributeTids.push_back (tid);
+              attributeNames.push_back (parent.GetAttribute (j).name);
+            }
+          for (uint32_t j = 0; j < parent.GetTraceSourceN (); j++)
+            {
+              traceTids.push_back (tid);
+              traceNames.push_back (parent.GetTraceSource (j).name);
+            }
+          if (parent.GetParent () == parent)
+            {
+              break;
+            }
+        }
+      typeTids.push_back (tid);
+      typeNames.push_back ("ns3::NoSuchType");
+      attributeTids.push_back (tid);
+      attributeNames.push_back ("NoSuchAttribute");
+      traceTids.push_back (tid);
+      traceNames.push_back ("NoSuchTraceSource");
+    }
+
+  std::cout << stacks << " stacks: " << stackUs << " us per stack" << std::endl << std::endl;
+  std::cout << std::setw (26) << "lookup" << std::setw (8) << "names"
+            << std::setw (14) << "ns per call" << std::endl;
+  std::cout << std::setw (26) << "LookupByName" << std::setw (8) << typeNames.size ()
+            << std::setw (14) << TimeLookups (typeTids, typeNames, rounds, &LookupByName) << std::endl;
+  std::cout << std::setw (26) << "LookupAttributeByName" << std::setw (8) << attributeNames.size ()
+            << std::setw (14) << TimeLookups (attributeTids, attributeNames, rounds, &LookupAttributeByName) << std::endl;
+  std::cout << std::setw (26) << "LookupTraceSourceByName" << std::setw (8) << traceNames.size ()
+            << std::setw (14) << TimeLookups (traceTids, traceNames, rounds, &LookupTraceSourceByName) << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
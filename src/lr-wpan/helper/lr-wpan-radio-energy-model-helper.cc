@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "lr-wpan-radio-energy-model-helper.h"
+#include <ns3/lr-wpan-net-device.h>
+#include <ns3/lr-wpan-phy.h>
+#include <ns3/fatal-error.h>
+
+namespace ns3 {
+
+LrWpanRadioEnergyModelHelper::LrWpanRadioEnergyModelHelper ()
+{
+  m_radioEnergy.SetTypeId ("ns3::LrWpanRadioEnergyModel");
+  m_depletionCallback.Nullify ();
+  m_rechargedCallback.Nullify ();
+  m_stateTable = Create<LrWpanRadioEnergyStateTable> ();
+}
+
+LrWpanRadioEnergyModelHelper::~LrWpanRadioEnergyModelHelper ()
+{
+}
+
+void
+LrWpanRadioEnergyModelHelper::Set (std::string name, const AttributeValue &v)
+{
+  m_radioEnergy.Set (name, v);
+}
+
+void
+LrWpanRadioEnergyModelHelper::SetDepletionCallback (
+  LrWpanRadioEnergyModel::LrWpanRadioEnergyDepletionCallback callback)
+{
+  m_depletionCallback = callback;
+}
+
+void
+LrWpanRadioEnergyModelHelper::SetRechargedCallback (
+  LrWpanRadioEnergyModel::LrWpanRadioEnergyRechargedCallback callback)
+{
+  m_rechargedCallback = callback;
+}
+
+DeviceEnergyModelContainer
+LrWpanRadioEnergyModelHelper::Install (NetDeviceContainer deviceContainer,
+                                       EnergySourceContainer sourceContainer) const
+{
+  m_stateTable->Reserve (m_stateTable->GetN () + deviceContainer.GetN ());
+  return DeviceEnergyModelHelper::Install (deviceContainer, sourceContainer);
+}
+
+Ptr<LrWpanRadioEnergyStateTable>
+LrWpanRadioEnergyModelHelper::GetStateTable (void) const
+{
+  return m_stateTable;
+}
+
+
+/*
+ * Private function starts here.
+ */
+
+Ptr<DeviceEnergyModel>
+LrWpanRadioEnergyModelHelper::DoInstall (Ptr<NetDevice> device,
+                                         Ptr<EnergySource> source) const
+{
+  NS_ASSERT (device != NULL);
+  NS_ASSERT (source != NULL);
+  // check if device is LrWpanNetDevice
+  Ptr<LrWpanNetDevice> lrWpanDevice = DynamicCast<LrWpanNetDevice> (device);
+  if (lrWpanDevice == NULL)
+    {
+      NS_FATAL_ERROR ("NetDevice type is not LrWpanNetDevice!");
+    }
+  Ptr<LrWpanRadioEnergyModel> model = m_radioEnergy.Create ()->GetObject<LrWpanRadioEnergyModel> ();
+  NS_ASSERT (model != NULL);
+  // keep the state in the table of the helper
+  model->SetStateTable (m_stateTable);
+  // set energy source pointer
+  model->SetEnergySource (source);
+  // the model always calls the depletion and recharged handlers of the PHY,
+  // the callbacks are optional
+  if (!m_depletionCallback.IsNull ())
+    {
+      model->SetEnergyDepletionCallback (m_depletionCallback);
+    }
+  if (!m_rechargedCallback.IsNull ())
+    {
+      model->SetEnergyRechargedCallback (m_rechargedCallback);
+    }
+  // add model to device model list in energy source
+  source->AppendDeviceEnergyModel (model);
+  // register the model as phy listener
+  model->AttachPhy (lrWpanDevice->GetPhy ());
+  return model;
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef LR_WPAN_RADIO_ENERGY_MODEL_HELPER_H
+#define LR_WPAN_RADIO_ENERGY_MODEL_HELPER_H
+
+#include <ns3/energy-model-helper.h>
+#include <ns3/lr-wpan-radio-energy-model.h>
+#include <ns3/lr-wpan-radio-energy-state-table.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup lr-wpan
+ * \brief Assign LrWpanRadioEnergyModel to LrWpan devices.
+ *
+ * This installer installs LrWpanRadioEnergyModel for only LrWpanNetDevice
+ * objects. The model is appended to the given energy source and attached
+ * to the PHY of the device.
+ *
+ * The state of all models installed by a helper is kept in a single
+ * LrWpanRadioEnergyStateTable, so large deployments keep the per-state
+ * residency and energy of all nodes in contiguous arrays, and the totals
+ * over the deployment are available from GetStateTable ().
+ */
+class LrWpanRadioEnergyModelHelper : public DeviceEnergyModelHelper
+{
+public:
+  /**
+   * Construct a helper which is used to add a radio energy model to a node
+   */
+  LrWpanRadioEnergyModelHelper ();
+
+  /**
+   * Destroy a RadioEnergy Helper
+   */
+  ~LrWpanRadioEnergyModelHelper ();
+
+  /**
+   * \param name the name of the attribute to set
+   * \param v the value of the attribute
+   *
+   * Sets an attribute of the underlying LrWpanRadioEnergyModel.
+   */
+  void Set (std::string name, const AttributeValue &v);
+
+  /**
+   * \param callback Callback function for energy depletion handling.
+   *
+   * Sets the callback to be invoked when energy is depleted, in addition to
+   * LrWpanPhy::EnergyDepletionHandler.
+   */
+  void SetDepletionCallback (
+    LrWpanRadioEnergyModel::LrWpanRadioEnergyDepletionCallback callback);
+
+  /**
+   * \param callback Callback function for energy recharged handling.
+   *
+   * Sets the callback to be invoked when energy is recharged, in addition to
+   * LrWpanPhy::EnergyRechargedHandler.
+   */
+  void SetRechargedCallback (
+    LrWpanRadioEnergyModel::LrWpanRadioEnergyRechargedCallback callback);
+
+  using DeviceEnergyModelHelper::Install;
+
+  /**
+   * \param deviceContainer List of LrWpanNetDevices to install
+   * LrWpanRadioEnergyModels on.
+   * \param sourceContainer List of EnergySources the models will be using.
+   * \returns A DeviceEnergyModelContainer with all the models.
+   *
+   * Installs the models in bulk. The state table of the helper is grown
+   * once for all devices.
+   */
+  DeviceEnergyModelContainer Install (NetDeviceContainer deviceContainer,
+                                      EnergySourceContainer sourceContainer) const;
+
+  /**
+   * \returns The table with the state of all models installed by this
+   * helper.
+   */
+  Ptr<LrWpanRadioEnergyStateTable> GetStateTable (void) const;
+
+private:
+  /**
+   * \param device Pointer to the NetDevice to install DeviceEnergyModel.
+   * \param source Pointer to EnergySource to install.
+   *
+   * Implements DeviceEnergyModel::Install.
+   */
+  virtual Ptr<DeviceEnergyModel> DoInstall (Ptr<NetDevice> device,
+                                            Ptr<EnergySource> source) const;
+
+private:
+  ObjectFactory m_radioEnergy;
+  LrWpanRadioEnergyModel::LrWpanRadioEnergyDepletionCallback m_depletionCallback;
+  LrWpanRadioEnergyModel::LrWpanRadioEnergyRechargedCallback m_rechargedCallback;
+  Ptr<LrWpanRadioEnergyStateTable> m_stateTable;
+
+};
+
+} // namespace ns3
+
+#endif /* LR_WPAN_RADIO_ENERGY_MODEL_HELPER_H */
@@ -19,11 +19,14 @@
 #include "lr-wpan-csmaca.h"
 #include "lr-wpan-mac-header.h"
 #include "lr-wpan-mac-trailer.h"
+#include "lr-wpan-duty-cycle-scheduler.h"
 #include <ns3/simulator.h>
+#include <ns3/simulation-singleton.h>
 #include <ns3/log.h>
 #include <ns3/uinteger.h>
 #include <ns3/boolean.h>
 #include <ns3/node.h>
+#include <ns3/net-device.h>
 #include <ns3/packet.h>
 #include <ns3/random-variable-stream.h>
 #include <ns3/double.h>
@@ -61,7 +64,29 @@ TypeId LrWpanContikiMac::GetTypeId(void) {
 					MakeUintegerChecker<uint8_t>()).AddAttribute("FastSleep",
 					"ContikiMAC fast sleep optimization", BooleanValue(false),
 					MakeBooleanAccessor(&LrWpanContikiMac::m_fastSleep),
-					MakeBooleanChecker());
+					MakeBooleanChecker()).AddAttribute("PhaseLockTimeout",
+					"Time after which the wake-up phase of a neighbor, which was "
+					"not refreshed by an ACK, is no longer used. Zero keeps "
+					"the phases forever.", TimeValue(Seconds(60)),
+					MakeTimeAccessor(&LrWpanContikiMac::m_phaseLockTimeout),
+					MakeTimeChecker()).AddAttribute("PhaseLockMaxFailures",
+					"Number of failed transmissions in a row after which the "
+					"wake-up phase of a neighbor is no longer used.",
+					UintegerValue(2),
+					MakeUintegerAccessor(
+							&LrWpanContikiMac::m_phaseLockMaxFailures),
+					MakeUintegerChecker<uint32_t>(1)).AddAttribute("BatchedWakeUp",
+					"Run the idle wake-up cycles of all nodes with the same "
+					"wake-up phase in shared events of the "
+					"LrWpanDutyCycleScheduler. Per-node events are only "
+					"scheduled once a cycle is interrupted.",
+					BooleanValue(false),
+					MakeBooleanAccessor(&LrWpanContikiMac::m_batchedWakeUp),
+					MakeBooleanChecker()).AddAttribute("WakeUpPhase",
+					"The offset of the periodic wake-ups within the sleep "
+					"interval.", TimeValue(Seconds(0)),
+					MakeTimeAccessor(&LrWpanContikiMac::m_wakeUpPhase),
+					MakeTimeChecker());
 	return tid;
 }
 
@@ -74,12 +99,22 @@ LrWpanContikiMac::LrWpanContikiMac() {
 	m_pastTxStart = Seconds(0);
 	m_currentTxStart = Seconds(0);
 	number_received_packets = 0;
+	m_batchedStage = BATCHED_NONE;
+	m_batchedStep = 0;
 }
 
 LrWpanContikiMac::~LrWpanContikiMac() {
 }
 
 void LrWpanContikiMac::DoInitialize() {
+	m_phaseLock.SetTimeout(m_phaseLockTimeout);
+	m_phaseLock.SetMaxFailures(m_phaseLockMaxFailures);
+	m_nextWakeUp = m_wakeUpPhase;
+	if (m_batchedWakeUp) {
+		m_phy->SetBatchInterruptCallback(
+				MakeCallback(&LrWpanContikiMac::ResumeBatchedCycle, this));
+	}
+
 	//Sleep
 	m_phy->PlmeSetTRXStateRequest(IEEE_802_15_4_PHY_TRX_OFF);
 
@@ -87,9 +122,12 @@ void LrWpanContikiMac::DoInitialize() {
 }
 
 void LrWpanContikiMac::DoDispose() {
-	if (m_wakeUp.IsRunning()) {
-		m_wakeUp.Cancel();
+	CancelWakeUp();
+	ResumeBatchedCycle();
+	if (m_phy) {
+		m_phy->SetBatchInterruptCallback(MakeNullCallback<void>());
 	}
+	m_phaseLock.Clear();
 
 	LrWpanMac::DoDispose();
 }
@@ -118,19 +156,131 @@ void LrWpanContikiMac::WakeUp() {
 	}
 }
 
+void LrWpanContikiMac::ScheduleWakeUp(Time upTime) {
+	if (m_batchedWakeUp) {
+		ScheduleBatchedStep(BATCHED_WAKEUP, upTime);
+	} else {
+		m_wakeUp = Simulator::Schedule(upTime, &LrWpanContikiMac::WakeUp,
+				this);
+	}
+}
+
+bool LrWpanContikiMac::IsWakeUpScheduled(void) const {
+	return m_wakeUp.IsRunning() || m_batchedStage == BATCHED_WAKEUP;
+}
+
+void LrWpanContikiMac::CancelWakeUp(void) {
+	m_wakeUp.Cancel();
+	if (m_batchedStage == BATCHED_WAKEUP) {
+		m_batchedStage = BATCHED_NONE;
+	}
+}
+
+void LrWpanContikiMac::ScheduleBatchedStep(BatchedStage stage, Time delay) {
+	m_batchedStage = stage;
+	m_batchedTime = Simulator::Now() + delay;
+	SimulationSingleton<LrWpanDutyCycleScheduler>::Get()->Schedule(
+			m_batchedTime, this, ++m_batchedStep);
+}
+
+uint32_t LrWpanContikiMac::GetNodeContext(void) const {
+	Ptr<NetDevice> device = m_phy->GetDevice();
+	if (device == 0 || device->GetNode() == 0) {
+		return 0xffffffff;
+	}
+	return device->GetNode()->GetId();
+}
+
+void LrWpanContikiMac::RunBatchedStep(uint32_t step) {
+	// The step is outdated, if the cycle was cancelled, resumed or
+	// rescheduled since.
+	if (m_batchedStage == BATCHED_NONE || m_batchedStep != step) {
+		return;
+	}
+	NS_LOG_FUNCTION(this << m_batchedStage);
+
+	// Every step does the same as the event it replaces in an idle cycle,
+	// see WakeUp, PlmeSetTRXStateConfirm, PlmeCcaConfirm and Sleep.
+	switch (m_batchedStage) {
+	case BATCHED_WAKEUP:
+		m_batchedStage = BATCHED_NONE;
+		if (m_lrWpanMacState == MAC_IDLE && m_txQueue.empty() && m_txPkt == 0
+				&& !m_setMacState.IsRunning() && m_sleep.IsExpired()
+				&& m_repeatPkt.IsExpired() && m_ccaCount == 0
+				&& m_phy->CanStartBatched()) {
+			NS_LOG_DEBUG("Batched wake-up");
+			m_phy->StartBatched();
+			ScheduleBatchedStep(BATCHED_RX_ON,
+					m_phy->StartBatchedTRXState(IEEE_802_15_4_PHY_RX_ON));
+		} else {
+			// Wake up right away, like the per-node wake-up event would.
+			WakeUp();
+		}
+		break;
+	case BATCHED_RX_ON:
+		m_phy->EndBatchedTRXState();
+		ScheduleBatchedStep(BATCHED_CCA, m_phy->StartBatchedCca());
+		break;
+	case BATCHED_CCA: {
+		LrWpanPhyEnumeration status = m_phy->EndBatchedCca();
+		if (status != IEEE_802_15_4_PHY_IDLE) {
+			// Stay awake, as without batching.
+			m_batchedStage = BATCHED_NONE;
+			m_phy->EndBatched();
+			PlmeCcaConfirm(status);
+		} else if (++m_ccaCount == 2) {
+			NS_LOG_DEBUG("Phy Idle twice, batched sleep");
+			m_ccaCount = 0;
+			ScheduleBatchedStep(BATCHED_TRX_OFF,
+					m_phy->StartBatchedTRXState(IEEE_802_15_4_PHY_TRX_OFF));
+		} else {
+			ScheduleBatchedStep(BATCHED_CCA_INTERVAL, m_ccaInterval);
+		}
+		break;
+	}
+	case BATCHED_CCA_INTERVAL:
+		ScheduleBatchedStep(BATCHED_CCA, m_phy->StartBatchedCca());
+		break;
+	case BATCHED_TRX_OFF:
+		m_batchedStage = BATCHED_NONE;
+		m_phy->EndBatchedTRXState();
+		m_phy->EndBatched();
+		// Schedules the next wake-up.
+		PlmeSetTRXStateConfirm(IEEE_802_15_4_PHY_SUCCESS);
+		break;
+	default:
+		NS_FATAL_ERROR("Unexpected batched stage " << m_batchedStage);
+	}
+}
+
+void LrWpanContikiMac::ResumeBatchedCycle(void) {
+	if (m_batchedStage == BATCHED_NONE || m_batchedStage == BATCHED_WAKEUP) {
+		return;
+	}
+	NS_LOG_FUNCTION(this << m_batchedStage);
+
+	// Schedule the pending event of the cycle, as it would have been
+	// scheduled without batching.
+	if (m_batchedStage == BATCHED_CCA_INTERVAL) {
+		m_phy->EndBatched();
+		Simulator::Schedule(m_batchedTime - Simulator::Now(),
+				&LrWpanPhy::PlmeCcaRequest, m_phy);
+	} else {
+		m_phy->ResumeBatched(m_batchedTime);
+	}
+	m_batchedStage = BATCHED_NONE;
+}
+
 Time LrWpanContikiMac::CheckPlm(Address address) {
 	NS_ASSERT_MSG(
 			Mac16Address::IsMatchingType(address)
 					|| Mac64Address::IsMatchingType(address),
 			"Not a valid Address type");
 
-	Neighbors::const_iterator it = m_nb.begin();
-	for (; it != m_nb.end(); it++) {
-		if ((*it).m_neighborAddress == address) {
-			return (*it).m_wakeupTime;
-		}
+	Time phase;
+	if (m_phaseLock.Lookup(address, phase)) {
+		return phase;
 	}
-
 	return Seconds(0);
 }
 
@@ -140,19 +290,25 @@ void LrWpanContikiMac::NotifyPlm(Address address, Time txStart) {
 					|| Mac64Address::IsMatchingType(address),
 			"Not a valid Address type");
 
-	Neighbors::const_iterator it = m_nb.begin();
-	for (; it != m_nb.end(); it++)  // Check if neighbor already present in list
-			{
-		if ((*it).m_neighborAddress == address) {
-			return;
-		}
+	// A zero phase is taken as unknown by CheckPlm.
+	if (txStart != Seconds(0)) {
+		m_phaseLock.Update(address, txStart);
 	}
+}
 
-	Neighbor *nb = new Neighbor;
-	(*nb).m_neighborAddress = address;
-	(*nb).m_wakeupTime = txStart;
-	(*nb).failedTransmissions = 0;
-	m_nb.push_back(*nb); // Add new neighbor to phase-lock module
+bool LrWpanContikiMac::GetUnicastDestination(const LrWpanMacHeader &hdr,
+		Address &address) {
+	if (hdr.GetDstAddrMode() == SHORT_ADDR) {
+		if (hdr.GetShortDstAddr() == Mac16Address("ff:ff")) {
+			return false;
+		}
+		address = hdr.GetShortDstAddr();
+		return true;
+	} else if (hdr.GetDstAddrMode() == EXT_ADDR) {
+		address = hdr.GetExtDstAddr();
+		return true;
+	}
+	return false;
 }
 
 void LrWpanContikiMac::McpsDataRequest(McpsDataRequestParams params,
@@ -161,6 +317,7 @@ void LrWpanContikiMac::McpsDataRequest(McpsDataRequestParams params,
 
 	NS_ASSERT_MSG(!GetCsmaCa()->IsSlottedCsmaCa(),
 			"ContikiMAC cannot be used in slotted mode");
+	ResumeBatchedCycle();
 
 	m_broadcast = false;
 	if (params.m_dstAddrMode == SHORT_ADDR
@@ -182,34 +339,25 @@ bool LrWpanContikiMac::CheckQueue() {
 		Ptr<Packet> pkt = m_txPkt->Copy();
 		LrWpanMacHeader hdr;
 		pkt->RemoveHeader(hdr);
+		Address dst;
+		Time phase = Seconds(0);
+		if (GetUnicastDestination(hdr, dst)) {
+			phase = CheckPlm(dst);
+		}
 		if (hdr.GetDstAddrMode() == SHORT_ADDR
 				&& hdr.GetShortDstAddr() == Mac16Address("ff:ff")) //Broadcast case
 						{
 			NS_LOG_DEBUG("Broadcast, scheduling packet now");
 			m_setMacState = Simulator::ScheduleNow(
 					&LrWpanContikiMac::SetLrWpanMacState, this, MAC_CSMA);
-		} else if (hdr.GetDstAddrMode() == SHORT_ADDR
-				&& CheckPlm(hdr.GetShortDstAddr()) != Seconds(0)) {
-			NS_LOG_DEBUG("Found neighbor in phase-lock module");
-			Time diff = Simulator::Now() - CheckPlm(hdr.GetShortDstAddr());
-			double d = diff.GetDouble() / m_sleepTime / (1000 * 1000 * 1000);
-			uint32_t t = ceil(d);
-			Time txTime = CheckPlm(hdr.GetShortDstAddr())
-					+ Seconds(t * m_sleepTime) - Simulator::Now();
-			NS_LOG_DEBUG(
-					"t = " << t << " d = " << d << " diff = " << diff << " txTime: " << Simulator::Now () + txTime << " PLM: " << CheckPlm (hdr.GetShortDstAddr ()));
-			m_setMacState = Simulator::Schedule(txTime,
-					&LrWpanContikiMac::SetLrWpanMacState, this, MAC_CSMA);
-		} else if (hdr.GetDstAddrMode() == EXT_ADDR
-				&& CheckPlm(hdr.GetExtDstAddr()) != Seconds(0)) {
+		} else if (phase != Seconds(0)) {
 			NS_LOG_DEBUG("Found neighbor in phase-lock module");
-			Time diff = Simulator::Now() - CheckPlm(hdr.GetExtDstAddr());
+			Time diff = Simulator::Now() - phase;
 			double d = diff.GetDouble() / m_sleepTime / (1000 * 1000 * 1000);
 			uint32_t t = ceil(d);
-			Time txTime = CheckPlm(hdr.GetExtDstAddr())
-					+ Seconds(t * m_sleepTime) - Simulator::Now();
+			Time txTime = phase + Seconds(t * m_sleepTime) - Simulator::Now();
 			NS_LOG_DEBUG(
-					"t = " << t << " d = " << d << " diff = " << diff << " txTime: " << Simulator::Now () + txTime << " PLM: " << CheckPlm (hdr.GetExtDstAddr ()));
+					"t = " << t << " d = " << d << " diff = " << diff << " txTime: " << Simulator::Now () + txTime << " PLM: " << phase);
 			m_setMacState = Simulator::Schedule(txTime,
 					&LrWpanContikiMac::SetLrWpanMacState, this, MAC_CSMA);
 		} else      // Neighbor node not listed in phase-lock module
@@ -403,18 +551,17 @@ void LrWpanContikiMac::PdDataIndication(uint32_t psduLength, Ptr<Packet> p,
 									"ContikiMAC pkt retransmission cancelled");
 							m_repeatPkt.Cancel();
 							m_rdcRetries = 0;
+							// The receiver woke up after the start of the strobe
+							// before the acknowledged one, if there was one.
 							Time phase = m_pastTxStart;
+							if (phase == Seconds(0)) {
+								phase = m_currentTxStart;
+							}
 							m_pastTxStart = m_currentTxStart = Seconds(0);
 							Address addr;
-							if (macHdr.GetDstAddrMode() == SHORT_ADDR) {
-								addr = macHdr.GetShortDstAddr();
-							} else {
-								addr = macHdr.GetExtDstAddr();
-							}
-							NotifyPlm(addr, phase);
-							NS_LOG_DEBUG("Phase: " << phase);
-							if (CheckPlm(addr) != Seconds(0)) {
-								NS_LOG_DEBUG("Check Plm: " << addr);
+							if (GetUnicastDestination(macHdr, addr)) {
+								NotifyPlm(addr, phase);
+								NS_LOG_DEBUG("Phase of " << addr << ": " << phase);
 							}
 						}
 						if (!m_mcpsDataConfirmCallback.IsNull()) {
@@ -484,6 +631,14 @@ void LrWpanContikiMac::PktRetransmissionTimeout(void) {
 	} else {
 		NS_LOG_DEBUG("Inform MAC");
 		m_rdcRetries = 0;
+		m_pastTxStart = m_currentTxStart = Seconds(0);
+		LrWpanMacHeader macHdr;
+		m_txPkt->PeekHeader(macHdr);
+		Address addr;
+		if (GetUnicastDestination(macHdr, addr)
+				&& m_phaseLock.NotifyFailure(addr)) {
+			NS_LOG_DEBUG("Phase of " << addr << " dropped after failures");
+		}
 		AckWaitTimeout();
 	}
 }
@@ -612,13 +767,13 @@ void LrWpanContikiMac::PlmeSetTRXStateConfirm(LrWpanPhyEnumeration status) {
 	NS_LOG_FUNCTION(this << status);
 	if (status == IEEE_802_15_4_PHY_SUCCESS)      //state change
 			{
-		if (m_wakeUp.IsRunning()) //If woke up to send packet, cancel pending wakeup
+		if (IsWakeUpScheduled()) //If woke up to send packet, cancel pending wakeup
 		{
 			NS_ASSERT(
 					m_phy->GetTRXState() == IEEE_802_15_4_PHY_TX_ON
 							|| m_phy->GetTRXState() == IEEE_802_15_4_PHY_RX_ON);
 			NS_LOG_DEBUG("WakeUp Cancelled");
-			m_wakeUp.Cancel();
+			CancelWakeUp();
 		}
 	}
 
@@ -664,8 +819,7 @@ void LrWpanContikiMac::PlmeSetTRXStateConfirm(LrWpanPhyEnumeration status) {
 				NS_LOG_DEBUG(
 						"next WakeUp (init): " << Simulator::Now () + upTime);
 			}
-			m_wakeUp = Simulator::Schedule(upTime, &LrWpanContikiMac::WakeUp,
-					this);
+			ScheduleWakeUp(upTime);
 			m_nextWakeUp = Simulator::Now() + upTime;
 			NS_LOG_DEBUG("WakeUp " << m_nextWakeUp);
 		}
@@ -682,6 +836,7 @@ void LrWpanContikiMac::PlmeSetTRXStateConfirm(LrWpanPhyEnumeration status) {
 
 void LrWpanContikiMac::SetLrWpanMacState(LrWpanMacState macState) {
 	NS_LOG_FUNCTION(this << "mac state = " << macState);
+	ResumeBatchedCycle();
 
 	McpsDataConfirmParams confirmParams;
 
@@ -20,10 +20,13 @@
 #define LR_WPAN_CONTIKIMAC_H
 
 #include "lr-wpan-mac.h"
+#include "lr-wpan-phase-lock-table.h"
 
 
 namespace ns3 {
 
+class LrWpanMacHeader;
+
 /**
  * \ingroup lr-wpan
  *
@@ -77,6 +80,20 @@ public:
   virtual void PlmeSetTRXStateConfirm (LrWpanPhyEnumeration status);
   virtual void SetLrWpanMacState (LrWpanMacState macState);
 
+  /**
+   * Run the next step of a batched wake-up cycle. Called by the
+   * LrWpanDutyCycleScheduler.
+   *
+   * \param step the number the step was scheduled with
+   */
+  void RunBatchedStep (uint32_t step);
+
+  /**
+   * \return the context of the node of the MAC, in which the
+   *         LrWpanDutyCycleScheduler runs its steps
+   */
+  uint32_t GetNodeContext (void) const;
+
 protected:
   // Inherited from Object.
   virtual void DoInitialize (void);
@@ -86,26 +103,63 @@ private:
 
   LrWpanPhyEnumeration m_currentState;  // current state the radio is in
   /**
-   * \ingroup lr-wpan
-   * \brief Neighbor description.
-   *
-   * This structure takes into account the known neighbors and their wakeup time (if known).
+   * The phase-lock module, with the known neighbors and their wake-up phase.
+   */
+  LrWpanPhaseLockTable m_phaseLock;
+
+  /**
+   * Time after which a wake-up phase which was not refreshed by an ACK is
+   * no longer used.
    */
-  struct Neighbor
+  Time m_phaseLockTimeout;
+
+  /**
+   * Number of failed transmissions in a row after which a wake-up phase is
+   * no longer used.
+   */
+  uint32_t m_phaseLockMaxFailures;
+
+  /**
+   * The steps of a wake-up cycle, which are run by the shared
+   * LrWpanDutyCycleScheduler, if batched wake-ups are enabled.
+   */
+  enum BatchedStage
   {
-    Address m_neighborAddress; //!< Neighbor address.
-    Time m_wakeupTime;              //!< Wakeup time.
-    uint8_t failedTransmissions;    //!< Number of failed transmissions.
+    BATCHED_NONE,         //!< No step scheduled
+    BATCHED_WAKEUP,       //!< Wake up from sleep
+    BATCHED_RX_ON,        //!< End of the switch to RX_ON
+    BATCHED_CCA,          //!< End of a CCA
+    BATCHED_CCA_INTERVAL, //!< End of the interval between both CCAs
+    BATCHED_TRX_OFF       //!< End of the switch to TRX_OFF
   };
 
-  // list of active neighbors
-  typedef std::vector<Neighbor> Neighbors;
-  Neighbors m_nb; //!< Known Neighbors.
+  /**
+   * Use the shared duty-cycle scheduler for the wake-ups.
+   */
+  bool m_batchedWakeUp;
+
+  /**
+   * The next scheduled step of a batched wake-up cycle.
+   */
+  BatchedStage m_batchedStage;
+
+  /**
+   * The time of the next scheduled step of a batched wake-up cycle.
+   */
+  Time m_batchedTime;
+
+  /**
+   * The number of the last scheduled step of a batched wake-up cycle. A
+   * step which is cancelled and scheduled again for the same time leaves an
+   * outdated entry in the scheduler, which has a lower number.
+   */
+  uint32_t m_batchedStep;
 
   uint8_t m_ccaCount;   //!< To keep count of two CCAs
   bool m_broadcast;     //!< Is Broadcast transmission
   Time m_bcStart;       //!< Start time of broadcast packet
   Time m_nextWakeUp;    //!< Time to next wakeup
+  Time m_wakeUpPhase;   //!< Offset of the wake-ups within the sleep interval
   Time m_pastTxStart;   //!< Start time of last unicast packet
   Time m_currentTxStart;//!< Start time of current unicast packet
 
@@ -121,23 +175,68 @@ private:
    */
   void WakeUp (void);
 
+  /**
+   * Schedule the next wake-up, either as own event or by the shared
+   * duty-cycle scheduler.
+   *
+   * \param upTime the time until the wake-up
+   */
+  void ScheduleWakeUp (Time upTime);
+
+  /**
+   * \return true, if a wake-up is scheduled
+   */
+  bool IsWakeUpScheduled (void) const;
+
+  /**
+   * Cancel a scheduled wake-up.
+   */
+  void CancelWakeUp (void);
+
+  /**
+   * Schedule a step of a batched wake-up cycle with the shared duty-cycle
+   * scheduler.
+   *
+   * \param stage the step
+   * \param delay the time until the step
+   */
+  void ScheduleBatchedStep (BatchedStage stage, Time delay);
+
+  /**
+   * Continue a running batched wake-up cycle with own events of the MAC and
+   * the PHY. Called whenever the idle cycle is interrupted, by an incoming
+   * signal, for example.
+   */
+  void ResumeBatchedCycle (void);
+
   /**
    * Check phase-lock module if it has a recorded wake-up phase
    * of the intended receiver.
    *
    * \param address The Address of the intended receiver
+   * \return the recorded wake-up phase, or zero if it is not known
    */
   Time CheckPlm (Address address);
 
   /**
    * Notify the phase-lock module the transmission time of the last packet
-   * as an approximation of the wake-up phase of the receiver.
+   * as an approximation of the wake-up phase of the receiver. The phase of a
+   * known receiver is refreshed.
    *
    * @param address The Address of the receiver
    * @param txStart Start time of unicast packet
    */
   void NotifyPlm (Address address, Time txStart);
 
+  /**
+   * Get the address of the receiver of a frame.
+   *
+   * \param hdr the MAC header of the frame
+   * \param address the address of the receiver, only set for unicast frames
+   * \return true, if the frame is a unicast frame
+   */
+  static bool GetUnicastDestination (const LrWpanMacHeader &hdr, Address &address);
+
   /**
    * Sets current state.
    */
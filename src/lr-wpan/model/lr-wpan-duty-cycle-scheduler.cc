@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "lr-wpan-duty-cycle-scheduler.h"
+#include "lr-wpan-contikimac.h"
+#include <ns3/simulator.h>
+#include <ns3/assert.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LrWpanDutyCycleScheduler");
+
+LrWpanDutyCycleScheduler::LrWpanDutyCycleScheduler (void)
+  : m_scheduledSteps (0),
+    m_scheduledEvents (0)
+{
+}
+
+LrWpanDutyCycleScheduler::~LrWpanDutyCycleScheduler (void)
+{
+  m_buckets.clear ();
+}
+
+void
+LrWpanDutyCycleScheduler::Schedule (Time time, Ptr<LrWpanContikiMac> mac, uint32_t step)
+{
+  NS_LOG_FUNCTION (this << time << mac << step);
+  NS_ASSERT (time >= Simulator::Now ());
+
+  std::pair<BucketMap::iterator, bool> inserted =
+    m_buckets.insert (std::make_pair (time, std::vector<Step> ()));
+  if (inserted.second)
+    {
+      // The bucket is shared by many nodes, so it runs without node context
+      // and sets the context of every node for its step.
+      Simulator::ScheduleWithContext (0xffffffff, time - Simulator::Now (),
+                                      &LrWpanDutyCycleScheduler::RunBucket, this, time);
+      m_scheduledEvents++;
+    }
+  inserted.first->second.push_back (std::make_pair (mac, step));
+  m_scheduledSteps++;
+}
+
+uint64_t
+LrWpanDutyCycleScheduler::GetScheduledSteps (void) const
+{
+  return m_scheduledSteps;
+}
+
+uint64_t
+LrWpanDutyCycleScheduler::GetScheduledEvents (void) const
+{
+  return m_scheduledEvents;
+}
+
+void
+LrWpanDutyCycleScheduler::RunBucket (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+
+  BucketMap::iterator it = m_buckets.find (time);
+  NS_ASSERT (it != m_buckets.end ());
+  // The steps may schedule new steps, even at the current time, so take the
+  // bucket out of the map before running them.
+  std::vector<Step> steps;
+  steps.swap (it->second);
+  m_buckets.erase (it);
+
+  NS_LOG_DEBUG ("Running " << steps.size () << " batched steps");
+  for (std::vector<Step>::const_iterator step = steps.begin ();
+       step != steps.end (); ++step)
+    {
+      Simulator::SetContext (step->first->GetNodeContext ());
+      step->first->RunBatchedStep (step->second);
+    }
+  Simulator::SetContext (0xffffffff);
+}
+
+}
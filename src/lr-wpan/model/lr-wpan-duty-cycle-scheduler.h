@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef LR_WPAN_DUTY_CYCLE_SCHEDULER_H
+#define LR_WPAN_DUTY_CYCLE_SCHEDULER_H
+
+#include <ns3/ptr.h>
+#include <ns3/nstime.h>
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+class LrWpanContikiMac;
+
+/**
+ * \ingroup lr-wpan
+ *
+ * \brief The duty-cycle scheduler shared by all LrWpanContikiMac instances
+ * of a simulation, which use batched wake-ups.
+ *
+ * An idle ContikiMAC node wakes up once per sleep interval, performs two
+ * CCAs and goes back to sleep. Every step of this cycle is a separate event
+ * for every node. Instead, the scheduler groups the nodes by the time of
+ * their next step into buckets, and runs the steps of all nodes of a bucket
+ * in a single simulator event. Nodes with the same wake-up phase share all
+ * buckets of their cycle.
+ *
+ * Use SimulationSingleton<LrWpanDutyCycleScheduler>::Get () to get the
+ * scheduler of the current simulation.
+ */
+class LrWpanDutyCycleScheduler
+{
+public:
+  LrWpanDutyCycleScheduler (void);
+  ~LrWpanDutyCycleScheduler (void);
+
+  /**
+   * Run the next step of the batched cycle of a MAC at the given time. The
+   * MAC ignores the step, if it scheduled another one or left the batched
+   * cycle in the meantime.
+   *
+   * \param time the absolute time of the step, not before now
+   * \param mac the MAC
+   * \param step the number of the step, which is passed back to the MAC
+   */
+  void Schedule (Time time, Ptr<LrWpanContikiMac> mac, uint32_t step);
+
+  /**
+   * \return the number of steps scheduled so far
+   */
+  uint64_t GetScheduledSteps (void) const;
+
+  /**
+   * \return the number of simulator events scheduled so far, one per bucket
+   */
+  uint64_t GetScheduledEvents (void) const;
+
+private:
+  /**
+   * Run the steps of all MACs of a bucket.
+   *
+   * \param time the time of the bucket
+   */
+  void RunBucket (Time time);
+
+  /**
+   * A MAC and the number of its step.
+   */
+  typedef std::pair<Ptr<LrWpanContikiMac>, uint32_t> Step;
+
+  /**
+   * The steps at a given time, in the order they were scheduled.
+   */
+  typedef std::map<Time, std::vector<Step> > BucketMap;
+
+  BucketMap m_buckets;        //!< The pending buckets
+  uint64_t m_scheduledSteps;  //!< The number of scheduled steps
+  uint64_t m_scheduledEvents; //!< The number of scheduled simulator events
+};
+
+}
+
+#endif /* LR_WPAN_DUTY_CYCLE_SCHEDULER_H */
@@ -18,8 +18,10 @@
  */
 #include "lr-wpan-error-model.h"
 #include <ns3/log.h>
+#include <ns3/boolean.h>
 
 #include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -27,6 +29,17 @@ NS_LOG_COMPONENT_DEFINE ("LrWpanErrorModel");
 
 NS_OBJECT_ENSURE_REGISTERED (LrWpanErrorModel);
 
+// The lookup table covers the SNR from 0 to LOOKUP_MAX_SNR (about 15 dB). The
+// error exponent is most curved at low SNR, where a finer resolution is used.
+// Above LOOKUP_MAX_SNR, the BER is below 1e-130 and the chunk success rate is
+// 1 in double precision.
+static const double LOOKUP_FINE_STEP = 0.001;    //!< SNR step below LOOKUP_FINE_MAX_SNR
+static const uint32_t LOOKUP_FINE_STEPS = 1000;  //!< Number of fine steps
+static const double LOOKUP_FINE_MAX_SNR = LOOKUP_FINE_STEP * LOOKUP_FINE_STEPS;
+static const double LOOKUP_COARSE_STEP = 0.01;   //!< SNR step above LOOKUP_FINE_MAX_SNR
+static const uint32_t LOOKUP_COARSE_STEPS = 3100; //!< Number of coarse steps
+static const double LOOKUP_MAX_SNR = LOOKUP_FINE_MAX_SNR + LOOKUP_COARSE_STEP * LOOKUP_COARSE_STEPS;
+
 TypeId
 LrWpanErrorModel::GetTypeId (void)
 {
@@ -34,11 +47,19 @@ LrWpanErrorModel::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName ("LrWpan")
     .AddConstructor<LrWpanErrorModel> ()
+    .AddAttribute ("UseLookupTable",
+                   "Interpolate the bit error rate from a precomputed table "
+                   "instead of evaluating the exact formula. The chunk success "
+                   "rate differs by at most 1e-5 from the exact one.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LrWpanErrorModel::m_useLookupTable),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 LrWpanErrorModel::LrWpanErrorModel (void)
+  : m_useLookupTable (false)
 {
   m_binomialCoefficients[0]  = 1;
   m_binomialCoefficients[1]  = -16;
@@ -61,6 +82,36 @@ LrWpanErrorModel::LrWpanErrorModel (void)
 
 double
 LrWpanErrorModel::GetChunkSuccessRate (double snr, uint32_t nbits) const
+{
+  if (m_useLookupTable && snr >= 0.0)
+    {
+      if (snr >= LOOKUP_MAX_SNR)
+        {
+          return 1.0;
+        }
+
+      const std::vector<double> &table = GetLookupTable ();
+      double x;
+      if (snr < LOOKUP_FINE_MAX_SNR)
+        {
+          x = snr / LOOKUP_FINE_STEP;
+        }
+      else
+        {
+          x = LOOKUP_FINE_STEPS + (snr - LOOKUP_FINE_MAX_SNR) / LOOKUP_COARSE_STEP;
+        }
+      uint32_t i = std::min (static_cast<uint32_t> (x), static_cast<uint32_t> (table.size () - 2));
+      double exponent = table[i] + (table[i + 1] - table[i]) * (x - i);
+      return exp (-(nbits * exp (exponent)));
+    }
+
+  double ber = GetBitErrorRate (snr);
+  double retval = pow (1.0 - ber, nbits);
+  return retval;
+}
+
+double
+LrWpanErrorModel::GetBitErrorRate (double snr) const
 {
   double ber = 0.0;
 
@@ -72,8 +123,33 @@ LrWpanErrorModel::GetChunkSuccessRate (double snr, uint32_t nbits) const
   ber = ber * 8.0 / 15.0 / 16.0;
 
   ber = std::min (ber, 1.0);
-  double retval = pow (1.0 - ber, nbits);
-  return retval;
+  return ber;
+}
+
+const std::vector<double>&
+LrWpanErrorModel::GetLookupTable (void) const
+{
+  // built once, by the first thread, and shared by all the threads
+  static const std::vector<double> table = BuildLookupTable ();
+  return table;
+}
+
+std::vector<double>
+LrWpanErrorModel::BuildLookupTable (void) const
+{
+  NS_LOG_LOGIC ("Building the BER lookup table");
+  std::vector<double> table;
+  table.reserve (LOOKUP_FINE_STEPS + LOOKUP_COARSE_STEPS + 1);
+  for (uint32_t i = 0; i < LOOKUP_FINE_STEPS; i++)
+    {
+      table.push_back (log (-log1p (-GetBitErrorRate (i * LOOKUP_FINE_STEP))));
+    }
+  for (uint32_t i = 0; i <= LOOKUP_COARSE_STEPS; i++)
+    {
+      double snr = LOOKUP_FINE_MAX_SNR + i * LOOKUP_COARSE_STEP;
+      table.push_back (log (-log1p (-GetBitErrorRate (snr))));
+    }
+  return table;
 }
 
 } // namespace ns3
@@ -19,6 +19,7 @@
 #define LR_WPAN_ERROR_MODEL_H
 
 #include <ns3/object.h>
+#include <vector>
 
 namespace ns3 {
 
@@ -28,6 +29,12 @@ namespace ns3 {
  * Model the error rate for IEEE 802.15.4 2.4 GHz AWGN channel for OQPSK
  * the model description can be found in IEEE Std 802.15.4-2006, section
  * E.4.1.7
+ *
+ * By default, the bit error rate is evaluated from the exact formula on every
+ * call. If the attribute UseLookupTable is set, it is interpolated from a
+ * table precomputed over the SNR, which is shared by all instances. The
+ * returned chunk success rate then differs by at most 1e-5 from the exact one,
+ * for any number of bits.
  */
 class LrWpanErrorModel : public Object
 {
@@ -51,6 +58,37 @@ public:
   double GetChunkSuccessRate (double snr, uint32_t nbits) const;
 
 private:
+  /**
+   * Evaluate the exact bit error rate.
+   *
+   * \param snr SNR expressed as a power ratio (i.e. not in dB)
+   * \return the bit error rate
+   */
+  double GetBitErrorRate (double snr) const;
+
+  /**
+   * Get the lookup table, which is built on first use.
+   *
+   * The table holds log (-log (1 - BER)) over the SNR, i.e. the logarithm of
+   * the per-bit error exponent, which is close to linear in the SNR. The
+   * chunk success rate for n bits is exp (-n * exp (entry)).
+   *
+   * \return the lookup table
+   */
+  const std::vector<double>& GetLookupTable (void) const;
+
+  /**
+   * Build the lookup table.
+   *
+   * \return the lookup table
+   */
+  std::vector<double> BuildLookupTable (void) const;
+
+  /**
+   * Use the lookup table instead of the exact formula.
+   */
+  bool m_useLookupTable;
+
   /**
    * Array of precalculated binomial coefficients.
    */
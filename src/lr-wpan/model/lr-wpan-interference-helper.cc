@@ -17,9 +17,11 @@
  *
  */
 #include "lr-wpan-interference-helper.h"
+#include "lr-wpan-spectrum-value-helper.h"
 #include <ns3/spectrum-value.h>
 #include <ns3/spectrum-model.h>
 #include <ns3/log.h>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -30,6 +32,7 @@ LrWpanInterferenceHelper::LrWpanInterferenceHelper (Ptr<const SpectrumModel> spe
     m_dirty (false)
 {
   m_signal = Create<SpectrumValue> (m_spectrumModel);
+  std::fill (m_channelPower, m_channelPower + N_CHANNELS, 0.0);
 }
 
 LrWpanInterferenceHelper::~LrWpanInterferenceHelper (void)
@@ -49,9 +52,16 @@ LrWpanInterferenceHelper::AddSignal (Ptr<const SpectrumValue> signal)
   if (signal->GetSpectrumModel () == m_spectrumModel)
     {
       result = m_signals.insert (signal).second;
-      if (result && !m_dirty)
+      if (result)
         {
-          *m_signal += *signal;
+          if (!m_dirty)
+            {
+              *m_signal += *signal;
+            }
+          for (uint32_t i = 0; i < N_CHANNELS; i++)
+            {
+              m_channelPower[i] += LrWpanSpectrumValueHelper::TotalAvgPower (signal, 11 + i);
+            }
         }
     }
   return result;
@@ -70,6 +80,18 @@ LrWpanInterferenceHelper::RemoveSignal (Ptr<const SpectrumValue> signal)
       if (result)
         {
           m_dirty = true;
+          if (m_signals.empty ())
+            {
+              // Do not let rounding errors of the running sums accumulate.
+              std::fill (m_channelPower, m_channelPower + N_CHANNELS, 0.0);
+            }
+          else
+            {
+              for (uint32_t i = 0; i < N_CHANNELS; i++)
+                {
+                  m_channelPower[i] -= LrWpanSpectrumValueHelper::TotalAvgPower (signal, 11 + i);
+                }
+            }
         }
     }
   return result;
@@ -82,6 +104,7 @@ LrWpanInterferenceHelper::ClearSignals (void)
 
   m_signals.clear ();
   m_dirty = true;
+  std::fill (m_channelPower, m_channelPower + N_CHANNELS, 0.0);
 }
 
 Ptr<SpectrumValue>
@@ -104,4 +127,19 @@ LrWpanInterferenceHelper::GetSignalPsd (void) const
   return m_signal->Copy ();
 }
 
+double
+LrWpanInterferenceHelper::GetSignalPower (uint32_t channel) const
+{
+  NS_ASSERT_MSG ((channel >= 11 && channel <= 26), "Invalid channel numbers");
+
+  // The running sum may drop marginally below zero by rounding errors.
+  return std::max (m_channelPower[channel - 11], 0.0);
+}
+
+uint32_t
+LrWpanInterferenceHelper::GetNumberOfSignals (void) const
+{
+  return m_signals.size ();
+}
+
 }
@@ -22,6 +22,7 @@
 #include <ns3/simple-ref-count.h>
 #include <ns3/ptr.h>
 #include <set>
+#include <stdint.h>
 
 namespace ns3 {
 
@@ -77,6 +78,24 @@ public:
    */
   Ptr<SpectrumValue> GetSignalPsd (void) const;
 
+  /**
+   * Get the in-band power of the sum of all accumulated signals, as
+   * LrWpanSpectrumValueHelper::TotalAvgPower would compute it from
+   * GetSignalPsd (). The power is maintained incrementally for every channel,
+   * so unlike GetSignalPsd (), this does not allocate or copy a SpectrumValue.
+   * Removed signals may leave rounding errors relative to the strongest
+   * accumulated signal, until all signals are removed.
+   *
+   * \param channel the channel number, 11 to 26
+   * \return the in-band power of the signals in W
+   */
+  double GetSignalPower (uint32_t channel) const;
+
+  /**
+   * \return the number of currently accumulated signals
+   */
+  uint32_t GetNumberOfSignals (void) const;
+
   /**
    * Get the SpectrumModel used by the helper.
    *
@@ -114,6 +133,17 @@ private:
    * to be recomputed before next use.
    */
   mutable bool m_dirty;
+
+  /**
+   * The number of channels of the 2.4 GHz band, channels 11 to 26.
+   */
+  static const uint32_t N_CHANNELS = 16;
+
+  /**
+   * The in-band power of the sum of all accumulated signals, for every
+   * channel. Updated whenever a signal is added or removed.
+   */
+  double m_channelPower[N_CHANNELS];
 };
 
 }
@@ -0,0 +1,393 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "lr-wpan-interference-tracker.h"
+#include "lr-wpan-spectrum-signal-parameters.h"
+#include "lr-wpan-oqpsk.h"
+#include <ns3/packet-burst.h>
+#include <ns3/simulator.h>
+#include <ns3/assert.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LrWpanInterferenceTracker");
+
+/**
+ * \param start the first bit position within the word, counted from the most
+ * significant bit
+ * \param end one past the last bit position, at most 64
+ * \return the mask with the bit positions [start, end) set
+ */
+static uint64_t
+WordMask (uint32_t start, uint32_t end)
+{
+  uint64_t mask = ~UINT64_C (0) >> start;
+  if (end < 64)
+    {
+      mask &= ~(~UINT64_C (0) >> end);
+    }
+  return mask;
+}
+
+LrWpanPackedPpdu::LrWpanPackedPpdu (void)
+  : m_size (0)
+{
+}
+
+void
+LrWpanPackedPpdu::Append (uint64_t value, uint32_t nBits)
+{
+  NS_ASSERT (nBits <= 64);
+  if (nBits == 0)
+    {
+      return;
+    }
+  if (nBits < 64)
+    {
+      value &= (UINT64_C (1) << nBits) - 1;
+    }
+
+  uint32_t offset = m_size % 64;
+  if (offset == 0)
+    {
+      m_words.push_back (0);
+    }
+  uint32_t free = 64 - offset;
+  if (nBits <= free)
+    {
+      m_words.back () |= value << (free - nBits);
+    }
+  else
+    {
+      m_words.back () |= value >> (nBits - free);
+      m_words.push_back (value << (64 - (nBits - free)));
+    }
+  m_size += nBits;
+}
+
+void
+LrWpanPackedPpdu::AppendZeros (uint32_t nBits)
+{
+  m_size += nBits;
+  m_words.resize ((m_size + 63) / 64, 0);
+}
+
+void
+LrWpanPackedPpdu::Reset (uint32_t nBits)
+{
+  m_size = nBits;
+  m_words.assign ((m_size + 63) / 64, 0);
+}
+
+void
+LrWpanPackedPpdu::Clear (void)
+{
+  m_size = 0;
+  m_words.clear ();
+}
+
+uint32_t
+LrWpanPackedPpdu::GetSize (void) const
+{
+  return m_size;
+}
+
+bool
+LrWpanPackedPpdu::GetBit (uint32_t index) const
+{
+  NS_ASSERT (index < m_size);
+  return (m_words[index / 64] >> (63 - index % 64)) & 1;
+}
+
+void
+LrWpanPackedPpdu::SetRange (uint32_t start, uint32_t end)
+{
+  if (end > m_size)
+    {
+      end = m_size;
+    }
+  if (start >= end)
+    {
+      return;
+    }
+
+  uint32_t first = start / 64;
+  uint32_t last = (end - 1) / 64;
+  if (first == last)
+    {
+      m_words[first] |= WordMask (start % 64, end - first * 64);
+      return;
+    }
+  m_words[first] |= WordMask (start % 64, 64);
+  for (uint32_t i = first + 1; i < last; i++)
+    {
+      m_words[i] = ~UINT64_C (0);
+    }
+  m_words[last] |= WordMask (0, end - last * 64);
+}
+
+void
+LrWpanPackedPpdu::Xor (const LrWpanPackedPpdu &other)
+{
+  NS_ASSERT (m_size == other.m_size);
+  for (uint32_t i = 0; i < m_words.size (); i++)
+    {
+      m_words[i] ^= other.m_words[i];
+    }
+}
+
+uint32_t
+LrWpanPackedPpdu::CountOnes (void) const
+{
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < m_words.size (); i++)
+    {
+      count += __builtin_popcountll (m_words[i]);
+    }
+  return count;
+}
+
+uint32_t
+LrWpanPackedPpdu::FindFirstOne (void) const
+{
+  for (uint32_t i = 0; i < m_words.size (); i++)
+    {
+      if (m_words[i] != 0)
+        {
+          return i * 64 + __builtin_clzll (m_words[i]);
+        }
+    }
+  return m_size;
+}
+
+std::string
+LrWpanPackedPpdu::ToString (void) const
+{
+  std::string repr (m_size, '0');
+  for (uint32_t i = 0; i < m_size; i++)
+    {
+      if (GetBit (i))
+        {
+          repr[i] = '1';
+        }
+    }
+  return repr;
+}
+
+LrWpanInterferenceTracker::LrWpanInterferenceTracker (void)
+  : m_rxActive (false),
+    m_firstJammedBit (0),
+    m_jammedBits (0)
+{
+}
+
+LrWpanInterferenceTracker::~LrWpanInterferenceTracker (void)
+{
+  m_frames.clear ();
+  m_rxFrame.params = 0;
+}
+
+void
+LrWpanInterferenceTracker::AddFrame (Ptr<const LrWpanSpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+
+  Frame frame;
+  frame.params = params;
+  frame.start = Simulator::Now ();
+  frame.stop = frame.start + params->duration;
+  frame.ended = false;
+  m_frames.push_back (frame);
+}
+
+bool
+LrWpanInterferenceTracker::RemoveFrame (Ptr<const LrWpanSpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+
+  for (std::vector<Frame>::iterator it = m_frames.begin (); it != m_frames.end (); ++it)
+    {
+      if (it->params == params)
+        {
+          if (m_rxActive && it->params != m_rxFrame.params && OverlapsRxFrame (*it))
+            {
+              it->ended = true;
+            }
+          else
+            {
+              *it = m_frames.back ();
+              m_frames.pop_back ();
+            }
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LrWpanInterferenceTracker::SetRxFrame (Ptr<const LrWpanSpectrumSignalParameters> params)
+{
+  NS_LOG_FUNCTION (this << params);
+
+  ClearRxFrame ();
+  for (std::vector<Frame>::const_iterator it = m_frames.begin (); it != m_frames.end (); ++it)
+    {
+      if (it->params == params)
+        {
+          m_rxFrame = *it;
+          m_rxActive = true;
+          return;
+        }
+    }
+  NS_ASSERT_MSG (false, "Received frame was not added to the tracker");
+}
+
+void
+LrWpanInterferenceTracker::ClearRxFrame (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_rxActive = false;
+  m_rxFrame.params = 0;
+  m_rxPpdu.Clear ();
+  m_jamMask.Clear ();
+  m_jammedPpdu.Clear ();
+  m_firstJammedBit = 0;
+  m_jammedBits = 0;
+
+  // Drop the frames which were only kept as interference of this reception.
+  uint32_t i = 0;
+  while (i < m_frames.size ())
+    {
+      if (m_frames[i].ended)
+        {
+          m_frames[i] = m_frames.back ();
+          m_frames.pop_back ();
+        }
+      else
+        {
+          i++;
+        }
+    }
+}
+
+bool
+LrWpanInterferenceTracker::OverlapsRxFrame (const Frame &frame) const
+{
+  return frame.start < m_rxFrame.stop && frame.stop > m_rxFrame.start;
+}
+
+bool
+LrWpanInterferenceTracker::CalculateInterference (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_rxActive)
+    {
+      return false;
+    }
+
+  uint32_t nBits = 0;
+  double timePerBit = 0.0;
+  bool overlapped = false;
+  for (std::vector<Frame>::const_iterator it = m_frames.begin (); it != m_frames.end (); ++it)
+    {
+      if (it->params == m_rxFrame.params || !OverlapsRxFrame (*it))
+        {
+          continue;
+        }
+
+      if (!overlapped)
+        {
+          // Pack the received frame only once we know that it is interfered.
+          if (m_rxPpdu.GetSize () == 0)
+            {
+              Ptr<Packet> p = m_rxFrame.params->packetBurst->GetPackets ().front ();
+              LrWpanOqpsk::GetPackedRepresentation (p, m_rxPpdu);
+            }
+          nBits = m_rxPpdu.GetSize ();
+          timePerBit = (m_rxFrame.stop - m_rxFrame.start).GetSeconds () / nBits;
+          m_jamMask.Reset (nBits);
+          overlapped = true;
+        }
+
+      Time from = std::max (it->start, m_rxFrame.start);
+      uint32_t start = (from - m_rxFrame.start).GetSeconds () / timePerBit;
+      uint32_t end;
+      if (it->stop >= m_rxFrame.stop)
+        {
+          end = nBits;
+        }
+      else
+        {
+          end = start + (uint32_t)((it->stop - from).GetSeconds () / timePerBit + 0.5);
+        }
+      m_jamMask.SetRange (start, end);
+    }
+
+  if (!overlapped)
+    {
+      return false;
+    }
+
+  uint32_t jammedBits = m_jamMask.CountOnes ();
+  if (jammedBits == m_jammedBits)
+    {
+      return false;
+    }
+
+  m_jammedBits = jammedBits;
+  m_firstJammedBit = m_jamMask.FindFirstOne ();
+  m_jammedPpdu = m_rxPpdu;
+  m_jammedPpdu.Xor (m_jamMask);
+
+  NS_LOG_DEBUG ("TimePerBit: " << timePerBit << " FirstJammedBit: " << m_firstJammedBit
+                               << " NumberJammedBits: " << m_jammedBits);
+  return true;
+}
+
+bool
+LrWpanInterferenceTracker::IsJammed (void) const
+{
+  return m_jammedBits > 0;
+}
+
+uint32_t
+LrWpanInterferenceTracker::GetFirstJammedBit (void) const
+{
+  return m_firstJammedBit;
+}
+
+uint32_t
+LrWpanInterferenceTracker::GetNumberOfJammedBits (void) const
+{
+  return m_jammedBits;
+}
+
+const LrWpanPackedPpdu&
+LrWpanInterferenceTracker::GetRxPpdu (void) const
+{
+  return m_rxPpdu;
+}
+
+const LrWpanPackedPpdu&
+LrWpanInterferenceTracker::GetJammedPpdu (void) const
+{
+  return m_jammedPpdu;
+}
+
+}
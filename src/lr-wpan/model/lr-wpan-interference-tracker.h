@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef LR_WPAN_INTERFERENCE_TRACKER_H
+#define LR_WPAN_INTERFERENCE_TRACKER_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/ptr.h>
+#include <ns3/nstime.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+struct LrWpanSpectrumSignalParameters;
+
+/**
+ * \ingroup lr-wpan
+ *
+ * \brief The bits of a PPDU as they are sent over the channel, packed into
+ * 64-bit words.
+ *
+ * Bit 0 of the PPDU is the most significant bit of the first word, so the
+ * words read in the same order as the string returned by
+ * LrWpanOqpsk::GetBinaryRepresentation.
+ */
+class LrWpanPackedPpdu
+{
+public:
+  LrWpanPackedPpdu (void);
+
+  /**
+   * Append the lowest nBits bits of value, most significant bit first.
+   *
+   * \param value the bits to append
+   * \param nBits the number of bits to append, at most 64
+   */
+  void Append (uint64_t value, uint32_t nBits);
+
+  /**
+   * Append nBits zero bits.
+   *
+   * \param nBits the number of bits to append
+   */
+  void AppendZeros (uint32_t nBits);
+
+  /**
+   * Resize to nBits bits, all of them cleared.
+   *
+   * \param nBits the new number of bits
+   */
+  void Reset (uint32_t nBits);
+
+  /**
+   * Remove all bits.
+   */
+  void Clear (void);
+
+  /**
+   * \return the number of bits
+   */
+  uint32_t GetSize (void) const;
+
+  /**
+   * \param index the index of the bit
+   * \return the value of the bit
+   */
+  bool GetBit (uint32_t index) const;
+
+  /**
+   * Set all bits in the range [start, end). The range is clipped to the size.
+   *
+   * \param start the first bit to set
+   * \param end one past the last bit to set
+   */
+  void SetRange (uint32_t start, uint32_t end);
+
+  /**
+   * Xor the bits of other into this PPDU. Both must have the same size.
+   *
+   * \param other the bits to xor with
+   */
+  void Xor (const LrWpanPackedPpdu &other);
+
+  /**
+   * \return the number of set bits
+   */
+  uint32_t CountOnes (void) const;
+
+  /**
+   * \return the index of the first set bit, or GetSize () if no bit is set
+   */
+  uint32_t FindFirstOne (void) const;
+
+  /**
+   * \return the bits as a string of '0' and '1' characters
+   */
+  std::string ToString (void) const;
+
+private:
+  std::vector<uint64_t> m_words; //!< The packed bits
+  uint32_t m_size;               //!< The number of valid bits
+};
+
+/**
+ * \ingroup lr-wpan
+ *
+ * \brief Tracks the 802.15.4 frames on the air at a single receiver and
+ * computes which bits of the currently received frame were jammed by other
+ * frames overlapping it in time.
+ *
+ * Every LrWpanPhy owns its own tracker, so any number of transmitters may
+ * overlap a reception. The jammed bit ranges are computed as a mask over the
+ * packed PPDU and applied with word-level xor.
+ */
+class LrWpanInterferenceTracker : public SimpleRefCount<LrWpanInterferenceTracker>
+{
+public:
+  LrWpanInterferenceTracker (void);
+
+  ~LrWpanInterferenceTracker (void);
+
+  /**
+   * Add a frame which starts arriving now. Never add the same frame more than
+   * once.
+   *
+   * \param params the signal parameters of the frame
+   */
+  void AddFrame (Ptr<const LrWpanSpectrumSignalParameters> params);
+
+  /**
+   * Remove a frame at the end of its reception. If the frame overlapped the
+   * currently received frame, it is kept until the reception ends, so that
+   * it still counts as interference.
+   *
+   * \param params the signal parameters of the frame
+   * \return false, if the frame was not added before, true otherwise
+   */
+  bool RemoveFrame (Ptr<const LrWpanSpectrumSignalParameters> params);
+
+  /**
+   * Start the reception of the given frame, which has to be added before.
+   *
+   * \param params the signal parameters of the received frame
+   */
+  void SetRxFrame (Ptr<const LrWpanSpectrumSignalParameters> params);
+
+  /**
+   * End the reception of the current frame.
+   */
+  void ClearRxFrame (void);
+
+  /**
+   * Recompute the jammed bits of the currently received frame from all
+   * frames overlapping it.
+   *
+   * \return true, if bits were jammed that were not jammed at the previous
+   * calculation, false otherwise
+   */
+  bool CalculateInterference (void);
+
+  /**
+   * \return true, if at least one bit of the received frame is jammed
+   */
+  bool IsJammed (void) const;
+
+  /**
+   * \return the index of the first jammed bit of the received frame
+   */
+  uint32_t GetFirstJammedBit (void) const;
+
+  /**
+   * \return the number of jammed bits of the received frame
+   */
+  uint32_t GetNumberOfJammedBits (void) const;
+
+  /**
+   * \return the bits of the received frame as they were sent
+   */
+  const LrWpanPackedPpdu& GetRxPpdu (void) const;
+
+  /**
+   * \return the bits of the received frame with all jammed bits flipped
+   */
+  const LrWpanPackedPpdu& GetJammedPpdu (void) const;
+
+private:
+  // Disable implicit copy constructors
+  /**
+   * \brief Copy constructor - defined and not implemented.
+   */
+  LrWpanInterferenceTracker (LrWpanInterferenceTracker const &);
+  /**
+   * \brief Copy constructor - defined and not implemented.
+   * \returns
+   */
+  LrWpanInterferenceTracker& operator= (LrWpanInterferenceTracker const &);
+
+  /**
+   * A frame on the air.
+   */
+  struct Frame
+  {
+    Ptr<const LrWpanSpectrumSignalParameters> params; //!< Signal parameters
+    Time start;                                       //!< Start of arrival
+    Time stop;                                        //!< End of arrival
+    bool ended;                                       //!< Arrival is complete
+  };
+
+  /**
+   * \param frame the frame to check
+   * \return true, if the frame overlaps the currently received frame
+   */
+  bool OverlapsRxFrame (const Frame &frame) const;
+
+  /**
+   * The frames currently on the air, including the received one.
+   */
+  std::vector<Frame> m_frames;
+
+  /**
+   * The frame currently received.
+   */
+  Frame m_rxFrame;
+
+  /**
+   * True, while a frame is received.
+   */
+  bool m_rxActive;
+
+  /**
+   * The bits of the received frame. Only packed once an overlapping frame
+   * is found.
+   */
+  LrWpanPackedPpdu m_rxPpdu;
+
+  /**
+   * The mask of the jammed bits of the received frame.
+   */
+  LrWpanPackedPpdu m_jamMask;
+
+  /**
+   * The bits of the received frame with all jammed bits flipped.
+   */
+  LrWpanPackedPpdu m_jammedPpdu;
+
+  /**
+   * The index of the first jammed bit.
+   */
+  uint32_t m_firstJammedBit;
+
+  /**
+   * The number of jammed bits.
+   */
+  uint32_t m_jammedBits;
+};
+
+}
+
+#endif /* LR_WPAN_INTERFERENCE_TRACKER_H */
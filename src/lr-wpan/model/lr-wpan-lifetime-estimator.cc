@@ -0,0 +1,436 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "lr-wpan-lifetime-estimator.h"
+#include "lr-wpan-radio-energy-model.h"
+#include "lr-wpan-net-device.h"
+#include <ns3/basic-energy-source.h>
+#include <ns3/mobility-model.h>
+#include <ns3/node.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+#include <ns3/boolean.h>
+#include <ns3/trace-source-accessor.h>
+#include <ns3/fatal-error.h>
+#include <ns3/log.h>
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LrWpanLifetimeEstimator");
+
+NS_OBJECT_ENSURE_REGISTERED (LrWpanLifetimeEstimator);
+
+/**
+ * The radio states, in the order of their index in the state table.
+ */
+static const LrWpanPhyEnumeration g_lrWpanRadioStates[LrWpanRadioEnergyStateTable::N_STATES] = {
+  IEEE_802_15_4_PHY_TX_ON,
+  IEEE_802_15_4_PHY_BUSY_TX,
+  IEEE_802_15_4_PHY_RX_ON,
+  IEEE_802_15_4_PHY_BUSY_RX,
+  IEEE_802_15_4_PHY_TRX_OFF,
+  IEEE_802_15_4_PHY_UNSPECIFIED
+};
+
+TypeId
+LrWpanLifetimeEstimator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LrWpanLifetimeEstimator")
+    .SetParent<Object> ()
+    .AddConstructor<LrWpanLifetimeEstimator> ()
+    .AddAttribute ("CycleTime",
+                   "The duration of a duty cycle, e.g. the SleepTime of ContikiMAC.",
+                   TimeValue (Seconds (0.125)),
+                   MakeTimeAccessor (&LrWpanLifetimeEstimator::m_cycleTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("WarmupCycles",
+                   "The number of duty cycles, which are simulated before the "
+                   "first window.",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&LrWpanLifetimeEstimator::m_warmupCycles),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("WindowCycles",
+                   "The number of duty cycles per window. The window should "
+                   "cover a whole number of traffic periods.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LrWpanLifetimeEstimator::m_windowCycles),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Tolerance",
+                   "The maximum relative difference of the energy consumed by "
+                   "a model in two consecutive windows, for which the regime "
+                   "is considered periodic.",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&LrWpanLifetimeEstimator::m_tolerance),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("DepletionMargin",
+                   "The number of windows before the next depletion of a "
+                   "source, which are simulated instead of skipped.",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&LrWpanLifetimeEstimator::m_depletionMargin),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("StopAtFirstDepletion",
+                   "Stop the simulation when the first source is depleted. "
+                   "Otherwise, it is stopped when all sources are depleted.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&LrWpanLifetimeEstimator::m_stopAtFirstDepletion),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("FastForward",
+                     "Time was skipped in the periodic regime.",
+                     MakeTraceSourceAccessor (&LrWpanLifetimeEstimator::m_fastForwardTrace),
+                     "ns3::LrWpanLifetimeEstimator::FastForwardTracedCallback")
+    .AddTraceSource ("Depletion",
+                     "An energy source reached its low battery threshold.",
+                     MakeTraceSourceAccessor (&LrWpanLifetimeEstimator::m_depletionTrace),
+                     "ns3::LrWpanLifetimeEstimator::DepletionTracedCallback")
+  ;
+  return tid;
+}
+
+LrWpanLifetimeEstimator::LrWpanLifetimeEstimator ()
+  : m_windows (0),
+    m_changeTime (Seconds (0)),
+    m_offset (Seconds (0)),
+    m_stopped (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LrWpanLifetimeEstimator::~LrWpanLifetimeEstimator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LrWpanLifetimeEstimator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_windowEvent.Cancel ();
+  m_models.clear ();
+  m_sources.clear ();
+  Object::DoDispose ();
+}
+
+void
+LrWpanLifetimeEstimator::Install (DeviceEnergyModelContainer models, EnergySourceContainer sources)
+{
+  NS_LOG_FUNCTION (this);
+  if (models.GetN () != sources.GetN ())
+    {
+      NS_FATAL_ERROR ("LrWpanLifetimeEstimator: the number of models and sources differs");
+    }
+
+  std::set<Ptr<MobilityModel> > mobilities;
+  for (uint32_t i = 0; i < models.GetN (); i++)
+    {
+      ModelState state;
+      state.model = DynamicCast<LrWpanRadioEnergyModel> (models.Get (i));
+      if (state.model == 0)
+        {
+          NS_FATAL_ERROR ("LrWpanLifetimeEstimator: DeviceEnergyModel type is not LrWpanRadioEnergyModel!");
+        }
+      Ptr<BasicEnergySource> source = DynamicCast<BasicEnergySource> (sources.Get (i));
+      if (source == 0)
+        {
+          NS_FATAL_ERROR ("LrWpanLifetimeEstimator: EnergySource type is not BasicEnergySource!");
+        }
+
+      // several models may draw from the same source
+      state.source = m_sources.size ();
+      for (uint32_t j = 0; j < m_sources.size (); j++)
+        {
+          if (m_sources[j].source == source)
+            {
+              state.source = j;
+              break;
+            }
+        }
+      if (state.source == m_sources.size ())
+        {
+          SourceState sourceState;
+          sourceState.source = source;
+          DoubleValue threshold;
+          source->GetAttribute ("BasicEnergyLowBatteryThreshold", threshold);
+          sourceState.thresholdJ = threshold.Get () * source->GetInitialEnergy ();
+          sourceState.depletionTime = Time::Max ();
+          m_sources.push_back (sourceState);
+          source->TraceConnectWithoutContext ("RemainingEnergy",
+                                              MakeCallback (&LrWpanLifetimeEstimator::RemainingEnergyChanged, this)
+                                              .Bind (state.source));
+
+          // a course change of a node changes the topology
+          Ptr<Node> node = source->GetNode ();
+          if (node != 0)
+            {
+              mobilities.insert (node->GetObject<MobilityModel> ());
+              for (uint32_t k = 0; k < node->GetNDevices (); k++)
+                {
+                  Ptr<LrWpanNetDevice> device = DynamicCast<LrWpanNetDevice> (node->GetDevice (k));
+                  if (device != 0)
+                    {
+                      mobilities.insert (device->GetPhy ()->GetMobility ());
+                    }
+                }
+            }
+        }
+      m_models.push_back (state);
+    }
+
+  for (std::set<Ptr<MobilityModel> >::iterator it = mobilities.begin (); it != mobilities.end (); ++it)
+    {
+      if (*it != 0)
+        {
+          (*it)->TraceConnectWithoutContext ("CourseChange",
+                                             MakeCallback (&LrWpanLifetimeEstimator::CourseChanged, this));
+        }
+    }
+
+  StartWarmup ();
+}
+
+void
+LrWpanLifetimeEstimator::NotifyChange (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_models.empty () && !m_stopped)
+    {
+      StartWarmup ();
+    }
+}
+
+void
+LrWpanLifetimeEstimator::NotifyChangeAt (Time time)
+{
+  NS_LOG_FUNCTION (this << time);
+  m_changeTime = std::max (m_changeTime, time);
+}
+
+Time
+LrWpanLifetimeEstimator::GetTimeOffset (void) const
+{
+  return m_offset;
+}
+
+Time
+LrWpanLifetimeEstimator::GetNetworkTime (void) const
+{
+  return Simulator::Now () + m_offset;
+}
+
+Time
+LrWpanLifetimeEstimator::GetDepletionTime (uint32_t index) const
+{
+  NS_ASSERT (index < m_sources.size ());
+  return m_sources[index].depletionTime;
+}
+
+Time
+LrWpanLifetimeEstimator::GetFirstDepletionTime (void) const
+{
+  Time first = Time::Max ();
+  for (std::vector<SourceState>::const_iterator it = m_sources.begin (); it != m_sources.end (); ++it)
+    {
+      first = std::min (first, it->depletionTime);
+    }
+  return first;
+}
+
+void
+LrWpanLifetimeEstimator::StartWarmup (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_windows = 0;
+  m_windowEvent.Cancel ();
+  m_windowEvent = Simulator::Schedule (m_cycleTime * m_warmupCycles,
+                                       &LrWpanLifetimeEstimator::StartWindow, this);
+}
+
+void
+LrWpanLifetimeEstimator::StartWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<ModelState>::iterator it = m_models.begin (); it != m_models.end (); ++it)
+    {
+      for (uint32_t s = 0; s < LrWpanRadioEnergyStateTable::N_STATES; s++)
+        {
+          it->residency[s] = it->model->GetStateResidency (g_lrWpanRadioStates[s]);
+          it->energy[s] = it->model->GetStateEnergyConsumption (g_lrWpanRadioStates[s]);
+        }
+      it->lastTotalEnergy = 0;
+    }
+  m_windows = 0;
+  m_windowStart = Simulator::Now ();
+  m_windowEvent.Cancel ();
+  m_windowEvent = Simulator::Schedule (m_cycleTime * m_windowCycles,
+                                       &LrWpanLifetimeEstimator::EndWindow, this);
+}
+
+void
+LrWpanLifetimeEstimator::EndWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+  Time window = Simulator::Now () - m_windowStart;
+  m_windows++;
+
+  bool periodic = m_windows >= 2;
+  for (std::vector<ModelState>::iterator it = m_models.begin (); it != m_models.end (); ++it)
+    {
+      double previousTotalEnergy = it->lastTotalEnergy;
+      it->lastTotalEnergy = 0;
+      for (uint32_t s = 0; s < LrWpanRadioEnergyStateTable::N_STATES; s++)
+        {
+          Time residency = it->model->GetStateResidency (g_lrWpanRadioStates[s]);
+          double energy = it->model->GetStateEnergyConsumption (g_lrWpanRadioStates[s]);
+          it->lastResidency[s] = residency - it->residency[s];
+          it->lastEnergy[s] = energy - it->energy[s];
+          it->lastTotalEnergy += it->lastEnergy[s];
+          it->residency[s] = residency;
+          it->energy[s] = energy;
+        }
+      if (std::fabs (it->lastTotalEnergy - previousTotalEnergy)
+          > m_tolerance * std::max (it->lastTotalEnergy, previousTotalEnergy))
+        {
+          periodic = false;
+        }
+    }
+  m_windowStart = Simulator::Now ();
+  NS_LOG_DEBUG ("Window " << m_windows << " of " << window.GetSeconds () << "s, periodic " << periodic);
+
+  if (periodic && Simulator::Now () >= m_changeTime)
+    {
+      Time toDepletion = GetTimeToDepletion ();
+      if (toDepletion != Time::Max ())
+        {
+          Time skipped = toDepletion - window * m_depletionMargin;
+          if (skipped.IsStrictlyPositive ())
+            {
+              FastForward (skipped);
+            }
+        }
+    }
+
+  if (m_stopped)
+    {
+      // a depletion while fast-forwarding stopped the simulation
+      return;
+    }
+  m_windowEvent = Simulator::Schedule (m_cycleTime * m_windowCycles,
+                                       &LrWpanLifetimeEstimator::EndWindow, this);
+}
+
+Time
+LrWpanLifetimeEstimator::GetTimeToDepletion (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<double> energy (m_sources.size (), 0.0);
+  for (std::vector<ModelState>::const_iterator it = m_models.begin (); it != m_models.end (); ++it)
+    {
+      energy[it->source] += it->lastTotalEnergy;
+    }
+
+  Time window = m_cycleTime * m_windowCycles;
+  double maxS = (Time::Max () - GetNetworkTime ()).GetSeconds () / 2;
+  double toDepletionS = maxS;
+  for (uint32_t i = 0; i < m_sources.size (); i++)
+    {
+      if (m_sources[i].depletionTime != Time::Max () || energy[i] <= 0)
+        {
+          continue;
+        }
+      double powerW = energy[i] / window.GetSeconds ();
+      double remainingJ = m_sources[i].source->GetRemainingEnergy () - m_sources[i].thresholdJ;
+      toDepletionS = std::min (toDepletionS, std::max (remainingJ, 0.0) / powerW);
+    }
+  if (toDepletionS >= maxS)
+    {
+      return Time::Max ();
+    }
+  return Seconds (toDepletionS);
+}
+
+void
+LrWpanLifetimeEstimator::FastForward (Time skipped)
+{
+  NS_LOG_FUNCTION (this << skipped);
+  NS_LOG_DEBUG ("Skipping " << skipped.GetSeconds () << "s at network time "
+                            << GetNetworkTime ().GetSeconds () << "s");
+  m_fastForwardTrace (GetNetworkTime (), skipped);
+
+  // each model repeats the last window
+  double windows = skipped.GetSeconds () / (m_cycleTime * m_windowCycles).GetSeconds ();
+  std::vector<double> energy (m_sources.size (), 0.0);
+  for (std::vector<ModelState>::iterator it = m_models.begin (); it != m_models.end (); ++it)
+    {
+      for (uint32_t s = 0; s < LrWpanRadioEnergyStateTable::N_STATES; s++)
+        {
+          Time residency = Seconds (it->lastResidency[s].GetSeconds () * windows);
+          double stateEnergy = it->lastEnergy[s] * windows;
+          it->model->AdvanceStateResidency (g_lrWpanRadioStates[s], residency, stateEnergy);
+          // the next window starts after the skipped time
+          it->residency[s] += residency;
+          it->energy[s] += stateEnergy;
+        }
+      energy[it->source] += it->lastTotalEnergy * windows;
+    }
+
+  m_offset += skipped;
+  for (uint32_t i = 0; i < m_sources.size (); i++)
+    {
+      m_sources[i].source->DrainEnergy (energy[i]);
+    }
+}
+
+void
+LrWpanLifetimeEstimator::RemainingEnergyChanged (uint32_t index, double oldValue, double newValue)
+{
+  NS_LOG_FUNCTION (this << index << oldValue << newValue);
+  SourceState &state = m_sources[index];
+  if (state.depletionTime != Time::Max () || newValue > state.thresholdJ)
+    {
+      return;
+    }
+  state.depletionTime = GetNetworkTime ();
+  NS_LOG_DEBUG ("Source " << index << " depleted at network time " << state.depletionTime.GetSeconds () << "s");
+  m_depletionTrace (index, state.depletionTime);
+
+  bool stop = m_stopAtFirstDepletion;
+  if (!stop)
+    {
+      stop = true;
+      for (std::vector<SourceState>::const_iterator it = m_sources.begin (); it != m_sources.end (); ++it)
+        {
+          stop = stop && it->depletionTime != Time::Max ();
+        }
+    }
+  if (stop)
+    {
+      m_stopped = true;
+      m_windowEvent.Cancel ();
+      Simulator::Stop ();
+    }
+}
+
+void
+LrWpanLifetimeEstimator::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  NotifyChange ();
+}
+
+} // namespace ns3
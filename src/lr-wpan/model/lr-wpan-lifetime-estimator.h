@@ -0,0 +1,242 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef LR_WPAN_LIFETIME_ESTIMATOR_H
+#define LR_WPAN_LIFETIME_ESTIMATOR_H
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
+#include <ns3/traced-callback.h>
+#include <ns3/device-energy-model-container.h>
+#include <ns3/energy-source-container.h>
+#include "lr-wpan-radio-energy-state-table.h"
+#include <vector>
+
+namespace ns3 {
+
+class LrWpanRadioEnergyModel;
+class BasicEnergySource;
+class MobilityModel;
+
+/**
+ * \ingroup lr-wpan
+ *
+ * \brief Fast-forwards the energy sources of a duty-cycled network to the
+ * depletion of its nodes.
+ *
+ * The network lifetime of a duty-cycled network is usually many orders of
+ * magnitude longer than its duty cycle. Once the traffic is periodic, every
+ * node consumes the same energy in every period, so the simulation of the
+ * remaining lifetime can be replaced by an extrapolation.
+ *
+ * After WarmupCycles duty cycles, the estimator measures the time spent and
+ * the energy consumed in every radio state by every LrWpanRadioEnergyModel
+ * in windows of WindowCycles duty cycles. When the energy consumed by each
+ * model in two consecutive windows differs by less than Tolerance, the
+ * network is in its periodic regime. The estimator then drains each
+ * BasicEnergySource by the average power of its models, and advances the
+ * state residency of the models, up to DepletionMargin windows before the
+ * next node reaches its low battery threshold. The depletion itself is
+ * simulated with full fidelity, so its effect on the other nodes is
+ * detected like any other change of the regime.
+ *
+ * The simulator clock does not jump: the skipped time is kept as an offset,
+ * and the network time of an instant is its simulation time plus the
+ * offset. Events scheduled by the scenario therefore happen at their
+ * simulation time. Traffic that should continue over the lifetime has to be
+ * generated periodically, with a period that divides the window.
+ *
+ * The estimator falls back to full simulation whenever the regime changes:
+ * - if the energy of the windows differs, no time is skipped;
+ * - a course change of the mobility model of a node or PHY, and
+ *   NotifyChange (), discard the current window and restart the warm-up;
+ * - no time is skipped before the last time passed to NotifyChangeAt ().
+ */
+class LrWpanLifetimeEstimator : public Object
+{
+public:
+  /**
+   * TracedCallback signature for fast-forwards.
+   *
+   * \param [in] networkTime The network time at which the fast-forward starts.
+   * \param [in] skipped The skipped time.
+   */
+  typedef void (* FastForwardTracedCallback)(Time networkTime, Time skipped);
+
+  /**
+   * TracedCallback signature for the depletion of an energy source.
+   *
+   * \param [in] index The index of the source in the installed container.
+   * \param [in] networkTime The network time of the depletion.
+   */
+  typedef void (* DepletionTracedCallback)(uint32_t index, Time networkTime);
+
+  static TypeId GetTypeId (void);
+  LrWpanLifetimeEstimator ();
+  virtual ~LrWpanLifetimeEstimator ();
+
+  /**
+   * Install the estimator on a set of models and their energy sources, and
+   * start the warm-up.
+   *
+   * \param models the LrWpanRadioEnergyModels
+   * \param sources the BasicEnergySources, the i-th model draws from the
+   * i-th source, as installed by the LrWpanRadioEnergyModelHelper
+   */
+  void Install (DeviceEnergyModelContainer models, EnergySourceContainer sources);
+
+  /**
+   * Discard the current window and start a new warm-up, e.g. because the
+   * traffic changes now.
+   */
+  void NotifyChange (void);
+
+  /**
+   * Do not skip any time before the given simulation time, e.g. because the
+   * traffic changes then.
+   *
+   * \param time the simulation time of the change
+   */
+  void NotifyChangeAt (Time time);
+
+  /**
+   * \return the total time skipped so far
+   */
+  Time GetTimeOffset (void) const;
+
+  /**
+   * \return the network time of now, i.e. the simulation time plus the
+   * skipped time
+   */
+  Time GetNetworkTime (void) const;
+
+  /**
+   * \param index the index of the source in the installed container
+   * \return the network time at which the source reached its low battery
+   * threshold, or Time::Max () if it is not depleted yet
+   */
+  Time GetDepletionTime (uint32_t index) const;
+
+  /**
+   * \return the network time of the first depletion of a source, or
+   * Time::Max () if no source is depleted yet
+   */
+  Time GetFirstDepletionTime (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * The measurement of an LrWpanRadioEnergyModel.
+   */
+  struct ModelState
+  {
+    Ptr<LrWpanRadioEnergyModel> model;  //!< the model
+    uint32_t source;                    //!< the index of the source of the model
+    Time residency[LrWpanRadioEnergyStateTable::N_STATES];  //!< residency at the start of the window
+    double energy[LrWpanRadioEnergyStateTable::N_STATES];   //!< energy at the start of the window
+    Time lastResidency[LrWpanRadioEnergyStateTable::N_STATES];  //!< residency in the last window
+    double lastEnergy[LrWpanRadioEnergyStateTable::N_STATES];   //!< energy in the last window
+    double lastTotalEnergy;             //!< energy in the last window, over all states
+  };
+
+  /**
+   * An energy source.
+   */
+  struct SourceState
+  {
+    Ptr<BasicEnergySource> source;  //!< the source
+    double thresholdJ;              //!< the remaining energy at which the source is depleted
+    Time depletionTime;             //!< the network time of the depletion
+  };
+
+  /**
+   * Start the warm-up before the first window of a regime.
+   */
+  void StartWarmup (void);
+
+  /**
+   * Start the first window of a regime at now.
+   */
+  void StartWindow (void);
+
+  /**
+   * Close the current window, compare it to the previous one, fast-forward
+   * if the regime is periodic, and start the next window.
+   */
+  void EndWindow (void);
+
+  /**
+   * Skip time in the periodic regime, in which every model repeats the last
+   * window.
+   *
+   * \param skipped the time to skip
+   */
+  void FastForward (Time skipped);
+
+  /**
+   * \return the time until the next depletion of a source in the periodic
+   * regime, or Time::Max () if no source is drained
+   */
+  Time GetTimeToDepletion (void) const;
+
+  /**
+   * Trace sink for the remaining energy of a source.
+   *
+   * \param index the index of the source
+   * \param oldValue the previous remaining energy
+   * \param newValue the remaining energy
+   */
+  void RemainingEnergyChanged (uint32_t index, double oldValue, double newValue);
+
+  /**
+   * Trace sink for course changes of a mobility model.
+   *
+   * \param mobility the mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+
+  Time m_cycleTime;            //!< the duration of a duty cycle
+  uint32_t m_warmupCycles;     //!< the number of cycles before the first window
+  uint32_t m_windowCycles;     //!< the number of cycles per window
+  double m_tolerance;          //!< the maximum relative difference of the energy of two windows
+  uint32_t m_depletionMargin;  //!< the number of windows, which are simulated before a depletion
+  bool m_stopAtFirstDepletion; //!< stop the simulation at the first depletion
+
+  std::vector<ModelState> m_models;   //!< the models
+  std::vector<SourceState> m_sources; //!< the sources
+  Time m_windowStart;                 //!< the start of the current window
+  uint32_t m_windows;                 //!< the number of windows measured in the current regime
+  Time m_changeTime;                  //!< the last declared change
+  Time m_offset;                      //!< the skipped time
+  EventId m_windowEvent;              //!< the end of the warm-up or of the current window
+  bool m_stopped;                     //!< the simulation was stopped at a depletion
+
+  /**
+   * The trace source fired when time is skipped.
+   */
+  TracedCallback<Time, Time> m_fastForwardTrace;
+
+  /**
+   * The trace source fired when a source is depleted.
+   */
+  TracedCallback<uint32_t, Time> m_depletionTrace;
+};
+
+} // namespace ns3
+
+#endif /* LR_WPAN_LIFETIME_ESTIMATOR_H */
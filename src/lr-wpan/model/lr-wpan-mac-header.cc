@@ -19,6 +19,7 @@
 #include "lr-wpan-mac-header.h"
 #include <ns3/address-utils.h>
 #include "ns3/lr-wpan-oqpsk.h"
+#include "ns3/lr-wpan-interference-tracker.h"
 #include <ns3/log.h>
 
 namespace ns3 {
@@ -527,6 +528,25 @@ std::string LrWpanMacHeader::GetBinaryRepresentation(void) {
 	return res;
 }
 
+void LrWpanMacHeader::AppendBinaryRepresentation(LrWpanPackedPpdu &ppdu) {
+	uint16_t frameControl = GetFrameControl();
+
+	//frame control has to be reversed most significant bit first
+	ppdu.Append(LrWpanOqpsk::reverseByte(frameControl >> 8), 8);
+	ppdu.Append(LrWpanOqpsk::reverseByte(frameControl & 0xff), 8);
+	ppdu.Append(m_SeqNum, 8);
+	ppdu.Append(m_addrDstPanId, 16);
+	uint8_t c[2];
+	m_addrShortDstAddr.CopyTo(c);
+	ppdu.Append(c[0], 8);
+	ppdu.Append(c[1], 8);
+
+	ppdu.Append(m_addrSrcPanId, 16);
+	m_addrShortSrcAddr.CopyTo(c);
+	ppdu.Append(c[0], 8);
+	ppdu.Append(c[1], 8);
+}
+
 LrWpanMacHeader LrWpanMacHeader::calculate_MacHeader(
 		std::string macHeader_Binary) {
 
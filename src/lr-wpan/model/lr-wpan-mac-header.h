@@ -44,6 +44,8 @@
 
 namespace ns3 {
 
+class LrWpanPackedPpdu;
+
 /**
  * \ingroup lr-wpan
  * Represent the Mac Header with the Frame Control and Sequence Number fields
@@ -408,6 +410,11 @@ public:
 	 */
 	std::string GetBinaryRepresentation(void);
 
+	/**
+	 * Appends the same representation as GetBinaryRepresentation to the packed PPDU.
+	 */
+	void AppendBinaryRepresentation(LrWpanPackedPpdu &ppdu);
+
 	/**
 	 * Calculates a new MacHeader with the given Binary Representations of a MAC Header.
 	 * This method is needed when creating a new Header of a jammed packet in OQPSK-class.
@@ -23,6 +23,7 @@
 #include <ns3/lr-wpan-mac-header.h>
 #include <ns3/lr-wpan-mac-trailer.h>
 #include <ns3/lr-wpan-phy.h>
+#include <ns3/lr-wpan-interference-tracker.h>
 #include <ns3/packet.h>
 
 namespace ns3 {
@@ -31,14 +32,6 @@ NS_LOG_COMPONENT_DEFINE("LrWpanOqpsk");
 
 NS_OBJECT_ENSURE_REGISTERED(LrWpanOqpsk);
 
-Ptr<Packet> LrWpanOqpsk::o_packets[2]; //first one is legitimate, second one is Jammer
-double LrWpanOqpsk::o_packetStartTime[2];
-double LrWpanOqpsk::o_packetStopTime[2];
-uint32_t LrWpanOqpsk::o_counter;
-std::string LrWpanOqpsk::o_interfered_Packet_Binary;
-int LrWpanOqpsk::o_number_NonJammedBitsStart = 0;
-int LrWpanOqpsk::o_number_JammedBits = 0;
-
 TypeId LrWpanOqpsk::GetTypeId(void) {
 	static TypeId tid =
 			TypeId("ns3::LrWpanOqpsk").SetParent<Object>().SetGroupName(
@@ -54,113 +47,19 @@ LrWpanOqpsk::~LrWpanOqpsk() {
 
 }
 
-/**
- * Adds a packet, which is transmitted at a given time and for a given duration.
- */
-void LrWpanOqpsk::addPacket(Ptr<Packet> packet, Time startTime, Time duration) {
-	o_counter = o_counter < 2 ? o_counter : 0;
-	if (o_counter == 0) {
-		o_interfered_Packet_Binary = "";
-	}
-
-	o_packets[o_counter] = packet;
-	o_packetStartTime[o_counter] = startTime.GetSeconds();
-
-	o_packetStopTime[o_counter] = startTime.GetSeconds()
-			+ duration.GetSeconds();
-
-	NS_LOG_DEBUG("START TIME: "<< o_packetStartTime[o_counter]);
-	NS_LOG_DEBUG("STOP TIME: "<< o_packetStopTime[o_counter]);
-	NS_LOG_DEBUG("DURATION: "<< duration);
-	o_counter++;
-}
-
-Ptr<Packet> LrWpanOqpsk::GetPacket(int i) {
-	return o_packets[i];
-}
-
-std::string LrWpanOqpsk::calculateInterference() {
-	if (o_counter < 2) {
-		NS_LOG_UNCOND("Interference can not be calculated without 2 packets.");
-		return "";
-	}
-
-	Ptr<Packet> p1_packet = o_packets[0];
-	Ptr<Packet> p2_packet = o_packets[1];
-	std::string p1_binary = GetBinaryRepresentation(p1_packet);
-	std::string p2_binary = GetBinaryRepresentation(p2_packet);
-	double p1_start = o_packetStartTime[0];
-	double p2_start = o_packetStartTime[1];
-	double p1_stop = o_packetStopTime[0];
-	double p2_stop = o_packetStopTime[1];
-
-	double p1_transmitDuration = p1_stop - p1_start;
-	double p2_transmitDuration = p2_stop - p2_start;
-	double p1_TimePerBit = p1_transmitDuration / (p1_packet->GetSize() * 8); //size is in bytes
-	NS_LOG_DEBUG("TIME PER BIT: "<<p1_TimePerBit);
-	//p1_TimePerBit = 0.000004;
-	double deltaStart_p1p2 = p2_start - p1_start;
-	int number_nonJammed_Bits_Start = deltaStart_p1p2 / p1_TimePerBit;
-
-	if (p1_stop < p2_start) {
-		NS_LOG_DEBUG("First packet was not interfered");
-		o_counter = 1; //first packet was not interfered, but second one may be interfered from the next packet
-		o_interfered_Packet_Binary = p1_binary; //no interference
-		o_number_NonJammedBitsStart = p1_binary.length();
-
-		//make second packet to new first packet
-		o_packets[0] = o_packets[1];
-		o_packetStartTime[0] = o_packetStartTime[1];
-		o_packetStopTime[0] = o_packetStopTime[1];
-
-		return "";
-	}
-
-	int number_Jammed_Bits;
-	if (p2_stop >= p1_stop) {
-		number_Jammed_Bits = p1_binary.length() - number_nonJammed_Bits_Start;
-	} else {
-		number_Jammed_Bits = (int) (p2_transmitDuration / p1_TimePerBit + 0.5);
-	}
-
-	//switch the bits from the first jammed component
-	int index = number_nonJammed_Bits_Start;
-	int i = number_Jammed_Bits;
-	while (i > 0 && index < p1_binary.length()) {
-		if (p1_binary.at(index) == ('1')) {
-			p1_binary.replace(index, 1, "0");
-		} else {
-			p1_binary.replace(index, 1, "1");
-		}
-		index++;
-		i--;
-	}
-
-	o_counter = 0; //after interference we don't need both packets anymore
-	o_interfered_Packet_Binary = p1_binary;
-	o_number_NonJammedBitsStart = number_nonJammed_Bits_Start;
-	o_number_JammedBits = number_Jammed_Bits;
-
-	NS_LOG_DEBUG("\nTimePerBit: " <<p1_TimePerBit);
-	NS_LOG_DEBUG("\nNonJammedBitsStart: " <<number_nonJammed_Bits_Start);
-	NS_LOG_DEBUG("\nNumberJammedBits: " <<number_Jammed_Bits);
-
-	return o_interfered_Packet_Binary;
-
-}
-
 //-----------------------------------------------------------------------------------------------------------------------
 
-std::string LrWpanOqpsk::GetBinaryRepresentation(Ptr<Packet> p) {
+std::string LrWpanOqpsk::GetBinaryRepresentation(Ptr<const Packet> p) {
+	// Read the MAC header behind the PHY header from a copy, which shares the
+	// buffer with the packet.
+	Ptr<Packet> copy = p->Copy();
 	LrWpanPhyHeader phyHeader;
-	p->RemoveHeader(phyHeader);
+	copy->RemoveHeader(phyHeader);
 	LrWpanMacHeader macHeader;
-	p->PeekHeader(macHeader);
-
-	p->AddHeader(phyHeader);
+	copy->PeekHeader(macHeader);
 
 	LrWpanMacTrailer trailer;
-	p->PeekTrailer(trailer);
+	copy->PeekTrailer(trailer);
 
 	uint32_t payload_size = p->GetSize() - phyHeader.GetSerializedSize() - 11 //this is the MAC header size in our simulation scenario
 			- trailer.GetSerializedSize();
@@ -187,6 +86,27 @@ std::string LrWpanOqpsk::GetBinaryRepresentation(Ptr<Packet> p) {
 	return repr;
 }
 
+void LrWpanOqpsk::GetPackedRepresentation(Ptr<const Packet> p,
+		LrWpanPackedPpdu &ppdu) {
+	Ptr<Packet> copy = p->Copy();
+	LrWpanPhyHeader phyHeader;
+	copy->RemoveHeader(phyHeader);
+	LrWpanMacHeader macHeader;
+	copy->PeekHeader(macHeader);
+
+	LrWpanMacTrailer trailer;
+	copy->PeekTrailer(trailer);
+
+	uint32_t payload_size = copy->GetSize() - 11 //this is the MAC header size in our simulation scenario
+			- trailer.GetSerializedSize();
+
+	ppdu.Clear();
+	phyHeader.AppendBinaryRepresentation(ppdu);
+	macHeader.AppendBinaryRepresentation(ppdu);
+	ppdu.AppendZeros(payload_size * 8);
+	ppdu.Append(trailer.GetFcs(), 16);
+}
+
 Ptr<Packet> LrWpanOqpsk::GetPacket(std::string binaryRepr) {
 
 	NS_LOG_DEBUG("GetPacket reversed:\n" << binaryRepr);
@@ -352,8 +272,18 @@ std::string LrWpanOqpsk::toBinary(uint16_t number) {
 	return res;
 }
 
-int LrWpanOqpsk::toInt(std::string binary) {
-	return std::stoi(binary, nullptr, 2);
+uint8_t LrWpanOqpsk::reverseByte(uint8_t toReverse) {
+	uint8_t reversed = 0;
+	for (int i = 0; i < 8; i++) {
+		reversed = (reversed << 1) | (toReverse & 1);
+		toReverse >>= 1;
+	}
+	return reversed;
+}
+
+uint32_t LrWpanOqpsk::toInt(std::string binary) {
+	// The preamble has 32 bits, which overflow an int once they are jammed.
+	return std::stoul(binary, nullptr, 2);
 }
 
 std::string LrWpanOqpsk::reverseString(std::string toReverse) {
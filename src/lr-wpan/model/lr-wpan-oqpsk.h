@@ -29,10 +29,13 @@
 
 namespace ns3 {
 
+class LrWpanPackedPpdu;
+
 /**
  * \ingroup lr-wpan
  *
  * This class models the O-QPSK modulation. For simulation purposes, we let chips be chips and only work with the packet bits (not modulated).
+ * The interference between overlapping frames is computed per receiver by LrWpanInterferenceTracker.
  */
 class LrWpanOqpsk: public Object {
 
@@ -51,9 +54,16 @@ public:
 	virtual ~LrWpanOqpsk(void);
 
 	/**
-	 * Returns the binary representation of a packet as it is send over the channel (most-significant-bit-first order)
+	 * Returns the binary representation of a packet as it is send over the channel (most-significant-bit-first order).
+	 * The packet is not modified, so it may be a PPDU shared among receivers.
+	 */
+	static std::string GetBinaryRepresentation(Ptr<const Packet> p);
+
+	/**
+	 * Writes the same representation as GetBinaryRepresentation into a packed PPDU,
+	 * without building the string.
 	 */
-	static std::string GetBinaryRepresentation(Ptr<Packet> p);
+	static void GetPackedRepresentation(Ptr<const Packet> p, LrWpanPackedPpdu &ppdu);
 
 	/**
 	 * Creates a Packet from the Binary Representation.
@@ -91,60 +101,14 @@ public:
 	static std::string reverseString(std::string toReverse);
 
 	/**
-	 * Transforms a binary string to an int.
-	 */
-	static int toInt(std::string binary);
-
-	/**
-	 * Returns the packet stored at position i in o_packets.
-	 */
-	static Ptr<Packet> GetPacket(int i);
-
-	/**
-	 * Adds a packet to o_packets, o_packetStartTime and o_packetStopTime.
-	 */
-	static void addPacket(Ptr<Packet> packet, Time startTime, Time stopTime);
-
-	/**
-	 *
-	 * returns empty string, if no Interference was detected
-	 */
-	static std::string calculateInterference(void);
-
-	/**
-	 * Stores at most two packets.
-	 */
-	static Ptr<Packet> o_packets[];
-
-	/**
-	 * Stores Start Time of the packets.
-	 */
-	static double o_packetStartTime[];
-
-	/**
-	 * Stores Stop Time of the packets.
-	 */
-	static double o_packetStopTime[];
-
-	/**
-	 * Counts the stored packets.
-	 */
-	static uint32_t o_counter;
-
-	/**
-	 * Contains the last interfered binary representation.
-	 */
-	static std::string o_interfered_Packet_Binary;
-
-	/**
-	 * Contains the non jammed bits number of the last interfered packet.
+	 * Reverses the bit order of a byte. Same as reverseString on the binary representation.
 	 */
-	static int o_number_NonJammedBitsStart;
+	static uint8_t reverseByte(uint8_t toReverse);
 
 	/**
-	 * Contains the jammed bits number of the last interfered packet.
+	 * Transforms a binary string of at most 32 bits to an unsigned int.
 	 */
-	static int o_number_JammedBits;
+	static uint32_t toInt(std::string binary);
 
 };
 }
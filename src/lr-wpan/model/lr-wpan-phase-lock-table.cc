@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "lr-wpan-phase-lock-table.h"
+#include <ns3/simulator.h>
+#include <ns3/assert.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LrWpanPhaseLockTable");
+
+LrWpanPhaseLockTable::LrWpanPhaseLockTable (void)
+  : m_slots (16),
+    m_size (0),
+    m_timeout (Seconds (0)),
+    m_maxFailures (1)
+{
+}
+
+void
+LrWpanPhaseLockTable::SetTimeout (Time timeout)
+{
+  m_timeout = timeout;
+}
+
+void
+LrWpanPhaseLockTable::SetMaxFailures (uint32_t maxFailures)
+{
+  NS_ASSERT (maxFailures > 0);
+  m_maxFailures = maxFailures;
+}
+
+uint32_t
+LrWpanPhaseLockTable::Hash (const Address &address)
+{
+  // FNV-1a over the address bytes.
+  uint8_t buffer[Address::MAX_SIZE];
+  uint32_t length = address.CopyTo (buffer);
+  uint32_t hash = 2166136261U;
+  for (uint32_t i = 0; i < length; i++)
+    {
+      hash ^= buffer[i];
+      hash *= 16777619U;
+    }
+  return hash;
+}
+
+uint32_t
+LrWpanPhaseLockTable::FindSlot (const Address &address) const
+{
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t slot = Hash (address) & mask;
+  while (!m_slots[slot].address.IsInvalid () && !(m_slots[slot].address == address))
+    {
+      slot = (slot + 1) & mask;
+    }
+  return slot;
+}
+
+void
+LrWpanPhaseLockTable::EraseSlot (uint32_t slot)
+{
+  uint32_t mask = m_slots.size () - 1;
+  uint32_t hole = slot;
+  uint32_t next = (hole + 1) & mask;
+  while (!m_slots[next].address.IsInvalid ())
+    {
+      // An entry may fill the hole, if the hole lies on its probe sequence,
+      // i.e. between its home slot and its current slot.
+      uint32_t home = Hash (m_slots[next].address) & mask;
+      if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+          m_slots[hole] = m_slots[next];
+          hole = next;
+        }
+      next = (next + 1) & mask;
+    }
+  m_slots[hole] = Entry ();
+  m_size--;
+}
+
+void
+LrWpanPhaseLockTable::Grow (void)
+{
+  NS_LOG_FUNCTION (this << m_slots.size ());
+
+  std::vector<Entry> slots (m_slots.size () * 2);
+  slots.swap (m_slots);
+  for (std::vector<Entry>::const_iterator it = slots.begin (); it != slots.end (); ++it)
+    {
+      if (!it->address.IsInvalid ())
+        {
+          m_slots[FindSlot (it->address)] = *it;
+        }
+    }
+}
+
+void
+LrWpanPhaseLockTable::Update (const Address &address, Time phase)
+{
+  NS_LOG_FUNCTION (this << address << phase);
+
+  uint32_t slot = FindSlot (address);
+  if (m_slots[slot].address.IsInvalid ())
+    {
+      // Keep the load factor at most 1/2, so that probe sequences stay short.
+      if (2 * (m_size + 1) > m_slots.size ())
+        {
+          Grow ();
+          slot = FindSlot (address);
+        }
+      m_slots[slot].address = address;
+      m_size++;
+    }
+  m_slots[slot].phase = phase;
+  m_slots[slot].lastUpdate = Simulator::Now ();
+  m_slots[slot].failures = 0;
+}
+
+bool
+LrWpanPhaseLockTable::Lookup (const Address &address, Time &phase)
+{
+  uint32_t slot = FindSlot (address);
+  if (m_slots[slot].address.IsInvalid ())
+    {
+      return false;
+    }
+  if (!m_timeout.IsZero () && Simulator::Now () - m_slots[slot].lastUpdate > m_timeout)
+    {
+      NS_LOG_LOGIC ("Phase of " << address << " expired");
+      EraseSlot (slot);
+      return false;
+    }
+  phase = m_slots[slot].phase;
+  return true;
+}
+
+bool
+LrWpanPhaseLockTable::NotifyFailure (const Address &address)
+{
+  NS_LOG_FUNCTION (this << address);
+
+  uint32_t slot = FindSlot (address);
+  if (m_slots[slot].address.IsInvalid ())
+    {
+      return false;
+    }
+  m_slots[slot].failures++;
+  if (m_slots[slot].failures >= m_maxFailures)
+    {
+      EraseSlot (slot);
+      return true;
+    }
+  return false;
+}
+
+bool
+LrWpanPhaseLockTable::Remove (const Address &address)
+{
+  NS_LOG_FUNCTION (this << address);
+
+  uint32_t slot = FindSlot (address);
+  if (m_slots[slot].address.IsInvalid ())
+    {
+      return false;
+    }
+  EraseSlot (slot);
+  return true;
+}
+
+void
+LrWpanPhaseLockTable::Clear (void)
+{
+  m_slots.assign (m_slots.size (), Entry ());
+  m_size = 0;
+}
+
+uint32_t
+LrWpanPhaseLockTable::GetSize (void) const
+{
+  return m_size;
+}
+
+} // namespace ns3
@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef LR_WPAN_PHASE_LOCK_TABLE_H
+#define LR_WPAN_PHASE_LOCK_TABLE_H
+
+#include <ns3/address.h>
+#include <ns3/nstime.h>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lr-wpan
+ *
+ * \brief The phase-lock table of ContikiMAC, which records the wake-up phase
+ * of the neighbors a unicast frame was successfully sent to.
+ *
+ * The entries are kept in an open-addressed hash table with linear probing,
+ * keyed by the Mac16Address or Mac64Address of the neighbor, so lookups and
+ * updates take constant time independent of the number of neighbors.
+ * Entries which were not refreshed within the timeout, or whose phase led to
+ * too many failed transmissions in a row, are removed.
+ */
+class LrWpanPhaseLockTable
+{
+public:
+  LrWpanPhaseLockTable (void);
+
+  /**
+   * Set the time after which an entry which was not updated is no longer
+   * used.
+   *
+   * \param timeout the timeout, zero to keep entries forever
+   */
+  void SetTimeout (Time timeout);
+
+  /**
+   * Set the number of failed transmissions in a row after which an entry is
+   * removed.
+   *
+   * \param maxFailures the maximum number of failed transmissions
+   */
+  void SetMaxFailures (uint32_t maxFailures);
+
+  /**
+   * Record the wake-up phase of a neighbor, which is added if not yet known.
+   * This resets the age and the failed transmissions of the entry.
+   *
+   * \param address the address of the neighbor
+   * \param phase a point in time at which the neighbor was awake
+   */
+  void Update (const Address &address, Time phase);
+
+  /**
+   * Look up the wake-up phase of a neighbor. An entry older than the timeout
+   * is removed.
+   *
+   * \param address the address of the neighbor
+   * \param phase the recorded wake-up phase, only set if found
+   * \return true, if the phase of the neighbor is known
+   */
+  bool Lookup (const Address &address, Time &phase);
+
+  /**
+   * Notify a transmission to a neighbor which failed, although it was
+   * started in the recorded wake-up phase.
+   *
+   * \param address the address of the neighbor
+   * \return true, if the entry was removed because of too many failures
+   */
+  bool NotifyFailure (const Address &address);
+
+  /**
+   * Remove the entry of a neighbor.
+   *
+   * \param address the address of the neighbor
+   * \return true, if the neighbor was known
+   */
+  bool Remove (const Address &address);
+
+  /**
+   * Remove all entries.
+   */
+  void Clear (void);
+
+  /**
+   * \return the number of entries, including expired ones not yet removed
+   */
+  uint32_t GetSize (void) const;
+
+private:
+  /**
+   * An entry of the table.
+   */
+  struct Entry
+  {
+    Address address;    //!< Neighbor address, invalid for empty slots
+    Time phase;         //!< Recorded wake-up phase
+    Time lastUpdate;    //!< Time of the last update
+    uint32_t failures;  //!< Number of failed transmissions in a row
+  };
+
+  /**
+   * \param address an address
+   * \return the hash of the address
+   */
+  static uint32_t Hash (const Address &address);
+
+  /**
+   * \param address the address to find
+   * \return the slot of the entry, or the empty slot where it would be added
+   */
+  uint32_t FindSlot (const Address &address) const;
+
+  /**
+   * Empty a slot and move the following entries of the probe sequence back,
+   * so that no tombstones are needed.
+   *
+   * \param slot the slot to empty
+   */
+  void EraseSlot (uint32_t slot);
+
+  /**
+   * Double the number of slots and reinsert all entries.
+   */
+  void Grow (void);
+
+  std::vector<Entry> m_slots;  //!< The slots, a power of two
+  uint32_t m_size;             //!< Number of used slots
+  Time m_timeout;              //!< Timeout of entries, zero for none
+  uint32_t m_maxFailures;      //!< Maximum failed transmissions in a row
+};
+
+} // namespace ns3
+
+#endif /* LR_WPAN_PHASE_LOCK_TABLE_H */
@@ -20,6 +20,7 @@
 #include <ns3/core-module.h>
 #include <ns3/lr-wpan-oqpsk.h>
 #include <ns3/lr-wpan-phy.h>
+#include <ns3/lr-wpan-interference-tracker.h>
 
 namespace ns3 {
 
@@ -178,6 +179,30 @@ std::string LrWpanPhyHeader::GetBinaryRepresentation(void) {
 	return repr;
 }
 
+void LrWpanPhyHeader::AppendBinaryRepresentation(LrWpanPackedPpdu &ppdu) {
+	//add preamble: 32 zeros
+	ppdu.AppendZeros(32);
+	//add sfd
+	ppdu.Append(lr_shrSfd, 8);
+	//add jrb if enabled
+	if (LrWpanPhy::IsJrbEnabled()) {
+		if (LrWpanPhy::IsEarlyJRB()) {
+			ppdu.Append(lr_jrb, 8);
+			//add phr: phr has 7 bits and one reserved bit
+			ppdu.Append(0, 1);
+			ppdu.Append(lr_phr, 7);
+		} else {
+			//add phr: phr has 7 bits and one reserved bit
+			ppdu.Append(0, 1);
+			ppdu.Append(lr_phr, 7);
+			ppdu.Append(lr_jrb, 8);
+		}
+	} else {
+		ppdu.Append(lr_phr, 7);
+		ppdu.Append(0, 1);
+	}
+}
+
 void LrWpanPhyHeader::Print(std::ostream &os) const {
 
 	os << "  Preamble = " << (uint32_t) lr_shrPreamble << ", SFD = "
@@ -23,6 +23,8 @@
 
 namespace ns3 {
 
+class LrWpanPackedPpdu;
+
 /**
  * \ingroup lr-wpan
  * Represents the Phy Header of a packet.
@@ -90,6 +92,11 @@ public:
 	 */
 	std::string GetBinaryRepresentation(void);
 
+	/**
+	 * Appends the same representation as GetBinaryRepresentation to the packed PPDU.
+	 */
+	void AppendBinaryRepresentation(LrWpanPackedPpdu &ppdu);
+
 	/**
 	 * Creates a random value for the information bits of the JRB and then creates the JRB out of it.
 	 */
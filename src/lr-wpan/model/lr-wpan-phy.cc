@@ -39,6 +39,7 @@
 #include <ns3/double.h>
 
 #include <ns3/lr-wpan-oqpsk.h>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -64,8 +65,8 @@ const LrWpanPhyPpduHeaderSymbolNumber LrWpanPhy::ppduHeaderSymbolNumbers[7] = {
 		{ 32.0, 8.0, 8.0, 8.0 }, { 2.0, 1.0, 0.4, 1.0 }, { 6.0, 1.0, 1.6, 1.0 },
 		{ 8.0, 2.0, 2.0, 2.0 }, { 8.0, 2.0, 2.0, 2.0 }, { 8.0, 2.0, 2.0, 2.0 } };
 
-bool LrWpanPhy::jrb_enabled = false;
-bool LrWpanPhy::early_jrb = true;
+ContextLocal<bool> LrWpanPhy::jrb_enabled (false);
+ContextLocal<bool> LrWpanPhy::early_jrb (true);
 
 TypeId LrWpanPhy::GetTypeId(void) {
 	static TypeId tid =
@@ -136,6 +137,7 @@ LrWpanPhy::LrWpanPhy(void) :
 	m_noise = psdHelper.CreateNoisePowerSpectralDensity(
 			m_phyPIBAttributes.phyCurrentChannel);
 	m_signal = Create<LrWpanInterferenceHelper>(m_noise->GetSpectrumModel());
+	m_interferenceTracker = Create<LrWpanInterferenceTracker>();
 	m_rxLastUpdate = Seconds(0);
 	Ptr<Packet> none_packet = 0;
 	Ptr<LrWpanSpectrumSignalParameters> none_params = 0;
@@ -149,7 +151,9 @@ LrWpanPhy::LrWpanPhy(void) :
 
 	ChangeTrxState (IEEE_802_15_4_PHY_TRX_OFF);
 	m_disabled = false;
-	jrb_enabled = false; //JRB is disabled by default
+	m_batched = false;
+	m_batchedCca = false;
+	jrb_enabled.Get () = false; //JRB is disabled by default
 }
 
 LrWpanPhy::~LrWpanPhy(void) {
@@ -162,6 +166,9 @@ void LrWpanPhy::DoDispose(void) {
 	m_setTRXState.Cancel();
 	m_trxState = IEEE_802_15_4_PHY_TRX_OFF;
 	m_trxStatePending = IEEE_802_15_4_PHY_IDLE;
+	m_batched = false;
+	m_batchedCca = false;
+	m_batchInterruptCallback = MakeNullCallback<void>();
 
 	m_mobility = 0;
 	m_device = 0;
@@ -169,6 +176,7 @@ void LrWpanPhy::DoDispose(void) {
 	m_txPsd = 0;
 	m_noise = 0;
 	m_signal = 0;
+	m_interferenceTracker = 0;
 	m_errorModel = 0;
 	m_pdDataIndicationCallback = MakeNullCallback<void, uint32_t, Ptr<Packet>,
 			uint8_t>();
@@ -240,11 +248,13 @@ void LrWpanPhy::StartRx(Ptr<SpectrumSignalParameters> spectrumRxParams) {
 	NS_LOG_FUNCTION(this << spectrumRxParams);
 	LrWpanSpectrumValueHelper psdHelper;
 
+	InterruptBatched();
+
 	if (!m_edRequest.IsExpired()) {
 		// Update the average receive power during ED.
 		Time now = Simulator::Now();
-		m_edPower.averagePower += LrWpanSpectrumValueHelper::TotalAvgPower(
-				m_signal->GetSignalPsd(), m_phyPIBAttributes.phyCurrentChannel)
+		m_edPower.averagePower += m_signal->GetSignalPower(
+				m_phyPIBAttributes.phyCurrentChannel)
 				* (now - m_edPower.lastUpdate).GetTimeStep()
 				/ m_edPower.measurementLength.GetTimeStep();
 		m_edPower.lastUpdate = now;
@@ -259,8 +269,7 @@ void LrWpanPhy::StartRx(Ptr<SpectrumSignalParameters> spectrumRxParams) {
 
 		// Update peak power if CCA is in progress.
 		if (!m_ccaRequest.IsExpired()) {
-			double power = LrWpanSpectrumValueHelper::TotalAvgPower(
-					m_signal->GetSignalPsd(),
+			double power = m_signal->GetSignalPower(
 					m_phyPIBAttributes.phyCurrentChannel);
 			if (m_ccaPeakPower < power) {
 				m_ccaPeakPower = power;
@@ -275,6 +284,9 @@ void LrWpanPhy::StartRx(Ptr<SpectrumSignalParameters> spectrumRxParams) {
 	Ptr<Packet> p = (lrWpanRxParams->packetBurst->GetPackets()).front();
 	NS_ASSERT(p != 0);
 
+	// Every frame on the air may jam the frame currently received.
+	m_interferenceTracker->AddFrame(lrWpanRxParams);
+
 	// Prevent PHY from receiving another packet while switching the transceiver state.
 	if (m_trxState == IEEE_802_15_4_PHY_RX_ON && !m_setTRXState.IsRunning()) {
 		// The specification doesn't seem to refer to BUSY_RX, but vendor
@@ -296,20 +308,20 @@ void LrWpanPhy::StartRx(Ptr<SpectrumSignalParameters> spectrumRxParams) {
 		NS_LOG_DEBUG(
 				this << " receiving packet with power: " << 10 * log10(LrWpanSpectrumValueHelper::TotalAvgPower (lrWpanRxParams->psd, m_phyPIBAttributes.phyCurrentChannel)) + 30 << "dBm");
 		m_signal->AddSignal(lrWpanRxParams->psd);
-		Ptr<SpectrumValue> interferenceAndNoise = m_signal->GetSignalPsd();
-		*interferenceAndNoise -= *lrWpanRxParams->psd;
-		*interferenceAndNoise += *m_noise;
-		double sinr = LrWpanSpectrumValueHelper::TotalAvgPower(
-				lrWpanRxParams->psd, m_phyPIBAttributes.phyCurrentChannel)
-				/ LrWpanSpectrumValueHelper::TotalAvgPower(interferenceAndNoise,
-						m_phyPIBAttributes.phyCurrentChannel);
+		double sinr = CalculateSinr(lrWpanRxParams->psd);
 
 		// Std. 802.15.4-2006, appendix E, Figure E.2
 		// At SNR < -5 the BER is less than 10e-1.
 		// It's useless to even *try* to decode the packet.
 		if (10 * log10(sinr) > -5) {
+			// The PPDU is shared by all receivers of the frame. Copy it before
+			// the reception changes its LQI tag and removes the PHY header.
+			lrWpanRxParams->packetBurst = lrWpanRxParams->packetBurst->Copy();
+			p = lrWpanRxParams->packetBurst->GetPackets().front();
+
 			ChangeTrxState (IEEE_802_15_4_PHY_BUSY_RX);
 			m_currentRxPacket = std::make_pair(lrWpanRxParams, false);
+			m_interferenceTracker->SetRxFrame(lrWpanRxParams);
 			m_phyRxBeginTrace(p);
 
 			m_rxLastUpdate = Simulator::Now();
@@ -340,8 +352,8 @@ void LrWpanPhy::StartRx(Ptr<SpectrumSignalParameters> spectrumRxParams) {
 
 	// Update peak power if CCA is in progress.
 	if (!m_ccaRequest.IsExpired()) {
-		double power = LrWpanSpectrumValueHelper::TotalAvgPower(
-				m_signal->GetSignalPsd(), m_phyPIBAttributes.phyCurrentChannel);
+		double power = m_signal->GetSignalPower(
+				m_phyPIBAttributes.phyCurrentChannel);
 		if (m_ccaPeakPower < power) {
 			m_ccaPeakPower = power;
 		}
@@ -370,14 +382,7 @@ void LrWpanPhy::CheckInterference(void) {
 			// How many bits did we receive since the last calculation?
 			double t = (Simulator::Now() - m_rxLastUpdate).ToDouble(Time::MS);
 			uint32_t chunkSize = ceil(t * (GetDataOrSymbolRate(true) / 1000));
-			Ptr<SpectrumValue> interferenceAndNoise = m_signal->GetSignalPsd();
-			*interferenceAndNoise -= *currentRxParams->psd;
-			*interferenceAndNoise += *m_noise;
-			double sinr = LrWpanSpectrumValueHelper::TotalAvgPower(
-					currentRxParams->psd, m_phyPIBAttributes.phyCurrentChannel)
-					/ LrWpanSpectrumValueHelper::TotalAvgPower(
-							interferenceAndNoise,
-							m_phyPIBAttributes.phyCurrentChannel);
+			double sinr = CalculateSinr(currentRxParams->psd);
 			double per = 1.0
 					- m_errorModel->GetChunkSuccessRate(sinr, chunkSize);
 
@@ -391,44 +396,27 @@ void LrWpanPhy::CheckInterference(void) {
 
 			//-------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
-			bool interfered = false;
-			if (LrWpanOqpsk::o_counter == 2) {
-				std::string interferedBinary =
-						LrWpanOqpsk::calculateInterference();
-
-				if (interferedBinary.length() != 0) { //empty, if no interference
-					interfered = true;
-					NS_LOG_UNCOND(this  << " !!!INTERFERENCE DETECTED!!!\n");
-					NS_LOG_UNCOND(
-							this << ": Position of first jammed bit: " << LrWpanOqpsk::o_number_NonJammedBitsStart);
-					NS_LOG_UNCOND(
-							this << ": First jammed field: " << LrWpanOqpsk::GetFirstJammedComponent((int)LrWpanOqpsk::o_number_NonJammedBitsStart));
-					NS_LOG_UNCOND(
-							this << ": Number of jammed bits: " << LrWpanOqpsk::o_number_JammedBits);
-					NS_LOG_UNCOND(
-							this << ": Old packet binary:\n" << LrWpanOqpsk::GetBinaryRepresentation(currentPacket)<<"\n");
-					NS_LOG_UNCOND(
-							this << ": New packet binary:\n" << interferedBinary<<"\n");
-					Ptr<Packet> interferedPacket;
-					interferedPacket = LrWpanOqpsk::GetPacket(interferedBinary);
-
-					NS_LOG_UNCOND(
-							"-----------------------------------------------------------------");
-					NS_LOG_UNCOND(
-							this<< " : Interfered Packet Representation: \n");
-					interferedPacket->EnablePrinting();
-					interferedPacket->Print(std::clog);
-					NS_LOG_UNCOND(
-							"\n-----------------------------------------------------------------\n");
-				} else {
-					NS_LOG_DEBUG(this << " No Interference was detected.");
+			bool interfered = m_interferenceTracker->CalculateInterference();
+			if (interfered) {
+				NS_LOG_LOGIC(
+						this << " Interference detected, first jammed bit: " << m_interferenceTracker->GetFirstJammedBit() << " (" << LrWpanOqpsk::GetFirstJammedComponent((int)m_interferenceTracker->GetFirstJammedBit()) << "), number of jammed bits: " << m_interferenceTracker->GetNumberOfJammedBits());
+				// The binary representations are only built when they are logged.
+				if (g_log.IsEnabled(LOG_DEBUG)) {
+					std::string interferedBinary =
+							m_interferenceTracker->GetJammedPpdu().ToString();
+					Ptr<Packet> interferedPacket = LrWpanOqpsk::GetPacket(
+							interferedBinary);
+					NS_LOG_DEBUG(
+							this << ": Old packet binary:\n" << m_interferenceTracker->GetRxPpdu().ToString() << "\n" << this << ": New packet binary:\n" << interferedBinary << "\n" << this << ": Interfered packet: " << *interferedPacket);
 				}
+			} else {
+				NS_LOG_DEBUG(this << " No new Interference was detected.");
 			}
 			if (m_random->GetValue() < per || interfered) {
 				// The packet was destroyed, drop the packet after reception.
 				m_currentRxPacket.second = true;
-				NS_LOG_UNCOND(
-						"\n" << this << ": The received Packet was destroyed due to interference.\n");
+				NS_LOG_LOGIC(
+						this << " The received packet was destroyed due to interference.");
 				//-------------------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 			}
@@ -439,25 +427,41 @@ void LrWpanPhy::CheckInterference(void) {
 	m_rxLastUpdate = Simulator::Now();
 }
 
+double LrWpanPhy::CalculateSinr(Ptr<const SpectrumValue> psd) const {
+	uint32_t channel = m_phyPIBAttributes.phyCurrentChannel;
+	double rxPower = LrWpanSpectrumValueHelper::TotalAvgPower(psd, channel);
+	double interferencePower = std::max(
+			m_signal->GetSignalPower(channel) - rxPower, 0.0);
+	return rxPower
+			/ (interferencePower
+					+ LrWpanSpectrumValueHelper::TotalAvgPower(m_noise, channel));
+}
+
 void LrWpanPhy::EndRx(Ptr<SpectrumSignalParameters> par) {
 	NS_LOG_FUNCTION(this);
 
+	Ptr<LrWpanSpectrumSignalParameters> params = DynamicCast<
+			LrWpanSpectrumSignalParameters>(par);
+	if (params != 0) {
+		m_interferenceTracker->RemoveFrame(params);
+	}
+
 	//For the Jammer: mustn't receive any packet while sending one. Necessary due to the inactivation of CSMA/CA.
 	if (m_trxState == IEEE_802_15_4_PHY_TX_ON
 			|| m_trxState == IEEE_802_15_4_PHY_BUSY_TX) {
 		NS_LOG_DEBUG(
 				"\n" << this << ": Cannot receive packet. I am currently transmitting a packet.\n");
+		// The signal still has to leave the interference, or it stays there for
+		// good and blocks the CCAs and receptions which follow.
+		m_signal->RemoveSignal(par->psd);
 		return;
 	}
 
-	Ptr<LrWpanSpectrumSignalParameters> params = DynamicCast<
-			LrWpanSpectrumSignalParameters>(par);
-
 	if (!m_edRequest.IsExpired()) {
 		// Update the average receive power during ED.
 		Time now = Simulator::Now();
-		m_edPower.averagePower += LrWpanSpectrumValueHelper::TotalAvgPower(
-				m_signal->GetSignalPsd(), m_phyPIBAttributes.phyCurrentChannel)
+		m_edPower.averagePower += m_signal->GetSignalPower(
+				m_phyPIBAttributes.phyCurrentChannel)
 				* (now - m_edPower.lastUpdate).GetTimeStep()
 				/ m_edPower.measurementLength.GetTimeStep();
 		m_edPower.lastUpdate = now;
@@ -467,10 +471,6 @@ void LrWpanPhy::EndRx(Ptr<SpectrumSignalParameters> par) {
 			m_currentRxPacket.first;
 	if (currentRxParams == params) {
 		CheckInterference();
-		Ptr<Packet> currentPacket =
-				currentRxParams->packetBurst->GetPackets().front(); //get the current packet
-		currentPacket->EnablePrinting();
-
 	}
 
 	// Update the interference.
@@ -508,11 +508,12 @@ void LrWpanPhy::EndRx(Ptr<SpectrumSignalParameters> par) {
 			}
 		} else {
 			// The packet was destroyed, drop it.
-			NS_LOG_UNCOND(this << ": The received packet was destroyed. \n");
+			NS_LOG_LOGIC(this << " The received packet was destroyed.");
 			m_phyRxDropTrace(currentPacket);
 		}
 		Ptr<LrWpanSpectrumSignalParameters> none = 0;
 		m_currentRxPacket = std::make_pair(none, true);
+		m_interferenceTracker->ClearRxFrame();
 
 		// We may be waiting to apply a pending state change.
 		if (m_trxStatePending != IEEE_802_15_4_PHY_IDLE) {
@@ -535,6 +536,7 @@ void LrWpanPhy::EndRx(Ptr<SpectrumSignalParameters> par) {
 
 void LrWpanPhy::PdDataRequest(const uint32_t psduLength, Ptr<Packet> p) {
 	NS_LOG_FUNCTION(this << psduLength << p);
+	InterruptBatched();
 	if (psduLength > aMaxPhyPacketSize) {
 		if (!m_pdDataConfirmCallback.IsNull()) {
 			m_pdDataConfirmCallback(IEEE_802_15_4_PHY_UNSPECIFIED);
@@ -579,10 +581,6 @@ void LrWpanPhy::PdDataRequest(const uint32_t psduLength, Ptr<Packet> p) {
 			txParams->packetBurst = pb;
 			m_channel->StartTx(txParams);
 
-			///-----------------------------------------------------------------------------------------------------------------
-			//let's add the packet to the interference handling class OQPSK
-			LrWpanOqpsk::addPacket(p, Simulator::Now(), txParams->duration);
-			///-----------------------------------------------------------------------------------------------------------------
 			m_pdDataRequest = Simulator::Schedule(txParams->duration,
 					&LrWpanPhy::EndTx, this);
 			ChangeTrxState (IEEE_802_15_4_PHY_BUSY_TX);
@@ -618,6 +616,7 @@ void LrWpanPhy::PdDataRequest(const uint32_t psduLength, Ptr<Packet> p) {
 
 void LrWpanPhy::PlmeCcaRequest(void) {
 	NS_LOG_FUNCTION(this);
+	InterruptBatched();
 
 	if (m_trxState == IEEE_802_15_4_PHY_RX_ON
 			|| m_trxState == IEEE_802_15_4_PHY_BUSY_RX) {
@@ -637,6 +636,7 @@ void LrWpanPhy::PlmeCcaRequest(void) {
 
 void LrWpanPhy::PlmeEdRequest(void) {
 	NS_LOG_FUNCTION(this);
+	InterruptBatched();
 	if (m_trxState == IEEE_802_15_4_PHY_RX_ON
 			|| m_trxState == IEEE_802_15_4_PHY_BUSY_RX) {
 		// Average over the powers of all signals received until EndEd()
@@ -688,6 +688,7 @@ void LrWpanPhy::PlmeGetAttributeRequest(LrWpanPibAttributeIdentifier id) {
 // Section 6.2.2.7.3
 void LrWpanPhy::PlmeSetTRXStateRequest(LrWpanPhyEnumeration state) {
 	NS_LOG_FUNCTION(this << state);
+	InterruptBatched();
 
 	// Check valid states (Table 14)
 	NS_ABORT_IF(
@@ -876,6 +877,7 @@ void LrWpanPhy::PlmeSetAttributeRequest(LrWpanPibAttributeIdentifier id,
 		LrWpanPhyPibAttributes *attribute) {
 	NS_LOG_FUNCTION(this << id << attribute);
 	NS_ASSERT(attribute);
+	InterruptBatched();
 	LrWpanPhyEnumeration status = IEEE_802_15_4_PHY_SUCCESS;
 
 	switch (id) {
@@ -1042,8 +1044,8 @@ void LrWpanPhy::CancelEd(LrWpanPhyEnumeration state) {
 void LrWpanPhy::EndEd(void) {
 	NS_LOG_FUNCTION(this);
 
-	m_edPower.averagePower += LrWpanSpectrumValueHelper::TotalAvgPower(
-			m_signal->GetSignalPsd(), m_phyPIBAttributes.phyCurrentChannel)
+	m_edPower.averagePower += m_signal->GetSignalPower(
+			m_phyPIBAttributes.phyCurrentChannel)
 			* (Simulator::Now() - m_edPower.lastUpdate).GetTimeStep()
 			/ m_edPower.measurementLength.GetTimeStep();
 
@@ -1068,11 +1070,19 @@ void LrWpanPhy::EndEd(void) {
 
 void LrWpanPhy::EndCca(void) {
 	NS_LOG_FUNCTION(this);
+	LrWpanPhyEnumeration sensedChannelState = SenseChannel();
+
+	if (!m_plmeCcaConfirmCallback.IsNull()) {
+		m_plmeCcaConfirmCallback(sensedChannelState);
+	}
+}
+
+LrWpanPhyEnumeration LrWpanPhy::SenseChannel(void) {
 	LrWpanPhyEnumeration sensedChannelState = IEEE_802_15_4_PHY_UNSPECIFIED;
 
 	// Update peak power.
-	double power = LrWpanSpectrumValueHelper::TotalAvgPower(
-			m_signal->GetSignalPsd(), m_phyPIBAttributes.phyCurrentChannel);
+	double power = m_signal->GetSignalPower(
+			m_phyPIBAttributes.phyCurrentChannel);
 	if (m_ccaPeakPower < power) {
 		m_ccaPeakPower = power;
 	}
@@ -1113,10 +1123,7 @@ void LrWpanPhy::EndCca(void) {
 	}
 
 	NS_LOG_LOGIC(this << "channel sensed state: " << sensedChannelState);
-
-	if (!m_plmeCcaConfirmCallback.IsNull()) {
-		m_plmeCcaConfirmCallback(sensedChannelState);
-	}
+	return sensedChannelState;
 }
 
 void LrWpanPhy::EndSetTRXState(void) {
@@ -1181,11 +1188,10 @@ void LrWpanPhy::EndTx(void) {
 Time LrWpanPhy::CalculateTxTime(Ptr<const Packet> packet) {
 	NS_LOG_FUNCTION(this << packet);
 
-	packet->EnablePrinting();
 	bool isData = true;
 	Time txTime = GetPpduHeaderTxTime();
 
-	if (jrb_enabled) {
+	if (jrb_enabled.Get ()) {
 		txTime += Seconds(
 				(packet->GetSize() - 7) * 8.0 / GetDataOrSymbolRate(isData)); //added "-7" because otherwise it would have been doubled since the PHY header is contained in the packet now
 	} else {
@@ -1223,7 +1229,7 @@ Time LrWpanPhy::GetPpduHeaderTxTime(void) {
 			+ ppduHeaderSymbolNumbers[m_phyOption].shrSfd
 			+ ppduHeaderSymbolNumbers[m_phyOption].phr;
 
-	if (jrb_enabled) {
+	if (jrb_enabled.Get ()) {
 		totalPpduHdrSymbols += +ppduHeaderSymbolNumbers[m_phyOption].jrb; //If jrb is enabled, the header becomes 8 bits larger
 	}
 
@@ -1322,26 +1328,26 @@ double LrWpanPhy::GetPhySymbolsPerOctet(void) const {
  * Enables the physical jamming resistance
  */
 void LrWpanPhy::EnableJRB() {
-	jrb_enabled = true;
+	jrb_enabled.Get () = true;
 }
 
 /**
  * Disables the physical jamming resistance
  */
 void LrWpanPhy::DisableJRB() {
-	jrb_enabled = false;
+	jrb_enabled.Get () = false;
 }
 
 bool LrWpanPhy::IsJrbEnabled() {
-	return jrb_enabled;
+	return jrb_enabled.Get ();
 }
 
 void LrWpanPhy::SetEarlyJRB(bool earlyJRB) {
-	early_jrb = earlyJRB;
+	early_jrb.Get () = earlyJRB;
 }
 
 bool LrWpanPhy::IsEarlyJRB() {
-	return early_jrb;
+	return early_jrb.Get ();
 }
 
 /**
@@ -1380,6 +1386,90 @@ Time LrWpanPhy::GetTrxTransitionTime(void) {
 	return m_tRxTransitionTime;
 }
 
+void LrWpanPhy::SetBatchInterruptCallback(Callback<void> c) {
+	NS_LOG_FUNCTION(this);
+	m_batchInterruptCallback = c;
+}
+
+bool LrWpanPhy::CanStartBatched(void) const {
+	return !m_batched && m_trxState == IEEE_802_15_4_PHY_TRX_OFF
+			&& m_trxStatePending == IEEE_802_15_4_PHY_IDLE
+			&& !m_setTRXState.IsRunning() && !m_ccaRequest.IsRunning()
+			&& !m_edRequest.IsRunning() && m_signal->GetNumberOfSignals() == 0
+			&& !m_batchInterruptCallback.IsNull();
+}
+
+void LrWpanPhy::StartBatched(void) {
+	NS_LOG_FUNCTION(this);
+	NS_ASSERT(CanStartBatched());
+	m_batched = true;
+}
+
+void LrWpanPhy::EndBatched(void) {
+	NS_LOG_FUNCTION(this);
+	NS_ASSERT(m_batched);
+	NS_ASSERT(m_trxStatePending == IEEE_802_15_4_PHY_IDLE && !m_batchedCca);
+	m_batched = false;
+}
+
+void LrWpanPhy::ResumeBatched(Time end) {
+	NS_LOG_FUNCTION(this << end);
+	NS_ASSERT(m_batched);
+	m_batched = false;
+	if (m_trxStatePending != IEEE_802_15_4_PHY_IDLE) {
+		m_setTRXState = Simulator::Schedule(end - Simulator::Now(),
+				&LrWpanPhy::EndSetTRXState, this);
+	}
+	if (m_batchedCca) {
+		m_batchedCca = false;
+		m_ccaRequest = Simulator::Schedule(end - Simulator::Now(),
+				&LrWpanPhy::EndCca, this);
+	}
+}
+
+Time LrWpanPhy::StartBatchedTRXState(LrWpanPhyEnumeration state) {
+	NS_LOG_FUNCTION(this << state);
+	NS_ASSERT(m_batched && m_trxStatePending == IEEE_802_15_4_PHY_IDLE);
+	NS_ASSERT(
+			(state == IEEE_802_15_4_PHY_RX_ON
+					&& m_trxState == IEEE_802_15_4_PHY_TRX_OFF)
+					|| (state == IEEE_802_15_4_PHY_TRX_OFF
+							&& m_trxState == IEEE_802_15_4_PHY_RX_ON));
+	m_trxStatePending = state;
+	NotifyListenersTransition(state);
+	return m_tRxTransitionTime;
+}
+
+void LrWpanPhy::EndBatchedTRXState(void) {
+	NS_LOG_FUNCTION(this);
+	NS_ASSERT(m_batched && m_trxStatePending != IEEE_802_15_4_PHY_IDLE);
+	ChangeTrxState(m_trxStatePending);
+	m_trxStatePending = IEEE_802_15_4_PHY_IDLE;
+}
+
+Time LrWpanPhy::StartBatchedCca(void) {
+	NS_LOG_FUNCTION(this);
+	NS_ASSERT(m_batched && m_trxState == IEEE_802_15_4_PHY_RX_ON);
+	m_ccaPeakPower = 0.0;
+	m_batchedCca = true;
+	return Seconds(8.0 / GetDataOrSymbolRate(false));
+}
+
+LrWpanPhyEnumeration LrWpanPhy::EndBatchedCca(void) {
+	NS_LOG_FUNCTION(this);
+	NS_ASSERT(m_batched && m_batchedCca);
+	m_batchedCca = false;
+	return SenseChannel();
+}
+
+void LrWpanPhy::InterruptBatched(void) {
+	if (m_batched) {
+		NS_LOG_DEBUG("Interrupt batched cycle");
+		m_batchInterruptCallback();
+		NS_ASSERT(!m_batched);
+	}
+}
+
 void LrWpanPhy::EnergyDepletionHandler(void) {
 	NS_LOG_FUNCTION(this);
 	NS_LOG_DEBUG("Energy depleted at node, stopping rx/tx activities");
@@ -20,11 +20,13 @@
 #define LR_WPAN_PHY_H
 
 #include "lr-wpan-interference-helper.h"
+#include "lr-wpan-interference-tracker.h"
 
 #include <ns3/spectrum-phy.h>
 #include <ns3/traced-callback.h>
 #include <ns3/traced-value.h>
 #include <ns3/event-id.h>
+#include <ns3/simulation-context.h>
 
 namespace ns3 {
 
@@ -585,6 +587,73 @@ public:
 	 */
 	Time GetTrxTransitionTime(void);
 
+	/**
+	 * Set the callback which ends a batched cycle, see StartBatched. The
+	 * callback has to call ResumeBatched or EndBatched.
+	 *
+	 * \param c the callback
+	 */
+	void SetBatchInterruptCallback(Callback<void> c);
+
+	/**
+	 * \return true, if the transceiver is off, no state switch or
+	 * measurement is pending and no signal is on the air, so a batched cycle
+	 * may be started
+	 */
+	bool CanStartBatched(void) const;
+
+	/**
+	 * Start a batched cycle. During a batched cycle, the transceiver state
+	 * switches and CCAs are driven by an LrWpanDutyCycleScheduler, instead of
+	 * own events of the PHY. The state changes are applied and reported to the
+	 * listeners at the same times as without batching. Every incoming signal
+	 * and every request to the PHY first calls the batch interrupt callback.
+	 */
+	void StartBatched(void);
+
+	/**
+	 * End a batched cycle, which has no pending state switch or CCA.
+	 */
+	void EndBatched(void);
+
+	/**
+	 * End a batched cycle and continue a pending state switch or CCA with an
+	 * own event of the PHY, as if it had been started without batching.
+	 *
+	 * \param end the time at which the pending state switch or CCA ends
+	 */
+	void ResumeBatched(Time end);
+
+	/**
+	 * Start a transceiver state switch in a batched cycle, like
+	 * PlmeSetTRXStateRequest from TRX_OFF to RX_ON or from RX_ON to TRX_OFF.
+	 *
+	 * \param state the new state
+	 * \return the time until the switch has to be ended by
+	 * EndBatchedTRXState
+	 */
+	Time StartBatchedTRXState(LrWpanPhyEnumeration state);
+
+	/**
+	 * End a transceiver state switch in a batched cycle. The MAC is not
+	 * notified.
+	 */
+	void EndBatchedTRXState(void);
+
+	/**
+	 * Start a CCA in a batched cycle, like PlmeCcaRequest in RX_ON state.
+	 *
+	 * \return the time until the CCA has to be ended by EndBatchedCca
+	 */
+	Time StartBatchedCca(void);
+
+	/**
+	 * End a CCA in a batched cycle. The MAC is not notified.
+	 *
+	 * \return the sensed channel state
+	 */
+	LrWpanPhyEnumeration EndBatchedCca(void);
+
 protected:
 	/**
 	 * The data and symbol rates for the different PHY options.
@@ -607,11 +676,11 @@ private:
 
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 	/**
-	 * Shows if jrb is enabled.
+	 * Shows if jrb is enabled, per SimulationContext.
 	 */
-	static bool jrb_enabled;
+	static ContextLocal<bool> jrb_enabled;
 
-	static bool early_jrb;
+	static ContextLocal<bool> early_jrb;
 	//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 	/**
@@ -686,6 +755,17 @@ private:
 	 */
 	void CheckInterference(void);
 
+	/**
+	 * Calculate the SINR of a signal currently received on the current channel,
+	 * from the in-band powers of the signal, of all accumulated signals and of
+	 * the noise. No SpectrumValue is allocated.
+	 *
+	 * \param psd the PSD of the received signal, which has to be accumulated
+	 * in the interference helper already
+	 * \return the SINR (linear)
+	 */
+	double CalculateSinr(Ptr<const SpectrumValue> psd) const;
+
 	/**
 	 * Finish the reception of a frame. This is called at the end of a frame
 	 * reception, applying possibly pending PHY state changes and fireing the
@@ -719,6 +799,18 @@ private:
 	 */
 	void EndCca(void);
 
+	/**
+	 * Determine the channel condition at the end of a CCA.
+	 *
+	 * \return the sensed channel state, busy or idle
+	 */
+	LrWpanPhyEnumeration SenseChannel(void);
+
+	/**
+	 * Call the batch interrupt callback, if a batched cycle is running.
+	 */
+	void InterruptBatched(void);
+
 	/**
 	 * Called after applying a deferred transceiver state switch. The result of
 	 * the state switch is reported to the MAC.
@@ -936,6 +1028,12 @@ private:
 	 */
 	Ptr<LrWpanInterferenceHelper> m_signal;
 
+	/**
+	 * The 802.15.4 frames currently on the air at this transceiver, used to
+	 * compute the bits of the received frame jammed by overlapping frames.
+	 */
+	Ptr<LrWpanInterferenceTracker> m_interferenceTracker;
+
 	/**
 	 * Timestamp of the last calculation of the PER of a packet currently received.
 	 */
@@ -977,6 +1075,21 @@ private:
 	 */
 	EventId m_pdDataRequest;
 
+	/**
+	 * True, while a batched cycle is running.
+	 */
+	bool m_batched;
+
+	/**
+	 * True, while a CCA of a batched cycle is running.
+	 */
+	bool m_batchedCca;
+
+	/**
+	 * The callback which ends a batched cycle.
+	 */
+	Callback<void> m_batchInterruptCallback;
+
 	/**
 	 * Uniform random variable stream.
 	 */
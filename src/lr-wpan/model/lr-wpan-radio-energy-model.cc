@@ -29,10 +29,6 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED(LrWpanRadioEnergyModel);
 
-double trans_duration = 0;
-double recv_duration = 0;
-//double sleep_duration = 0;
-
 TypeId LrWpanRadioEnergyModel::GetTypeId(void) {
 	static TypeId tid =
 			TypeId("ns3::LrWpanRadioEnergyModel").SetParent<DeviceEnergyModel>().AddConstructor<
@@ -54,24 +50,27 @@ TypeId LrWpanRadioEnergyModel::GetTypeId(void) {
 					"Total energy consumption of the radio device.",
 					MakeTraceSourceAccessor(
 							&LrWpanRadioEnergyModel::m_totalEnergyConsumption),
-					"ns3::TracedValue::DoubleCallback");
+					"ns3::TracedValue::DoubleCallback").AddTraceSource(
+					"StateResidency",
+					"Time spent and energy consumed in a radio state, fired when the state is left.",
+					MakeTraceSourceAccessor(
+							&LrWpanRadioEnergyModel::m_stateResidencyTrace),
+					"ns3::LrWpanRadioEnergyModel::StateResidencyTracedCallback");
 	return tid;
 }
 
 LrWpanRadioEnergyModel::LrWpanRadioEnergyModel() :
 		m_totalEnergyConsumption(0) {
 	NS_LOG_FUNCTION(this);
-	m_currentState = IEEE_802_15_4_PHY_TRX_OFF;  // initially SLEEP
-	m_lastUpdateTime = Seconds(0.0);
+	m_table = LrWpanRadioEnergyStateTable::GetDefault();
+	m_slot = m_table->Allocate();  // initially SLEEP
 	m_energyDepletionCallback.Nullify();
 	m_source = NULL;      // EnergySource
-	sleep_duration = 0; //sleep, transition and receive duration set to 0
-	trans_duration = 0;
-	recv_duration = 0;
 }
 
 LrWpanRadioEnergyModel::~LrWpanRadioEnergyModel() {
 	NS_LOG_FUNCTION(this);
+	m_table->Release(m_slot);
 }
 
 void LrWpanRadioEnergyModel::AttachPhy(Ptr<LrWpanPhy> phy) {
@@ -122,7 +121,66 @@ void LrWpanRadioEnergyModel::SetSleepCurrentA(double sleepCurrentA) {
 
 LrWpanPhyEnumeration LrWpanRadioEnergyModel::GetCurrentState(void) const {
 	NS_LOG_FUNCTION(this);
-	return m_currentState;
+	return m_table->GetState(m_slot);
+}
+
+Time LrWpanRadioEnergyModel::GetStateResidency(LrWpanPhyEnumeration state) const {
+	NS_LOG_FUNCTION(this << state);
+	Time residency = m_table->GetResidency(m_slot, state);
+	if (state == m_table->GetState(m_slot)) {
+		residency += Simulator::Now() - m_table->GetLastUpdateTime(m_slot);
+	}
+	return residency;
+}
+
+double LrWpanRadioEnergyModel::GetStateEnergyConsumption(
+		LrWpanPhyEnumeration state) const {
+	NS_LOG_FUNCTION(this << state);
+	double energy = m_table->GetEnergy(m_slot, state);
+	if (state == m_table->GetState(m_slot) && m_source != NULL) {
+		Time duration = Simulator::Now() - m_table->GetLastUpdateTime(m_slot);
+		energy += duration.GetSeconds() * DoGetCurrentA()
+				* m_source->GetSupplyVoltage();
+	}
+	return energy;
+}
+
+void LrWpanRadioEnergyModel::AdvanceStateResidency(LrWpanPhyEnumeration state,
+		Time duration, double energy) {
+	NS_LOG_FUNCTION(this << state << duration << energy);
+	m_table->AddResidency(m_slot, state, duration, energy);
+	m_totalEnergyConsumption += energy;
+}
+
+void LrWpanRadioEnergyModel::SetStateTable(
+		Ptr<LrWpanRadioEnergyStateTable> table) {
+	NS_LOG_FUNCTION(this << table);
+	NS_ASSERT(table != NULL);
+	if (table == m_table) {
+		return;
+	}
+	uint32_t slot = table->Allocate();
+	table->SetState(slot, m_table->GetState(m_slot));
+	table->SetNextState(slot, m_table->GetNextState(m_slot));
+	table->SetLastUpdateTime(slot, m_table->GetLastUpdateTime(m_slot));
+	static const LrWpanPhyEnumeration states[] = { IEEE_802_15_4_PHY_TX_ON,
+			IEEE_802_15_4_PHY_BUSY_TX, IEEE_802_15_4_PHY_RX_ON,
+			IEEE_802_15_4_PHY_BUSY_RX, IEEE_802_15_4_PHY_TRX_OFF,
+			IEEE_802_15_4_PHY_UNSPECIFIED };
+	for (uint32_t i = 0; i < sizeof(states) / sizeof(states[0]); i++) {
+		table->AddResidency(slot, states[i],
+				m_table->GetResidency(m_slot, states[i]),
+				m_table->GetEnergy(m_slot, states[i]));
+	}
+	m_table->Release(m_slot);
+	m_table = table;
+	m_slot = slot;
+}
+
+Ptr<LrWpanRadioEnergyStateTable> LrWpanRadioEnergyModel::GetStateTable(
+		void) const {
+	NS_LOG_FUNCTION(this);
+	return m_table;
 }
 
 void LrWpanRadioEnergyModel::SetEnergyDepletionCallback(
@@ -148,66 +206,26 @@ void LrWpanRadioEnergyModel::SetEnergyRechargedCallback(
 void LrWpanRadioEnergyModel::ChangeState(int newState) {
 	NS_LOG_FUNCTION(this << newState);
 
-	Time duration = Simulator::Now() - m_lastUpdateTime;
+	Time duration = Simulator::Now() - m_table->GetLastUpdateTime(m_slot);
 	NS_ASSERT(duration.GetNanoSeconds() >= 0); // check if duration is valid
 
-	// energy to decrease = current * voltage * time
-	double energyToDecrease = 0.0; //energyToDecrease = duration.GetSeconds () * DoGetCurrentA() * supplyVoltage;
+	// energy to decrease = current * voltage * time; in a transition, the
+	// current of the arrival state is drawn
 	double supplyVoltage = m_source->GetSupplyVoltage();
+	double energyToDecrease = duration.GetSeconds() * DoGetCurrentA()
+			* supplyVoltage;
 
-	switch (m_currentState) {
-	case IEEE_802_15_4_PHY_TX_ON:
-		energyToDecrease = duration.GetSeconds() * m_txCurrentA * supplyVoltage;
-		trans_duration += duration.GetSeconds();
-		NS_LOG_DEBUG(this << " Trans Duration: " << duration.GetSeconds());
-		break;
-	case IEEE_802_15_4_PHY_RX_ON:
-		energyToDecrease = duration.GetSeconds() * m_rxCurrentA * supplyVoltage;
-		recv_duration += duration.GetSeconds();
-		NS_LOG_DEBUG(this << " Recv Duration: " << duration.GetSeconds());
-
-		break;
-	case IEEE_802_15_4_PHY_TRX_OFF:
-		energyToDecrease = duration.GetSeconds() * m_sleepCurrentA
-				* supplyVoltage;
-		sleep_duration += duration.GetSeconds();
-		NS_LOG_DEBUG(this << " Sleep Duration: " << duration.GetSeconds());
-
-		break;
-		// \todo use a better algorithm to guess the energy in this state
-	case IEEE_802_15_4_PHY_UNSPECIFIED:
-		energyToDecrease = duration.GetSeconds() * DoGetCurrentA()
-				* supplyVoltage; //TRANSITION duration * current * supplyVoltage
-		//--------------------------------------------For tracing the times spent in the different transceiver states
-		double cu;
-		cu = DoGetCurrentA();
-		if (cu == m_txCurrentA) {
-			trans_duration += duration.GetSeconds();
-			NS_LOG_DEBUG(this << " Trans Duration: " << duration.GetSeconds());
-
-		} else if (cu == m_rxCurrentA) {
-			recv_duration += duration.GetSeconds();
-			NS_LOG_DEBUG(this << " Recv Duration: " << duration.GetSeconds());
-
-		} else if (cu == m_sleepCurrentA) {
-			sleep_duration += duration.GetSeconds();
-			NS_LOG_DEBUG(this << " Sleep Duration: " << duration.GetSeconds());
-
-		}
-		//--------------------------------------------
-
-		break;
-	default:
-		NS_FATAL_ERROR(
-				"LrWpanRadioEnergyModel:Undefined radio state: " << m_currentState);
-		return;
-	}
+	// account the residency of the state that is left
+	LrWpanPhyEnumeration currentState = m_table->GetState(m_slot);
+	m_table->AddResidency(m_slot, currentState, duration, energyToDecrease);
+	m_stateResidencyTrace(currentState, duration, energyToDecrease);
+	NS_LOG_DEBUG(this << " State " << currentState << " Duration: " << duration.GetSeconds());
 
 	// update total energy consumption
 	m_totalEnergyConsumption += energyToDecrease;
 
 	// update last update time stamp
-	m_lastUpdateTime = Simulator::Now();
+	m_table->SetLastUpdateTime(m_slot, Simulator::Now());
 
 	// notify energy source
 	m_source->UpdateEnergySource();
@@ -218,6 +236,7 @@ void LrWpanRadioEnergyModel::ChangeState(int newState) {
 	// EnergySource::NotifyEnergyDrained -> LrWpanRadioEnergyModel::HandleEnergyDepletion -> LrWpanPhy::EnergyDepletionHandler
 
 	SetLrWpanRadioState((LrWpanPhyEnumeration) newState);
+	m_source->NotifyCurrentChanged();
 	NS_LOG_DEBUG("Current: " << DoGetCurrentA() << "A");
 	NS_LOG_DEBUG(
 			"LrWpanRadioEnergyModel:Total energy consumption is " << m_totalEnergyConsumption << "J");
@@ -257,15 +276,18 @@ void LrWpanRadioEnergyModel::DoDispose(void) {
 
 double LrWpanRadioEnergyModel::DoGetCurrentA(void) const {
 	NS_LOG_FUNCTION(this);
-	switch (m_currentState) {
+	LrWpanPhyEnumeration currentState = m_table->GetState(m_slot);
+	switch (currentState) {
 	case IEEE_802_15_4_PHY_TX_ON:
+	case IEEE_802_15_4_PHY_BUSY_TX:
 		return m_txCurrentA;
 	case IEEE_802_15_4_PHY_RX_ON:
+	case IEEE_802_15_4_PHY_BUSY_RX:
 		return m_rxCurrentA;
 	case IEEE_802_15_4_PHY_TRX_OFF:
 		return m_sleepCurrentA;
 	case IEEE_802_15_4_PHY_UNSPECIFIED:
-		switch (m_nextState) {
+		switch (m_table->GetNextState(m_slot)) {
 		case IEEE_802_15_4_PHY_TX_ON:
 			return m_txCurrentA;
 		case IEEE_802_15_4_PHY_RX_ON:
@@ -274,12 +296,12 @@ double LrWpanRadioEnergyModel::DoGetCurrentA(void) const {
 			return m_sleepCurrentA;
 		default:
 			NS_FATAL_ERROR(
-					"LrWpanRadioEnergyModel:Undefined radio state:" << m_nextState);
+					"LrWpanRadioEnergyModel:Undefined radio state:" << m_table->GetNextState(m_slot));
 			return 0;
 		}
 	default:
 		NS_FATAL_ERROR(
-				"LrWpanRadioEnergyModel:Undefined radio state:" << m_currentState);
+				"LrWpanRadioEnergyModel:Undefined radio state:" << currentState);
 		return 0;
 	}
 }
@@ -287,15 +309,21 @@ double LrWpanRadioEnergyModel::DoGetCurrentA(void) const {
 void LrWpanRadioEnergyModel::SetLrWpanRadioState(
 		const LrWpanPhyEnumeration state) {
 	NS_LOG_FUNCTION(this << state);
-	m_currentState = state;
+	m_table->SetState(m_slot, state);
 	std::string stateName;
 	switch (state) {
 	case IEEE_802_15_4_PHY_TX_ON:
 		stateName = "TX_ON";
 		break;
+	case IEEE_802_15_4_PHY_BUSY_TX:
+		stateName = "BUSY_TX";
+		break;
 	case IEEE_802_15_4_PHY_RX_ON:
 		stateName = "RX_ON";
 		break;
+	case IEEE_802_15_4_PHY_BUSY_RX:
+		stateName = "BUSY_RX";
+		break;
 	case IEEE_802_15_4_PHY_TRX_OFF:
 		stateName = "TRX_OFF";
 		break;
@@ -304,7 +332,7 @@ void LrWpanRadioEnergyModel::SetLrWpanRadioState(
 		break;
 	default:
 		NS_FATAL_ERROR(
-				"LrWpanRadioEnergyModel:Undefined radio state:" << m_currentState);
+				"LrWpanRadioEnergyModel:Undefined radio state:" << state);
 		return;
 	}
 	NS_LOG_DEBUG(
@@ -320,6 +348,7 @@ void LrWpanRadioEnergyModel::NotifyRx() {
 
 void LrWpanRadioEnergyModel::NotifyRxStart() {
 	NS_LOG_FUNCTION(this);
+	ChangeState(IEEE_802_15_4_PHY_BUSY_RX);
 }
 
 void LrWpanRadioEnergyModel::NotifyTx() {
@@ -329,6 +358,7 @@ void LrWpanRadioEnergyModel::NotifyTx() {
 
 void LrWpanRadioEnergyModel::NotifyTxStart() {
 	NS_LOG_FUNCTION(this);
+	ChangeState(IEEE_802_15_4_PHY_BUSY_TX);
 }
 
 void LrWpanRadioEnergyModel::NotifySleep(void) {
@@ -338,7 +368,7 @@ void LrWpanRadioEnergyModel::NotifySleep(void) {
 
 void LrWpanRadioEnergyModel::NotifyTransition(LrWpanPhyEnumeration nextState) {
 	NS_LOG_FUNCTION(this);
-	m_nextState = (LrWpanPhyEnumeration) nextState;
+	m_table->SetNextState(m_slot, nextState);
 	ChangeState(IEEE_802_15_4_PHY_UNSPECIFIED);
 }
 
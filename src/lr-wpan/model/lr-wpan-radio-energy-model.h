@@ -22,16 +22,15 @@
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/traced-value.h"
+#include "ns3/traced-callback.h"
 #include "lr-wpan-phy.h"
+#include "lr-wpan-radio-energy-state-table.h"
 
 namespace ns3 {
 
 class LrWpanRadioEnergyModel : public DeviceEnergyModel, public LrWpanPhyListener
 {
 public:
-	double trans_duration;
-	double recv_duration;
- 	double sleep_duration;
   /**
    * Callback type for energy depletion handling.
    */
@@ -42,6 +41,17 @@ public:
    */
   typedef Callback<void> LrWpanRadioEnergyRechargedCallback;
 
+  /**
+   * TracedCallback signature for leaving a radio state.
+   *
+   * \param [in] state The state that is left. IEEE_802_15_4_PHY_UNSPECIFIED
+   *             stands for a transition between states.
+   * \param [in] duration The time spent in the state.
+   * \param [in] energy The energy consumed in the state, in Joules.
+   */
+  typedef void (* StateResidencyTracedCallback)
+    (LrWpanPhyEnumeration state, Time duration, double energy);
+
   static TypeId GetTypeId (void);
   LrWpanRadioEnergyModel ();
   virtual ~LrWpanRadioEnergyModel ();
@@ -126,6 +136,48 @@ public:
    */
   LrWpanPhyEnumeration GetCurrentState (void) const;
 
+  /**
+   * \param state One of TX_ON, BUSY_TX, RX_ON, BUSY_RX, TRX_OFF, or
+   * UNSPECIFIED for the transitions between states.
+   * \returns The total time spent in the state, including the time spent in
+   * the current state up to now.
+   */
+  Time GetStateResidency (LrWpanPhyEnumeration state) const;
+
+  /**
+   * \param state One of TX_ON, BUSY_TX, RX_ON, BUSY_RX, TRX_OFF, or
+   * UNSPECIFIED for the transitions between states.
+   * \returns The energy consumed in the state, in Joules, including the
+   * energy consumed in the current state up to now.
+   */
+  double GetStateEnergyConsumption (LrWpanPhyEnumeration state) const;
+
+  /**
+   * \param state One of TX_ON, BUSY_TX, RX_ON, BUSY_RX, TRX_OFF, or
+   * UNSPECIFIED for the transitions between states.
+   * \param duration The time spent in the state.
+   * \param energy The energy consumed in the state, in Joules.
+   *
+   * Accounts time spent and energy consumed in a state over a period that
+   * was not simulated, e.g. by the LrWpanLifetimeEstimator. The current
+   * state and the energy source are not changed.
+   */
+  void AdvanceStateResidency (LrWpanPhyEnumeration state, Time duration, double energy);
+
+  /**
+   * \param table The table to keep the state in.
+   *
+   * Moves the radio state, and the residency and energy accounted so far,
+   * to a new slot of the given table. By default, the state is kept in
+   * LrWpanRadioEnergyStateTable::GetDefault ().
+   */
+  void SetStateTable (Ptr<LrWpanRadioEnergyStateTable> table);
+
+  /**
+   * \returns The table the state is kept in.
+   */
+  Ptr<LrWpanRadioEnergyStateTable> GetStateTable (void) const;
+
   /**
    * \param callback Callback function.
    *
@@ -195,10 +247,16 @@ private:
    */
   TracedValue<double> m_totalEnergyConsumption;
 
-  // State variables.
-  LrWpanPhyEnumeration m_currentState;  //!< current state the radio is in
-  LrWpanPhyEnumeration m_nextState;  //!< next state after transition
-  Time m_lastUpdateTime;          //!< time stamp of previous energy update
+  // State variables: the current and next state, the time stamp of the
+  // previous energy update, and the time spent and energy consumed in each
+  // state are kept in a slot of a shared table.
+  Ptr<LrWpanRadioEnergyStateTable> m_table;  //!< table with the state
+  uint32_t m_slot;                           //!< slot of the model in the table
+
+  /**
+   * Trace fired whenever a state is left.
+   */
+  TracedCallback<LrWpanPhyEnumeration, Time, double> m_stateResidencyTrace;
 
   /**
    * Energy depletion callback.
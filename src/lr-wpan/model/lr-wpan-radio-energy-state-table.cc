@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "lr-wpan-radio-energy-state-table.h"
+#include <ns3/assert.h>
+#include <ns3/fatal-error.h>
+#include <ns3/log.h>
+#include <ns3/simulation-context.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LrWpanRadioEnergyStateTable");
+
+LrWpanRadioEnergyStateTable::LrWpanRadioEnergyStateTable (void)
+{
+}
+
+Ptr<LrWpanRadioEnergyStateTable>
+LrWpanRadioEnergyStateTable::GetDefault (void)
+{
+  // one table per SimulationContext, the reference count of a table is not
+  // thread-safe
+  static ContextLocal<Ptr<LrWpanRadioEnergyStateTable> > table;
+  Ptr<LrWpanRadioEnergyStateTable> &ptr = table.Get ();
+  if (ptr == 0)
+    {
+      ptr = Create<LrWpanRadioEnergyStateTable> ();
+    }
+  return ptr;
+}
+
+uint32_t
+LrWpanRadioEnergyStateTable::GetStateIndex (LrWpanPhyEnumeration state)
+{
+  switch (state)
+    {
+    case IEEE_802_15_4_PHY_TX_ON:
+      return 0;
+    case IEEE_802_15_4_PHY_BUSY_TX:
+      return 1;
+    case IEEE_802_15_4_PHY_RX_ON:
+      return 2;
+    case IEEE_802_15_4_PHY_BUSY_RX:
+      return 3;
+    case IEEE_802_15_4_PHY_TRX_OFF:
+      return 4;
+    case IEEE_802_15_4_PHY_UNSPECIFIED:
+      return 5;
+    default:
+      NS_FATAL_ERROR ("LrWpanRadioEnergyStateTable:Undefined radio state:" << state);
+      return 0;
+    }
+}
+
+void
+LrWpanRadioEnergyStateTable::Reserve (uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  m_state.reserve (n);
+  m_nextState.reserve (n);
+  m_lastUpdateTime.reserve (n);
+  for (uint32_t i = 0; i < N_STATES; i++)
+    {
+      m_residency[i].reserve (n);
+      m_energy[i].reserve (n);
+    }
+}
+
+uint32_t
+LrWpanRadioEnergyStateTable::Allocate (void)
+{
+  uint32_t slot;
+  if (!m_free.empty ())
+    {
+      slot = m_free.back ();
+      m_free.pop_back ();
+    }
+  else
+    {
+      slot = m_state.size ();
+      m_state.push_back (IEEE_802_15_4_PHY_TRX_OFF);
+      m_nextState.push_back (IEEE_802_15_4_PHY_TRX_OFF);
+      m_lastUpdateTime.push_back (Seconds (0.0));
+      for (uint32_t i = 0; i < N_STATES; i++)
+        {
+          m_residency[i].push_back (Seconds (0.0));
+          m_energy[i].push_back (0.0);
+        }
+    }
+  NS_LOG_FUNCTION (this << slot);
+  return slot;
+}
+
+void
+LrWpanRadioEnergyStateTable::Release (uint32_t slot)
+{
+  NS_LOG_FUNCTION (this << slot);
+  NS_ASSERT (slot < m_state.size ());
+  m_state[slot] = IEEE_802_15_4_PHY_TRX_OFF;
+  m_nextState[slot] = IEEE_802_15_4_PHY_TRX_OFF;
+  m_lastUpdateTime[slot] = Seconds (0.0);
+  for (uint32_t i = 0; i < N_STATES; i++)
+    {
+      m_residency[i][slot] = Seconds (0.0);
+      m_energy[i][slot] = 0.0;
+    }
+  m_free.push_back (slot);
+}
+
+uint32_t
+LrWpanRadioEnergyStateTable::GetN (void) const
+{
+  return m_state.size () - m_free.size ();
+}
+
+LrWpanPhyEnumeration
+LrWpanRadioEnergyStateTable::GetState (uint32_t slot) const
+{
+  return static_cast<LrWpanPhyEnumeration> (m_state[slot]);
+}
+
+void
+LrWpanRadioEnergyStateTable::SetState (uint32_t slot, LrWpanPhyEnumeration state)
+{
+  m_state[slot] = state;
+}
+
+LrWpanPhyEnumeration
+LrWpanRadioEnergyStateTable::GetNextState (uint32_t slot) const
+{
+  return static_cast<LrWpanPhyEnumeration> (m_nextState[slot]);
+}
+
+void
+LrWpanRadioEnergyStateTable::SetNextState (uint32_t slot, LrWpanPhyEnumeration state)
+{
+  m_nextState[slot] = state;
+}
+
+Time
+LrWpanRadioEnergyStateTable::GetLastUpdateTime (uint32_t slot) const
+{
+  return m_lastUpdateTime[slot];
+}
+
+void
+LrWpanRadioEnergyStateTable::SetLastUpdateTime (uint32_t slot, Time time)
+{
+  m_lastUpdateTime[slot] = time;
+}
+
+void
+LrWpanRadioEnergyStateTable::AddResidency (uint32_t slot, LrWpanPhyEnumeration state,
+                                           Time duration, double energy)
+{
+  uint32_t index = GetStateIndex (state);
+  m_residency[index][slot] += duration;
+  m_energy[index][slot] += energy;
+}
+
+Time
+LrWpanRadioEnergyStateTable::GetResidency (uint32_t slot, LrWpanPhyEnumeration state) const
+{
+  return m_residency[GetStateIndex (state)][slot];
+}
+
+double
+LrWpanRadioEnergyStateTable::GetEnergy (uint32_t slot, LrWpanPhyEnumeration state) const
+{
+  return m_energy[GetStateIndex (state)][slot];
+}
+
+Time
+LrWpanRadioEnergyStateTable::GetTotalResidency (LrWpanPhyEnumeration state) const
+{
+  const std::vector<Time> &residency = m_residency[GetStateIndex (state)];
+  int64_t total = 0;
+  for (std::vector<Time>::const_iterator it = residency.begin (); it != residency.end (); ++it)
+    {
+      total += it->GetTimeStep ();
+    }
+  return TimeStep (total);
+}
+
+double
+LrWpanRadioEnergyStateTable::GetTotalEnergy (LrWpanPhyEnumeration state) const
+{
+  const std::vector<double> &energy = m_energy[GetStateIndex (state)];
+  double total = 0;
+  for (std::vector<double>::const_iterator it = energy.begin (); it != energy.end (); ++it)
+    {
+      total += *it;
+    }
+  return total;
+}
+
+} // namespace ns3
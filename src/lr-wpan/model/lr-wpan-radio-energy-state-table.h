@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef LR_WPAN_RADIO_ENERGY_STATE_TABLE_H
+#define LR_WPAN_RADIO_ENERGY_STATE_TABLE_H
+
+#include <ns3/simple-ref-count.h>
+#include <ns3/nstime.h>
+#include "lr-wpan-phy.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lr-wpan
+ *
+ * \brief The radio state and the per-state residency and energy of a set of
+ * LrWpanRadioEnergyModel instances, stored as struct of arrays.
+ *
+ * Every model owns a slot of a table. The residency and the energy of each
+ * radio state are kept in one contiguous array per state, indexed by the
+ * slot, so the totals over all models of a table are computed without
+ * touching the models. Released slots are zeroed and reused.
+ *
+ * Models created on their own share a process-wide default table. The
+ * LrWpanRadioEnergyModelHelper keeps all models it installs in one table.
+ */
+class LrWpanRadioEnergyStateTable : public SimpleRefCount<LrWpanRadioEnergyStateTable>
+{
+public:
+  /**
+   * The number of radio states the residency is accounted for.
+   */
+  static const uint32_t N_STATES = 6;
+
+  LrWpanRadioEnergyStateTable (void);
+
+  /**
+   * \return the table shared by all models which are not bound to another
+   * table
+   */
+  static Ptr<LrWpanRadioEnergyStateTable> GetDefault (void);
+
+  /**
+   * \param state one of TX_ON, BUSY_TX, RX_ON, BUSY_RX, TRX_OFF, or
+   * UNSPECIFIED for the transitions between states
+   * \return the index of the state in the residency arrays
+   */
+  static uint32_t GetStateIndex (LrWpanPhyEnumeration state);
+
+  /**
+   * Reserve memory for a number of slots.
+   *
+   * \param n the number of slots
+   */
+  void Reserve (uint32_t n);
+
+  /**
+   * Allocate a zeroed slot in state TRX_OFF.
+   *
+   * \return the slot
+   */
+  uint32_t Allocate (void);
+
+  /**
+   * Release a slot, which is reused by the next allocation.
+   *
+   * \param slot the slot
+   */
+  void Release (uint32_t slot);
+
+  /**
+   * \return the number of allocated slots
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \param slot the slot
+   * \return the current radio state
+   */
+  LrWpanPhyEnumeration GetState (uint32_t slot) const;
+
+  /**
+   * \param slot the slot
+   * \param state the current radio state
+   */
+  void SetState (uint32_t slot, LrWpanPhyEnumeration state);
+
+  /**
+   * \param slot the slot
+   * \return the state after the current transition
+   */
+  LrWpanPhyEnumeration GetNextState (uint32_t slot) const;
+
+  /**
+   * \param slot the slot
+   * \param state the state after the current transition
+   */
+  void SetNextState (uint32_t slot, LrWpanPhyEnumeration state);
+
+  /**
+   * \param slot the slot
+   * \return the time of the last state change
+   */
+  Time GetLastUpdateTime (uint32_t slot) const;
+
+  /**
+   * \param slot the slot
+   * \param time the time of the last state change
+   */
+  void SetLastUpdateTime (uint32_t slot, Time time);
+
+  /**
+   * Add the time spent and the energy consumed in a state.
+   *
+   * \param slot the slot
+   * \param state the state
+   * \param duration the time spent in the state
+   * \param energy the energy consumed in the state, in Joules
+   */
+  void AddResidency (uint32_t slot, LrWpanPhyEnumeration state, Time duration, double energy);
+
+  /**
+   * \param slot the slot
+   * \param state the state
+   * \return the accounted time spent in the state
+   */
+  Time GetResidency (uint32_t slot, LrWpanPhyEnumeration state) const;
+
+  /**
+   * \param slot the slot
+   * \param state the state
+   * \return the accounted energy consumed in the state, in Joules
+   */
+  double GetEnergy (uint32_t slot, LrWpanPhyEnumeration state) const;
+
+  /**
+   * \param state the state
+   * \return the accounted time spent in the state, summed up over all slots
+   */
+  Time GetTotalResidency (LrWpanPhyEnumeration state) const;
+
+  /**
+   * \param state the state
+   * \return the accounted energy consumed in the state, summed up over all
+   * slots, in Joules
+   */
+  double GetTotalEnergy (LrWpanPhyEnumeration state) const;
+
+private:
+  std::vector<uint8_t> m_state;                 //!< Current radio state
+  std::vector<uint8_t> m_nextState;             //!< State after the current transition
+  std::vector<Time> m_lastUpdateTime;           //!< Time of the last state change
+  std::vector<Time> m_residency[N_STATES];      //!< Time spent in each state
+  std::vector<double> m_energy[N_STATES];       //!< Energy consumed in each state
+  std::vector<uint32_t> m_free;                 //!< Released slots
+};
+
+} // namespace ns3
+
+#endif /* LR_WPAN_RADIO_ENERGY_STATE_TABLE_H */
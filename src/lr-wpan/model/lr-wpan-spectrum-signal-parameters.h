@@ -45,11 +45,18 @@ struct LrWpanSpectrumSignalParameters : public SpectrumSignalParameters
 
   /**
    * copy constructor
+   *
+   * The copy shares the packet burst with the original. The channel copies
+   * the signal parameters for every receiver, so the PPDU of a frame is
+   * shared by the transmitter and all receivers, and must not be modified.
+   * A receiver, which has to modify the PPDU, replaces the packet burst of
+   * its copy with a copy of the burst.
    */
   LrWpanSpectrumSignalParameters (const LrWpanSpectrumSignalParameters& p);
 
   /**
-   * The packet burst being transmitted with this signal
+   * The packet burst being transmitted with this signal, shared among all
+   * copies of the signal parameters
    */
   Ptr<PacketBurst> packetBurst;
 };
@@ -188,8 +188,11 @@ LrWpanCollisionTestCase::DoRun (void)
 
   Simulator::Run ();
 
+  // The CCA of dev1 ends before the frame of dev2 is on the air, so both are
+  // sent. dev0 synchronizes to the weak frame of dev2, which the strong frame
+  // of dev1 destroys, and there are no retransmissions without ACKs.
   std::cout << "m_rxPackets = " << int(m_rxPackets) << std::endl;
-  NS_TEST_EXPECT_MSG_EQ (m_rxPackets, 1, "Received a packet (as expected)");
+  NS_TEST_EXPECT_MSG_EQ (m_rxPackets, 0, "Not received a packet (as expected)");
 
   // Fourth case: two concurrent tx and ACKs
   std::cout << "*** Fourth test " << std::endl;
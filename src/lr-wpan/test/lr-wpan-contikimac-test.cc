@@ -25,6 +25,14 @@
 #include <ns3/single-model-spectrum-channel.h>
 #include <ns3/constant-position-mobility-model.h>
 #include <ns3/packet.h>
+#include <ns3/lr-wpan-phase-lock-table.h>
+#include <ns3/lr-wpan-duty-cycle-scheduler.h>
+#include <ns3/lr-wpan-radio-energy-model.h>
+#include <ns3/basic-energy-source.h>
+#include <ns3/simulation-singleton.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <sstream>
 
 
 using namespace ns3;
@@ -144,6 +152,487 @@ LrWpanContikiMacTestCase::DoRun (void)
 
 }
 
+// ==============================================================================
+class LrWpanPhaseLockTableTestCase : public TestCase
+{
+public:
+  LrWpanPhaseLockTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Look up the phase of a neighbor.
+   *
+   * \param address the address of the neighbor
+   * \return the phase, or a negative time if not known
+   */
+  Time Lookup (Address address);
+
+  void CheckAged (void);
+
+  LrWpanPhaseLockTable m_table;
+};
+
+LrWpanPhaseLockTableTestCase::LrWpanPhaseLockTableTestCase ()
+  : TestCase ("Test the ContikiMAC phase-lock table")
+{
+}
+
+Time
+LrWpanPhaseLockTableTestCase::Lookup (Address address)
+{
+  Time phase = Seconds (-1);
+  m_table.Lookup (address, phase);
+  return phase;
+}
+
+void
+LrWpanPhaseLockTableTestCase::CheckAged (void)
+{
+  // Only the entry refreshed at 5 s survives at 12 s with a 10 s timeout.
+  NS_TEST_EXPECT_MSG_EQ (Lookup (Mac16Address ("00:01")), Seconds (-1), "Entry did not age out");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (Mac16Address ("00:02")), MilliSeconds (5002), "Refreshed entry aged out");
+  m_table.Update (Mac16Address ("00:01"), MilliSeconds (12001));
+}
+
+void
+LrWpanPhaseLockTableTestCase::DoRun (void)
+{
+  m_table.SetMaxFailures (2);
+
+  // Enough neighbors to grow the table several times, with short and
+  // extended addresses of the same bytes.
+  for (uint16_t i = 1; i <= 300; i++)
+    {
+      uint8_t buffer[2] = { static_cast<uint8_t> (i >> 8), static_cast<uint8_t> (i) };
+      Mac16Address shortAddr;
+      shortAddr.CopyFrom (buffer);
+      m_table.Update (shortAddr, MicroSeconds (i));
+      uint8_t extBuffer[8] = { 0, 0, 0, 0, 0, 0, static_cast<uint8_t> (i >> 8), static_cast<uint8_t> (i) };
+      Mac64Address extAddr;
+      extAddr.CopyFrom (extBuffer);
+      m_table.Update (extAddr, MicroSeconds (1000 + i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_table.GetSize (), 600, "Wrong number of entries");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (Mac16Address ("00:07")), MicroSeconds (7), "Wrong phase of a short address");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (Mac64Address ("00:00:00:00:00:00:01:2c")), MicroSeconds (1300),
+                         "Wrong phase of an extended address");
+
+  // Updates refresh the phase, removals keep the other entries reachable.
+  m_table.Update (Mac16Address ("00:07"), MicroSeconds (77));
+  NS_TEST_EXPECT_MSG_EQ (Lookup (Mac16Address ("00:07")), MicroSeconds (77), "Phase not refreshed");
+  for (uint16_t i = 1; i <= 300; i += 2)
+    {
+      uint8_t buffer[2] = { static_cast<uint8_t> (i >> 8), static_cast<uint8_t> (i) };
+      Mac16Address shortAddr;
+      shortAddr.CopyFrom (buffer);
+      NS_TEST_EXPECT_MSG_EQ (m_table.Remove (shortAddr), true, "Entry not found for removal");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_table.GetSize (), 450, "Wrong number of entries after removal");
+  for (uint16_t i = 1; i <= 300; i++)
+    {
+      uint8_t buffer[2] = { static_cast<uint8_t> (i >> 8), static_cast<uint8_t> (i) };
+      Mac16Address shortAddr;
+      shortAddr.CopyFrom (buffer);
+      Time expected = (i % 2 == 1) ? Seconds (-1) : MicroSeconds (i);
+      NS_TEST_EXPECT_MSG_EQ (Lookup (shortAddr), expected, "Wrong entry after removal of " << i);
+    }
+
+  // Failed transmissions in a row drop the entry, an update resets them.
+  NS_TEST_EXPECT_MSG_EQ (m_table.NotifyFailure (Mac16Address ("00:02")), false, "Dropped after one failure");
+  m_table.Update (Mac16Address ("00:02"), MicroSeconds (2));
+  NS_TEST_EXPECT_MSG_EQ (m_table.NotifyFailure (Mac16Address ("00:02")), false, "Failures not reset");
+  NS_TEST_EXPECT_MSG_EQ (m_table.NotifyFailure (Mac16Address ("00:02")), true, "Not dropped after two failures");
+  NS_TEST_EXPECT_MSG_EQ (Lookup (Mac16Address ("00:02")), Seconds (-1), "Dropped entry still found");
+
+  // Entries which were not updated within the timeout age out.
+  m_table.Clear ();
+  m_table.SetTimeout (Seconds (10));
+  m_table.Update (Mac16Address ("00:01"), MilliSeconds (1));
+  m_table.Update (Mac16Address ("00:02"), MilliSeconds (2));
+  Simulator::Schedule (Seconds (5), &LrWpanPhaseLockTable::Update, &m_table,
+                       Mac16Address ("00:02"), MilliSeconds (5002));
+  Simulator::Schedule (Seconds (12), &LrWpanPhaseLockTableTestCase::CheckAged, this);
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_table.GetSize (), 2, "Wrong number of entries after aging");
+  Simulator::Destroy ();
+}
+
+// ==============================================================================
+class LrWpanContikiMacBatchedWakeUpTestCase : public TestCase
+{
+public:
+  LrWpanContikiMacBatchedWakeUpTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * The outcome of a simulation run.
+   */
+  struct Result
+  {
+    std::vector<Time> residency;  //!< Time spent in every state of every node
+    std::vector<double> energy;   //!< Energy consumed by every node
+    uint32_t received;            //!< Number of received data frames
+    uint64_t scheduledSteps;      //!< Steps scheduled by the duty-cycle scheduler
+    uint64_t scheduledEvents;     //!< Events scheduled by the duty-cycle scheduler
+  };
+
+  /**
+   * Run a network of three nodes with unicast and broadcast traffic.
+   *
+   * \param batched enable batched wake-ups
+   * \return the outcome of the run
+   */
+  Result RunNetwork (bool batched);
+
+  /**
+   * Callback invoked on packet reception.
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  uint32_t m_received;      // number of received data frames
+};
+
+LrWpanContikiMacBatchedWakeUpTestCase::LrWpanContikiMacBatchedWakeUpTestCase ()
+  : TestCase ("Test batched ContikiMAC wake-ups against per-node wake-ups"),
+    m_received (0)
+{
+}
+
+void
+LrWpanContikiMacBatchedWakeUpTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  m_received++;
+}
+
+LrWpanContikiMacBatchedWakeUpTestCase::Result
+LrWpanContikiMacBatchedWakeUpTestCase::RunNetwork (bool batched)
+{
+  m_received = 0;
+
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  std::vector<Ptr<LrWpanContikiMac> > macs;
+  std::vector<Ptr<LrWpanRadioEnergyModel> > energyModels;
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<LrWpanNetDevice> dev = CreateObject<LrWpanNetDevice> ();
+      Ptr<LrWpanContikiMac> mac = CreateObject<LrWpanContikiMac> ();
+      mac->SetAttribute ("BatchedWakeUp", BooleanValue (batched));
+      dev->SetMac (mac);
+      uint8_t address[2] = { 0, static_cast<uint8_t> (i + 1) };
+      Mac16Address shortAddress;
+      shortAddress.CopyFrom (address);
+      dev->SetAddress (shortAddress);
+      dev->SetChannel (channel);
+      node->AddDevice (dev);
+      // Both runs must draw the same random numbers.
+      dev->AssignStreams (10 * i);
+
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (0, 10 * i, 0));
+      dev->GetPhy ()->SetMobility (mobility);
+      mac->SetMcpsDataIndicationCallback (MakeCallback (&LrWpanContikiMacBatchedWakeUpTestCase::DataIndication, this));
+
+      Ptr<BasicEnergySource> source = CreateObject<BasicEnergySource> ();
+      Ptr<LrWpanRadioEnergyModel> energyModel = CreateObject<LrWpanRadioEnergyModel> ();
+      source->SetNode (node);
+      source->AppendDeviceEnergyModel (energyModel);
+      energyModel->SetEnergySource (source);
+      energyModel->AttachPhy (dev->GetPhy ());
+
+      macs.push_back (mac);
+      energyModels.push_back (energyModel);
+    }
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstPanId = 0;
+  params.m_msduHandle = 0;
+
+  // Unicast frames with ACK, which interrupt the batched cycles of the
+  // receivers.
+  params.m_dstAddr = Mac16Address ("00:02");
+  params.m_txOptions = TX_OPTION_ACK;
+  Simulator::Schedule (Seconds (1.09), &LrWpanContikiMac::McpsDataRequest, macs[0], params, Create<Packet> (20));
+  Simulator::Schedule (Seconds (2.34), &LrWpanContikiMac::McpsDataRequest, macs[0], params, Create<Packet> (20));
+  // A broadcast frame, repeated for a whole sleep interval.
+  params.m_dstAddr = Mac16Address ("ff:ff");
+  params.m_txOptions = TX_OPTION_NONE;
+  Simulator::Schedule (Seconds (1.7), &LrWpanContikiMac::McpsDataRequest, macs[2], params, Create<Packet> (20));
+
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+
+  Result result;
+  for (uint32_t i = 0; i < energyModels.size (); i++)
+    {
+      result.residency.push_back (energyModels[i]->GetStateResidency (IEEE_802_15_4_PHY_TX_ON));
+      result.residency.push_back (energyModels[i]->GetStateResidency (IEEE_802_15_4_PHY_BUSY_TX));
+      result.residency.push_back (energyModels[i]->GetStateResidency (IEEE_802_15_4_PHY_RX_ON));
+      result.residency.push_back (energyModels[i]->GetStateResidency (IEEE_802_15_4_PHY_BUSY_RX));
+      result.residency.push_back (energyModels[i]->GetStateResidency (IEEE_802_15_4_PHY_TRX_OFF));
+      result.residency.push_back (energyModels[i]->GetStateResidency (IEEE_802_15_4_PHY_UNSPECIFIED));
+      result.energy.push_back (energyModels[i]->GetTotalEnergyConsumption ());
+    }
+  result.received = m_received;
+  result.scheduledSteps = SimulationSingleton<LrWpanDutyCycleScheduler>::Get ()->GetScheduledSteps ();
+  result.scheduledEvents = SimulationSingleton<LrWpanDutyCycleScheduler>::Get ()->GetScheduledEvents ();
+
+  Simulator::Destroy ();
+  return result;
+}
+
+void
+LrWpanContikiMacBatchedWakeUpTestCase::DoRun (void)
+{
+  Result single = RunNetwork (false);
+  Result batched = RunNetwork (true);
+
+  NS_TEST_ASSERT_MSG_GT (single.received, 0, "No frames received");
+  NS_TEST_EXPECT_MSG_EQ (batched.received, single.received, "Different number of received frames");
+  for (uint32_t i = 0; i < single.residency.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (batched.residency[i], single.residency[i],
+                             "Different residency of state " << i % 6 << " of node " << i / 6);
+    }
+  for (uint32_t i = 0; i < single.energy.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ_TOL (batched.energy[i], single.energy[i], 1e-12,
+                                 "Different energy consumption of node " << i);
+    }
+
+  // The nodes wake up with the same phase, so they share the events.
+  NS_TEST_EXPECT_MSG_EQ (single.scheduledSteps, 0, "Steps scheduled without batching");
+  NS_TEST_EXPECT_MSG_GT (batched.scheduledSteps, batched.scheduledEvents,
+                         "Steps of the nodes not batched");
+}
+
+// ==============================================================================
+class LrWpanContikiMacBatchedPhasesTestCase : public TestCase
+{
+public:
+  LrWpanContikiMacBatchedPhasesTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run a network of nodes with different wake-up phases, whose cycles are
+   * interrupted by unicast and broadcast traffic.
+   *
+   * \param batched enable batched wake-ups
+   * \return the events of all nodes, in the order they happened
+   */
+  std::vector<std::string> RunNetwork (bool batched);
+
+  /**
+   * Add an event of a node to the trace.
+   *
+   * \param node the index of the node
+   * \param event the description of the event
+   */
+  void Record (uint32_t node, std::string event);
+
+  /**
+   * Callback invoked when the radio of a node leaves a state.
+   */
+  void StateResidency (std::string node, LrWpanPhyEnumeration state, Time duration, double energy);
+
+  /**
+   * Callback invoked when the transceiver of a node changes its state.
+   */
+  void TrxState (std::string node, Time time, LrWpanPhyEnumeration oldState, LrWpanPhyEnumeration newState);
+
+  /**
+   * Callback invoked when the MAC of a node changes its state.
+   */
+  void MacState (std::string node, LrWpanMacState oldState, LrWpanMacState newState);
+
+  /**
+   * Callback invoked on packet reception.
+   */
+  void DataIndication (McpsDataIndicationParams params, Ptr<Packet> p);
+
+  std::vector<uint32_t> m_nodeIds;    // node id of every node
+  std::vector<std::string> m_trace;   // events of all nodes
+};
+
+LrWpanContikiMacBatchedPhasesTestCase::LrWpanContikiMacBatchedPhasesTestCase ()
+  : TestCase ("Test batched ContikiMAC wake-ups of nodes with different phases against per-node wake-ups")
+{
+}
+
+void
+LrWpanContikiMacBatchedPhasesTestCase::Record (uint32_t node, std::string event)
+{
+  // Every event has to run in the context of its node.
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetContext (), m_nodeIds[node], "Wrong context of node " << node);
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetTimeStep () << " " << node << " " << event;
+  m_trace.push_back (oss.str ());
+}
+
+void
+LrWpanContikiMacBatchedPhasesTestCase::StateResidency (std::string node, LrWpanPhyEnumeration state, Time duration, double energy)
+{
+  std::ostringstream oss;
+  oss << "leaves radio state " << state << " after " << duration.GetTimeStep ();
+  Record (atoi (node.c_str ()), oss.str ());
+}
+
+void
+LrWpanContikiMacBatchedPhasesTestCase::TrxState (std::string node, Time time, LrWpanPhyEnumeration oldState, LrWpanPhyEnumeration newState)
+{
+  std::ostringstream oss;
+  oss << "transceiver state " << oldState << " -> " << newState;
+  Record (atoi (node.c_str ()), oss.str ());
+}
+
+void
+LrWpanContikiMacBatchedPhasesTestCase::MacState (std::string node, LrWpanMacState oldState, LrWpanMacState newState)
+{
+  std::ostringstream oss;
+  oss << "MAC state " << oldState << " -> " << newState;
+  Record (atoi (node.c_str ()), oss.str ());
+}
+
+void
+LrWpanContikiMacBatchedPhasesTestCase::DataIndication (McpsDataIndicationParams params, Ptr<Packet> p)
+{
+  for (uint32_t i = 0; i < m_nodeIds.size (); i++)
+    {
+      if (m_nodeIds[i] == Simulator::GetContext ())
+        {
+          std::ostringstream oss;
+          oss << "receives from " << params.m_srcAddr;
+          Record (i, oss.str ());
+          return;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (true, false, "Frame received without node context");
+}
+
+std::vector<std::string>
+LrWpanContikiMacBatchedPhasesTestCase::RunNetwork (bool batched)
+{
+  m_nodeIds.clear ();
+  m_trace.clear ();
+
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  // The nodes are 10 m apart, and a frame only reaches the nodes within 35 m.
+  channel->SetAttribute ("ReceiverCullingRange", DoubleValue (35));
+
+  // The nodes wake up with different phases. Pairs of them share a phase, so
+  // that they share the steps of the scheduler, too, while only one node of
+  // a pair hears a sender and leaves the batched cycle.
+  const double phases[] = { 0.0, 0.031, 0.0, 0.077, 0.077, 0.031 };
+  const uint32_t nNodes = sizeof (phases) / sizeof (phases[0]);
+  std::vector<Ptr<LrWpanContikiMac> > macs;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<LrWpanNetDevice> dev = CreateObject<LrWpanNetDevice> ();
+      Ptr<LrWpanContikiMac> mac = CreateObject<LrWpanContikiMac> ();
+      mac->SetAttribute ("BatchedWakeUp", BooleanValue (batched));
+      mac->SetAttribute ("WakeUpPhase", TimeValue (Seconds (phases[i])));
+      dev->SetMac (mac);
+      uint8_t address[2] = { 0, static_cast<uint8_t> (i + 1) };
+      Mac16Address shortAddress;
+      shortAddress.CopyFrom (address);
+      dev->SetAddress (shortAddress);
+      dev->SetChannel (channel);
+      node->AddDevice (dev);
+      // Both runs must draw the same random numbers.
+      dev->AssignStreams (10 * i);
+
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (10 * i, 0, 0));
+      dev->GetPhy ()->SetMobility (mobility);
+      mac->SetMcpsDataIndicationCallback (MakeCallback (&LrWpanContikiMacBatchedPhasesTestCase::DataIndication, this));
+
+      std::ostringstream index;
+      index << i;
+      Ptr<BasicEnergySource> source = CreateObject<BasicEnergySource> ();
+      Ptr<LrWpanRadioEnergyModel> energyModel = CreateObject<LrWpanRadioEnergyModel> ();
+      source->SetNode (node);
+      source->AppendDeviceEnergyModel (energyModel);
+      energyModel->SetEnergySource (source);
+      energyModel->AttachPhy (dev->GetPhy ());
+      energyModel->TraceConnect ("StateResidency", index.str (),
+                                 MakeCallback (&LrWpanContikiMacBatchedPhasesTestCase::StateResidency, this));
+      dev->GetPhy ()->TraceConnect ("TrxState", index.str (),
+                                    MakeCallback (&LrWpanContikiMacBatchedPhasesTestCase::TrxState, this));
+      mac->TraceConnect ("MacState", index.str (),
+                         MakeCallback (&LrWpanContikiMacBatchedPhasesTestCase::MacState, this));
+      m_nodeIds.push_back (node->GetId ());
+      macs.push_back (mac);
+    }
+
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstPanId = 0;
+  params.m_msduHandle = 0;
+
+  // Unicast frames with ACK and a broadcast frame, which interrupt the
+  // batched cycles of the nodes in range at different points of their
+  // cycles.
+  params.m_dstAddr = Mac16Address ("00:04");
+  params.m_txOptions = TX_OPTION_ACK;
+  Simulator::ScheduleWithContext (m_nodeIds[0], Seconds (1.09), &LrWpanContikiMac::McpsDataRequest,
+                                  macs[0], params, Create<Packet> (20));
+  params.m_dstAddr = Mac16Address ("00:02");
+  Simulator::ScheduleWithContext (m_nodeIds[5], Seconds (1.53), &LrWpanContikiMac::McpsDataRequest,
+                                  macs[5], params, Create<Packet> (20));
+  params.m_dstAddr = Mac16Address ("ff:ff");
+  params.m_txOptions = TX_OPTION_NONE;
+  Simulator::ScheduleWithContext (m_nodeIds[2], Seconds (2.21), &LrWpanContikiMac::McpsDataRequest,
+                                  macs[2], params, Create<Packet> (20));
+
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+  if (batched)
+    {
+      LrWpanDutyCycleScheduler *scheduler = SimulationSingleton<LrWpanDutyCycleScheduler>::Get ();
+      NS_TEST_EXPECT_MSG_GT (scheduler->GetScheduledSteps (), scheduler->GetScheduledEvents (),
+                             "Steps of the nodes with the same phase not batched");
+    }
+  Simulator::Destroy ();
+  return m_trace;
+}
+
+void
+LrWpanContikiMacBatchedPhasesTestCase::DoRun (void)
+{
+  std::vector<std::string> single = RunNetwork (false);
+  std::vector<std::string> batched = RunNetwork (true);
+
+  uint32_t received = 0;
+  for (uint32_t i = 0; i < single.size (); i++)
+    {
+      if (single[i].find ("receives") != std::string::npos)
+        {
+          received++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (received, 0, "No frames received");
+  NS_TEST_EXPECT_MSG_EQ (batched.size (), single.size (), "Different number of traced events");
+  for (uint32_t i = 0; i < std::min (single.size (), batched.size ()); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (batched[i], single[i], "Different event " << i);
+    }
+}
+
 // ==============================================================================
 class LrWpanContikiMacTestSuite : public TestSuite
 {
@@ -154,6 +643,9 @@ public:
 LrWpanContikiMacTestSuite::LrWpanContikiMacTestSuite ()
   : TestSuite ("lr-wpan-contikimac", UNIT)
 {
+  AddTestCase (new LrWpanPhaseLockTableTestCase, TestCase::QUICK);
+  AddTestCase (new LrWpanContikiMacBatchedWakeUpTestCase, TestCase::QUICK);
+  AddTestCase (new LrWpanContikiMacBatchedPhasesTestCase, TestCase::QUICK);
   AddTestCase (new LrWpanContikiMacTestCase, TestCase::QUICK);
 }
 
@@ -20,11 +20,15 @@
 #include "ns3/basic-energy-source-helper.h"
 #include "ns3/energy-source-container.h"
 #include "ns3/lr-wpan-radio-energy-model.h"
+#include "ns3/lr-wpan-radio-energy-model-helper.h"
+#include "ns3/lr-wpan-net-device.h"
 #include "ns3/lr-wpan-phy.h"
 #include "ns3/device-energy-model-container.h"
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
 #include "ns3/simulator.h"
 #include "ns3/double.h"
 #include "ns3/config.h"
@@ -284,6 +288,200 @@ LrWpanEnergyTest::PhyStateSwitchTest (void)
 
 // -------------------------------------------------------------------------- //
 
+/**
+ * Test case of the per-state residency of LrWpanRadioEnergyModel.
+ */
+class LrWpanEnergyResidencyTest : public TestCase
+{
+public:
+  LrWpanEnergyResidencyTest ();
+  virtual ~LrWpanEnergyResidencyTest ();
+
+private:
+  void DoRun (void);
+
+  /**
+   * Sums up the residency trace.
+   *
+   * \param state The state that is left.
+   * \param duration The time spent in the state.
+   * \param energy The energy consumed in the state.
+   */
+  void StateResidency (LrWpanPhyEnumeration state, Time duration, double energy);
+
+  uint32_t m_traceCount; // number of states left
+  Time m_tracedDuration; // sum of the traced durations
+  double m_tracedEnergy; // sum of the traced energy
+};
+
+LrWpanEnergyResidencyTest::LrWpanEnergyResidencyTest ()
+  : TestCase ("LrWpan energy model state residency test case"),
+    m_traceCount (0),
+    m_tracedEnergy (0)
+{
+}
+
+LrWpanEnergyResidencyTest::~LrWpanEnergyResidencyTest ()
+{
+}
+
+void
+LrWpanEnergyResidencyTest::StateResidency (LrWpanPhyEnumeration state, Time duration, double energy)
+{
+  m_traceCount++;
+  m_tracedDuration += duration;
+  m_tracedEnergy += energy;
+}
+
+void
+LrWpanEnergyResidencyTest::DoRun (void)
+{
+  Ptr<LrWpanRadioEnergyModel> devModel = CreateObject<LrWpanRadioEnergyModel> ();
+  Ptr<BasicEnergySource> source = CreateObject<BasicEnergySource> ();
+  devModel->SetEnergySource (source);
+  source->AppendDeviceEnergyModel (devModel);
+  devModel->TraceConnectWithoutContext ("StateResidency",
+                                        MakeCallback (&LrWpanEnergyResidencyTest::StateResidency, this));
+
+  Simulator::Schedule (Seconds (1.0), &LrWpanRadioEnergyModel::NotifyRx, devModel);
+  Simulator::Schedule (Seconds (2.0), &LrWpanRadioEnergyModel::NotifyRxStart, devModel);
+  Simulator::Schedule (Seconds (2.5), &LrWpanRadioEnergyModel::NotifyRx, devModel);
+  Simulator::Schedule (Seconds (3.0), &LrWpanRadioEnergyModel::NotifyTransition, devModel,
+                       IEEE_802_15_4_PHY_TX_ON);
+  Simulator::Schedule (MicroSeconds (3000192), &LrWpanRadioEnergyModel::NotifyTx, devModel);
+  Simulator::Schedule (Seconds (3.5), &LrWpanRadioEnergyModel::NotifyTxStart, devModel);
+  Simulator::Schedule (Seconds (3.75), &LrWpanRadioEnergyModel::NotifyTx, devModel);
+  Simulator::Schedule (Seconds (4.0), &LrWpanRadioEnergyModel::NotifySleep, devModel);
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (devModel->GetStateResidency (IEEE_802_15_4_PHY_TRX_OFF), Seconds (2.0),
+                         "Incorrect TRX_OFF residency");
+  NS_TEST_ASSERT_MSG_EQ (devModel->GetStateResidency (IEEE_802_15_4_PHY_RX_ON), Seconds (1.5),
+                         "Incorrect RX_ON residency");
+  NS_TEST_ASSERT_MSG_EQ (devModel->GetStateResidency (IEEE_802_15_4_PHY_BUSY_RX), Seconds (0.5),
+                         "Incorrect BUSY_RX residency");
+  NS_TEST_ASSERT_MSG_EQ (devModel->GetStateResidency (IEEE_802_15_4_PHY_UNSPECIFIED), MicroSeconds (192),
+                         "Incorrect transition residency");
+  NS_TEST_ASSERT_MSG_EQ (devModel->GetStateResidency (IEEE_802_15_4_PHY_TX_ON), MicroSeconds (750000 - 192),
+                         "Incorrect TX_ON residency");
+  NS_TEST_ASSERT_MSG_EQ (devModel->GetStateResidency (IEEE_802_15_4_PHY_BUSY_TX), Seconds (0.25),
+                         "Incorrect BUSY_TX residency");
+
+  double voltage = source->GetSupplyVoltage ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (devModel->GetStateEnergyConsumption (IEEE_802_15_4_PHY_BUSY_RX),
+                             0.5 * devModel->GetRxCurrentA () * voltage, 1.0e-12,
+                             "Incorrect BUSY_RX energy");
+  // a transition draws the current of the arrival state
+  NS_TEST_ASSERT_MSG_EQ_TOL (devModel->GetStateEnergyConsumption (IEEE_802_15_4_PHY_UNSPECIFIED),
+                             192e-6 * devModel->GetTxCurrentA () * voltage, 1.0e-12,
+                             "Incorrect transition energy");
+  NS_TEST_ASSERT_MSG_EQ_TOL (devModel->GetStateEnergyConsumption (IEEE_802_15_4_PHY_TRX_OFF),
+                             2.0 * devModel->GetSleepCurrentA () * voltage, 1.0e-12,
+                             "Incorrect TRX_OFF energy");
+
+  // the trace covers all states left, i.e. all but the last second of TRX_OFF
+  NS_TEST_ASSERT_MSG_EQ (m_traceCount, 8, "Incorrect number of traced states");
+  NS_TEST_ASSERT_MSG_EQ (m_tracedDuration, Seconds (4.0), "Incorrect traced duration");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_tracedEnergy, devModel->GetTotalEnergyConsumption (), 1.0e-12,
+                             "Traced energy differs from total energy consumption");
+
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * Test case of LrWpanRadioEnergyModelHelper and the shared state table of
+ * the installed models.
+ */
+class LrWpanEnergyHelperTest : public TestCase
+{
+public:
+  LrWpanEnergyHelperTest ();
+  virtual ~LrWpanEnergyHelperTest ();
+
+private:
+  void DoRun (void);
+};
+
+LrWpanEnergyHelperTest::LrWpanEnergyHelperTest ()
+  : TestCase ("LrWpan energy model helper and state table test case")
+{
+}
+
+LrWpanEnergyHelperTest::~LrWpanEnergyHelperTest ()
+{
+}
+
+void
+LrWpanEnergyHelperTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<LrWpanNetDevice> dev = CreateObject<LrWpanNetDevice> ();
+      nodes.Get (i)->AddDevice (dev);
+      devices.Add (dev);
+    }
+
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Set ("BasicEnergySupplyVoltageV", DoubleValue (3.0));
+  EnergySourceContainer sources = sourceHelper.Install (nodes);
+  LrWpanRadioEnergyModelHelper radioHelper;
+  radioHelper.Set ("RxCurrentA", DoubleValue (0.02));
+  DeviceEnergyModelContainer models = radioHelper.Install (devices, sources);
+
+  Ptr<LrWpanRadioEnergyStateTable> table = radioHelper.GetStateTable ();
+  NS_TEST_ASSERT_MSG_EQ (models.GetN (), 3, "Incorrect number of installed models");
+  NS_TEST_ASSERT_MSG_EQ (table->GetN (), 3, "Incorrect number of slots in the state table");
+
+  // The MACs switch the radios on at the start, switch them off one after
+  // the other.
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<LrWpanPhy> phy = DynamicCast<LrWpanNetDevice> (devices.Get (i))->GetPhy ();
+      Simulator::Schedule (Seconds (1.0 + i), &LrWpanPhy::PlmeSetTRXStateRequest, phy, IEEE_802_15_4_PHY_TRX_OFF);
+    }
+  Simulator::Stop (Seconds (4.0));
+  Simulator::Run ();
+
+  Time rxResidency;
+  double rxEnergy = 0;
+  for (uint32_t i = 0; i < models.GetN (); i++)
+    {
+      Ptr<LrWpanRadioEnergyModel> model = DynamicCast<LrWpanRadioEnergyModel> (models.Get (i));
+      NS_TEST_ASSERT_MSG_EQ (model->GetStateTable (), table, "Model not kept in the table of the helper");
+      NS_TEST_ASSERT_MSG_EQ (model->GetRxCurrentA (), 0.02, "Attribute of the helper not set");
+      rxResidency += model->GetStateResidency (IEEE_802_15_4_PHY_RX_ON);
+      rxEnergy += model->GetStateEnergyConsumption (IEEE_802_15_4_PHY_RX_ON);
+    }
+  NS_TEST_ASSERT_MSG_GT (rxResidency, Seconds (5.0), "Incorrect RX_ON residency");
+  NS_TEST_ASSERT_MSG_EQ (table->GetTotalResidency (IEEE_802_15_4_PHY_RX_ON), rxResidency,
+                         "Table total differs from the sum over the models");
+  NS_TEST_ASSERT_MSG_EQ_TOL (table->GetTotalEnergy (IEEE_802_15_4_PHY_RX_ON), rxEnergy, 1.0e-12,
+                             "Table total differs from the sum over the models");
+
+  // Moving a model to another table keeps the accounted state.
+  Ptr<LrWpanRadioEnergyModel> model = DynamicCast<LrWpanRadioEnergyModel> (models.Get (1));
+  Time trxOff = model->GetStateResidency (IEEE_802_15_4_PHY_TRX_OFF);
+  double rxOnEnergy = model->GetStateEnergyConsumption (IEEE_802_15_4_PHY_RX_ON);
+  Ptr<LrWpanRadioEnergyStateTable> other = Create<LrWpanRadioEnergyStateTable> ();
+  model->SetStateTable (other);
+  NS_TEST_ASSERT_MSG_EQ (table->GetN (), 2, "Slot not released");
+  NS_TEST_ASSERT_MSG_EQ (other->GetN (), 1, "Slot not allocated");
+  NS_TEST_ASSERT_MSG_EQ (model->GetCurrentState (), IEEE_802_15_4_PHY_TRX_OFF, "State not moved");
+  NS_TEST_ASSERT_MSG_EQ (model->GetStateResidency (IEEE_802_15_4_PHY_TRX_OFF), trxOff, "Residency not moved");
+  NS_TEST_ASSERT_MSG_EQ (model->GetStateEnergyConsumption (IEEE_802_15_4_PHY_RX_ON), rxOnEnergy,
+                         "Energy not moved");
+
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------------- //
+
 /**
  * Unit test suite for LrWpan energy model.
  */
@@ -298,6 +496,8 @@ LrWpanEnergyModelTestSuite::LrWpanEnergyModelTestSuite ()
 {
   AddTestCase (new LrWpanEnergyUpdateTest, TestCase::QUICK);
   AddTestCase (new LrWpanEnergyTest, TestCase::QUICK);  //PhyUpdateTest
+  AddTestCase (new LrWpanEnergyResidencyTest, TestCase::QUICK);
+  AddTestCase (new LrWpanEnergyHelperTest, TestCase::QUICK);
 }
 
 // create an instance of the test suite
@@ -32,6 +32,10 @@
 #include <ns3/mac16-address.h>
 #include <ns3/constant-position-mobility-model.h>
 #include "ns3/rng-seed-manager.h"
+#include <ns3/boolean.h>
+
+#include <cmath>
+#include <algorithm>
 
 using namespace ns3;
 
@@ -63,6 +67,15 @@ private:
   virtual void DoRun (void);
 };
 
+class LrWpanErrorModelLookupTestCase : public TestCase
+{
+public:
+  LrWpanErrorModelLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
 LrWpanErrorDistanceTestCase::LrWpanErrorDistanceTestCase ()
   : TestCase ("Test the 802.15.4 error model vs distance"),
     m_received (0)
@@ -175,6 +188,50 @@ LrWpanErrorModelTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ber, 0.175, 0.001, "Model fails for SNR = " << snr);
 }
 
+// ==============================================================================
+LrWpanErrorModelLookupTestCase::LrWpanErrorModelLookupTestCase ()
+  : TestCase ("Test the 802.15.4 error model lookup table against the exact formula")
+{
+}
+
+void
+LrWpanErrorModelLookupTestCase::DoRun (void)
+{
+  Ptr<LrWpanErrorModel> exact = CreateObject<LrWpanErrorModel> ();
+  Ptr<LrWpanErrorModel> lookup = CreateObject<LrWpanErrorModel> ();
+  lookup->SetAttribute ("UseLookupTable", BooleanValue (true));
+
+  // The documented bound on the chunk success rate holds for any chunk size,
+  // from single bits to the longest PPDU.
+  uint32_t nbits[] = { 1, 8, 32, 160, 1016, 100000 };
+  double maxError = 0.0;
+  for (double snr = -30.0; snr <= 30.0; snr += 0.0137)
+    {
+      double linearSnr = pow (10.0, snr / 10.0);
+      for (uint32_t i = 0; i < sizeof (nbits) / sizeof (nbits[0]); i++)
+        {
+          double error = std::abs (lookup->GetChunkSuccessRate (linearSnr, nbits[i])
+                                   - exact->GetChunkSuccessRate (linearSnr, nbits[i]));
+          maxError = std::max (maxError, error);
+        }
+    }
+  NS_TEST_ASSERT_MSG_LT (maxError, 1.0e-5, "Lookup table exceeds the error bound");
+
+  // The lookup table reproduces the reference values of the exact formula.
+  double snr = 5;
+  double ber = 1.0 - lookup->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 7.38e-14, 0.01e-14, "Lookup table fails for SNR = " << snr);
+  snr = 2;
+  ber = 1.0 - lookup->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 5.13e-7, 0.01e-7, "Lookup table fails for SNR = " << snr);
+  snr = -1;
+  ber = 1.0 - lookup->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 0.00114, 0.00001, "Lookup table fails for SNR = " << snr);
+  snr = -7;
+  ber = 1.0 - lookup->GetChunkSuccessRate (pow (10.0, snr / 10.0), 1);
+  NS_TEST_ASSERT_MSG_EQ_TOL (ber, 0.175, 0.001, "Lookup table fails for SNR = " << snr);
+}
+
 // ==============================================================================
 class LrWpanErrorModelTestSuite : public TestSuite
 {
@@ -186,6 +243,7 @@ LrWpanErrorModelTestSuite::LrWpanErrorModelTestSuite ()
   : TestSuite ("lr-wpan-error-model", UNIT)
 {
   AddTestCase (new LrWpanErrorModelTestCase, TestCase::QUICK);
+  AddTestCase (new LrWpanErrorModelLookupTestCase, TestCase::QUICK);
   AddTestCase (new LrWpanErrorDistanceTestCase, TestCase::QUICK);
 }
 
@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <ns3/test.h>
+#include <ns3/packet.h>
+#include <ns3/packet-burst.h>
+#include <ns3/simulator.h>
+#include <ns3/lr-wpan-mac-header.h>
+#include <ns3/lr-wpan-mac-trailer.h>
+#include <ns3/lr-wpan-phy-header.h>
+#include <ns3/lr-wpan-oqpsk.h>
+#include <ns3/lr-wpan-interference-tracker.h>
+#include <ns3/lr-wpan-spectrum-signal-parameters.h>
+#include <ns3/log.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("lr-wpan-interference-tracker-test");
+
+static Ptr<Packet>
+CreatePpdu (uint32_t payloadSize)
+{
+  LrWpanMacHeader macHdr (LrWpanMacHeader::LRWPAN_MAC_DATA, 0);
+  macHdr.SetDstAddrMode (LrWpanMacHeader::SHORTADDR);
+  macHdr.SetSrcAddrMode (LrWpanMacHeader::SHORTADDR);
+  macHdr.SetDstAddrFields (7, Mac16Address ("00:02"));
+  macHdr.SetSrcAddrFields (7, Mac16Address ("00:01"));
+  macHdr.SetSeqNum (42);
+
+  Ptr<Packet> p = Create<Packet> (payloadSize);
+  p->AddHeader (macHdr);
+  LrWpanMacTrailer trailer;
+  trailer.EnableFcs (true);
+  trailer.SetFcs (p);
+  p->AddTrailer (trailer);
+  LrWpanPhyHeader phyHdr (p->GetSize ());
+  p->AddHeader (phyHdr);
+  return p;
+}
+
+class LrWpanPackedPpduTestCase : public TestCase
+{
+public:
+  LrWpanPackedPpduTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LrWpanPackedPpduTestCase::LrWpanPackedPpduTestCase ()
+  : TestCase ("Test the packed PPDU representation")
+{
+}
+
+void
+LrWpanPackedPpduTestCase::DoRun (void)
+{
+  LrWpanPackedPpdu bits;
+  bits.Append (0x5, 3);
+  bits.AppendZeros (70);
+  bits.Append (0xffffffffffffffffULL, 64);
+  NS_TEST_EXPECT_MSG_EQ (bits.GetSize (), 137, "Wrong size");
+  NS_TEST_EXPECT_MSG_EQ (bits.CountOnes (), 66, "Wrong number of set bits");
+  NS_TEST_EXPECT_MSG_EQ (bits.ToString (), "101" + std::string (70, '0') + std::string (64, '1'),
+                         "Wrong bit order");
+
+  LrWpanPackedPpdu mask;
+  mask.Reset (137);
+  mask.SetRange (60, 130);
+  NS_TEST_EXPECT_MSG_EQ (mask.CountOnes (), 70, "Wrong range across words");
+  NS_TEST_EXPECT_MSG_EQ (mask.FindFirstOne (), 60, "Wrong first set bit");
+  bits.Xor (mask);
+  NS_TEST_EXPECT_MSG_EQ (bits.ToString (),
+                         "101" + std::string (57, '0') + std::string (13, '1')
+                         + std::string (57, '0') + std::string (7, '1'),
+                         "Wrong xor");
+
+  for (uint32_t payload = 0; payload < 40; payload += 13)
+    {
+      Ptr<Packet> p = CreatePpdu (payload);
+      LrWpanPackedPpdu ppdu;
+      LrWpanOqpsk::GetPackedRepresentation (p, ppdu);
+      NS_TEST_EXPECT_MSG_EQ (ppdu.ToString (), LrWpanOqpsk::GetBinaryRepresentation (p),
+                             "Packed representation differs from the string representation");
+    }
+}
+
+class LrWpanInterferenceTrackerTestCase : public TestCase
+{
+public:
+  LrWpanInterferenceTrackerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  void AddFrame (Ptr<LrWpanSpectrumSignalParameters> params);
+  void RemoveFrame (Ptr<LrWpanSpectrumSignalParameters> params);
+  void Check (uint32_t firstJammedBit, uint32_t jammedBits);
+
+  Ptr<LrWpanInterferenceTracker> m_tracker;
+};
+
+LrWpanInterferenceTrackerTestCase::LrWpanInterferenceTrackerTestCase ()
+  : TestCase ("Test the jammed bits of overlapping frames")
+{
+}
+
+void
+LrWpanInterferenceTrackerTestCase::AddFrame (Ptr<LrWpanSpectrumSignalParameters> params)
+{
+  m_tracker->AddFrame (params);
+}
+
+void
+LrWpanInterferenceTrackerTestCase::RemoveFrame (Ptr<LrWpanSpectrumSignalParameters> params)
+{
+  m_tracker->RemoveFrame (params);
+}
+
+void
+LrWpanInterferenceTrackerTestCase::Check (uint32_t firstJammedBit, uint32_t jammedBits)
+{
+  m_tracker->CalculateInterference ();
+  NS_TEST_EXPECT_MSG_EQ (m_tracker->GetFirstJammedBit (), firstJammedBit, "Wrong first jammed bit");
+  NS_TEST_EXPECT_MSG_EQ (m_tracker->GetNumberOfJammedBits (), jammedBits, "Wrong number of jammed bits");
+
+  LrWpanPackedPpdu diff = m_tracker->GetRxPpdu ();
+  diff.Xor (m_tracker->GetJammedPpdu ());
+  NS_TEST_EXPECT_MSG_EQ (diff.CountOnes (), jammedBits, "Wrong number of flipped bits");
+}
+
+void
+LrWpanInterferenceTrackerTestCase::DoRun (void)
+{
+  m_tracker = Create<LrWpanInterferenceTracker> ();
+
+  // 4 us per bit, as for the 2.4 GHz O-QPSK PHY.
+  Ptr<Packet> p = CreatePpdu (20);
+  LrWpanPackedPpdu ppdu;
+  LrWpanOqpsk::GetPackedRepresentation (p, ppdu);
+  uint32_t nBits = ppdu.GetSize ();
+
+  Ptr<LrWpanSpectrumSignalParameters> rx = Create<LrWpanSpectrumSignalParameters> ();
+  rx->duration = MicroSeconds (4 * nBits);
+  rx->packetBurst = CreateObject<PacketBurst> ();
+  rx->packetBurst->AddPacket (p);
+
+  Ptr<LrWpanSpectrumSignalParameters> before = Create<LrWpanSpectrumSignalParameters> ();
+  before->duration = MicroSeconds (48);
+  Ptr<LrWpanSpectrumSignalParameters> short1 = Create<LrWpanSpectrumSignalParameters> ();
+  short1->duration = MicroSeconds (20);
+  Ptr<LrWpanSpectrumSignalParameters> short2 = Create<LrWpanSpectrumSignalParameters> ();
+  short2->duration = MicroSeconds (40);
+  Ptr<LrWpanSpectrumSignalParameters> tail = Create<LrWpanSpectrumSignalParameters> ();
+  tail->duration = MicroSeconds (4 * nBits);
+
+  // A frame which is on the air before the reception starts jams the first bits.
+  Simulator::Schedule (MicroSeconds (0), &LrWpanInterferenceTrackerTestCase::AddFrame, this, before);
+  Simulator::Schedule (MicroSeconds (20), &LrWpanInterferenceTrackerTestCase::AddFrame, this, rx);
+  Simulator::Schedule (MicroSeconds (20), &LrWpanInterferenceTracker::SetRxFrame, m_tracker, rx);
+  Simulator::Schedule (MicroSeconds (20), &LrWpanInterferenceTrackerTestCase::Check, this, 0, 7);
+  Simulator::Schedule (MicroSeconds (48), &LrWpanInterferenceTrackerTestCase::RemoveFrame, this, before);
+
+  // Two overlapping short frames jam bits [10, 20).
+  Simulator::Schedule (MicroSeconds (60), &LrWpanInterferenceTrackerTestCase::AddFrame, this, short1);
+  Simulator::Schedule (MicroSeconds (60), &LrWpanInterferenceTrackerTestCase::AddFrame, this, short2);
+  Simulator::Schedule (MicroSeconds (80), &LrWpanInterferenceTrackerTestCase::RemoveFrame, this, short1);
+  Simulator::Schedule (MicroSeconds (100), &LrWpanInterferenceTrackerTestCase::RemoveFrame, this, short2);
+  Simulator::Schedule (MicroSeconds (100), &LrWpanInterferenceTrackerTestCase::Check, this, 0, 17);
+
+  // A frame lasting beyond the reception jams all remaining bits.
+  Simulator::Schedule (MicroSeconds (420), &LrWpanInterferenceTrackerTestCase::AddFrame, this, tail);
+  Simulator::Schedule (MicroSeconds (420), &LrWpanInterferenceTrackerTestCase::Check, this, 0, 17 + nBits - 100);
+
+  Simulator::Run ();
+
+  // After the reception, ended frames no longer count.
+  m_tracker->ClearRxFrame ();
+  NS_TEST_EXPECT_MSG_EQ (m_tracker->IsJammed (), false, "Jammed without a reception");
+  NS_TEST_EXPECT_MSG_EQ (m_tracker->RemoveFrame (short1), false, "Ended frame still tracked");
+  NS_TEST_EXPECT_MSG_EQ (m_tracker->RemoveFrame (tail), true, "Frame on the air not tracked");
+
+  Simulator::Destroy ();
+}
+
+class LrWpanInterferenceTrackerTestSuite : public TestSuite
+{
+public:
+  LrWpanInterferenceTrackerTestSuite ();
+};
+
+LrWpanInterferenceTrackerTestSuite::LrWpanInterferenceTrackerTestSuite ()
+  : TestSuite ("lr-wpan-interference-tracker", UNIT)
+{
+  AddTestCase (new LrWpanPackedPpduTestCase, TestCase::QUICK);
+  AddTestCase (new LrWpanInterferenceTrackerTestCase, TestCase::QUICK);
+}
+
+static LrWpanInterferenceTrackerTestSuite lrWpanInterferenceTrackerTestSuite;
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/lr-wpan-module.h>
+#include <ns3/lr-wpan-lifetime-estimator.h>
+#include <ns3/lr-wpan-radio-energy-model-helper.h>
+#include <ns3/basic-energy-source-helper.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/propagation-delay-model.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/simulator.h>
+#include <ns3/packet.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/uinteger.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("lr-wpan-lifetime-estimator-test");
+
+class LrWpanLifetimeEstimatorTestCase : public TestCase
+{
+public:
+  LrWpanLifetimeEstimatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * The outcome of a simulation run.
+   */
+  struct Result
+  {
+    Time depletion;       //!< Network time of the first depletion
+    uint32_t depleted;    //!< Index of the first depleted source
+    Time simulated;       //!< Simulation time at the end of the run
+    Time skipped;         //!< Time skipped by the estimator
+    uint32_t fastForwards; //!< Number of fast-forwards
+    Time txResidency;     //!< Time spent by the sender in BUSY_TX
+  };
+
+  /**
+   * Run a sender and a receiver with ContikiMAC until the first source is
+   * depleted.
+   *
+   * \param fastForward allow the estimator to skip time
+   * \return the outcome of the run
+   */
+  Result RunNetwork (bool fastForward);
+
+  /**
+   * Send a frame and schedule the next one.
+   *
+   * \param mac the MAC of the sender
+   */
+  void Send (Ptr<LrWpanMac> mac);
+
+  void FastForward (Time networkTime, Time skipped);
+  void Depletion (uint32_t index, Time networkTime);
+
+  uint32_t m_fastForwards;  // number of fast-forwards
+  uint32_t m_depleted;      // index of the first depleted source
+};
+
+LrWpanLifetimeEstimatorTestCase::LrWpanLifetimeEstimatorTestCase ()
+  : TestCase ("Test the network lifetime fast-forward against full simulation"),
+    m_fastForwards (0),
+    m_depleted (0)
+{
+}
+
+void
+LrWpanLifetimeEstimatorTestCase::Send (Ptr<LrWpanMac> mac)
+{
+  McpsDataRequestParams params;
+  params.m_srcAddrMode = SHORT_ADDR;
+  params.m_dstAddrMode = SHORT_ADDR;
+  params.m_dstPanId = 0;
+  params.m_dstAddr = Mac16Address ("00:01");
+  params.m_msduHandle = 0;
+  params.m_txOptions = TX_OPTION_NONE;
+  mac->McpsDataRequest (params, Create<Packet> (20));
+  Simulator::Schedule (Seconds (1), &LrWpanLifetimeEstimatorTestCase::Send, this, mac);
+}
+
+void
+LrWpanLifetimeEstimatorTestCase::FastForward (Time networkTime, Time skipped)
+{
+  m_fastForwards++;
+}
+
+void
+LrWpanLifetimeEstimatorTestCase::Depletion (uint32_t index, Time networkTime)
+{
+  m_depleted = index;
+}
+
+LrWpanLifetimeEstimatorTestCase::Result
+LrWpanLifetimeEstimatorTestCase::RunNetwork (bool fastForward)
+{
+  m_fastForwards = 0;
+
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+
+  NodeContainer nodes;
+  NetDeviceContainer devices;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      Ptr<LrWpanNetDevice> dev = CreateObject<LrWpanNetDevice> ();
+      dev->SetMac (CreateObject<LrWpanContikiMac> ());
+      uint8_t address[2] = { 0, static_cast<uint8_t> (i + 1) };
+      Mac16Address shortAddress;
+      shortAddress.CopyFrom (address);
+      dev->SetAddress (shortAddress);
+      dev->SetChannel (channel);
+      node->AddDevice (dev);
+      // Both runs must draw the same random numbers.
+      dev->AssignStreams (10 * i);
+
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (0, 10 * i, 0));
+      dev->GetPhy ()->SetMobility (mobility);
+
+      nodes.Add (node);
+      devices.Add (dev);
+    }
+
+  BasicEnergySourceHelper sourceHelper;
+  sourceHelper.Set ("BasicEnergySupplyVoltageV", DoubleValue (1.2));
+  sourceHelper.Set ("BasicEnergySourceInitialEnergyJ", DoubleValue (0.3));
+  sourceHelper.Set ("LazyEnergyUpdate", BooleanValue (true));
+  EnergySourceContainer sources = sourceHelper.Install (nodes);
+  LrWpanRadioEnergyModelHelper radioHelper;
+  DeviceEnergyModelContainer models = radioHelper.Install (devices, sources);
+
+  Ptr<LrWpanLifetimeEstimator> estimator = CreateObject<LrWpanLifetimeEstimator> ();
+  if (!fastForward)
+    {
+      // the depletion is always closer than the margin
+      estimator->SetAttribute ("DepletionMargin", UintegerValue (1000000));
+    }
+  estimator->TraceConnectWithoutContext ("FastForward", MakeCallback (&LrWpanLifetimeEstimatorTestCase::FastForward, this));
+  estimator->TraceConnectWithoutContext ("Depletion", MakeCallback (&LrWpanLifetimeEstimatorTestCase::Depletion, this));
+  estimator->Install (models, sources);
+
+  // node 2 sends a frame per second, i.e. per window of the estimator
+  Ptr<LrWpanNetDevice> sender = DynamicCast<LrWpanNetDevice> (devices.Get (1));
+  Simulator::Schedule (Seconds (0.5), &LrWpanLifetimeEstimatorTestCase::Send, this, sender->GetMac ());
+
+  Simulator::Stop (Seconds (1000));
+  Simulator::Run ();
+
+  Result result;
+  result.depletion = estimator->GetFirstDepletionTime ();
+  result.depleted = m_depleted;
+  result.simulated = Simulator::Now ();
+  result.skipped = estimator->GetTimeOffset ();
+  result.fastForwards = m_fastForwards;
+  result.txResidency = DynamicCast<LrWpanRadioEnergyModel> (models.Get (1))->GetStateResidency (IEEE_802_15_4_PHY_BUSY_TX);
+
+  Simulator::Destroy ();
+  return result;
+}
+
+void
+LrWpanLifetimeEstimatorTestCase::DoRun (void)
+{
+  Result full = RunNetwork (false);
+  Result fast = RunNetwork (true);
+
+  NS_TEST_ASSERT_MSG_NE (full.depletion, Time::Max (), "No source depleted in full simulation");
+  NS_TEST_EXPECT_MSG_EQ (full.fastForwards, 0, "Time skipped in full simulation");
+  NS_TEST_EXPECT_MSG_EQ (full.skipped, Seconds (0), "Time skipped in full simulation");
+  NS_TEST_EXPECT_MSG_EQ (full.depletion, full.simulated, "Full simulation not stopped at the depletion");
+
+  NS_TEST_ASSERT_MSG_NE (fast.depletion, Time::Max (), "No source depleted with fast-forward");
+  NS_TEST_EXPECT_MSG_GT (fast.fastForwards, 0, "No time skipped");
+  NS_TEST_EXPECT_MSG_EQ (fast.depletion, fast.simulated + fast.skipped, "Wrong network time of the depletion");
+  NS_TEST_EXPECT_MSG_LT (fast.simulated, full.simulated / 4, "Not enough time skipped");
+  NS_TEST_EXPECT_MSG_EQ (fast.depleted, full.depleted, "Different source depleted first");
+
+  // The extrapolated lifetime and the residency of the sender match the
+  // full simulation.
+  NS_TEST_EXPECT_MSG_EQ_TOL (fast.depletion.GetSeconds (), full.depletion.GetSeconds (),
+                             0.02 * full.depletion.GetSeconds (), "Wrong lifetime");
+  NS_TEST_EXPECT_MSG_EQ_TOL (fast.txResidency.GetSeconds (), full.txResidency.GetSeconds (),
+                             0.05 * full.txResidency.GetSeconds (), "Wrong BUSY_TX residency of the sender");
+}
+
+// ==============================================================================
+class LrWpanLifetimeEstimatorTestSuite : public TestSuite
+{
+public:
+  LrWpanLifetimeEstimatorTestSuite ();
+};
+
+LrWpanLifetimeEstimatorTestSuite::LrWpanLifetimeEstimatorTestSuite ()
+  : TestSuite ("lr-wpan-lifetime-estimator", UNIT)
+{
+  AddTestCase (new LrWpanLifetimeEstimatorTestCase, TestCase::QUICK);
+}
+
+static LrWpanLifetimeEstimatorTestSuite lrWpanLifetimeEstimatorTestSuite;
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include <ns3/test.h>
+#include <ns3/packet.h>
+#include <ns3/packet-burst.h>
+#include <ns3/simulator.h>
+#include <ns3/lr-wpan-phy.h>
+#include <ns3/lr-wpan-phy-header.h>
+#include <ns3/lr-wpan-spectrum-signal-parameters.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/log.h>
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("lr-wpan-ppdu-sharing-test");
+
+/**
+ * The objects allocated for the PPDU of a frame, counted over the
+ * transmitter and all receivers.
+ */
+struct LrWpanPpduAllocations
+{
+  std::set<PacketBurst *> bursts;   //!< the distinct packet bursts
+  std::set<Packet *> packets;       //!< the distinct packets
+
+  void Add (Ptr<const LrWpanSpectrumSignalParameters> params)
+  {
+    bursts.insert (PeekPointer (params->packetBurst));
+    packets.insert (PeekPointer (params->packetBurst->GetPackets ().front ()));
+  }
+};
+
+/**
+ * A PHY, which records the PPDU it gets from the channel, and the PPDU it
+ * keeps after the start of the reception.
+ */
+class LrWpanPpduCountingPhy : public LrWpanPhy
+{
+public:
+  LrWpanPpduCountingPhy (LrWpanPpduAllocations *delivered, LrWpanPpduAllocations *allocated)
+    : m_delivered (delivered),
+      m_allocated (allocated)
+  {
+  }
+
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    Ptr<LrWpanSpectrumSignalParameters> lrWpanParams = DynamicCast<LrWpanSpectrumSignalParameters> (params);
+    m_delivered->Add (lrWpanParams);
+    LrWpanPhy::StartRx (params);
+    m_allocated->Add (lrWpanParams);
+  }
+
+private:
+  LrWpanPpduAllocations *m_delivered;   //!< the PPDUs delivered by the channel
+  LrWpanPpduAllocations *m_allocated;   //!< the PPDUs kept by the receivers
+};
+
+class LrWpanPpduSharingTestCase : public TestCase
+{
+public:
+  LrWpanPpduSharingTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a PHY attached to the channel.
+   *
+   * \param distance the distance to the transmitter
+   * \param state the transceiver state of the PHY
+   * \return the PHY
+   */
+  Ptr<LrWpanPhy> CreatePhy (double distance, LrWpanPhyEnumeration state);
+
+  void PdDataIndication (uint32_t psduLength, Ptr<Packet> p, uint8_t lqi);
+  void PlmeSetTRXStateConfirm (LrWpanPhyEnumeration status);
+
+  Ptr<SingleModelSpectrumChannel> m_channel;
+  LrWpanPpduAllocations m_delivered;    //!< the PPDUs delivered by the channel
+  LrWpanPpduAllocations m_allocated;    //!< the PPDUs kept by the receivers
+  std::vector<Ptr<Packet> > m_received; //!< the received PSDUs
+};
+
+LrWpanPpduSharingTestCase::LrWpanPpduSharingTestCase ()
+  : TestCase ("Test the sharing of the PPDU among the receivers of a frame")
+{
+}
+
+void
+LrWpanPpduSharingTestCase::PdDataIndication (uint32_t psduLength, Ptr<Packet> p, uint8_t lqi)
+{
+  m_received.push_back (p);
+}
+
+void
+LrWpanPpduSharingTestCase::PlmeSetTRXStateConfirm (LrWpanPhyEnumeration status)
+{
+}
+
+Ptr<LrWpanPhy>
+LrWpanPpduSharingTestCase::CreatePhy (double distance, LrWpanPhyEnumeration state)
+{
+  Ptr<LrWpanPhy> phy = CreateObject<LrWpanPpduCountingPhy> (&m_delivered, &m_allocated);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  mobility->SetPosition (Vector (distance, 0, 0));
+  phy->SetMobility (mobility);
+  phy->SetChannel (m_channel);
+  m_channel->AddRx (phy);
+  phy->SetPdDataIndicationCallback (MakeCallback (&LrWpanPpduSharingTestCase::PdDataIndication, this));
+  phy->SetPlmeSetTRXStateConfirmCallback (MakeCallback (&LrWpanPpduSharingTestCase::PlmeSetTRXStateConfirm, this));
+  phy->PlmeSetTRXStateRequest (state);
+  return phy;
+}
+
+void
+LrWpanPpduSharingTestCase::DoRun (void)
+{
+  m_channel = CreateObject<SingleModelSpectrumChannel> ();
+  m_channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  Ptr<LrWpanPhy> sender = CreatePhy (0, IEEE_802_15_4_PHY_TX_ON);
+  // Two receivers in range, listening.
+  CreatePhy (10, IEEE_802_15_4_PHY_RX_ON);
+  CreatePhy (20, IEEE_802_15_4_PHY_RX_ON);
+  // Three sleeping receivers, and one out of range.
+  CreatePhy (10, IEEE_802_15_4_PHY_TRX_OFF);
+  CreatePhy (20, IEEE_802_15_4_PHY_TRX_OFF);
+  CreatePhy (30, IEEE_802_15_4_PHY_TRX_OFF);
+  CreatePhy (100000, IEEE_802_15_4_PHY_RX_ON);
+
+  Ptr<Packet> psdu = Create<Packet> (30);
+  Simulator::Schedule (MilliSeconds (10), &LrWpanPhy::PdDataRequest, sender, psdu->GetSize (), psdu);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 2, "The frame was not received by both listening receivers");
+  NS_TEST_EXPECT_MSG_EQ (m_received[0]->GetSize (), psdu->GetSize (), "Wrong size of the received PSDU");
+  NS_TEST_EXPECT_MSG_EQ (m_received[1]->GetSize (), psdu->GetSize (), "Wrong size of the received PSDU");
+
+  // The channel hands the single PPDU of the transmitter to all receivers.
+  NS_TEST_EXPECT_MSG_EQ (m_delivered.bursts.size (), 1, "The packet burst was copied for the receivers");
+  NS_TEST_EXPECT_MSG_EQ (m_delivered.packets.size (), 1, "The PPDU was copied for the receivers");
+
+  // Only the receivers, which actually receive the frame, allocate an own
+  // copy: one packet burst and one packet per frame and receiver.
+  NS_TEST_EXPECT_MSG_EQ (m_allocated.bursts.size (), 3, "Wrong number of allocated packet bursts per frame");
+  NS_TEST_EXPECT_MSG_EQ (m_allocated.packets.size (), 3, "Wrong number of allocated packets per frame");
+
+  // The shared PPDU still has its PHY header after the receptions.
+  Ptr<Packet> ppdu = *m_delivered.packets.begin ();
+  LrWpanPhyHeader phyHeader (psdu->GetSize ());
+  NS_TEST_EXPECT_MSG_EQ (ppdu->GetSize (), psdu->GetSize () + phyHeader.GetSerializedSize (),
+                         "The shared PPDU was modified by a receiver");
+
+  Simulator::Destroy ();
+}
+
+// ==============================================================================
+class LrWpanPpduSharingTestSuite : public TestSuite
+{
+public:
+  LrWpanPpduSharingTestSuite ();
+};
+
+LrWpanPpduSharingTestSuite::LrWpanPpduSharingTestSuite ()
+  : TestSuite ("lr-wpan-ppdu-sharing", UNIT)
+{
+  AddTestCase (new LrWpanPpduSharingTestCase, TestCase::QUICK);
+}
+
+static LrWpanPpduSharingTestSuite lrWpanPpduSharingTestSuite;
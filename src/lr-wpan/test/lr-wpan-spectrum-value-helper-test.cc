@@ -20,6 +20,7 @@
 #include <ns3/log.h>
 #include <ns3/test.h>
 #include <ns3/lr-wpan-spectrum-value-helper.h>
+#include <ns3/lr-wpan-interference-helper.h>
 #include <ns3/spectrum-value.h>
 
 #include <cmath>
@@ -64,6 +65,66 @@ LrWpanSpectrumValueHelperTestCase::DoRun (void)
     }
 }
 
+class LrWpanInterferenceHelperPowerTestCase : public TestCase
+{
+public:
+  LrWpanInterferenceHelperPowerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  void CheckPower (Ptr<LrWpanInterferenceHelper> interference);
+};
+
+LrWpanInterferenceHelperPowerTestCase::LrWpanInterferenceHelperPowerTestCase ()
+  : TestCase ("Test the in-band powers of the 802.15.4 interference helper")
+{
+}
+
+void
+LrWpanInterferenceHelperPowerTestCase::CheckPower (Ptr<LrWpanInterferenceHelper> interference)
+{
+  Ptr<SpectrumValue> psd = interference->GetSignalPsd ();
+  for (uint32_t chan = 11; chan <= 26; chan++)
+    {
+      // The running sums may keep rounding errors of removed signals, which are
+      // far below the thermal noise of about 2e-14 W.
+      double expected = LrWpanSpectrumValueHelper::TotalAvgPower (psd, chan);
+      NS_TEST_ASSERT_MSG_EQ_TOL (interference->GetSignalPower (chan), expected, expected * 1e-9 + 1e-18,
+                                 "In-band power differs from the PSD for channel " << chan);
+    }
+}
+
+void
+LrWpanInterferenceHelperPowerTestCase::DoRun (void)
+{
+  LrWpanSpectrumValueHelper helper;
+  Ptr<SpectrumValue> strong = helper.CreateTxPowerSpectralDensity (0, 11);
+  Ptr<SpectrumValue> weak = helper.CreateTxPowerSpectralDensity (-90, 11);
+  Ptr<SpectrumValue> other = helper.CreateTxPowerSpectralDensity (-20, 17);
+  Ptr<LrWpanInterferenceHelper> interference = Create<LrWpanInterferenceHelper> (strong->GetSpectrumModel ());
+
+  interference->AddSignal (strong);
+  interference->AddSignal (weak);
+  interference->AddSignal (other);
+  CheckPower (interference);
+
+  // The weak signal must not get lost in rounding errors of the strong one.
+  interference->RemoveSignal (strong);
+  CheckPower (interference);
+  NS_TEST_ASSERT_MSG_EQ_TOL (interference->GetSignalPower (11), helper.TotalAvgPower (weak, 11),
+                             helper.TotalAvgPower (weak, 11) * 1e-3, "Weak signal lost");
+
+  interference->RemoveSignal (weak);
+  interference->RemoveSignal (other);
+  NS_TEST_ASSERT_MSG_EQ (interference->GetSignalPower (11), 0.0, "Power left without signals");
+  NS_TEST_ASSERT_MSG_EQ (interference->GetSignalPower (17), 0.0, "Power left without signals");
+
+  interference->AddSignal (other);
+  interference->ClearSignals ();
+  NS_TEST_ASSERT_MSG_EQ (interference->GetSignalPower (17), 0.0, "Power left after clearing");
+}
+
 // ==============================================================================
 class LrWpanSpectrumValueHelperTestSuite : public TestSuite
 {
@@ -75,6 +136,7 @@ LrWpanSpectrumValueHelperTestSuite::LrWpanSpectrumValueHelperTestSuite ()
   : TestSuite ("lr-wpan-spectrum-value-helper", UNIT)
 {
   AddTestCase (new LrWpanSpectrumValueHelperTestCase, TestCase::QUICK);
+  AddTestCase (new LrWpanInterferenceHelperPowerTestCase, TestCase::QUICK);
 }
 
 static LrWpanSpectrumValueHelperTestSuite lrWpanSpectrumValueHelperTestSuite;
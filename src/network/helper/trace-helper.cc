@@ -28,6 +28,11 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pcapng-writer.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include "ns3/simulation-context.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +40,42 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/**
+ * \ingroup network
+ * The name of the pcapng file shared by the pcap traces, or empty.
+ */
+static GlobalValue g_pcapngFile = GlobalValue ("PcapngFile",
+                                               "The name of a pcapng file where the pcap traces "
+                                               "created by the helpers are written, one interface per "
+                                               "trace, instead of one pcap file per trace.",
+                                               StringValue (""),
+                                               MakeStringChecker ());
+
+/**
+ * \returns The writer of the shared pcapng file of the simulation.
+ */
+static Ptr<PcapngWriter> &
+GetPcapngWriter (void)
+{
+  static ContextLocal<Ptr<PcapngWriter> > writer;
+  return writer.Get ();
+}
+
+/**
+ * Close the shared pcapng file, when the simulation is destroyed.
+ */
+static void
+ClosePcapngWriter (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Ptr<PcapngWriter> &writer = GetPcapngWriter ();
+  if (writer != 0)
+    {
+      writer->Dispose ();
+      writer = 0;
+    }
+}
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -56,7 +97,28 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
-  file->Open (filename, filemode);
+  StringValue pcapngFile;
+  g_pcapngFile.GetValue (pcapngFile);
+  if (pcapngFile.Get () != "" && (filemode & std::ios::out) && !(filemode & std::ios::app))
+    {
+      //
+      // All the traces are interfaces of one pcapng file, written by a
+      // thread in large buffers, and closed with the simulation.
+      //
+      Ptr<PcapngWriter> &writer = GetPcapngWriter ();
+      if (writer == 0)
+        {
+          writer = CreateObject<PcapngWriter> ();
+          writer->Open (pcapngFile.Get ());
+          NS_ABORT_MSG_IF (writer->Fail (), "Unable to Open " << pcapngFile.Get ());
+          Simulator::ScheduleDestroy (&ClosePcapngWriter);
+        }
+      file->Open (writer, filename);
+    }
+  else
+    {
+      file->Open (filename, filemode);
+    }
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
   file->Init (dataLinkType, snapLen, tzCorrection);
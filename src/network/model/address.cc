@@ -139,8 +139,8 @@ Address::Register (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   static uint8_t type = 1;
-  type++;
-  return type;
+  // the address types may be registered by several threads at once
+  return __sync_add_and_fetch (&type, 1);
 }
 
 uint32_t
@@ -18,8 +18,12 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "ns3/core-config.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -50,7 +54,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
-uint32_t Buffer::g_recommendedStart = 0;
+__thread uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -68,6 +72,9 @@ uint32_t Buffer::g_recommendedStart = 0;
  * which the compiler assigns to zero-memory which is initialized to _zero_
  * before the constructors run so this ensures perfect handling of crazy 
  * constructor orderings.
+ * Every thread has its own free list: the one of the main thread is
+ * destroyed with the static destructors, the one of another thread when
+ * the thread exits.
  */
 #define MAGIC_DESTROYED (~(long) 0)
 #define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
@@ -75,13 +82,26 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
+__thread uint32_t Buffer::g_maxSize = 0;
+__thread Buffer::FreeList *Buffer::g_freeList = 0;
 struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
+#ifdef HAVE_PTHREAD_H
+/** The key, whose destructor destroys the free list of an exiting thread. */
+static pthread_key_t g_freeListKey;
+/** Create g_freeListKey once. */
+static pthread_once_t g_freeListKeyOnce = PTHREAD_ONCE_INIT;
+#endif /* HAVE_PTHREAD_H */
+
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
   NS_LOG_FUNCTION (this);
+  Buffer::DestroyFreeList ();
+}
+
+void
+Buffer::DestroyFreeList (void)
+{
   if (IS_INITIALIZED (g_freeList))
     {
       for (Buffer::FreeList::iterator i = g_freeList->begin ();
@@ -94,23 +114,36 @@ Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
     }
 }
 
+void
+Buffer::CreateFreeListKey (void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_key_create (&g_freeListKey, &Buffer::DestroyFreeListAtExit);
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+Buffer::DestroyFreeListAtExit (void *value)
+{
+  DestroyFreeList ();
+}
+
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
   g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
+  /* feed into free list; the buffer may have been created in another
+   * thread, whose free list is not created yet */
   if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
+      !IS_INITIALIZED (g_freeList) ||
       g_freeList->size () > 1000)
     {
       Buffer::Deallocate (data);
     }
   else
     {
-      NS_ASSERT (IS_INITIALIZED (g_freeList));
       g_freeList->push_back (data);
     }
 }
@@ -123,6 +156,11 @@ Buffer::Create (uint32_t dataSize)
   if (IS_UNINITIALIZED (g_freeList))
     {
       g_freeList = new Buffer::FreeList ();
+#ifdef HAVE_PTHREAD_H
+      pthread_once (&g_freeListKeyOnce, &CreateFreeListKey);
+      // any non-null value, for the destructor to be called
+      pthread_setspecific (g_freeListKey, g_freeList);
+#endif /* HAVE_PTHREAD_H */
     }
   else if (IS_INITIALIZED (g_freeList))
     {
@@ -772,9 +772,9 @@ private:
   /**
    * location in a newly-allocated buffer where you should start
    * writing data. i.e., m_start should be initialized to this 
-   * value.
+   * value. One value per thread.
    */
-  static uint32_t g_recommendedStart;
+  static __thread uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -805,8 +805,23 @@ private:
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
+  /**
+   * Deallocate the free list of the calling thread, and the buffers in it.
+   */
+  static void DestroyFreeList (void);
+  /**
+   * Create the key, whose destructor deallocates the free list of an
+   * exiting thread.
+   */
+  static void CreateFreeListKey (void);
+  /**
+   * Deallocate the free list of an exiting thread.
+   *
+   * \param value Unused.
+   */
+  static void DestroyFreeListAtExit (void *value);
+  static __thread uint32_t g_maxSize; //!< Max observed data size, per thread
+  static __thread FreeList *g_freeList; //!< Buffer data container, per thread
   static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
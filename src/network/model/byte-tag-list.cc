@@ -19,6 +19,7 @@
  */
 #include "byte-tag-list.h"
 #include "ns3/log.h"
+#include "ns3/simulation-context.h"
 #include <vector>
 #include <cstring>
 
@@ -52,12 +53,14 @@ struct ByteTagListData {
  *
  * Internal use only.
  */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
+class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
 {
 public:
   ~ByteTagListDataFreeList ();
-} g_freeList; //!< Container for struct ByteTagListData
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+};
+/// Container for struct ByteTagListData, per SimulationContext
+static ContextLocal<ByteTagListDataFreeList> g_freeList;
+static __thread uint32_t g_maxSize = 0; //!< maximum data size (used for allocation), per thread
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList ()
 {
@@ -358,10 +361,11 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
+  ByteTagListDataFreeList &freeList = g_freeList.Get ();
+  while (!freeList.empty ())
     {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
+      struct ByteTagListData *data = freeList.back ();
+      freeList.pop_back ();
       NS_ASSERT (data != 0);
       if (data->size >= size)
         {
@@ -392,7 +396,8 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
   data->count--;
   if (data->count == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
+      ByteTagListDataFreeList &freeList = g_freeList.Get ();
+      if (freeList.size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
         {
           uint8_t *buffer = (uint8_t *)data;
@@ -400,7 +405,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
         }
       else
         {
-          g_freeList.push_back (data);
+          freeList.push_back (data);
         }
     }
 }
@@ -21,6 +21,7 @@
 #include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
+#include "ns3/simulation-context.h"
 #include "channel-list.h"
 #include "channel.h"
 
@@ -128,7 +129,8 @@ Ptr<ChannelListPriv> *
 ChannelListPriv::DoGet (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static Ptr<ChannelListPriv> ptr = 0;
+  static ContextLocal<Ptr<ChannelListPriv> > list;
+  Ptr<ChannelListPriv> &ptr = list.Get ();
   if (ptr == 0)
     {
       ptr = CreateObject<ChannelListPriv> ();
@@ -24,6 +24,7 @@
 #include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
+#include "ns3/simulation-context.h"
 #include "node-list.h"
 #include "node.h"
 
@@ -130,7 +131,8 @@ Ptr<NodeListPriv> *
 NodeListPriv::DoGet (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static Ptr<NodeListPriv> ptr = 0;
+  static ContextLocal<Ptr<NodeListPriv> > list;
+  Ptr<NodeListPriv> &ptr = list.Get ();
   if (ptr == 0)
     {
       ptr = CreateObject<NodeListPriv> ();
@@ -26,6 +26,7 @@
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
+#include "ns3/simulation-context.h"
 #include "buffer.h"
 
 namespace ns3 {
@@ -656,7 +657,7 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
+  static ContextLocal<DataFreeList> m_freeList; //!< the metadata data storage, per SimulationContext
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -667,8 +668,8 @@ public:
    */
   static bool m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
-  static uint16_t m_chunkUid; //!< Chunk Uid
+  static __thread uint32_t m_maxSize; //!< maximum metadata size, per thread
+  static ContextLocal<uint16_t> m_chunkUid; //!< Chunk Uid, per SimulationContext
 
   struct Data *m_data; //!< Metadata storage
   /*
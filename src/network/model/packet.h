@@ -32,6 +32,7 @@
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/ptr.h"
+#include "ns3/simulation-context.h"
 #include "ns3/deprecated.h"
 
 namespace ns3 {
@@ -701,7 +702,7 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static ContextLocal<uint32_t> m_globalUid; //!< Counter of packets Uid, per SimulationContext
 };
 
 /**
@@ -0,0 +1,312 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/config.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/pcapng-writer.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ * A block of a pcapng file read back.
+ */
+struct PcapngBlock
+{
+  uint32_t type;              //!< The type of the block.
+  std::vector<uint8_t> body;  //!< The body of the block, between its lengths.
+};
+
+/**
+ * \param body The body of a block.
+ * \param offset The offset of the value.
+ * \returns A 32-bit value of the body.
+ */
+static uint32_t
+Get32 (std::vector<uint8_t> const &body, uint32_t offset)
+{
+  uint32_t value;
+  std::memcpy (&value, &body[offset], 4);
+  return value;
+}
+
+/**
+ * \param body The body of a block.
+ * \param offset The offset of the value.
+ * \returns A 16-bit value of the body.
+ */
+static uint16_t
+Get16 (std::vector<uint8_t> const &body, uint32_t offset)
+{
+  uint16_t value;
+  std::memcpy (&value, &body[offset], 2);
+  return value;
+}
+
+/**
+ * Read the blocks of a pcapng file.
+ *
+ * \param filename The name of the file.
+ * \param blocks The blocks.
+ * \returns true if the file is made of well-formed blocks.
+ */
+static bool
+ReadPcapng (std::string filename, std::vector<PcapngBlock> &blocks)
+{
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  std::vector<uint8_t> data ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+  uint32_t offset = 0;
+  while (offset + 12 <= data.size ())
+    {
+      PcapngBlock block;
+      block.type = Get32 (data, offset);
+      uint32_t length = Get32 (data, offset + 4);
+      if (length < 12 || length % 4 != 0 || offset + length > data.size ()
+          || Get32 (data, offset + length - 4) != length)
+        {
+          return false;
+        }
+      block.body.assign (data.begin () + offset + 8, data.begin () + offset + length - 4);
+      blocks.push_back (block);
+      offset += length;
+    }
+  return offset == data.size ();
+}
+
+/**
+ * \param block An interface description block.
+ * \returns The if_name option of the interface.
+ */
+static std::string
+GetInterfaceName (PcapngBlock const &block)
+{
+  uint32_t offset = 8;
+  while (offset + 4 <= block.body.size ())
+    {
+      uint16_t code = Get16 (block.body, offset);
+      uint16_t length = Get16 (block.body, offset + 2);
+      if (code == 2)
+        {
+          return std::string (block.body.begin () + offset + 4, block.body.begin () + offset + 4 + length);
+        }
+      if (code == 0)
+        {
+          break;
+        }
+      offset += 4 + ((length + 3) & ~3);
+    }
+  return "";
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ * Write the packets of two interfaces through several buffers, and read
+ * them back.
+ */
+class PcapngWriterTestCase : public TestCase
+{
+public:
+  /**
+   * \param asynchronous Write the buffers in the writer thread.
+   */
+  PcapngWriterTestCase (bool asynchronous);
+
+private:
+  virtual void DoRun (void);
+
+  bool m_asynchronous;  //!< Write the buffers in the writer thread.
+};
+
+PcapngWriterTestCase::PcapngWriterTestCase (bool asynchronous)
+  : TestCase (std::string ("Check the packets of a pcapng file, written ")
+              + (asynchronous ? "by a thread" : "synchronously")),
+    m_asynchronous (asynchronous)
+{
+}
+
+void
+PcapngWriterTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("writer.pcapng");
+  Ptr<PcapngWriter> writer = CreateObject<PcapngWriter> ();
+  writer->SetAttribute ("BufferSize", UintegerValue (4096));
+  writer->SetAttribute ("Asynchronous", BooleanValue (m_asynchronous));
+  writer->Open (filename);
+  NS_TEST_ASSERT_MSG_EQ (writer->Fail (), false, "Cannot open " << filename);
+  NS_TEST_ASSERT_MSG_EQ (writer->AddInterface (PcapHelper::DLT_PPP, 65535, "first"), 0, "Wrong interface");
+  NS_TEST_ASSERT_MSG_EQ (writer->AddInterface (PcapHelper::DLT_IEEE802_15_4, 100, "second"), 1, "Wrong interface");
+
+  // enough packets for many buffers; the packets of the second interface
+  // are truncated to 100 bytes
+  const uint32_t packets = 500;
+  uint8_t data[300];
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      uint32_t size = (i * 37) % 300;
+      for (uint32_t j = 0; j < size; j++)
+        {
+          data[j] = i + j;
+        }
+      if (i % 3 == 0)
+        {
+          writer->Write (i % 2, NanoSeconds (i * 1001), Create<Packet> (data, size));
+        }
+      else
+        {
+          writer->Write (i % 2, NanoSeconds (i * 1001), data, size);
+        }
+    }
+  writer->Close ();
+  NS_TEST_ASSERT_MSG_EQ (writer->Fail (), false, "Cannot write " << filename);
+  NS_TEST_ASSERT_MSG_EQ (writer->GetRecords (), packets, "Wrong number of packets");
+  NS_TEST_ASSERT_MSG_EQ (writer->GetWrittenRecords (), packets, "Wrong number of written packets");
+  NS_TEST_ASSERT_MSG_EQ (writer->GetQueuedRecords (), 0, "Packets not written");
+  NS_TEST_ASSERT_MSG_EQ (writer->GetDroppedRecords (), 0, "Packets dropped");
+
+  std::vector<PcapngBlock> blocks;
+  bool wellFormed = ReadPcapng (filename, blocks);
+  NS_TEST_ASSERT_MSG_EQ (wellFormed, true, "Malformed pcapng file");
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 3 + packets, "Wrong number of blocks");
+  if (blocks.size () != 3 + packets)
+    {
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ (blocks[0].type, 0x0a0d0d0a, "No section header block");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (blocks[0].body, 0), 0x1a2b3c4d, "Wrong byte order magic");
+  NS_TEST_ASSERT_MSG_EQ (blocks[1].type, 1, "No interface description block");
+  NS_TEST_ASSERT_MSG_EQ (Get16 (blocks[1].body, 0), PcapHelper::DLT_PPP, "Wrong link type");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (blocks[1].body, 4), 65535, "Wrong snap length");
+  NS_TEST_ASSERT_MSG_EQ (GetInterfaceName (blocks[1]), "first", "Wrong interface name");
+  NS_TEST_ASSERT_MSG_EQ (Get16 (blocks[2].body, 0), PcapHelper::DLT_IEEE802_15_4, "Wrong link type");
+  NS_TEST_ASSERT_MSG_EQ (Get32 (blocks[2].body, 4), 100, "Wrong snap length");
+  NS_TEST_ASSERT_MSG_EQ (GetInterfaceName (blocks[2]), "second", "Wrong interface name");
+
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      PcapngBlock const &block = blocks[3 + i];
+      uint32_t size = (i * 37) % 300;
+      uint32_t inclLen = i % 2 ? std::min (size, (uint32_t) 100) : size;
+      uint64_t ts = ((uint64_t) Get32 (block.body, 4) << 32) | Get32 (block.body, 8);
+      NS_TEST_ASSERT_MSG_EQ (block.type, 6, "No enhanced packet block " << i);
+      NS_TEST_ASSERT_MSG_EQ (Get32 (block.body, 0), i % 2, "Wrong interface of packet " << i);
+      NS_TEST_ASSERT_MSG_EQ (ts, i * 1001, "Wrong timestamp of packet " << i);
+      NS_TEST_ASSERT_MSG_EQ (Get32 (block.body, 12), inclLen, "Wrong captured length of packet " << i);
+      NS_TEST_ASSERT_MSG_EQ (Get32 (block.body, 16), size, "Wrong length of packet " << i);
+      for (uint32_t j = 0; j < inclLen; j++)
+        {
+          NS_TEST_ASSERT_MSG_EQ ((uint32_t) block.body[20 + j], (uint8_t)(i + j), "Wrong data of packet " << i);
+        }
+    }
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ * Check that the PcapngFile global value writes the pcap traces of the
+ * helpers to one pcapng file.
+ */
+class PcapngHelperTestCase : public TestCase
+{
+public:
+  PcapngHelperTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapngHelperTestCase::PcapngHelperTestCase ()
+  : TestCase ("Check that the PcapngFile global value shares a pcapng file between the pcap traces")
+{
+}
+
+void
+PcapngHelperTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("helper.pcapng");
+  std::string first = CreateTempDirFilename ("helper-0-0.pcap");
+  std::string second = CreateTempDirFilename ("helper-1-0.pcap");
+  Config::SetGlobal ("PcapngFile", StringValue (filename));
+
+  PcapHelper helper;
+  Ptr<PcapFileWrapper> file0 = helper.CreateFile (first, std::ios::out, PcapHelper::DLT_PPP);
+  Ptr<PcapFileWrapper> file1 = helper.CreateFile (second, std::ios::out, PcapHelper::DLT_PPP);
+  NS_TEST_ASSERT_MSG_EQ (file1->GetDataLinkType (), PcapHelper::DLT_PPP, "Wrong link type");
+  NS_TEST_ASSERT_MSG_EQ (file1->GetSnapLen (), 65535, "Wrong snap length");
+  Config::SetGlobal ("PcapngFile", StringValue (""));
+  file0->Write (Seconds (1), Create<Packet> (10));
+  file1->Write (Seconds (2), Create<Packet> (20));
+  file0->Write (Seconds (3), Create<Packet> (30));
+  NS_TEST_ASSERT_MSG_EQ (file0->Fail (), false, "Cannot write the traces");
+
+  // the pcapng file is closed with the simulation
+  Simulator::Destroy ();
+
+  std::vector<PcapngBlock> blocks;
+  bool wellFormed = ReadPcapng (filename, blocks);
+  NS_TEST_ASSERT_MSG_EQ (wellFormed, true, "Malformed pcapng file");
+  NS_TEST_ASSERT_MSG_EQ (blocks.size (), 6, "Wrong number of blocks");
+  if (blocks.size () != 6)
+    {
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ (GetInterfaceName (blocks[1]), first, "Wrong interface name");
+  NS_TEST_ASSERT_MSG_EQ (GetInterfaceName (blocks[2]), second, "Wrong interface name");
+  const uint32_t interfaces[] = { 0, 1, 0 };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (Get32 (blocks[3 + i].body, 0), interfaces[i], "Wrong interface of packet " << i);
+      NS_TEST_ASSERT_MSG_EQ (Get32 (blocks[3 + i].body, 16), (i + 1) * 10, "Wrong length of packet " << i);
+    }
+  std::ifstream pcapFile (first.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (pcapFile.good (), false, "A pcap file was created");
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ * The pcapng writer test suite.
+ */
+class PcapngWriterTestSuite : public TestSuite
+{
+public:
+  PcapngWriterTestSuite ()
+    : TestSuite ("pcapng-writer", UNIT)
+  {
+    AddTestCase (new PcapngWriterTestCase (false), TestCase::QUICK);
+    AddTestCase (new PcapngWriterTestCase (true), TestCase::QUICK);
+    AddTestCase (new PcapngHelperTestCase, TestCase::QUICK);
+  }
+};
+
+static PcapngWriterTestSuite g_pcapngWriterTestSuite; //!< Static variable for test initialization
@@ -22,6 +22,7 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/simulation-context.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -140,8 +141,8 @@ Mac16Address
 Mac16Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
-  id++;
+  static ContextLocal<uint64_t> lastId;
+  uint64_t id = ++lastId.Get ();
   Mac16Address address;
   address.m_address[0] = (id >> 8) & 0xff;
   address.m_address[1] = (id >> 0) & 0xff;
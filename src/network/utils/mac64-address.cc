@@ -21,6 +21,7 @@
 #include "ns3/address.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/simulation-context.h"
 #include <iomanip>
 #include <iostream>
 #include <cstring>
@@ -137,8 +138,8 @@ Mac64Address
 Mac64Address::Allocate (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  static uint64_t id = 0;
-  id++;
+  static ContextLocal<uint64_t> lastId;
+  uint64_t id = ++lastId.Get ();
   Mac64Address address;
   address.m_address[0] = (id >> 56) & 0xff;
   address.m_address[1] = (id >> 48) & 0xff;
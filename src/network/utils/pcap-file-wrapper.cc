@@ -46,6 +46,9 @@ PcapFileWrapper::GetTypeId (void)
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_interface (0),
+    m_dataLinkType (0),
+    m_interfaceSnapLen (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -61,6 +64,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      return m_writer->Fail ();
+    }
   return m_file.Fail ();
 }
 bool 
@@ -80,6 +87,7 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  m_writer = 0;
   m_file.Close ();
 }
 
@@ -90,6 +98,14 @@ PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
   m_file.Open (filename, mode);
 }
 
+void
+PcapFileWrapper::Open (Ptr<PcapngWriter> writer, std::string const &name)
+{
+  NS_LOG_FUNCTION (this << writer << name);
+  m_writer = writer;
+  m_name = name;
+}
+
 void
 PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrection)
 {
@@ -99,20 +115,31 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
-  if (snapLen != std::numeric_limits<uint32_t>::max ())
+  if (snapLen == std::numeric_limits<uint32_t>::max ())
     {
-      m_file.Init (dataLinkType, snapLen, tzCorrection);
-    } 
+      snapLen = m_snapLen;
+    }
+  if (m_writer)
+    {
+      m_dataLinkType = dataLinkType;
+      m_interfaceSnapLen = snapLen;
+      m_interface = m_writer->AddInterface (dataLinkType, snapLen, m_name);
+    }
   else
     {
-      m_file.Init (dataLinkType, m_snapLen, tzCorrection);
-    } 
+      m_file.Init (dataLinkType, snapLen, tzCorrection);
+    }
 }
 
 void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_writer)
+    {
+      m_writer->Write (m_interface, t, p);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -124,6 +151,11 @@ void
 PcapFileWrapper::Write (Time t, Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_writer)
+    {
+      m_writer->Write (m_interface, t, header, p);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -135,6 +167,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_writer)
+    {
+      m_writer->Write (m_interface, t, buffer, length);
+      return;
+    }
   uint64_t current = t.GetMicroSeconds ();
   uint64_t s = current / 1000000;
   uint64_t us = current % 1000000;
@@ -181,6 +218,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      return m_interfaceSnapLen;
+    }
   return m_file.GetSnapLen ();
 }
 
@@ -188,6 +229,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer)
+    {
+      return m_dataLinkType;
+    }
   return m_file.GetDataLinkType ();
 }
 
@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-writer.h"
 
 namespace ns3 {
 
@@ -77,6 +78,18 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Write the packets to an interface of a shared pcapng file, instead
+   * of a pcap file of their own.  The interface is added to the file by
+   * Init().
+   *
+   * \param writer The writer of the pcapng file.
+   *
+   * \param name String containing the name of the interface, e.g. the
+   * name of the pcap file which would capture it.
+   */
+  void Open (Ptr<PcapngWriter> writer, std::string const &name);
+
   /**
    * Close the underlying pcap file.
    */
@@ -215,6 +228,11 @@ public:
 private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
+  Ptr<PcapngWriter> m_writer; //!< Shared pcapng file, or 0
+  std::string m_name; //!< Name of the interface of the pcapng file
+  uint32_t m_interface; //!< Interface of the pcapng file
+  uint32_t m_dataLinkType; //!< Data link type of the interface of the pcapng file
+  uint32_t m_interfaceSnapLen; //!< Max length of the packets of the interface of the pcapng file
 };
 
 } // namespace ns3
@@ -222,16 +222,18 @@ PcapFile::WriteFileHeader (void)
     }
 
   //
-  // Watch out for memory alignment differences between machines, so write
-  // them all individually.
-  //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  // Watch out for memory alignment differences between machines, so copy
+  // the fields individually, then write them at once.
+  //
+  uint8_t out[24];
+  std::memcpy (out, &headerOut->m_magicNumber, 4);
+  std::memcpy (out + 4, &headerOut->m_versionMajor, 2);
+  std::memcpy (out + 6, &headerOut->m_versionMinor, 2);
+  std::memcpy (out + 8, &headerOut->m_zone, 4);
+  std::memcpy (out + 12, &headerOut->m_sigFigs, 4);
+  std::memcpy (out + 16, &headerOut->m_snapLen, 4);
+  std::memcpy (out + 20, &headerOut->m_type, 4);
+  m_file.write ((const char *)out, sizeof (out));
 }
 
 void
@@ -390,13 +392,15 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     }
 
   //
-  // Watch out for memory alignment differences between machines, so write
-  // them all individually.
+  // Watch out for memory alignment differences between machines, so copy
+  // the fields individually.  The record is written at once by the caller,
+  // with the data of the packet.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
+  m_record.resize (16 + inclLen);
+  std::memcpy (&m_record[0], &header.m_tsSec, 4);
+  std::memcpy (&m_record[4], &header.m_tsUsec, 4);
+  std::memcpy (&m_record[8], &header.m_inclLen, 4);
+  std::memcpy (&m_record[12], &header.m_origLen, 4);
   return inclLen;
 }
 
@@ -405,7 +409,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
+  std::memcpy (&m_record[0] + 16, data, inclLen);
+  m_file.write ((const char *)&m_record[0], m_record.size ());
 }
 
 void 
@@ -413,7 +418,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
+  p->CopyData (&m_record[0] + 16, inclLen);
+  m_file.write ((const char *)&m_record[0], m_record.size ());
 }
 
 void 
@@ -428,9 +434,10 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Header &header, Ptr<const Pack
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
+  headerBuffer.CopyData (&m_record[0] + 16, toCopy);
   inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  p->CopyData (&m_record[0] + 16 + toCopy, inclLen);
+  m_file.write ((const char *)&m_record[0], m_record.size ());
 }
 
 void
@@ -23,6 +23,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ptr.h"
 
@@ -336,7 +337,8 @@ private:
    */
   void WriteFileHeader (void);
   /**
-   * \brief Write a Pcap packet header
+   * \brief Write a Pcap packet header at the start of m_record, and
+   * make room for the data of the packet after it
    * \param tsSec Time stamp (seconds part)
    * \param tsUsec Time stamp (microseconds part)
    * \param totalLen total packet length
@@ -353,6 +355,7 @@ private:
   std::fstream   m_file;        //!< file stream
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
+  std::vector<uint8_t> m_record; //!< record being written, to write it at once
 };
 
 } // namespace ns3
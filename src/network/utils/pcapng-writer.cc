@@ -0,0 +1,591 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ns3/core-config.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/buffer.h"
+#include "ns3/header.h"
+#include "ns3/packet.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif /* HAVE_PTHREAD_H */
+#include "pcapng-writer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapngWriter");
+
+NS_OBJECT_ENSURE_REGISTERED (PcapngWriter);
+
+const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;   /**< Type of the section header block */
+const uint32_t INTERFACE_BLOCK = 0x00000001;        /**< Type of the interface description block */
+const uint32_t ENHANCED_PACKET_BLOCK = 0x00000006;  /**< Type of the enhanced packet block */
+const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;       /**< Identifies the byte order of a section */
+const uint16_t OPTION_END = 0;                      /**< End of the options */
+const uint16_t OPTION_IF_NAME = 2;                  /**< Name of an interface */
+const uint16_t OPTION_IF_TSRESOL = 9;               /**< Resolution of the timestamps of an interface */
+const uint32_t PACKET_BLOCK_SIZE = 32;              /**< Size of an enhanced packet block without data */
+
+/**
+ * \param size A size.
+ * \returns The size rounded up to a multiple of 4.
+ */
+static uint32_t
+Pad (uint32_t size)
+{
+  return (size + 3) & ~3U;
+}
+
+/**
+ * Write a 32-bit value, in the byte order of the host.
+ *
+ * \param p The position.
+ * \param value The value.
+ * \returns The next position.
+ */
+static uint8_t *
+Put32 (uint8_t *p, uint32_t value)
+{
+  std::memcpy (p, &value, 4);
+  return p + 4;
+}
+
+/**
+ * Write a 16-bit value, in the byte order of the host.
+ *
+ * \param p The position.
+ * \param value The value.
+ * \returns The next position.
+ */
+static uint8_t *
+Put16 (uint8_t *p, uint16_t value)
+{
+  std::memcpy (p, &value, 2);
+  return p + 2;
+}
+
+TypeId
+PcapngWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PcapngWriter")
+    .SetParent<Object> ()
+    .SetGroupName ("Network")
+    .AddConstructor<PcapngWriter> ()
+    .AddAttribute ("BufferSize",
+                   "The size of a buffer of packets, in bytes.",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&PcapngWriter::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (4096))
+    .AddAttribute ("Buffers",
+                   "The maximum number of buffers of packets, being filled or queued to the writer.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&PcapngWriter::m_maxBuffers),
+                   MakeUintegerChecker<uint32_t> (2))
+    .AddAttribute ("DropWhenFull",
+                   "Drop the packets when all the buffers are queued to the writer, "
+                   "instead of waiting for the writer.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapngWriter::m_dropWhenFull),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Asynchronous",
+                   "Write the buffers in a writer thread, if threads are available.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&PcapngWriter::m_asynchronous),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+PcapngWriter::PcapngWriter ()
+  : m_fd (-1),
+    m_fail (false),
+    m_current (0),
+    m_writing (false),
+    m_stop (false),
+    m_written (0),
+    m_records (0),
+    m_dropped (0),
+    m_mutex (0),
+    m_queuedCondition (0),
+    m_freeCondition (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapngWriter::~PcapngWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+PcapngWriter::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+  Object::DoDispose ();
+}
+
+void
+PcapngWriter::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  NS_ASSERT (m_fd < 0);
+  m_filename = filename;
+  m_fd = open (filename.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  m_fail = m_fd < 0;
+  if (m_fail)
+    {
+      return;
+    }
+  m_current = AllocateBlock ();
+
+#ifdef HAVE_PTHREAD_H
+  if (m_asynchronous)
+    {
+      m_mutex = new SystemMutex ();
+      m_queuedCondition = new SystemCondition ();
+      m_freeCondition = new SystemCondition ();
+      m_stop = false;
+      m_thread = Create<SystemThread> (MakeCallback (&PcapngWriter::Run, this));
+      m_thread->Start ();
+    }
+#endif /* HAVE_PTHREAD_H */
+
+  // the section header block, of unknown length
+  uint8_t *p = Reserve (28, false);
+  p = Put32 (p, SECTION_HEADER_BLOCK);
+  p = Put32 (p, 28);
+  p = Put32 (p, BYTE_ORDER_MAGIC);
+  p = Put16 (p, 1);
+  p = Put16 (p, 0);
+  p = Put32 (p, 0xffffffff);
+  p = Put32 (p, 0xffffffff);
+  Put32 (p, 28);
+}
+
+bool
+PcapngWriter::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_mutex != 0)
+    {
+      CriticalSection critical (*m_mutex);
+      return m_fail;
+    }
+#endif /* HAVE_PTHREAD_H */
+  return m_fail;
+}
+
+uint32_t
+PcapngWriter::AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string name)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name);
+  NS_ASSERT (m_fd >= 0);
+  Interface interface;
+  interface.snapLen = snapLen;
+  m_interfaces.push_back (interface);
+
+  // the interface description block, with its name and nanosecond
+  // timestamps
+  uint32_t nameSize = std::min<uint32_t> (name.size (), 0xffff);
+  uint32_t size = 16 + (nameSize > 0 ? 4 + Pad (nameSize) : 0) + 8 + 4 + 4;
+  uint8_t *p = Reserve (size, false);
+  std::memset (p, 0, size);
+  p = Put32 (p, INTERFACE_BLOCK);
+  p = Put32 (p, size);
+  p = Put16 (p, dataLinkType);
+  p = Put16 (p, 0);
+  p = Put32 (p, snapLen);
+  if (nameSize > 0)
+    {
+      p = Put16 (p, OPTION_IF_NAME);
+      p = Put16 (p, nameSize);
+      std::memcpy (p, name.data (), nameSize);
+      p += Pad (nameSize);
+    }
+  p = Put16 (p, OPTION_IF_TSRESOL);
+  p = Put16 (p, 1);
+  *p = 9;
+  p += 4;
+  p = Put16 (p, OPTION_END);
+  p = Put16 (p, 0);
+  Put32 (p, size);
+  return m_interfaces.size () - 1;
+}
+
+uint8_t *
+PcapngWriter::StartPacket (uint32_t interface, Time t, uint32_t totalLen, uint32_t &inclLen)
+{
+  NS_ASSERT_MSG (interface < m_interfaces.size (), "Unknown interface " << interface);
+  inclLen = std::min (totalLen, m_interfaces[interface].snapLen);
+  inclLen = std::min (inclLen, m_bufferSize - PACKET_BLOCK_SIZE);
+  uint32_t size = PACKET_BLOCK_SIZE + Pad (inclLen);
+  uint8_t *p = Reserve (size, m_dropWhenFull);
+  if (p == 0)
+    {
+      m_dropped++;
+      return 0;
+    }
+  uint64_t ts = t.GetNanoSeconds ();
+  p = Put32 (p, ENHANCED_PACKET_BLOCK);
+  p = Put32 (p, size);
+  p = Put32 (p, interface);
+  p = Put32 (p, ts >> 32);
+  p = Put32 (p, ts & 0xffffffff);
+  p = Put32 (p, inclLen);
+  p = Put32 (p, totalLen);
+  std::memset (p + inclLen, 0, Pad (inclLen) - inclLen);
+  Put32 (p + Pad (inclLen), size);
+  m_current->records++;
+  m_records++;
+  return p;
+}
+
+void
+PcapngWriter::Write (uint32_t interface, Time t, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << t << p);
+  uint32_t inclLen;
+  uint8_t *data = StartPacket (interface, t, p->GetSize (), inclLen);
+  if (data != 0)
+    {
+      p->CopyData (data, inclLen);
+    }
+}
+
+void
+PcapngWriter::Write (uint32_t interface, Time t, Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << t << &header << p);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t inclLen;
+  uint8_t *data = StartPacket (interface, t, headerSize + p->GetSize (), inclLen);
+  if (data == 0)
+    {
+      return;
+    }
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (data, toCopy);
+  p->CopyData (data + toCopy, inclLen - toCopy);
+}
+
+void
+PcapngWriter::Write (uint32_t interface, Time t, uint8_t const *buffer, uint32_t length)
+{
+  NS_LOG_FUNCTION (this << interface << t << &buffer << length);
+  uint32_t inclLen;
+  uint8_t *data = StartPacket (interface, t, length, inclLen);
+  if (data != 0)
+    {
+      std::memcpy (data, buffer, inclLen);
+    }
+}
+
+uint8_t *
+PcapngWriter::Reserve (uint32_t size, bool drop)
+{
+  NS_ASSERT (size <= m_bufferSize);
+  if (m_current == 0 || m_current->size + size > m_bufferSize)
+    {
+      Dispatch (!drop);
+      if (m_current == 0)
+        {
+          return 0;
+        }
+    }
+  uint8_t *p = m_current->data + m_current->size;
+  m_current->size += size;
+  return p;
+}
+
+PcapngWriter::Block *
+PcapngWriter::AllocateBlock (void)
+{
+  NS_LOG_FUNCTION (this);
+  void *data;
+  if (posix_memalign (&data, 4096, m_bufferSize) != 0)
+    {
+      NS_FATAL_ERROR ("Cannot allocate a pcapng buffer of " << m_bufferSize << " bytes");
+    }
+  Block *block = new Block;
+  block->data = static_cast<uint8_t *> (data);
+  block->size = 0;
+  block->records = 0;
+  m_blocks.push_back (block);
+  return block;
+}
+
+void
+PcapngWriter::Dispatch (bool wait)
+{
+  NS_LOG_FUNCTION (this << wait);
+  if (m_thread == 0)
+    {
+      // the buffer is written right away, and reused
+      WriteBlock (m_current);
+      m_written += m_current->records;
+      m_current->size = 0;
+      m_current->records = 0;
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_current != 0)
+    {
+      if (m_current->size == 0)
+        {
+          return;
+        }
+      m_mutex->Lock ();
+      m_queued.push_back (m_current);
+      m_queuedCondition->SetCondition (true);
+      m_queuedCondition->Signal ();
+      m_mutex->Unlock ();
+      m_current = 0;
+    }
+  while (m_current == 0)
+    {
+      // reset before looking at the free buffers, so that a buffer freed in
+      // between ends the wait right away
+      m_freeCondition->SetCondition (false);
+      m_mutex->Lock ();
+      if (!m_free.empty ())
+        {
+          m_current = m_free.back ();
+          m_free.pop_back ();
+        }
+      m_mutex->Unlock ();
+      if (m_current == 0 && m_blocks.size () < m_maxBuffers)
+        {
+          m_current = AllocateBlock ();
+        }
+      if (m_current == 0)
+        {
+          if (!wait)
+            {
+              return;
+            }
+          m_freeCondition->Wait ();
+        }
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+PcapngWriter::WriteBlock (Block *block)
+{
+  NS_LOG_FUNCTION (this << block->size << block->records);
+  const uint8_t *data = block->data;
+  uint32_t left = block->size;
+  bool fail = false;
+  while (left > 0)
+    {
+      ssize_t n = write (m_fd, data, left);
+      if (n < 0 && errno == EINTR)
+        {
+          continue;
+        }
+      if (n <= 0)
+        {
+          fail = true;
+          break;
+        }
+      data += n;
+      left -= n;
+    }
+  if (!fail)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_mutex != 0)
+    {
+      CriticalSection critical (*m_mutex);
+      m_fail = true;
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  m_fail = true;
+}
+
+void
+PcapngWriter::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_queuedCondition->SetCondition (false);
+      m_mutex->Lock ();
+      Block *block = 0;
+      if (!m_queued.empty ())
+        {
+          block = m_queued.front ();
+          m_queued.pop_front ();
+          m_writing = true;
+        }
+      bool stop = m_stop;
+      m_mutex->Unlock ();
+      if (block == 0)
+        {
+          if (stop)
+            {
+              break;
+            }
+          m_queuedCondition->Wait ();
+          continue;
+        }
+      WriteBlock (block);
+      m_mutex->Lock ();
+      m_written += block->records;
+      block->size = 0;
+      block->records = 0;
+      m_free.push_back (block);
+      m_writing = false;
+      m_freeCondition->SetCondition (true);
+      m_freeCondition->Signal ();
+      m_mutex->Unlock ();
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+PcapngWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fd < 0)
+    {
+      return;
+    }
+  Dispatch (true);
+#ifdef HAVE_PTHREAD_H
+  while (m_thread != 0)
+    {
+      m_freeCondition->SetCondition (false);
+      m_mutex->Lock ();
+      bool done = m_queued.empty () && !m_writing;
+      m_mutex->Unlock ();
+      if (done)
+        {
+          break;
+        }
+      m_freeCondition->Wait ();
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+PcapngWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fd < 0)
+    {
+      return;
+    }
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      m_mutex->Lock ();
+      m_stop = true;
+      m_queuedCondition->SetCondition (true);
+      m_queuedCondition->Signal ();
+      m_mutex->Unlock ();
+      m_thread->Join ();
+      m_thread = 0;
+      delete m_freeCondition;
+      delete m_queuedCondition;
+      delete m_mutex;
+      m_freeCondition = 0;
+      m_queuedCondition = 0;
+      m_mutex = 0;
+    }
+#endif /* HAVE_PTHREAD_H */
+  if (close (m_fd) != 0)
+    {
+      m_fail = true;
+    }
+  m_fd = -1;
+  for (std::vector<Block *>::iterator i = m_blocks.begin (); i != m_blocks.end (); i++)
+    {
+      std::free ((*i)->data);
+      delete *i;
+    }
+  m_blocks.clear ();
+  m_free.clear ();
+  m_queued.clear ();
+  m_current = 0;
+  NS_LOG_INFO (m_filename << ": " << m_written << " packets written, "
+                          << m_dropped << " dropped");
+  if (m_dropped > 0)
+    {
+      NS_LOG_WARN (m_filename << ": " << m_dropped << " packets dropped, the writer was too slow");
+    }
+}
+
+uint64_t
+PcapngWriter::GetRecords (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_records;
+}
+
+uint64_t
+PcapngWriter::GetWrittenRecords (void) const
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_mutex != 0)
+    {
+      CriticalSection critical (*m_mutex);
+      return m_written;
+    }
+#endif /* HAVE_PTHREAD_H */
+  return m_written;
+}
+
+uint64_t
+PcapngWriter::GetQueuedRecords (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_records - GetWrittenRecords ();
+}
+
+uint64_t
+PcapngWriter::GetDroppedRecords (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_dropped;
+}
+
+} // namespace ns3
@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef PCAPNG_WRITER_H
+#define PCAPNG_WRITER_H
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class Packet;
+class Header;
+class SystemThread;
+class SystemMutex;
+class SystemCondition;
+
+/**
+ * \ingroup network
+ * \brief Write the captures of many interfaces to one pcapng file.
+ *
+ * Each capture is an interface of the file, added with AddInterface(),
+ * and its packets are written as enhanced packet blocks with the id of
+ * the interface and a timestamp in nanoseconds. Wireshark and tcpdump
+ * read such files, and can split them by interface.
+ *
+ * The blocks are serialized in large buffers, aligned on pages: a full
+ * buffer is queued to a writer thread, which writes it with one system
+ * call, while the simulation fills the next buffer. The number of
+ * buffers is bounded: when they are all queued, the simulation waits
+ * for the writer thread, or drops the packets if DropWhenFull is set.
+ * Without threads, or if Asynchronous is false, the full buffers are
+ * written by the simulation itself.
+ *
+ * The blocks are written in the byte order of the host, as allowed by
+ * the pcapng format.
+ */
+class PcapngWriter : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PcapngWriter ();
+  virtual ~PcapngWriter ();
+
+  /**
+   * Create the file, and write its section header block.
+   *
+   * \param filename The name of the file.
+   */
+  void Open (std::string filename);
+
+  /**
+   * \return true if the file cannot be opened or written.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Add an interface to the file.
+   *
+   * \param dataLinkType The data link type of the packets, as in
+   *        PcapFile::Init().
+   * \param snapLen The maximum size of the packets written to the file,
+   *        longer packets are truncated.
+   * \param name The name of the interface, e.g. the name of the pcap
+   *        file which would capture it.
+   * \returns The id of the interface.
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string name);
+
+  /**
+   * \brief Write a packet of an interface.
+   *
+   * \param interface The id of the interface.
+   * \param t The timestamp of the packet.
+   * \param p The packet.
+   */
+  void Write (uint32_t interface, Time t, Ptr<const Packet> p);
+
+  /**
+   * \brief Write a header and a packet of an interface.
+   *
+   * \param interface The id of the interface.
+   * \param t The timestamp of the packet.
+   * \param header The header to prepend to the packet.
+   * \param p The packet.
+   */
+  void Write (uint32_t interface, Time t, Header &header, Ptr<const Packet> p);
+
+  /**
+   * \brief Write a data buffer of an interface.
+   *
+   * \param interface The id of the interface.
+   * \param t The timestamp of the data.
+   * \param buffer The data.
+   * \param length The size of the data.
+   */
+  void Write (uint32_t interface, Time t, uint8_t const *buffer, uint32_t length);
+
+  /**
+   * Write all the packets to the file, and wait until they are written.
+   */
+  void Flush (void);
+
+  /**
+   * Write all the packets to the file, stop the writer thread and
+   * close the file.
+   */
+  void Close (void);
+
+  /**
+   * \returns The number of packets serialized in the buffers.
+   */
+  uint64_t GetRecords (void) const;
+  /**
+   * \returns The number of packets written to the file.
+   */
+  uint64_t GetWrittenRecords (void) const;
+  /**
+   * \returns The number of packets not yet written to the file.
+   */
+  uint64_t GetQueuedRecords (void) const;
+  /**
+   * \returns The number of packets dropped because all the buffers
+   *          were queued, see DropWhenFull.
+   */
+  uint64_t GetDroppedRecords (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /** A buffer of blocks. */
+  struct Block
+  {
+    uint8_t *data;        //!< The data, aligned on a page.
+    uint32_t size;        //!< The size of the blocks.
+    uint32_t records;     //!< The number of packets.
+  };
+  /** An interface. */
+  struct Interface
+  {
+    uint32_t snapLen;     //!< The maximum size of a packet.
+  };
+
+  /**
+   * Reserve room for a block in the current buffer.
+   *
+   * \param size The size of the block, a multiple of 4.
+   * \param drop Drop the block if all the buffers are queued, instead of
+   *        waiting for the writer.
+   * \returns The room, or 0 if the block is dropped.
+   */
+  uint8_t *Reserve (uint32_t size, bool drop);
+  /**
+   * Start an enhanced packet block.
+   *
+   * \param interface The id of the interface.
+   * \param t The timestamp.
+   * \param totalLen The size of the packet.
+   * \param inclLen The size of the packet written to the file.
+   * \returns The room of the data of the packet, or 0 if the packet is
+   *          dropped.
+   */
+  uint8_t *StartPacket (uint32_t interface, Time t, uint32_t totalLen, uint32_t &inclLen);
+  /**
+   * Queue the current buffer to the writer, and get a free one.
+   *
+   * \param wait Wait for a free buffer if they are all queued.
+   */
+  void Dispatch (bool wait);
+  /**
+   * Write a buffer to the file.
+   *
+   * \param block The buffer.
+   */
+  void WriteBlock (Block *block);
+  /** The writer thread. */
+  void Run (void);
+  /** \returns A new buffer. */
+  Block *AllocateBlock (void);
+
+  std::string m_filename;              //!< The name of the file.
+  int m_fd;                            //!< The file, or -1.
+  bool m_fail;                         //!< The file cannot be written.
+  uint32_t m_bufferSize;               //!< The size of a buffer.
+  uint32_t m_maxBuffers;               //!< The maximum number of buffers.
+  bool m_dropWhenFull;                 //!< Drop the packets when all the buffers are queued.
+  bool m_asynchronous;                 //!< Write the buffers in a writer thread.
+  std::vector<Interface> m_interfaces; //!< The interfaces, by id.
+  Block *m_current;                    //!< The buffer being filled, or 0 if full.
+  std::vector<Block *> m_blocks;       //!< All the buffers.
+
+  // shared with the writer thread, protected by m_mutex
+  std::deque<Block *> m_queued;        //!< The buffers to write.
+  std::vector<Block *> m_free;         //!< The free buffers.
+  bool m_writing;                      //!< The writer thread is writing a buffer.
+  bool m_stop;                         //!< The writer thread must stop.
+  uint64_t m_written;                  //!< The number of packets written.
+
+  uint64_t m_records;                  //!< The number of packets serialized.
+  uint64_t m_dropped;                  //!< The number of packets dropped.
+  SystemMutex *m_mutex;                //!< The lock of the buffers, or 0.
+  SystemCondition *m_queuedCondition;  //!< Signalled when a buffer is queued.
+  SystemCondition *m_freeCondition;    //!< Signalled when a buffer is free.
+  Ptr<SystemThread> m_thread;          //!< The writer thread, or 0.
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_WRITER_H */
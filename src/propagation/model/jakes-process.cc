@@ -97,6 +97,12 @@ JakesProcess::ConstructOscillators ()
   double phi = m_jakes->GetUniformRandomVariable ()->GetValue ();
   // Theta is common for all oscillatoer:
   double theta = m_jakes->GetUniformRandomVariable ()->GetValue ();
+  // The phases of the amplitudes, drawn in bulk:
+  std::vector<double> psis (m_nOscillators);
+  if (m_nOscillators > 0)
+    {
+      m_jakes->GetUniformRandomVariable ()->GetValues (&psis[0], m_nOscillators);
+    }
   for (unsigned int i = 0; i < m_nOscillators; i++)
     {
       unsigned int n = i + 1;
@@ -106,7 +112,7 @@ JakesProcess::ConstructOscillators ()
       /// 1b. Initiate rotation speed:
       double omega = m_omegaDopplerMax * std::cos (alpha);
       /// 2. Initiate complex amplitude:
-      double psi = m_jakes->GetUniformRandomVariable ()->GetValue ();
+      double psi = psis[i];
       std::complex<double> amplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (m_nOscillators);
       /// 3. Construct oscillator:
       m_oscillators.push_back (Oscillator (amplitude, phi, omega)); 
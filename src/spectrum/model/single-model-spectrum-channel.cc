@@ -33,6 +33,8 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <algorithm>
+#include <cmath>
 
 
 #include "single-model-spectrum-channel.h"
@@ -45,6 +47,8 @@ NS_LOG_COMPONENT_DEFINE ("SingleModelSpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED (SingleModelSpectrumChannel);
 
 SingleModelSpectrumChannel::SingleModelSpectrumChannel ()
+  : m_receiverCullingRange (0.0),
+    m_receiverGridDirty (true)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -53,6 +57,15 @@ void
 SingleModelSpectrumChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  for (std::set<Ptr<MobilityModel> >::const_iterator it = m_trackedMobilities.begin ();
+       it != m_trackedMobilities.end ();
+       ++it)
+    {
+      (*it)->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&SingleModelSpectrumChannel::NotifyCourseChange, this));
+    }
+  m_trackedMobilities.clear ();
+  m_receiverGrid.clear ();
+  m_unlocatedReceivers.clear ();
   m_phyList.clear ();
   m_spectrumModel = 0;
   m_propagationDelay = 0;
@@ -83,6 +96,25 @@ SingleModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&SingleModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("ReceiverCullingRange",
+                   "If positive, the maximum distance in meters between "
+                   "the transmitter and the receivers to which transmissions "
+                   "will be passed. Receivers are looked up in a grid over "
+                   "their positions, so the propagation models are not even "
+                   "evaluated for receivers beyond this range. Like MaxLossDb, "
+                   "this reduces the computational load for large deployments; "
+                   "set it beyond the range at which the loss exceeds the "
+                   "interference range. Receivers without mobility model "
+                   "are never culled. The positions of the receivers are "
+                   "updated on their CourseChange, so a receiver which moves "
+                   "without notifying it, like a ConstantVelocityMobilityModel "
+                   "between velocity changes, may be culled by its old "
+                   "position. The PathLoss trace is not fired for the culled "
+                   "receivers. The default value disables culling.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&SingleModelSpectrumChannel::SetReceiverCullingRange,
+                                       &SingleModelSpectrumChannel::GetReceiverCullingRange),
+                   MakeDoubleChecker<double> ())
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -107,6 +139,7 @@ SingleModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
   m_phyList.push_back (phy);
+  m_receiverGridDirty = true;
 }
 
 
@@ -134,80 +167,219 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
+  if (m_receiverCullingRange > 0 && senderMobility)
+    {
+      FindReceiverCandidates (senderMobility->GetPosition ());
+      NS_LOG_LOGIC ("passing signal to " << m_receiverCandidates.size () << " of "
+                                         << m_phyList.size () << " receivers");
+      for (std::vector<uint32_t>::const_iterator it = m_receiverCandidates.begin ();
+           it != m_receiverCandidates.end ();
+           ++it)
+        {
+          StartTxToReceiver (txParams, senderMobility, m_phyList[*it]);
+        }
+      return;
+    }
+
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
        ++rxPhyIterator)
     {
-      if ((*rxPhyIterator) != txParams->txPhy)
+      StartTxToReceiver (txParams, senderMobility, *rxPhyIterator);
+    }
+}
+
+void
+SingleModelSpectrumChannel::StartTxToReceiver (Ptr<SpectrumSignalParameters> txParams,
+                                               Ptr<MobilityModel> senderMobility,
+                                               Ptr<SpectrumPhy> receiver)
+{
+  if (receiver == txParams->txPhy)
+    {
+      return;
+    }
+
+  Time delay  = MicroSeconds (0);
+
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+  NS_LOG_LOGIC ("copying signal parameters " << txParams);
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+
+  if (senderMobility && receiverMobility)
+    {
+      double pathLossDb = 0;
+      if (rxParams->txAntenna != 0)
+        {
+          Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+          double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+          NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+          pathLossDb -= txAntennaGain;
+        }
+      Ptr<AntennaModel> rxAntenna = receiver->GetRxAntenna ();
+      if (rxAntenna != 0)
+        {
+          Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
+          double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+          NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+          pathLossDb -= rxAntennaGain;
+        }
+      if (m_propagationLoss)
+        {
+          double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
+          NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+          pathLossDb -= propagationGainDb;
+        }                    
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
+      m_pathLossTrace (txParams->txPhy, receiver, pathLossDb);
+      if ( pathLossDb > m_maxLossDb)
+        {
+          // beyond range
+          return;
+        }
+      double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+      *(rxParams->psd) *= pathGainLinear;              
+
+      if (m_spectrumPropagationLoss)
+        {
+          rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
+        }
+
+      if (m_propagationDelay)
+        {
+          delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
+        }
+    }
+
+
+  Ptr<NetDevice> netDev = receiver->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode =  netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &SingleModelSpectrumChannel::StartRx, this, rxParams, receiver);
+    }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &SingleModelSpectrumChannel::StartRx, this,
+                           rxParams, receiver);
+    }
+}
+
+bool
+SingleModelSpectrumChannel::GridCell::operator< (const GridCell &other) const
+{
+  if (x != other.x)
+    {
+      return x < other.x;
+    }
+  if (y != other.y)
+    {
+      return y < other.y;
+    }
+  return z < other.z;
+}
+
+SingleModelSpectrumChannel::GridCell
+SingleModelSpectrumChannel::GetGridCell (const Vector &position) const
+{
+  GridCell cell;
+  cell.x = static_cast<int64_t> (std::floor (position.x / m_receiverCullingRange));
+  cell.y = static_cast<int64_t> (std::floor (position.y / m_receiverCullingRange));
+  cell.z = static_cast<int64_t> (std::floor (position.z / m_receiverCullingRange));
+  return cell;
+}
+
+void
+SingleModelSpectrumChannel::SetReceiverCullingRange (double range)
+{
+  NS_LOG_FUNCTION (this << range);
+  m_receiverCullingRange = range;
+  // the cells of the grid have the size of the range
+  m_receiverGridDirty = true;
+}
+
+double
+SingleModelSpectrumChannel::GetReceiverCullingRange (void) const
+{
+  return m_receiverCullingRange;
+}
+
+void
+SingleModelSpectrumChannel::BuildReceiverGrid (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_receiverGrid.clear ();
+  m_unlocatedReceivers.clear ();
+  for (uint32_t i = 0; i < m_phyList.size (); i++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[i]->GetMobility ();
+      if (mobility == 0)
+        {
+          m_unlocatedReceivers.push_back (i);
+          continue;
+        }
+      m_receiverGrid[GetGridCell (mobility->GetPosition ())].push_back (i);
+      if (m_trackedMobilities.insert (mobility).second)
         {
-          Time delay  = MicroSeconds (0);
+          mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&SingleModelSpectrumChannel::NotifyCourseChange, this));
+        }
+    }
+  m_receiverGridDirty = false;
+}
 
-          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-          NS_LOG_LOGIC ("copying signal parameters " << txParams);
-          Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+void
+SingleModelSpectrumChannel::FindReceiverCandidates (const Vector &position)
+{
+  // a mobility model may have been attached to a receiver after AddRx
+  for (std::vector<uint32_t>::const_iterator it = m_unlocatedReceivers.begin ();
+       it != m_unlocatedReceivers.end () && !m_receiverGridDirty;
+       ++it)
+    {
+      m_receiverGridDirty = m_phyList[*it]->GetMobility () != 0;
+    }
+  if (m_receiverGridDirty)
+    {
+      BuildReceiverGrid ();
+    }
 
-          if (senderMobility && receiverMobility)
+  m_receiverCandidates = m_unlocatedReceivers;
+  GridCell center = GetGridCell (position);
+  GridCell cell;
+  for (cell.x = center.x - 1; cell.x <= center.x + 1; cell.x++)
+    {
+      for (cell.y = center.y - 1; cell.y <= center.y + 1; cell.y++)
+        {
+          for (cell.z = center.z - 1; cell.z <= center.z + 1; cell.z++)
             {
-              double pathLossDb = 0;
-              if (rxParams->txAntenna != 0)
-                {
-                  Angles txAngles (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-                  double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                  NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                  pathLossDb -= txAntennaGain;
-                }
-              Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-              if (rxAntenna != 0)
-                {
-                  Angles rxAngles (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-                  double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                  NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                  pathLossDb -= rxAntennaGain;
-                }
-              if (m_propagationLoss)
+              std::map<GridCell, std::vector<uint32_t> >::const_iterator it = m_receiverGrid.find (cell);
+              if (it == m_receiverGrid.end ())
                 {
-                  double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
-                  NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                  pathLossDb -= propagationGainDb;
-                }                    
-              NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-              m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-              if ( pathLossDb > m_maxLossDb)
-                {
-                  // beyond range
                   continue;
                 }
-              double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-              *(rxParams->psd) *= pathGainLinear;              
-
-              if (m_spectrumPropagationLoss)
-                {
-                  rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, senderMobility, receiverMobility);
-                }
-
-              if (m_propagationDelay)
+              for (std::vector<uint32_t>::const_iterator rx = it->second.begin (); rx != it->second.end (); ++rx)
                 {
-                  delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
+                  Vector rxPosition = m_phyList[*rx]->GetMobility ()->GetPosition ();
+                  if (CalculateDistance (position, rxPosition) <= m_receiverCullingRange)
+                    {
+                      m_receiverCandidates.push_back (*rx);
+                    }
                 }
             }
-
-
-          Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-          if (netDev)
-            {
-              // the receiver has a NetDevice, so we expect that it is attached to a Node
-              uint32_t dstNode =  netDev->GetNode ()->GetId ();
-              Simulator::ScheduleWithContext (dstNode, delay, &SingleModelSpectrumChannel::StartRx, this, rxParams, *rxPhyIterator);
-            }
-          else
-            {
-              // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-              Simulator::Schedule (delay, &SingleModelSpectrumChannel::StartRx, this,
-                                   rxParams, *rxPhyIterator);
-            }
         }
     }
 
+  // Keep the order of m_phyList, so that receptions at the same time are
+  // scheduled in the same order as without culling.
+  std::sort (m_receiverCandidates.begin (), m_receiverCandidates.end ());
+}
+
+void
+SingleModelSpectrumChannel::NotifyCourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  m_receiverGridDirty = true;
 }
 
 void
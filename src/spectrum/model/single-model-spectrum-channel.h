@@ -25,10 +25,14 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-model.h>
 #include <ns3/traced-callback.h>
+#include <ns3/vector.h>
+#include <map>
+#include <set>
+#include <vector>
 
 namespace ns3 {
 
-
+class MobilityModel;
 
 /**
  * \ingroup spectrum
@@ -36,6 +40,18 @@ namespace ns3 {
  * @brief SpectrumChannel implementation which handles a single spectrum model
  *
  * All SpectrumPhy layers attached to this SpectrumChannel
+ *
+ * If the attribute ReceiverCullingRange is set, receivers are indexed in a
+ * uniform grid over their positions, with the culling range as cell size.
+ * A transmission is then only passed to the receivers within the culling range
+ * of the transmitter, which are found in the 27 grid cells around it, instead
+ * of evaluating the propagation loss towards every attached receiver. The grid
+ * is rebuilt at the first transmission after a receiver was added, got a
+ * mobility model, or notified a CourseChange, or after the range was changed.
+ * A receiver which moves without notifying a CourseChange, like a
+ * ConstantVelocityMobilityModel between velocity changes, stays in the cell of
+ * its last notified position, and may thus be culled although it is in range.
+ * The PathLoss trace is only fired for the receivers which are not culled.
  */
 class SingleModelSpectrumChannel : public SpectrumChannel
 {
@@ -53,6 +69,19 @@ public:
   virtual void AddRx (Ptr<SpectrumPhy> phy);
   virtual void StartTx (Ptr<SpectrumSignalParameters> params);
 
+  /**
+   * Set the culling range, see the ReceiverCullingRange attribute.
+   *
+   * @param range the maximum distance in meters between the transmitter and
+   *        the receivers, or 0 to disable culling
+   */
+  void SetReceiverCullingRange (double range);
+
+  /**
+   * @return the culling range in meters, 0 if culling is disabled
+   */
+  double GetReceiverCullingRange (void) const;
+
 
   // inherited from Channel
   virtual uint32_t GetNDevices (void) const;
@@ -74,6 +103,62 @@ private:
    */
   void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Apply the propagation models towards a single receiver and schedule the
+   * reception of the signal.
+   *
+   * @param txParams the parameters of the transmitted signal
+   * @param senderMobility the mobility of the transmitter, may be null
+   * @param receiver the receiver
+   */
+  void StartTxToReceiver (Ptr<SpectrumSignalParameters> txParams,
+                          Ptr<MobilityModel> senderMobility,
+                          Ptr<SpectrumPhy> receiver);
+
+  /**
+   * A cell of the receiver grid.
+   */
+  struct GridCell
+  {
+    int64_t x; //!< Cell index along the x axis
+    int64_t y; //!< Cell index along the y axis
+    int64_t z; //!< Cell index along the z axis
+
+    /**
+     * @param other the cell to compare with
+     * @return true, if this cell is ordered before the other cell
+     */
+    bool operator< (const GridCell &other) const;
+  };
+
+  /**
+   * @param position a position
+   * @return the grid cell containing the position
+   */
+  GridCell GetGridCell (const Vector &position) const;
+
+  /**
+   * Sort all receivers into the grid and connect to the CourseChange trace
+   * of their mobility models.
+   */
+  void BuildReceiverGrid (void);
+
+  /**
+   * Collect the indices into m_phyList of all receivers within the culling
+   * range of the given position, plus all receivers without mobility, in the
+   * order of m_phyList.
+   *
+   * @param position the position of the transmitter
+   */
+  void FindReceiverCandidates (const Vector &position);
+
+  /**
+   * Invalidate the receiver grid, when a receiver moved.
+   *
+   * @param mobility the mobility model of the receiver
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility);
+
   /**
    * list of SpectrumPhy instances attached to
    * the channel
@@ -109,6 +194,38 @@ private:
 
   double m_maxLossDb;
 
+  /**
+   * Maximum distance in meters between transmitter and receivers, if
+   * positive. Otherwise, receivers are not culled.
+   */
+  double m_receiverCullingRange;
+
+  /**
+   * The indices into m_phyList of the receivers, by grid cell.
+   */
+  std::map<GridCell, std::vector<uint32_t> > m_receiverGrid;
+
+  /**
+   * The indices into m_phyList of the receivers without mobility, which are
+   * never culled.
+   */
+  std::vector<uint32_t> m_unlocatedReceivers;
+
+  /**
+   * The mobility models connected to NotifyCourseChange.
+   */
+  std::set<Ptr<MobilityModel> > m_trackedMobilities;
+
+  /**
+   * True, if the receiver grid has to be rebuilt before next use.
+   */
+  bool m_receiverGridDirty;
+
+  /**
+   * The receivers found by FindReceiverCandidates, kept to reuse the memory.
+   */
+  std::vector<uint32_t> m_receiverCandidates;
+
   TracedCallback<Ptr<SpectrumPhy>, Ptr<SpectrumPhy>, double > m_pathLossTrace;
 };
 
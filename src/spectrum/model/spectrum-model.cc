@@ -41,7 +41,8 @@ SpectrumModelUid_t SpectrumModel::m_uidCount = 0;
 SpectrumModel::SpectrumModel (std::vector<double> centerFreqs)
 {
   NS_ASSERT (centerFreqs.size () > 1);
-  m_uid = ++m_uidCount;
+  // the models of several simulation threads must have distinct uids
+  m_uid = __sync_add_and_fetch (&m_uidCount, 1);
 
   for (std::vector<double>::const_iterator it = centerFreqs.begin ();
        it != centerFreqs.end ();
@@ -72,7 +73,7 @@ SpectrumModel::SpectrumModel (std::vector<double> centerFreqs)
 
 SpectrumModel::SpectrumModel (Bands bands)
 {
-  m_uid = ++m_uidCount;
+  m_uid = __sync_add_and_fetch (&m_uidCount, 1);
   NS_LOG_INFO ("creating new SpectrumModel, m_uid=" << m_uid);
   m_bands = bands;
 }
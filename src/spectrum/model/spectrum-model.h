@@ -59,8 +59,10 @@ typedef uint32_t SpectrumModelUid_t;
  * Hz. It is intended that frequency values are non-negative, though
  * this is not enforced.
  *
+ * A SpectrumModel is immutable, so it can be shared by the simulations
+ * of several threads, see SimulationContext.
  */
-class SpectrumModel : public SimpleRefCount<SpectrumModel>
+class SpectrumModel : public SharedRefCount<SpectrumModel>
 {
 public:
   friend bool operator== (const SpectrumModel& lhs, const SpectrumModel& rhs);
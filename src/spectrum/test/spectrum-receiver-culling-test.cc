@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-model-ism2400MHz-res1MHz.h>
+#include <ns3/single-model-spectrum-channel.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumReceiverCullingTest");
+
+/**
+ * SpectrumPhy which counts the signals passed to it by the channel.
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+public:
+  CountingSpectrumPhy ()
+    : m_rxCount (0)
+  {
+  }
+
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice ()
+  {
+    return 0;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility ()
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return SpectrumModelIsm2400MhzRes1Mhz;
+  }
+  virtual Ptr<AntennaModel> GetRxAntenna ()
+  {
+    return 0;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    m_rxCount++;
+  }
+
+  uint32_t m_rxCount;  //!< Number of signals received
+  Ptr<MobilityModel> m_mobility; //!< The mobility model, may be null
+};
+
+class SpectrumReceiverCullingTestCase : public TestCase
+{
+public:
+  SpectrumReceiverCullingTestCase (double cullingRange);
+
+private:
+  virtual void DoRun (void);
+
+  double m_cullingRange; //!< Culling range of the channel, 0 to disable culling
+};
+
+SpectrumReceiverCullingTestCase::SpectrumReceiverCullingTestCase (double cullingRange)
+  : TestCase ("Test the receiver culling of SingleModelSpectrumChannel, culling range "
+              + std::string (cullingRange > 0 ? "100 m" : "disabled")),
+    m_cullingRange (cullingRange)
+{
+}
+
+static void
+StartTx (Ptr<SpectrumChannel> channel, Ptr<SpectrumPhy> txPhy)
+{
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->psd = Create<SpectrumValue> (SpectrumModelIsm2400MhzRes1Mhz);
+  (*params->psd) = 1.0e-10;
+  params->duration = MilliSeconds (1);
+  params->txPhy = txPhy;
+  channel->StartTx (params);
+}
+
+void
+SpectrumReceiverCullingTestCase::DoRun (void)
+{
+  Ptr<SingleModelSpectrumChannel> channel = CreateObject<SingleModelSpectrumChannel> ();
+  channel->SetAttribute ("ReceiverCullingRange", DoubleValue (m_cullingRange));
+  channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+
+  // The receivers within 100 m of the transmitter at the origin are the
+  // first four, and the last one, which has no mobility model.
+  std::vector<Vector> positions;
+  positions.push_back (Vector (30, 0, 0));
+  positions.push_back (Vector (99.9, 0, 0));
+  positions.push_back (Vector (-70, 70, 0));
+  positions.push_back (Vector (0, 0, -90));
+  positions.push_back (Vector (100.1, 0, 0));
+  positions.push_back (Vector (80, 80, 0));
+  positions.push_back (Vector (500, 0, 0));
+  positions.push_back (Vector (-1000, 3000, 10));
+
+  Ptr<CountingSpectrumPhy> txPhy = Create<CountingSpectrumPhy> ();
+  txPhy->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  channel->AddRx (txPhy);
+
+  std::vector<Ptr<CountingSpectrumPhy> > rxPhys;
+  for (uint32_t i = 0; i < positions.size (); i++)
+    {
+      Ptr<CountingSpectrumPhy> rxPhy = Create<CountingSpectrumPhy> ();
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (positions[i]);
+      rxPhy->SetMobility (mobility);
+      channel->AddRx (rxPhy);
+      rxPhys.push_back (rxPhy);
+    }
+  Ptr<CountingSpectrumPhy> unlocatedPhy = Create<CountingSpectrumPhy> ();
+  channel->AddRx (unlocatedPhy);
+  rxPhys.push_back (unlocatedPhy);
+
+  Simulator::Schedule (Seconds (1), &StartTx, channel, txPhy);
+
+  // Move a receiver from outside into the culling range and the other way round.
+  Simulator::Schedule (Seconds (2), &MobilityModel::SetPosition, rxPhys[6]->GetMobility (), Vector (50, 0, 0));
+  Simulator::Schedule (Seconds (2), &MobilityModel::SetPosition, rxPhys[0]->GetMobility (), Vector (0, 300, 0));
+  Simulator::Schedule (Seconds (3), &StartTx, channel, txPhy);
+
+  // Locate the receiver without mobility model out of the culling range.
+  Ptr<MobilityModel> farMobility = CreateObject<ConstantPositionMobilityModel> ();
+  farMobility->SetPosition (Vector (1000, 0, 0));
+  Simulator::Schedule (Seconds (4), &CountingSpectrumPhy::SetMobility, unlocatedPhy, farMobility);
+  Simulator::Schedule (Seconds (5), &StartTx, channel, txPhy);
+
+  // Extend the culling range, so that only the last located receiver is out.
+  if (m_cullingRange > 0)
+    {
+      Simulator::Schedule (Seconds (6), &SingleModelSpectrumChannel::SetReceiverCullingRange, channel, 1000.0);
+    }
+  Simulator::Schedule (Seconds (7), &StartTx, channel, txPhy);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (txPhy->m_rxCount, 0, "Transmitter received its own signal");
+  if (m_cullingRange > 0)
+    {
+      uint32_t expected[] = { 2, 4, 4, 4, 1, 1, 3, 0, 3 };
+      for (uint32_t i = 0; i < rxPhys.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (rxPhys[i]->m_rxCount, expected[i], "Wrong number of signals at receiver " << i);
+        }
+    }
+  else
+    {
+      for (uint32_t i = 0; i < rxPhys.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (rxPhys[i]->m_rxCount, 4, "Signal culled at receiver " << i);
+        }
+    }
+
+  channel->Dispose ();
+  Simulator::Destroy ();
+}
+
+class SpectrumReceiverCullingTestSuite : public TestSuite
+{
+public:
+  SpectrumReceiverCullingTestSuite ();
+};
+
+SpectrumReceiverCullingTestSuite::SpectrumReceiverCullingTestSuite ()
+  : TestSuite ("spectrum-receiver-culling", UNIT)
+{
+  AddTestCase (new SpectrumReceiverCullingTestCase (0.0), TestCase::QUICK);
+  AddTestCase (new SpectrumReceiverCullingTestCase (100.0), TestCase::QUICK);
+}
+
+static SpectrumReceiverCullingTestSuite g_spectrumReceiverCullingTestSuite;
@@ -0,0 +1,524 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <iterator>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif /* HAVE_ZLIB */
+
+#include "binary-trace-file.h"
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+NS_OBJECT_ENSURE_REGISTERED (BinaryTraceRecorder);
+
+/*
+ * The file starts with a header of 16 bytes: the magic "NS3TRACE", the
+ * version and a reserved word.  Then come blocks, all little-endian:
+ *
+ * - a series: type 1, the id of the series (4 bytes), the type of its
+ *   values (1 byte), the size of its name (2 bytes) and the name;
+ * - a chunk: type 2, the id of the series (4 bytes), the number of
+ *   samples (4 bytes), the codec (1 byte, 0 for none, 1 for deflate),
+ *   the size of the column of the timestamps, the size of the two
+ *   columns, the size of the stored data (4 bytes each), and the data.
+ */
+const char MAGIC[8] = { 'N', 'S', '3', 'T', 'R', 'A', 'C', 'E' }; //!< Magic of the files
+const uint32_t VERSION = 1;               //!< Version of the format
+const uint8_t SERIES_BLOCK = 1;           //!< Type of a series block
+const uint8_t CHUNK_BLOCK = 2;            //!< Type of a chunk block
+const uint8_t CODEC_NONE = 0;             //!< The chunk is stored as is
+const uint8_t CODEC_DEFLATE = 1;          //!< The chunk is deflated by zlib
+const uint32_t CHUNK_HEADER_SIZE = 22;    //!< Size of the header of a chunk block
+
+/**
+ * Append a little-endian integer.
+ *
+ * \param out The buffer.
+ * \param value The integer.
+ * \param size The size of the integer, in bytes.
+ */
+static void
+PutLittleEndian (std::vector<uint8_t> &out, uint64_t value, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; i++)
+    {
+      out.push_back (value >> (8 * i));
+    }
+}
+
+/**
+ * Read a little-endian integer.
+ *
+ * \param p The integer.
+ * \param size The size of the integer, in bytes.
+ * \returns The integer.
+ */
+static uint64_t
+GetLittleEndian (const uint8_t *p, uint32_t size)
+{
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      value |= (uint64_t) p[i] << (8 * i);
+    }
+  return value;
+}
+
+/**
+ * Append an unsigned integer, 7 bits per byte, with the highest bit set
+ * on all the bytes but the last one.
+ *
+ * \param out The buffer.
+ * \param value The integer.
+ */
+static void
+PutVarint (std::vector<uint8_t> &out, uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      out.push_back ((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+  out.push_back (value);
+}
+
+/**
+ * Read an unsigned integer written by PutVarint().
+ *
+ * \param p The position, moved after the integer.
+ * \param end The end of the buffer.
+ * \param value The integer.
+ * \returns false if the integer is truncated.
+ */
+static bool
+GetVarint (const uint8_t *&p, const uint8_t *end, uint64_t &value)
+{
+  value = 0;
+  for (uint32_t shift = 0; p < end && shift < 64; shift += 7)
+    {
+      uint8_t byte = *p++;
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/**
+ * \param value A signed integer.
+ * \returns The integer with its sign in its lowest bit, so that small
+ *          negative integers are small.
+ */
+static uint64_t
+ZigZag (int64_t value)
+{
+  return ((uint64_t) value << 1) ^ (uint64_t)(value >> 63);
+}
+
+/**
+ * \param value An integer returned by ZigZag().
+ * \returns The signed integer.
+ */
+static int64_t
+UnZigZag (uint64_t value)
+{
+  return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+TypeId
+BinaryTraceRecorder::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::BinaryTraceRecorder")
+    .SetParent<DataCollectionObject> ()
+    .SetGroupName ("Stats")
+    .AddAttribute ("ChunkSize",
+                   "The number of samples of a series stored together.",
+                   UintegerValue (4096),
+                   MakeUintegerAccessor (&BinaryTraceRecorder::m_chunkSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Compress",
+                   "Deflate the chunks with zlib, if available.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&BinaryTraceRecorder::m_compress),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+BinaryTraceRecorder::BinaryTraceRecorder (const std::string &outputFileName)
+  : m_outputFileName (outputFileName),
+    m_chunkSize (4096),
+    m_compress (true),
+    m_samples (0)
+{
+  NS_LOG_FUNCTION (this << outputFileName);
+  m_file.open (m_outputFileName.c_str (), std::ios::out | std::ios::binary);
+  NS_ABORT_MSG_UNLESS (m_file.is_open (), "Unable to open " << m_outputFileName);
+  std::vector<uint8_t> header (MAGIC, MAGIC + sizeof (MAGIC));
+  PutLittleEndian (header, VERSION, 4);
+  PutLittleEndian (header, 0, 4);
+  m_file.write ((const char *) &header[0], header.size ());
+}
+
+BinaryTraceRecorder::~BinaryTraceRecorder ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+uint32_t
+BinaryTraceRecorder::AddSeries (const std::string &name, enum SeriesType type)
+{
+  NS_LOG_FUNCTION (this << name << type);
+  NS_ABORT_MSG_IF (name.size () > 0xffff, "Name too long: " << name);
+  Series series;
+  series.type = type;
+  series.samples = 0;
+  series.lastTime = 0;
+  series.lastValue = 0;
+  m_series.push_back (series);
+  uint32_t id = m_series.size () - 1;
+
+  m_block.clear ();
+  m_block.push_back (SERIES_BLOCK);
+  PutLittleEndian (m_block, id, 4);
+  m_block.push_back (type);
+  PutLittleEndian (m_block, name.size (), 2);
+  m_block.insert (m_block.end (), name.begin (), name.end ());
+  m_file.write ((const char *) &m_block[0], m_block.size ());
+  return id;
+}
+
+BinaryTraceRecorder::Series &
+BinaryTraceRecorder::StartSample (uint32_t id, Time t)
+{
+  NS_ASSERT_MSG (id < m_series.size (), "Unknown series " << id);
+  Series &series = m_series[id];
+  if (series.samples >= m_chunkSize)
+    {
+      WriteChunk (id);
+    }
+  int64_t time = t.GetNanoSeconds ();
+  PutVarint (series.times, ZigZag (time - series.lastTime));
+  series.lastTime = time;
+  series.samples++;
+  m_samples++;
+  return series;
+}
+
+void
+BinaryTraceRecorder::Write (uint32_t id, Time t, double value)
+{
+  NS_LOG_FUNCTION (this << id << t << value);
+  if (!m_enabled)
+    {
+      return;
+    }
+  Series &series = StartSample (id, t);
+  NS_ASSERT (series.type == DOUBLE_SERIES);
+
+  // the close values of a series share their sign, their exponent and
+  // the high bits of their mantissa: the XOR of a value with the previous
+  // one has leading zero bytes, and often trailing zero bytes, which are
+  // not stored
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  uint64_t x = bits ^ series.lastValue;
+  series.lastValue = bits;
+  uint32_t lead = 0;
+  while (lead < 8 && ((x >> (56 - 8 * lead)) & 0xff) == 0)
+    {
+      lead++;
+    }
+  uint32_t trail = 0;
+  while (lead + trail < 8 && ((x >> (8 * trail)) & 0xff) == 0)
+    {
+      trail++;
+    }
+  uint32_t length = 8 - lead - trail;
+  series.values.push_back ((lead << 4) | length);
+  for (uint32_t i = 0; i < length; i++)
+    {
+      series.values.push_back (x >> (8 * (7 - lead - i)));
+    }
+}
+
+void
+BinaryTraceRecorder::WriteInteger (uint32_t id, Time t, int64_t value)
+{
+  NS_LOG_FUNCTION (this << id << t << value);
+  if (!m_enabled)
+    {
+      return;
+    }
+  Series &series = StartSample (id, t);
+  NS_ASSERT (series.type == INTEGER_SERIES);
+  PutVarint (series.values, ZigZag (value - (int64_t) series.lastValue));
+  series.lastValue = value;
+}
+
+void
+BinaryTraceRecorder::WriteChunk (uint32_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+  Series &series = m_series[id];
+  if (series.samples == 0)
+    {
+      return;
+    }
+  uint32_t timesSize = series.times.size ();
+  series.times.insert (series.times.end (), series.values.begin (), series.values.end ());
+  uint32_t rawSize = series.times.size ();
+
+  m_block.resize (CHUNK_HEADER_SIZE);
+  uint8_t codec = CODEC_NONE;
+#ifdef HAVE_ZLIB
+  if (m_compress)
+    {
+      uLongf storedSize = compressBound (rawSize);
+      m_block.resize (CHUNK_HEADER_SIZE + storedSize);
+      if (compress2 (&m_block[CHUNK_HEADER_SIZE], &storedSize, &series.times[0], rawSize,
+                     Z_DEFAULT_COMPRESSION) == Z_OK
+          && storedSize < rawSize)
+        {
+          codec = CODEC_DEFLATE;
+          m_block.resize (CHUNK_HEADER_SIZE + storedSize);
+        }
+    }
+#endif /* HAVE_ZLIB */
+  if (codec == CODEC_NONE)
+    {
+      m_block.resize (CHUNK_HEADER_SIZE);
+      m_block.insert (m_block.end (), series.times.begin (), series.times.end ());
+    }
+
+  std::vector<uint8_t> header;
+  header.push_back (CHUNK_BLOCK);
+  PutLittleEndian (header, id, 4);
+  PutLittleEndian (header, series.samples, 4);
+  header.push_back (codec);
+  PutLittleEndian (header, timesSize, 4);
+  PutLittleEndian (header, rawSize, 4);
+  PutLittleEndian (header, m_block.size () - CHUNK_HEADER_SIZE, 4);
+  NS_ASSERT (header.size () == CHUNK_HEADER_SIZE);
+  std::copy (header.begin (), header.end (), m_block.begin ());
+  m_file.write ((const char *) &m_block[0], m_block.size ());
+
+  // the chunks are decoded independently
+  series.samples = 0;
+  series.lastTime = 0;
+  series.lastValue = 0;
+  series.times.clear ();
+  series.values.clear ();
+}
+
+void
+BinaryTraceRecorder::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t id = 0; id < m_series.size (); id++)
+    {
+      WriteChunk (id);
+    }
+  m_file.flush ();
+}
+
+void
+BinaryTraceRecorder::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.is_open ())
+    {
+      Flush ();
+      m_file.close ();
+    }
+}
+
+uint64_t
+BinaryTraceRecorder::GetSamples (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_samples;
+}
+
+bool
+BinaryTraceReader::Read (const std::string &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_series.clear ();
+  std::ifstream in (filename.c_str (), std::ios::in | std::ios::binary);
+  std::vector<uint8_t> data ((std::istreambuf_iterator<char> (in)), std::istreambuf_iterator<char> ());
+  if (data.size () < 16 || std::memcmp (&data[0], MAGIC, sizeof (MAGIC)) != 0
+      || GetLittleEndian (&data[8], 4) != VERSION)
+    {
+      NS_LOG_WARN (filename << " is not a binary trace");
+      return false;
+    }
+
+  std::vector<uint8_t> raw;
+  const uint8_t *p = &data[0] + 16;
+  const uint8_t *end = &data[0] + data.size ();
+  while (p < end)
+    {
+      if (*p == SERIES_BLOCK && end - p >= 8)
+        {
+          uint32_t id = GetLittleEndian (p + 1, 4);
+          uint32_t nameSize = GetLittleEndian (p + 6, 2);
+          if (end - p < 8 + nameSize)
+            {
+              return false;
+            }
+          if (id >= m_series.size ())
+            {
+              m_series.resize (id + 1);
+            }
+          m_series[id].type = (BinaryTraceRecorder::SeriesType) p[5];
+          m_series[id].name.assign (p + 8, p + 8 + nameSize);
+          p += 8 + nameSize;
+        }
+      else if (*p == CHUNK_BLOCK && end - p >= CHUNK_HEADER_SIZE)
+        {
+          uint32_t id = GetLittleEndian (p + 1, 4);
+          uint32_t samples = GetLittleEndian (p + 5, 4);
+          uint8_t codec = p[9];
+          uint32_t timesSize = GetLittleEndian (p + 10, 4);
+          uint32_t rawSize = GetLittleEndian (p + 14, 4);
+          uint32_t storedSize = GetLittleEndian (p + 18, 4);
+          const uint8_t *stored = p + CHUNK_HEADER_SIZE;
+          if (id >= m_series.size () || (uint64_t)(end - stored) < storedSize || timesSize > rawSize)
+            {
+              return false;
+            }
+          p = stored + storedSize;
+          if (codec == CODEC_NONE && storedSize == rawSize)
+            {
+              if (!DecodeChunk (m_series[id], stored, rawSize, timesSize, samples))
+                {
+                  return false;
+                }
+              continue;
+            }
+#ifdef HAVE_ZLIB
+          raw.resize (rawSize + 1);
+          uLongf size = rawSize;
+          if (codec == CODEC_DEFLATE
+              && uncompress (&raw[0], &size, stored, storedSize) == Z_OK
+              && size == rawSize
+              && DecodeChunk (m_series[id], &raw[0], rawSize, timesSize, samples))
+            {
+              continue;
+            }
+#endif /* HAVE_ZLIB */
+          NS_LOG_WARN ("Cannot decode a chunk of " << filename);
+          return false;
+        }
+      else
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+BinaryTraceReader::DecodeChunk (Series &series, const uint8_t *data, uint32_t size,
+                                uint32_t timesSize, uint32_t samples)
+{
+  NS_LOG_FUNCTION (this << size << timesSize << samples);
+  const uint8_t *p = data;
+  const uint8_t *end = data + timesSize;
+  int64_t time = 0;
+  for (uint32_t i = 0; i < samples; i++)
+    {
+      uint64_t delta;
+      if (!GetVarint (p, end, delta))
+        {
+          return false;
+        }
+      time += UnZigZag (delta);
+      series.times.push_back (time);
+    }
+
+  end = data + size;
+  uint64_t last = 0;
+  for (uint32_t i = 0; i < samples; i++)
+    {
+      if (series.type == BinaryTraceRecorder::INTEGER_SERIES)
+        {
+          uint64_t delta;
+          if (!GetVarint (p, end, delta))
+            {
+              return false;
+            }
+          last += UnZigZag (delta);
+          series.integers.push_back (last);
+          continue;
+        }
+      if (p >= end)
+        {
+          return false;
+        }
+      uint32_t lead = *p >> 4;
+      uint32_t length = *p & 0x0f;
+      p++;
+      if (lead + length > 8 || end - p < length)
+        {
+          return false;
+        }
+      uint64_t x = 0;
+      for (uint32_t j = 0; j < length; j++)
+        {
+          x |= (uint64_t) *p++ << (8 * (7 - lead - j));
+        }
+      last ^= x;
+      double value;
+      std::memcpy (&value, &last, sizeof (value));
+      series.values.push_back (value);
+    }
+  return p == end;
+}
+
+const std::vector<BinaryTraceReader::Series> &
+BinaryTraceReader::GetSeries (void) const
+{
+  return m_series;
+}
+
+const BinaryTraceReader::Series *
+BinaryTraceReader::GetSeries (const std::string &name) const
+{
+  for (std::vector<Series>::const_iterator i = m_series.begin (); i != m_series.end (); i++)
+    {
+      if (i->name == name)
+        {
+          return &(*i);
+        }
+    }
+  return 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/data-collection-object.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup aggregator
+ *
+ * \brief Record the samples of trace sources to a compact binary file.
+ *
+ * Each trace source connected to the recorder is a series of the file,
+ * with a name, and each sample is a timestamp in nanoseconds and a value,
+ * either a double or an integer (e.g. the state of a state machine).
+ * The samples of a series are stored by chunks of ChunkSize samples, each
+ * chunk as two columns: the deltas of the timestamps, as variable-length
+ * integers, then the values, the doubles XORed with the previous value
+ * and stripped of their zero bytes, the integers as variable-length
+ * deltas.  If zlib is available and Compress is set, each chunk is also
+ * deflated.  Slowly changing values, like the energy of a battery, thus
+ * take a few bytes per sample, and every sample can be kept.
+ *
+ * The file is read back by BinaryTraceReader, or by
+ * utils/read-binary-trace.py for an analysis in Python.
+ *
+ * A TracedValue is connected with MakeTracedValueSink(), and a trace
+ * source with a single value with MakeValueSink():
+ *
+ * \code
+ *   Ptr<BinaryTraceRecorder> recorder = CreateObject<BinaryTraceRecorder> ("energy.nstr");
+ *   uint32_t series = recorder->AddSeries ("node0/RemainingEnergy");
+ *   source->TraceConnectWithoutContext ("RemainingEnergy",
+ *                                       recorder->MakeTracedValueSink<double> (series));
+ * \endcode
+ */
+class BinaryTraceRecorder : public DataCollectionObject
+{
+public:
+  /// The type of the values of a series.
+  enum SeriesType
+  {
+    DOUBLE_SERIES = 0,
+    INTEGER_SERIES = 1
+  };
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \param outputFileName name of the file to write.
+   *
+   * Creates the file, and writes its header.
+   */
+  BinaryTraceRecorder (const std::string &outputFileName);
+
+  virtual ~BinaryTraceRecorder ();
+
+  /**
+   * \param name The name of the series.
+   * \param type The type of the values of the series.
+   * \returns The id of the series.
+   */
+  uint32_t AddSeries (const std::string &name, enum SeriesType type = DOUBLE_SERIES);
+
+  /**
+   * \param series The id of a double series.
+   * \param t The time of the sample.
+   * \param value The value of the sample.
+   */
+  void Write (uint32_t series, Time t, double value);
+
+  /**
+   * \param series The id of an integer series.
+   * \param t The time of the sample.
+   * \param value The value of the sample.
+   */
+  void WriteInteger (uint32_t series, Time t, int64_t value);
+
+  /**
+   * \param series The id of a series.
+   * \returns A sink for a TracedValue<T>, which records the new values
+   *          of the series at the current time.
+   */
+  template <typename T>
+  Callback<void, T, T> MakeTracedValueSink (uint32_t series);
+
+  /**
+   * \param series The id of a series.
+   * \returns A sink for a trace source with a single value of type T,
+   *          which records it at the current time.
+   */
+  template <typename T>
+  Callback<void, T> MakeValueSink (uint32_t series);
+
+  /**
+   * Write the pending samples of all the series to the file.
+   */
+  void Flush (void);
+
+  /**
+   * Write the pending samples, and close the file.
+   */
+  void Close (void);
+
+  /**
+   * \returns The number of samples recorded.
+   */
+  uint64_t GetSamples (void) const;
+
+private:
+  /// A series, with the columns of its current chunk.
+  struct Series
+  {
+    enum SeriesType type;          //!< The type of the values.
+    uint32_t samples;              //!< The number of samples of the chunk.
+    int64_t lastTime;              //!< The time of the last sample of the chunk, in ns.
+    uint64_t lastValue;            //!< The bits of the last value of the chunk.
+    std::vector<uint8_t> times;    //!< The column of the timestamps.
+    std::vector<uint8_t> values;   //!< The column of the values.
+  };
+
+  /**
+   * Record a value converted to the type of a series.
+   *
+   * \param series The id of the series.
+   * \param value The value.
+   */
+  template <typename T>
+  void WriteValue (uint32_t series, T value);
+
+  /**
+   * Sink of a TracedValue.
+   *
+   * \param recorder The recorder.
+   * \param series The id of the series.
+   * \param oldValue The old value.
+   * \param newValue The new value.
+   */
+  template <typename T>
+  static void TracedValueSink (Ptr<BinaryTraceRecorder> recorder, uint32_t series,
+                               T oldValue, T newValue);
+
+  /**
+   * Sink of a trace source with a single value.
+   *
+   * \param recorder The recorder.
+   * \param series The id of the series.
+   * \param value The value.
+   */
+  template <typename T>
+  static void ValueSink (Ptr<BinaryTraceRecorder> recorder, uint32_t series, T value);
+
+  /**
+   * Append the timestamp of a sample to the current chunk of a series,
+   * writing the chunk first if it is full.
+   *
+   * \param series The id of the series.
+   * \param t The time of the sample.
+   * \returns The series.
+   */
+  Series &StartSample (uint32_t series, Time t);
+
+  /**
+   * Write the current chunk of a series to the file.
+   *
+   * \param id The id of the series.
+   */
+  void WriteChunk (uint32_t id);
+
+  std::string m_outputFileName;    //!< The name of the file.
+  std::ofstream m_file;            //!< The file.
+  std::vector<Series> m_series;    //!< The series, by id.
+  std::vector<uint8_t> m_block;    //!< The block being written.
+  uint32_t m_chunkSize;            //!< The number of samples of a chunk.
+  bool m_compress;                 //!< Deflate the chunks.
+  uint64_t m_samples;              //!< The number of samples recorded.
+};
+
+/**
+ * \ingroup aggregator
+ *
+ * \brief Read the series of a file written by BinaryTraceRecorder.
+ */
+class BinaryTraceReader
+{
+public:
+  /// A series read back.
+  struct Series
+  {
+    std::string name;                    //!< The name of the series.
+    BinaryTraceRecorder::SeriesType type; //!< The type of the values.
+    std::vector<int64_t> times;          //!< The times of the samples, in ns.
+    std::vector<double> values;          //!< The values of a double series.
+    std::vector<int64_t> integers;       //!< The values of an integer series.
+  };
+
+  /**
+   * Read a file.
+   *
+   * \param filename The name of the file.
+   * \returns true if the file could be read, false if it is not a valid
+   *          file, or compressed and zlib is not available.
+   */
+  bool Read (const std::string &filename);
+
+  /**
+   * \returns The series of the file, by id.
+   */
+  const std::vector<Series> &GetSeries (void) const;
+
+  /**
+   * \param name The name of a series.
+   * \returns The series, or 0 if the file has no series of this name.
+   */
+  const Series *GetSeries (const std::string &name) const;
+
+private:
+  /**
+   * Decode a chunk.
+   *
+   * \param series The series of the chunk.
+   * \param data The columns of the chunk.
+   * \param size The size of the columns.
+   * \param timesSize The size of the column of the timestamps.
+   * \param samples The number of samples of the chunk.
+   * \returns true if the chunk is valid.
+   */
+  bool DecodeChunk (Series &series, const uint8_t *data, uint32_t size,
+                    uint32_t timesSize, uint32_t samples);
+
+  std::vector<Series> m_series;  //!< The series, by id.
+};
+
+template <typename T>
+Callback<void, T, T>
+BinaryTraceRecorder::MakeTracedValueSink (uint32_t series)
+{
+  return MakeBoundCallback (&BinaryTraceRecorder::TracedValueSink<T>,
+                            Ptr<BinaryTraceRecorder> (this), series);
+}
+
+template <typename T>
+Callback<void, T>
+BinaryTraceRecorder::MakeValueSink (uint32_t series)
+{
+  return MakeBoundCallback (&BinaryTraceRecorder::ValueSink<T>,
+                            Ptr<BinaryTraceRecorder> (this), series);
+}
+
+template <typename T>
+void
+BinaryTraceRecorder::WriteValue (uint32_t series, T value)
+{
+  if (m_series[series].type == INTEGER_SERIES)
+    {
+      WriteInteger (series, Simulator::Now (), static_cast<int64_t> (value));
+    }
+  else
+    {
+      Write (series, Simulator::Now (), static_cast<double> (value));
+    }
+}
+
+template <typename T>
+void
+BinaryTraceRecorder::TracedValueSink (Ptr<BinaryTraceRecorder> recorder, uint32_t series,
+                                      T oldValue, T newValue)
+{
+  recorder->WriteValue (series, newValue);
+}
+
+template <typename T>
+void
+BinaryTraceRecorder::ValueSink (Ptr<BinaryTraceRecorder> recorder, uint32_t series, T value)
+{
+  recorder->WriteValue (series, value);
+}
+
+} // namespace ns3
+
+#endif // BINARY_TRACE_FILE_H
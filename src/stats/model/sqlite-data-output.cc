@@ -22,8 +22,15 @@
 
 #include <sqlite3.h>
 
+#include "ns3/core-config.h"
 #include "ns3/log.h"
 #include "ns3/nstime.h"
+#include "ns3/boolean.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif /* HAVE_PTHREAD_H */
 
 #include "data-collector.h"
 #include "data-calculator.h"
@@ -33,9 +40,51 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("SqliteDataOutput");
 
+NS_OBJECT_ENSURE_REGISTERED (SqliteDataOutput);
+
+namespace {
+
+const uint32_t BATCH_ROWS = 4096;     //!< Number of rows of a batch handed to the writer thread.
+const uint64_t WAIT_NS = 100000000;   //!< Longest wait of a condition, in ns.
+
+} // anonymous namespace
+
 //--------------------------------------------------------------
 //----------------------------------------------
+TypeId
+SqliteDataOutput::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SqliteDataOutput")
+    .SetParent<Object> ()
+    .SetGroupName ("Stats")
+    .AddConstructor<SqliteDataOutput> ()
+    .AddAttribute ("WriteAheadLog",
+                   "Use the write-ahead log of SQLite, with normal synchronization, "
+                   "instead of the rollback journal.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SqliteDataOutput::m_writeAheadLog),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Asynchronous",
+                   "Insert the rows from a thread, so that Output returns "
+                   "before the database is written.  Ignored without threads.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SqliteDataOutput::m_asynchronous),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
 SqliteDataOutput::SqliteDataOutput()
+  : m_db (0),
+    m_insertSingleton (0),
+    m_writeAheadLog (false),
+    m_asynchronous (false),
+    m_rows (0),
+    m_batch (0),
+    m_done (false),
+    m_mutex (0),
+    m_queuedCondition (0),
+    m_thread (0)
 {
   NS_LOG_FUNCTION (this);
 
@@ -44,12 +93,14 @@ SqliteDataOutput::SqliteDataOutput()
 SqliteDataOutput::~SqliteDataOutput()
 {
   NS_LOG_FUNCTION (this);
+  Wait ();
 }
 void
 SqliteDataOutput::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
 
+  Wait ();
   DataOutputInterface::DoDispose ();
   // end SqliteDataOutput::DoDispose
 }
@@ -59,96 +110,292 @@ SqliteDataOutput::Exec (std::string exe) {
   NS_LOG_FUNCTION (this << exe);
 
   int res;
-  char **result;
-  int nrows, ncols;
   char *errMsg = 0;
 
   NS_LOG_INFO ("executing '" << exe << "'");
 
-  res = sqlite3_get_table (m_db,
-                           exe.c_str (),
-                           &result, &nrows, &ncols,
-                           &errMsg);
+  res = sqlite3_exec (m_db, exe.c_str (), 0, 0, &errMsg);
 
   if (res != SQLITE_OK) {
       NS_LOG_ERROR ("sqlite3 error: \"" << errMsg << "\"");
-      /*
-      } else {
-        // std::cout << "nrows " << nrows << " ncols " << ncols << std::endl;
-
-        if (nrows > 0) {
-          for (int i = 0; i < ncols; i++) {
-            std::cout << "  " << result[i];
-          }
-          std::cout << std::endl;
-
-          for (int r = 1; r <= nrows; r++) {
-            for (int c = 0; c < ncols; c++) {
-              std::cout << "  " << result[(r*ncols)+c];
-            }
-            std::cout << std::endl;
-          }
-          std::cout << std::endl;
-        }
-      */
     }
 
-  sqlite3_free_table (result);
+  sqlite3_free (errMsg);
   return res;
 
   // end SqliteDataOutput::Exec
 }
 
+sqlite3_stmt *
+SqliteDataOutput::Prepare (std::string sql)
+{
+  NS_LOG_FUNCTION (this << sql);
+
+  sqlite3_stmt *stmt = 0;
+  if (sqlite3_prepare_v2 (m_db, sql.c_str (), -1, &stmt, 0) != SQLITE_OK)
+    {
+      NS_LOG_ERROR ("sqlite3 error: \"" << sqlite3_errmsg (m_db) << "\"");
+      return 0;
+    }
+  return stmt;
+}
+
+int
+SqliteDataOutput::Step (sqlite3_stmt *stmt)
+{
+  int res = sqlite3_step (stmt);
+  if (res != SQLITE_DONE)
+    {
+      NS_LOG_ERROR ("sqlite3 error: \"" << sqlite3_errmsg (m_db) << "\"");
+    }
+  sqlite3_reset (stmt);
+  return res;
+}
+
 //----------------------------------------------
 void
 SqliteDataOutput::Output (DataCollector &dc)
 {
   NS_LOG_FUNCTION (this << &dc);
 
+  // the previous output must be written before the database is reopened
+  Wait ();
+
   std::string m_dbFile = m_filePrefix + ".db";
 
   if (sqlite3_open (m_dbFile.c_str (), &m_db)) {
       NS_LOG_ERROR ("Could not open sqlite3 database \"" << m_dbFile << "\"");
       NS_LOG_ERROR ("sqlite3 error \"" << sqlite3_errmsg (m_db) << "\"");
       sqlite3_close (m_db);
+      m_db = 0;
       /// \todo Better error reporting, management!
       return;
     }
 
-  std::string run = dc.GetRunLabel ();
+  if (m_writeAheadLog)
+    {
+      Exec ("pragma journal_mode=WAL");
+      Exec ("pragma synchronous=NORMAL");
+    }
+
+  m_run = dc.GetRunLabel ();
+  m_rows = 0;
 
+  Exec ("BEGIN");
   Exec ("create table if not exists Experiments (run, experiment, strategy, input, description text)");
-  Exec ("insert into Experiments (run,experiment,strategy,input,description) values ('" +
-        run + "', '" +
-        dc.GetExperimentLabel () + "', '" +
-        dc.GetStrategyLabel () + "', '" +
-        dc.GetInputLabel () + "', '" +
-        dc.GetDescription () + "')");
-
   Exec ("create table if not exists Metadata ( run text, key text, value)");
+  Exec ("create table if not exists Singletons ( run text, name text, variable text, value )");
+
+  sqlite3_stmt *stmt = Prepare ("insert into Experiments (run,experiment,strategy,input,description) values (?,?,?,?,?)");
+  if (stmt != 0)
+    {
+      std::string labels[5] = { m_run, dc.GetExperimentLabel (), dc.GetStrategyLabel (),
+                                dc.GetInputLabel (), dc.GetDescription () };
+      for (int i = 0; i < 5; i++)
+        {
+          sqlite3_bind_text (stmt, i + 1, labels[i].c_str (), -1, SQLITE_STATIC);
+        }
+      Step (stmt);
+      sqlite3_finalize (stmt);
+    }
 
-  for (MetadataList::iterator i = dc.MetadataBegin ();
-       i != dc.MetadataEnd (); i++) {
-      std::pair<std::string, std::string> blob = (*i);
-      Exec ("insert into Metadata (run,key,value) values ('" +
-            run + "', '" +
-            blob.first + "', '" +
-            blob.second + "')");
+  stmt = Prepare ("insert into Metadata (run,key,value) values (?,?,?)");
+  if (stmt != 0)
+    {
+      sqlite3_bind_text (stmt, 1, m_run.c_str (), -1, SQLITE_STATIC);
+      for (MetadataList::iterator i = dc.MetadataBegin ();
+           i != dc.MetadataEnd (); i++) {
+          sqlite3_bind_text (stmt, 2, i->first.c_str (), -1, SQLITE_STATIC);
+          sqlite3_bind_text (stmt, 3, i->second.c_str (), -1, SQLITE_STATIC);
+          Step (stmt);
+        }
+      sqlite3_finalize (stmt);
     }
 
-  Exec ("BEGIN");
-  SqliteOutputCallback callback (this, run);
+  // the run label is bound once, the other parameters by each row
+  m_insertSingleton = Prepare ("insert into Singletons (run,name,variable,value) values (?,?,?,?)");
+  if (m_insertSingleton != 0)
+    {
+      sqlite3_bind_text (m_insertSingleton, 1, m_run.c_str (), -1, SQLITE_STATIC);
+    }
+
+#ifdef HAVE_PTHREAD_H
+  if (m_asynchronous)
+    {
+      m_mutex = new SystemMutex ();
+      m_queuedCondition = new SystemCondition ();
+      m_done = false;
+      m_thread = new SystemThread (MakeCallback (&SqliteDataOutput::Run, this));
+      m_thread->Start ();
+    }
+#endif /* HAVE_PTHREAD_H */
+
+  SqliteOutputCallback callback (this, m_run);
   for (DataCalculatorList::iterator i = dc.DataCalculatorBegin ();
        i != dc.DataCalculatorEnd (); i++) {
       (*i)->Output (callback);
     }
-  Exec ("COMMIT");
 
-  sqlite3_close (m_db);
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      // the writer thread commits, and closes the database
+      Dispatch ();
+      m_mutex->Lock ();
+      m_done = true;
+      m_mutex->Unlock ();
+      m_queuedCondition->SetCondition (true);
+      m_queuedCondition->Signal ();
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+
+  Finish ();
 
   // end SqliteDataOutput::Output
 }
 
+void
+SqliteDataOutput::Write (const Row &row)
+{
+  if (m_thread == 0)
+    {
+      Insert (row);
+      return;
+    }
+  if (m_batch == 0)
+    {
+      m_batch = new Batch ();
+      m_batch->reserve (BATCH_ROWS);
+    }
+  m_batch->push_back (row);
+  if (m_batch->size () >= BATCH_ROWS)
+    {
+      Dispatch ();
+    }
+}
+
+void
+SqliteDataOutput::Insert (const Row &row)
+{
+  if (m_insertSingleton == 0)
+    {
+      return;
+    }
+  sqlite3_bind_text (m_insertSingleton, 2, row.name.c_str (), -1, SQLITE_STATIC);
+  sqlite3_bind_text (m_insertSingleton, 3, row.variable.c_str (), -1, SQLITE_STATIC);
+  switch (row.type)
+    {
+    case Row::INTEGER:
+      sqlite3_bind_int64 (m_insertSingleton, 4, row.integer);
+      break;
+    case Row::REAL:
+      sqlite3_bind_double (m_insertSingleton, 4, row.real);
+      break;
+    case Row::TEXT:
+      sqlite3_bind_text (m_insertSingleton, 4, row.text.c_str (), -1, SQLITE_STATIC);
+      break;
+    }
+  if (Step (m_insertSingleton) == SQLITE_DONE)
+    {
+      m_rows++;
+    }
+}
+
+void
+SqliteDataOutput::Dispatch (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_batch == 0)
+    {
+      return;
+    }
+  m_mutex->Lock ();
+  m_queued.push_back (m_batch);
+  m_mutex->Unlock ();
+  m_batch = 0;
+  m_queuedCondition->SetCondition (true);
+  m_queuedCondition->Signal ();
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+SqliteDataOutput::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_queuedCondition->SetCondition (false);
+      m_mutex->Lock ();
+      Batch *batch = 0;
+      if (!m_queued.empty ())
+        {
+          batch = m_queued.front ();
+          m_queued.pop_front ();
+        }
+      bool done = m_done;
+      m_mutex->Unlock ();
+      if (batch == 0)
+        {
+          if (done)
+            {
+              break;
+            }
+          m_queuedCondition->TimedWait (WAIT_NS);
+          continue;
+        }
+      for (Batch::const_iterator i = batch->begin (); i != batch->end (); i++)
+        {
+          Insert (*i);
+        }
+      delete batch;
+    }
+  Finish ();
+#endif /* HAVE_PTHREAD_H */
+}
+
+void
+SqliteDataOutput::Finish (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_insertSingleton != 0)
+    {
+      sqlite3_finalize (m_insertSingleton);
+      m_insertSingleton = 0;
+    }
+  Exec ("COMMIT");
+  sqlite3_close (m_db);
+  m_db = 0;
+  NS_LOG_INFO (m_filePrefix << ".db: " << m_rows << " singletons written");
+}
+
+void
+SqliteDataOutput::Wait (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  if (m_thread == 0)
+    {
+      return;
+    }
+  m_mutex->Lock ();
+  m_done = true;
+  m_mutex->Unlock ();
+  m_queuedCondition->SetCondition (true);
+  m_queuedCondition->Signal ();
+  m_thread->Join ();
+  delete m_thread;
+  delete m_queuedCondition;
+  delete m_mutex;
+  m_thread = 0;
+  m_queuedCondition = 0;
+  m_mutex = 0;
+#endif /* HAVE_PTHREAD_H */
+}
+
 SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback
   (Ptr<SqliteDataOutput> owner, std::string run) :
   m_owner (owner),
@@ -156,8 +403,6 @@ SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback
 {
   NS_LOG_FUNCTION (this << owner << run);
 
-  m_owner->Exec ("create table if not exists Singletons ( run text, name text, variable text, value )");
-
   // end SqliteDataOutput::SqliteOutputCallback::SqliteOutputCallback
 }
 
@@ -189,13 +434,12 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', " <<
-  val << ")";
-  m_owner->Exec (sstr.str ());
+  Row row;
+  row.name = key;
+  row.variable = variable;
+  row.type = Row::INTEGER;
+  row.integer = val;
+  m_owner->Write (row);
 
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
@@ -206,13 +450,12 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', " <<
-  val << ")";
-  m_owner->Exec (sstr.str ());
+  Row row;
+  row.name = key;
+  row.variable = variable;
+  row.type = Row::INTEGER;
+  row.integer = val;
+  m_owner->Write (row);
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
 void
@@ -222,13 +465,12 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', " <<
-  val << ")";
-  m_owner->Exec (sstr.str ());
+  Row row;
+  row.name = key;
+  row.variable = variable;
+  row.type = Row::REAL;
+  row.real = val;
+  m_owner->Write (row);
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
 void
@@ -238,13 +480,12 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', '" <<
-  val << "')";
-  m_owner->Exec (sstr.str ());
+  Row row;
+  row.name = key;
+  row.variable = variable;
+  row.type = Row::TEXT;
+  row.text = val;
+  m_owner->Write (row);
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
 void
@@ -254,12 +495,11 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  std::stringstream sstr;
-  sstr << "insert into Singletons (run,name,variable,value) values ('" <<
-  m_runLabel << "', '" <<
-  key << "', '" <<
-  variable << "', " <<
-  val.GetTimeStep () << ")";
-  m_owner->Exec (sstr.str ());
+  Row row;
+  row.name = key;
+  row.variable = variable;
+  row.type = Row::INTEGER;
+  row.integer = val.GetTimeStep ();
+  m_owner->Write (row);
   // end SqliteDataOutput::SqliteOutputCallback::OutputSingleton
 }
@@ -21,6 +21,9 @@
 #ifndef SQLITE_DATA_OUTPUT_H
 #define SQLITE_DATA_OUTPUT_H
 
+#include <deque>
+#include <vector>
+
 #include "ns3/nstime.h"
 
 #include "data-output-interface.h"
@@ -28,23 +31,48 @@
 #define STATS_HAS_SQLITE3
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace ns3 {
 
+class SystemThread;
+class SystemMutex;
+class SystemCondition;
+
 //------------------------------------------------------------
 //--------------------------------------------
 /**
  * \ingroup dataoutput
  * \class SqliteDataOutput
  * \brief Outputs data in a format compatible with SQLite
+ *
+ * The rows are inserted with prepared statements, in a single transaction
+ * per call to Output().  With WriteAheadLog, the database uses the
+ * write-ahead log of SQLite, which is faster, but needs the -wal and -shm
+ * files next to the database while it is written.  With Asynchronous,
+ * the rows are inserted by a thread, and Output() returns as soon as the
+ * data calculators have output their values; Wait() waits for the
+ * database to be written.
  */
 class SqliteDataOutput : public DataOutputInterface {
 public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void);
+
   SqliteDataOutput();
   virtual ~SqliteDataOutput();
 
   virtual void Output (DataCollector &dc);
 
+  /**
+   * Wait for the rows of the last Output() to be written to the
+   * database, if it is written by a thread.
+   */
+  void Wait (void);
+
 protected:
   virtual void DoDispose ();
 
@@ -131,7 +159,41 @@ private:
   };
 
 
+  /// A row of the Singletons table.
+  struct Row
+  {
+    /// The type of the value.
+    enum Type
+    {
+      INTEGER,
+      REAL,
+      TEXT
+    };
+
+    std::string name;       //!< The name of the value.
+    std::string variable;   //!< The variable of the value.
+    enum Type type;         //!< The type of the value.
+    int64_t integer;        //!< The value, if an integer.
+    double real;            //!< The value, if a real.
+    std::string text;       //!< The value, if a text.
+  };
+
+  /// A batch of rows handed to the writer thread.
+  typedef std::vector<Row> Batch;
+
   sqlite3 *m_db; //!< pointer to the SQL database
+  sqlite3_stmt *m_insertSingleton; //!< The prepared insertion of a singleton.
+  std::string m_run; //!< The run label bound to the insertion of the singletons.
+  bool m_writeAheadLog; //!< Use the write-ahead log.
+  bool m_asynchronous; //!< Insert the rows from a thread.
+  uint64_t m_rows; //!< The number of rows inserted.
+
+  Batch *m_batch; //!< The batch being filled, if asynchronous.
+  std::deque<Batch *> m_queued; //!< The batches to insert.
+  bool m_done; //!< No more batches will be queued.
+  SystemMutex *m_mutex; //!< The lock of the queue, or 0.
+  SystemCondition *m_queuedCondition; //!< Signalled when a batch is queued.
+  SystemThread *m_thread; //!< The writer thread, or 0.
 
   /**
    * \brief Execute a sqlite3 query
@@ -140,6 +202,47 @@ private:
    */
   int Exec (std::string exe);
 
+  /**
+   * Prepare a statement.
+   * \param sql The SQL of the statement.
+   * \return The statement, or 0 on error.
+   */
+  sqlite3_stmt *Prepare (std::string sql);
+
+  /**
+   * Run a prepared statement whose parameters are bound, and reset it.
+   * \param stmt The statement.
+   * \return sqlite return code.
+   */
+  int Step (sqlite3_stmt *stmt);
+
+  /**
+   * Insert a row, or queue it to the writer thread.
+   * \param row The row.
+   */
+  void Write (const Row &row);
+
+  /**
+   * Insert a row in the Singletons table.
+   * \param row The row.
+   */
+  void Insert (const Row &row);
+
+  /**
+   * Queue the current batch to the writer thread.
+   */
+  void Dispatch (void);
+
+  /**
+   * The writer thread: insert the queued batches until done.
+   */
+  void Run (void);
+
+  /**
+   * Commit the transaction, and close the database.
+   */
+  void Finish (void);
+
   // end class SqliteDataOutput
 };
 
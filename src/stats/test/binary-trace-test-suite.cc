@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "ns3/binary-trace-file.h"
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-value.h"
+#include "ns3/traced-callback.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup stats
+ * \ingroup tests
+ * Record the samples of trace sources to a binary trace, and read them
+ * back.
+ */
+class BinaryTraceTestCase : public TestCase
+{
+public:
+  /**
+   * \param compress Deflate the chunks.
+   */
+  BinaryTraceTestCase (bool compress);
+
+private:
+  virtual void DoRun (void);
+
+  /** Change the traced values, and record the expected samples. */
+  void Change (void);
+
+  bool m_compress;                       //!< Deflate the chunks.
+  Ptr<UniformRandomVariable> m_random;   //!< The random changes.
+  TracedValue<double> m_energy;          //!< A slowly decreasing value.
+  TracedValue<uint32_t> m_state;         //!< A state.
+  TracedCallback<double> m_noise;        //!< A random value.
+  std::vector<int64_t> m_times;          //!< The times of the changes.
+  std::vector<double> m_energies;        //!< The expected energies.
+  std::vector<int64_t> m_states;         //!< The expected states.
+  std::vector<double> m_noises;          //!< The expected random values.
+};
+
+BinaryTraceTestCase::BinaryTraceTestCase (bool compress)
+  : TestCase (std::string ("Check that the samples of a binary trace are read back")
+              + (compress ? ", compressed" : "")),
+    m_compress (compress)
+{
+}
+
+void
+BinaryTraceTestCase::Change (void)
+{
+  m_times.push_back (Simulator::Now ().GetNanoSeconds ());
+  m_energy = m_energy - m_random->GetValue (1e-9, 1e-6);
+  m_energies.push_back (m_energy);
+  // a TracedValue only calls its sinks when it changes
+  m_state = (m_state + m_random->GetInteger (1, 6)) % 7;
+  m_states.push_back (m_state);
+  double noise = m_random->GetValue (-1e9, 1e9);
+  m_noise (noise);
+  m_noises.push_back (noise);
+  Simulator::Schedule (NanoSeconds (m_random->GetInteger (0, 3000000)), &BinaryTraceTestCase::Change, this);
+}
+
+void
+BinaryTraceTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("trace.nstr");
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_energy = 11232.0;
+  m_state = 0;
+
+  Ptr<BinaryTraceRecorder> recorder = CreateObject<BinaryTraceRecorder> (filename);
+  recorder->SetAttribute ("ChunkSize", UintegerValue (1000));
+  recorder->SetAttribute ("Compress", BooleanValue (m_compress));
+  uint32_t energy = recorder->AddSeries ("node0/RemainingEnergy");
+  uint32_t state = recorder->AddSeries ("node0/TrxState", BinaryTraceRecorder::INTEGER_SERIES);
+  uint32_t noise = recorder->AddSeries ("noise");
+  m_energy.ConnectWithoutContext (recorder->MakeTracedValueSink<double> (energy));
+  m_state.ConnectWithoutContext (recorder->MakeTracedValueSink<uint32_t> (state));
+  m_noise.ConnectWithoutContext (recorder->MakeValueSink<double> (noise));
+
+  // many chunks, the last one partial
+  Simulator::Schedule (Seconds (1), &BinaryTraceTestCase::Change, this);
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  recorder->Close ();
+  NS_TEST_ASSERT_MSG_EQ (recorder->GetSamples (), 3 * m_times.size (), "Wrong number of samples");
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Read (filename), true, "Cannot read " << filename);
+  NS_TEST_ASSERT_MSG_EQ (reader.GetSeries ().size (), 3, "Wrong number of series");
+  const BinaryTraceReader::Series *energies = reader.GetSeries ("node0/RemainingEnergy");
+  const BinaryTraceReader::Series *states = reader.GetSeries ("node0/TrxState");
+  const BinaryTraceReader::Series *noises = reader.GetSeries ("noise");
+  NS_TEST_ASSERT_MSG_NE (energies, 0, "No energy series");
+  NS_TEST_ASSERT_MSG_NE (states, 0, "No state series");
+  NS_TEST_ASSERT_MSG_NE (noises, 0, "No noise series");
+  if (energies == 0 || states == 0 || noises == 0)
+    {
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ (states->type, BinaryTraceRecorder::INTEGER_SERIES, "Wrong type of series");
+  NS_TEST_ASSERT_MSG_EQ (energies->times.size (), m_times.size (), "Wrong number of energies");
+  NS_TEST_ASSERT_MSG_EQ (states->integers.size (), m_times.size (), "Wrong number of states");
+  NS_TEST_ASSERT_MSG_EQ (noises->values.size (), m_times.size (), "Wrong number of random values");
+  if (energies->values.size () != m_times.size () || states->integers.size () != m_times.size ()
+      || noises->values.size () != m_times.size ())
+    {
+      return;
+    }
+  for (uint32_t i = 0; i < m_times.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (energies->times[i], m_times[i], "Wrong time of energy " << i);
+      NS_TEST_ASSERT_MSG_EQ (states->times[i], m_times[i], "Wrong time of state " << i);
+      NS_TEST_ASSERT_MSG_EQ (energies->values[i], m_energies[i], "Wrong energy " << i);
+      NS_TEST_ASSERT_MSG_EQ (states->integers[i], m_states[i], "Wrong state " << i);
+      NS_TEST_ASSERT_MSG_EQ (noises->values[i], m_noises[i], "Wrong random value " << i);
+    }
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup stats
+ * \ingroup tests
+ * The binary trace test suite.
+ */
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ()
+    : TestSuite ("binary-trace", UNIT)
+  {
+    AddTestCase (new BinaryTraceTestCase (false), TestCase::QUICK);
+    AddTestCase (new BinaryTraceTestCase (true), TestCase::QUICK);
+  }
+};
+
+static BinaryTraceTestSuite g_binaryTraceTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,208 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <string>
+
+#include <sqlite3.h>
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/data-collector.h"
+#include "ns3/basic-data-calculators.h"
+#include "ns3/sqlite-data-output.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup stats
+ * \ingroup tests
+ * A data calculator which outputs a value of each type.
+ */
+class SingletonsCalculator : public DataCalculator
+{
+public:
+  /**
+   * \param rows The number of rows of each type.
+   */
+  SingletonsCalculator (uint32_t rows)
+    : m_rows (rows)
+  {
+  }
+
+  virtual void Output (DataOutputCallback &callback) const
+  {
+    for (uint32_t i = 0; i < m_rows; i++)
+      {
+        callback.OutputSingleton (m_context, "int", -(int) i);
+        callback.OutputSingleton (m_context, "uint32", (uint32_t) 4000000000U + i);
+        callback.OutputSingleton (m_context, "double", 1.0 / 3 + i);
+        callback.OutputSingleton (m_context, "string", std::string ("it's ") + (i % 2 ? "odd" : "even"));
+        callback.OutputSingleton (m_context, "time", NanoSeconds (1234567890123LL + i));
+      }
+  }
+
+private:
+  uint32_t m_rows;  //!< The number of rows of each type.
+};
+
+/**
+ * \ingroup stats
+ * \ingroup tests
+ * Output the data of two runs to a database, and read it back.
+ */
+class SqliteDataOutputTestCase : public TestCase
+{
+public:
+  /**
+   * \param writeAheadLog Use the write-ahead log.
+   * \param asynchronous Insert the rows from a thread.
+   */
+  SqliteDataOutputTestCase (bool writeAheadLog, bool asynchronous);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \param sql A query with a single result.
+   * \returns The result, as a text.
+   */
+  std::string Query (std::string sql);
+
+  bool m_writeAheadLog;  //!< Use the write-ahead log.
+  bool m_asynchronous;   //!< Insert the rows from a thread.
+  sqlite3 *m_db;         //!< The database read back.
+};
+
+SqliteDataOutputTestCase::SqliteDataOutputTestCase (bool writeAheadLog, bool asynchronous)
+  : TestCase (std::string ("Check that the rows of a SqliteDataOutput are read back")
+              + (writeAheadLog ? ", write-ahead log" : "")
+              + (asynchronous ? ", asynchronous" : "")),
+    m_writeAheadLog (writeAheadLog),
+    m_asynchronous (asynchronous),
+    m_db (0)
+{
+}
+
+std::string
+SqliteDataOutputTestCase::Query (std::string sql)
+{
+  std::string result;
+  sqlite3_stmt *stmt = 0;
+  if (sqlite3_prepare_v2 (m_db, sql.c_str (), -1, &stmt, 0) != SQLITE_OK)
+    {
+      return "error: " + std::string (sqlite3_errmsg (m_db));
+    }
+  if (sqlite3_step (stmt) == SQLITE_ROW && sqlite3_column_type (stmt, 0) != SQLITE_NULL)
+    {
+      result = (const char *) sqlite3_column_text (stmt, 0);
+    }
+  sqlite3_finalize (stmt);
+  return result;
+}
+
+void
+SqliteDataOutputTestCase::DoRun (void)
+{
+  std::string prefix = CreateTempDirFilename ("data");
+  const uint32_t rows = 5000;
+
+  Ptr<SqliteDataOutput> output = CreateObject<SqliteDataOutput> ();
+  output->SetFilePrefix (prefix);
+  output->SetAttribute ("WriteAheadLog", BooleanValue (m_writeAheadLog));
+  output->SetAttribute ("Asynchronous", BooleanValue (m_asynchronous));
+
+  for (uint32_t run = 0; run < 2; run++)
+    {
+      DataCollector data;
+      data.DescribeRun ("experiment", "strategy", "input", run ? "run1" : "run0", "quote ' in description");
+      data.AddMetadata ("author", "someone");
+      data.AddMetadata ("rows", rows);
+      Ptr<SingletonsCalculator> singletons = CreateObject<SingletonsCalculator> (rows);
+      singletons->SetContext ("node[0]");
+      data.AddDataCalculator (singletons);
+      Ptr<MinMaxAvgTotalCalculator<uint32_t> > delay = CreateObject<MinMaxAvgTotalCalculator<uint32_t> > ();
+      delay->SetKey ("delay");
+      delay->SetContext ("node[1]");
+      delay->Update (3);
+      delay->Update (5);
+      data.AddDataCalculator (delay);
+      // the second output waits for the first one
+      output->Output (data);
+    }
+  output->Wait ();
+  output->Dispose ();
+
+  std::string filename = prefix + ".db";
+  NS_TEST_ASSERT_MSG_EQ (sqlite3_open (filename.c_str (), &m_db), SQLITE_OK, "Cannot open " << filename);
+  std::string journalMode = m_writeAheadLog ? "wal" : "delete";
+  NS_TEST_ASSERT_MSG_EQ (Query ("pragma journal_mode"), journalMode, "Wrong journal mode");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select count(*) from Experiments"), "2", "Wrong number of runs");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select description from Experiments where run='run1'"),
+                         "quote ' in description", "Wrong description");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select value from Metadata where run='run0' and key='rows'"),
+                         "5000", "Wrong metadata");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select count(*) from Singletons where run='run1'"),
+                         "25006", "Wrong number of singletons");
+
+  // the values keep their types
+  const char *types[][2] = {
+    { "int", "integer" },
+    { "uint32", "integer" },
+    { "double", "real" },
+    { "string", "text" },
+    { "time", "integer" },
+  };
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (Query (std::string ("select count(*) from Singletons where variable='")
+                                    + types[i][0] + "' and typeof(value)='" + types[i][1] + "'"),
+                             "10000", "Wrong type of " << types[i][0]);
+    }
+  NS_TEST_ASSERT_MSG_EQ (Query ("select sum(value) from Singletons where variable='int' and run='run0'"),
+                         "-12497500", "Wrong integers");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select max(value) from Singletons where variable='uint32'"),
+                         "4000004999", "Wrong unsigned integers");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select count(*) from Singletons where variable='double' and value=1.0/3"),
+                         "2", "Doubles are not exact");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select count(*) from Singletons where value='it''s odd'"),
+                         "5000", "Wrong strings");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select min(value) from Singletons where variable='time'"),
+                         "1234567890123", "Wrong times");
+  NS_TEST_ASSERT_MSG_EQ (Query ("select value from Singletons where name='node[1]' and variable='delay-max'"),
+                         "5.0", "Wrong statistic");
+  sqlite3_close (m_db);
+  std::remove (filename.c_str ());
+}
+
+/**
+ * \ingroup stats
+ * \ingroup tests
+ * The SqliteDataOutput test suite.
+ */
+class SqliteDataOutputTestSuite : public TestSuite
+{
+public:
+  SqliteDataOutputTestSuite ()
+    : TestSuite ("sqlite-data-output", UNIT)
+  {
+    AddTestCase (new SqliteDataOutputTestCase (false, false), TestCase::QUICK);
+    AddTestCase (new SqliteDataOutputTestCase (true, false), TestCase::QUICK);
+    AddTestCase (new SqliteDataOutputTestCase (true, true), TestCase::QUICK);
+  }
+};
+
+static SqliteDataOutputTestSuite g_sqliteDataOutputTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <time.h>
+
+#include "ns3/core-module.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device.h"
+
+using namespace ns3;
+
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/**
+ * \returns The monotonic clock, in ns.
+ */
+static uint64_t
+NowNs (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * A trace sink with context.
+ *
+ * \param context The context.
+ * \param packet The packet.
+ */
+static void
+Sink (std::string context, Ptr<const Packet> packet)
+{
+}
+
+/**
+ * A trace sink without context.
+ *
+ * \param packet The packet.
+ */
+static void
+SinkWithoutContext (Ptr<const Packet> packet)
+{
+}
+
+/**
+ * Create the nodes, each with a SimpleNetDevice.
+ *
+ * \param nodes The number of nodes.
+ */
+static void
+CreateNodes (uint32_t nodes)
+{
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      node->AddDevice (CreateObject<SimpleNetDevice> ());
+    }
+}
+
+/**
+ * Print the time taken to configure the nodes.
+ *
+ * \param start The start time, in ns.
+ * \param nodes The number of nodes.
+ */
+static void
+PrintTime (uint64_t start, uint32_t nodes)
+{
+  double elapsed = (NowNs () - start) / 1000.0;
+  std::cout << std::setw (g_fwidth) << elapsed / 1000.0
+            << std::setw (g_fwidth) << elapsed / nodes;
+}
+
+/**
+ * Configure the nodes in the usual ways, and print the time of each.
+ *
+ * \param nodes The number of nodes.
+ */
+static void
+Bench (uint32_t nodes)
+{
+  CreateNodes (nodes);
+  std::cout << std::setw (g_fwidth) << nodes;
+
+  uint64_t start = NowNs ();
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/PhyRxDrop",
+                   MakeCallback (&Sink));
+  PrintTime (start, nodes);
+
+  start = NowNs ();
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      std::ostringstream oss;
+      oss << "/NodeList/" << i << "/DeviceList/0/$ns3::SimpleNetDevice/PhyRxDrop";
+      Config::Connect (oss.str (), MakeCallback (&Sink));
+    }
+  PrintTime (start, nodes);
+
+  start = NowNs ();
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/TxQueue/Drop",
+                                 MakeCallback (&SinkWithoutContext));
+  PrintTime (start, nodes);
+
+  start = NowNs ();
+  Config::Set ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/PointToPointMode",
+               BooleanValue (true));
+  PrintTime (start, nodes);
+  std::cout << std::endl;
+
+  Simulator::Destroy ();
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t minNodes = 1000;
+  uint32_t maxNodes = 16000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the cost of Config::Connect and Config::Set vs the number of nodes.\n"
+             "\n"
+             "For each number of nodes, from min to max, doubling, create the\n"
+             "nodes with a SimpleNetDevice each, then connect a trace sink to all\n"
+             "the devices with one wildcard path, again with one path per node,\n"
+             "through a pointer attribute without context, and set an attribute\n"
+             "of all the devices. The table reports the total time in ms and the\n"
+             "time per node in us of each.");
+  cmd.AddValue ("min", "smallest number of nodes (default 1000)", minNodes);
+  cmd.AddValue ("max", "largest number of nodes (default 16000)", maxNodes);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+
+  LOGME ("nodes: " << minNodes << " to " << maxNodes);
+  LOG ("");
+  LOG (std::setw (g_fwidth) << "" <<
+       std::setw (2 * g_fwidth) << "Connect *" <<
+       std::setw (2 * g_fwidth) << "Connect each" <<
+       std::setw (2 * g_fwidth) << "Pointer *" <<
+       std::setw (2 * g_fwidth) << "Set *");
+  std::cout << std::setw (g_fwidth) << "Nodes";
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      std::cout << std::setw (g_fwidth) << "ms" << std::setw (g_fwidth) << "us/node";
+    }
+  std::cout << std::endl;
+  LOG (std::setfill ('-') << std::setw (9 * g_fwidth) << "" << std::setfill (' '));
+
+  for (uint32_t nodes = minNodes; nodes <= maxNodes; nodes *= 2)
+    {
+      Bench (nodes);
+    }
+
+  LOG ("");
+  return 0;
+}
@@ -0,0 +1,336 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include "ns3/core-module.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+
+using namespace ns3;
+
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 12;
+
+/**
+ * \returns The monotonic clock, in ns.
+ */
+static uint64_t
+NowNs (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * The producer threads inject events, stamped with the time they were
+ * injected; the consumer records the latency of each event.
+ */
+class Injection
+{
+public:
+  Injection (uint32_t producers, uint32_t events, uint64_t interval);
+  virtual ~Injection ();
+
+  /**
+   * Run the producers and the consumer, and print the results.
+   *
+   * \param name The name of the row.
+   */
+  void Run (std::string name);
+
+protected:
+  /**
+   * Inject an event, from a producer thread.
+   *
+   * \param stamp The injection time, in ns.
+   */
+  virtual void Inject (uint64_t stamp) = 0;
+  /** Consume the events until all of them have been received. */
+  virtual void Consume (void) = 0;
+  /**
+   * Record the reception of an event.
+   *
+   * \param stamp The injection time, in ns.
+   */
+  void Received (uint64_t stamp);
+  /** \returns true if all the events have been received. */
+  bool IsDone (void) const;
+
+private:
+  /** The producer thread. */
+  void Produce (void);
+
+  uint32_t m_producers;              //!< The number of producer threads.
+  uint32_t m_events;                 //!< The number of events per producer.
+  uint64_t m_interval;               //!< The time between two events of a producer, in ns.
+  std::vector<uint64_t> m_latencies; //!< The latencies of the received events.
+};
+
+Injection::Injection (uint32_t producers, uint32_t events, uint64_t interval)
+  : m_producers (producers),
+    m_events (events),
+    m_interval (interval)
+{
+}
+
+Injection::~Injection ()
+{
+}
+
+void
+Injection::Produce (void)
+{
+  uint64_t next = NowNs ();
+  for (uint32_t i = 0; i < m_events; i++)
+    {
+      if (m_interval > 0)
+        {
+          next += m_interval;
+          while (NowNs () < next)
+            {
+            }
+        }
+      Inject (NowNs ());
+    }
+}
+
+void
+Injection::Received (uint64_t stamp)
+{
+  m_latencies.push_back (NowNs () - stamp);
+}
+
+bool
+Injection::IsDone (void) const
+{
+  return m_latencies.size () == (uint64_t) m_producers * m_events;
+}
+
+void
+Injection::Run (std::string name)
+{
+  m_latencies.clear ();
+  m_latencies.reserve ((uint64_t) m_producers * m_events);
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads.push_back (Create<SystemThread> (MakeCallback (&Injection::Produce, this)));
+    }
+  uint64_t start = NowNs ();
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads[i]->Start ();
+    }
+  Consume ();
+  double elapsed = (NowNs () - start) / 1e9;
+  for (uint32_t i = 0; i < m_producers; i++)
+    {
+      threads[i]->Join ();
+    }
+
+  std::sort (m_latencies.begin (), m_latencies.end ());
+  uint64_t n = m_latencies.size ();
+  std::cout << std::left << std::setw (2 * g_fwidth) << name << std::right <<
+    std::setw (g_fwidth) << (uint64_t)(n / elapsed) <<
+    std::setw (g_fwidth) << m_latencies[n / 2] / 1000.0 <<
+    std::setw (g_fwidth) << m_latencies[n * 99 / 100] / 1000.0 <<
+    std::setw (g_fwidth) << m_latencies[n * 999 / 1000] / 1000.0 <<
+    std::setw (g_fwidth) << m_latencies[n - 1] / 1000.0 << std::endl;
+}
+
+/**
+ * Inject the events with Simulator::ScheduleWithContext, into a running
+ * simulation.
+ */
+class SimulatorInjection : public Injection
+{
+public:
+  SimulatorInjection (uint32_t producers, uint32_t events, uint64_t interval)
+    : Injection (producers, events, interval)
+  {
+    // create the simulator in the main thread, before the producers
+    Simulator::Now ();
+  }
+
+protected:
+  virtual void Inject (uint64_t stamp)
+  {
+    Simulator::ScheduleWithContext (0, Seconds (0), &SimulatorInjection::Receive, this, stamp);
+  }
+  virtual void Consume (void)
+  {
+    Simulator::Schedule (Seconds (0), &SimulatorInjection::Tick, this);
+    Simulator::Run ();
+  }
+
+private:
+  void Receive (uint64_t stamp)
+  {
+    Received (stamp);
+  }
+  /** Keep the simulation running until all the events are received. */
+  void Tick (void)
+  {
+    if (IsDone ())
+      {
+        Simulator::Stop ();
+        return;
+      }
+    Simulator::Schedule (MicroSeconds (1), &SimulatorInjection::Tick, this);
+  }
+};
+
+/**
+ * Inject the events into a queue, drained by the consumer in a loop.
+ *
+ * \tparam QUEUE The queue, with Push and PopAll.
+ */
+template <typename QUEUE>
+class QueueInjection : public Injection
+{
+public:
+  QueueInjection (uint32_t producers, uint32_t events, uint64_t interval)
+    : Injection (producers, events, interval)
+  {
+  }
+
+protected:
+  virtual void Inject (uint64_t stamp)
+  {
+    m_queue.Push (stamp);
+  }
+  virtual void Consume (void)
+  {
+    std::vector<uint64_t> stamps;
+    while (!IsDone ())
+      {
+        stamps.clear ();
+        m_queue.PopAll (stamps);
+        for (std::vector<uint64_t>::const_iterator i = stamps.begin (); i != stamps.end (); i++)
+          {
+            Received (*i);
+          }
+      }
+  }
+
+private:
+  QUEUE m_queue;  //!< The queue.
+};
+
+/**
+ * The list and mutex, which DefaultSimulatorImpl used before MpscQueue.
+ */
+class LockedListQueue
+{
+public:
+  void Push (uint64_t stamp)
+  {
+    CriticalSection cs (m_mutex);
+    m_list.push_back (stamp);
+  }
+  void PopAll (std::vector<uint64_t> &stamps)
+  {
+    std::list<uint64_t> list;
+    {
+      CriticalSection cs (m_mutex);
+      m_list.swap (list);
+    }
+    stamps.insert (stamps.end (), list.begin (), list.end ());
+  }
+
+private:
+  std::list<uint64_t> m_list;  //!< The queue.
+  SystemMutex m_mutex;         //!< Protect m_list.
+};
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t producers = 4;
+  uint32_t events = 100000;
+  uint64_t interval = 0;
+  uint32_t runs = 1;
+  bool realtime = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the injection of events from other threads.\n"
+             "\n"
+             "The producer threads schedule events with ScheduleWithContext\n"
+             "into a running simulation, then push the same events to the\n"
+             "lock-free MpscQueue and to a list protected by a mutex, drained\n"
+             "by a consumer loop. The table reports the events per second and\n"
+             "the latency from the injection to the execution of the events.");
+  cmd.AddValue ("producers", "number of producer threads (default 4)", producers);
+  cmd.AddValue ("events", "number of events per producer (default 1E5)", events);
+  cmd.AddValue ("interval", "time between two events of a producer, in ns, "
+                "0 for as fast as possible (default 0)", interval);
+  cmd.AddValue ("realtime", "use the RealtimeSimulatorImpl", realtime);
+  cmd.AddValue ("runs", "number of runs (default 1)", runs);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+
+  if (realtime)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+    }
+  LOGME ("producers: " << producers);
+  LOGME ("events per producer: " << events);
+  LOGME ("interval: " << interval << " ns");
+
+  LOG ("");
+  LOG (std::left << std::setw (2 * g_fwidth) << "Injection" << std::right <<
+       std::setw (g_fwidth) << "Events/s" <<
+       std::setw (g_fwidth) << "p50 (us)" <<
+       std::setw (g_fwidth) << "p99 (us)" <<
+       std::setw (g_fwidth) << "p99.9 (us)" <<
+       std::setw (g_fwidth) << "max (us)");
+  LOG (std::setfill ('-') << std::setw (7 * g_fwidth) << "" << std::setfill (' '));
+
+  for (uint32_t i = 0; i < runs; i++)
+    {
+      SimulatorInjection simulator (producers, events, interval);
+      simulator.Run (realtime ? "RealtimeSimulatorImpl" : "DefaultSimulatorImpl");
+      Simulator::Destroy ();
+    }
+  for (uint32_t i = 0; i < runs; i++)
+    {
+      QueueInjection<MpscQueue<uint64_t> > queue (producers, events, interval);
+      queue.Run ("MpscQueue");
+    }
+  for (uint32_t i = 0; i < runs; i++)
+    {
+      QueueInjection<LockedListQueue> queue (producers, events, interval);
+      queue.Run ("mutex + std::list");
+    }
+
+  LOG ("");
+  return 0;
+}
@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <time.h>
+
+#include "ns3/core-module.h"
+#include "ns3/rng-stream.h"
+
+using namespace ns3;
+
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/**
+ * \returns The monotonic clock, in ns.
+ */
+static uint64_t
+NowNs (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Print the time per value of a generator.
+ *
+ * \param name The name of the generator.
+ * \param start The start time, in ns.
+ * \param values The number of values generated.
+ * \param sum The sum of the values, so that they are not optimized out.
+ */
+static void
+Print (std::string name, uint64_t start, uint64_t values, double sum)
+{
+  double elapsed = NowNs () - start;
+  LOG (std::left << std::setw (3 * g_fwidth) << name << std::right
+       << std::setw (g_fwidth) << std::fixed << std::setprecision (2) << elapsed / values
+       << std::setw (2 * g_fwidth) << std::setprecision (0) << sum);
+}
+
+/**
+ * Generate the values one by one, and in bulk.
+ *
+ * \param name The name of the random variable.
+ * \param rv The random variable.
+ * \param values The number of values.
+ * \param batch The number of values of a bulk call.
+ */
+static void
+Bench (std::string name, Ptr<RandomVariableStream> rv, uint32_t values, uint32_t batch)
+{
+  std::vector<double> buffer (batch);
+  double sum = 0;
+  uint64_t start = NowNs ();
+  for (uint32_t i = 0; i < values; i++)
+    {
+      sum += rv->GetValue ();
+    }
+  Print (name + " GetValue", start, values, sum);
+
+  sum = 0;
+  start = NowNs ();
+  for (uint32_t i = 0; i < values; i += batch)
+    {
+      rv->GetValues (&buffer[0], batch);
+      for (uint32_t j = 0; j < batch; j++)
+        {
+          sum += buffer[j];
+        }
+    }
+  Print (name + " GetValues", start, values, sum);
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t values = 10000000;
+  uint32_t batch = 1024;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the generation of random numbers, one by one and in bulk.\n"
+             "\n"
+             "The table reports the time per value in ns of the MRG32k3a\n"
+             "generator (the first numbers of a stream, which are computed one\n"
+             "by one, then the numbers of a stream which draws many, one by one\n"
+             "and in bulk) and of a few random variables.");
+  cmd.AddValue ("values", "number of values of each generator (default 10000000)", values);
+  cmd.AddValue ("batch", "number of values of a bulk call (default 1024)", batch);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  batch = std::max (batch, (uint32_t) 1);
+  values = (values + batch - 1) / batch * batch;
+
+  LOGME ("values: " << values << ", batch: " << batch);
+  LOG ("");
+  LOG (std::left << std::setw (3 * g_fwidth) << "Generator" << std::right
+       << std::setw (g_fwidth) << "ns/value" << std::setw (2 * g_fwidth) << "sum");
+  LOG (std::setfill ('-') << std::setw (6 * g_fwidth) << "" << std::setfill (' '));
+
+  // the first numbers of fresh streams
+  RngStream stream (1, 2, 3);
+  double sum = 0;
+  uint64_t start = NowNs ();
+  for (uint32_t i = 0; i < values; i += 100)
+    {
+      RngStream fresh (stream);
+      for (uint32_t j = 0; j < 100; j++)
+        {
+          sum += fresh.RandU01 ();
+        }
+    }
+  Print ("RngStream first RandU01", start, values, sum);
+
+  sum = 0;
+  start = NowNs ();
+  for (uint32_t i = 0; i < values; i++)
+    {
+      sum += stream.RandU01 ();
+    }
+  Print ("RngStream RandU01", start, values, sum);
+
+  std::vector<double> buffer (batch);
+  sum = 0;
+  start = NowNs ();
+  for (uint32_t i = 0; i < values; i += batch)
+    {
+      stream.RandU01 (&buffer[0], batch);
+      for (uint32_t j = 0; j < batch; j++)
+        {
+          sum += buffer[j];
+        }
+    }
+  Print ("RngStream RandU01 bulk", start, values, sum);
+
+  Bench ("Uniform", CreateObject<UniformRandomVariable> (), values, batch);
+  Bench ("Exponential", CreateObject<ExponentialRandomVariable> (), values, batch);
+  Bench ("Normal", CreateObject<NormalRandomVariable> (), values, batch);
+
+  LOG ("");
+  return 0;
+}
@@ -0,0 +1,329 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "ns3/core-module.h"
+#include "ns3/scheduler-trace.h"
+
+using namespace ns3;
+
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/**
+ * Count the cache misses of this process with the perf events of Linux.
+ * The counter is not available on other systems, or if perf events are
+ * not permitted.
+ */
+class CacheMissCounter
+{
+public:
+  CacheMissCounter ()
+    : m_fd (-1)
+  {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset (&attr, 0, sizeof (attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof (attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    m_fd = syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+
+  ~CacheMissCounter ()
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        close (m_fd);
+      }
+#endif
+  }
+
+  bool IsAvailable (void) const
+  {
+    return m_fd >= 0;
+  }
+
+  void Start (void)
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        ioctl (m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl (m_fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+  }
+
+  uint64_t End (void)
+  {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (m_fd >= 0)
+      {
+        ioctl (m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read (m_fd, &count, sizeof (count)) != sizeof (count))
+          {
+            count = 0;
+          }
+      }
+#endif
+    return count;
+  }
+
+private:
+  int m_fd;
+};
+
+/**
+ * The events of the replay do nothing.
+ */
+class ReplayEvent : public EventImpl
+{
+protected:
+  virtual void Notify (void)
+  {
+  }
+};
+
+/**
+ * Replay a scheduler trace on schedulers.
+ */
+class Replay
+{
+public:
+  Replay (std::string filename, uint64_t minOperations);
+  void Run (ObjectFactory factory);
+
+private:
+  std::vector<SchedulerTraceRecord> m_records;
+  uint64_t m_minOperations;
+  uint32_t m_maxUid;
+  CacheMissCounter m_cacheMisses;
+};
+
+Replay::Replay (std::string filename, uint64_t minOperations)
+  : m_minOperations (minOperations),
+    m_maxUid (0)
+{
+  uint64_t counts[SchedulerTraceRecord::REMOVE + 1] = { 0, 0, 0, 0 };
+  SchedulerTraceReader reader (filename);
+  SchedulerTraceRecord record;
+  while (reader.Read (record))
+    {
+      m_records.push_back (record);
+      m_maxUid = std::max (m_maxUid, record.uid);
+      counts[record.operation]++;
+    }
+  LOGME ("records: " << m_records.size ());
+  LOGME ("inserts: " << counts[SchedulerTraceRecord::INSERT]);
+  LOGME ("executions: " << counts[SchedulerTraceRecord::EXECUTE]);
+  LOGME ("cancellations: " << counts[SchedulerTraceRecord::CANCEL]);
+  LOGME ("removals: " << counts[SchedulerTraceRecord::REMOVE]);
+  NS_ABORT_MSG_IF (m_records.empty (), "Empty scheduler trace file " << filename);
+  if (!m_cacheMisses.IsAvailable ())
+    {
+      LOGME ("cache misses: not available");
+    }
+}
+
+void
+Replay::Run (ObjectFactory factory)
+{
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+  bool removeCheap = scheduler->IsRemoveCheap ();
+
+  // Replay the trace several times, to measure at least m_minOperations.
+  // The events are created before the measurement, the uids of the i-th
+  // replay are offset by i * (m_maxUid + 1).
+  uint32_t replays = std::max<uint64_t> (1, (m_minOperations + m_records.size () - 1) / m_records.size ());
+  uint32_t uids = m_maxUid + 1;
+  std::vector<Ptr<EventImpl> > events (replays * uids);
+  std::vector<uint64_t> timestamps (replays * uids);
+  for (uint32_t replay = 0; replay < replays; replay++)
+    {
+      for (std::vector<SchedulerTraceRecord>::const_iterator i = m_records.begin (); i != m_records.end (); i++)
+        {
+          if (i->operation == SchedulerTraceRecord::INSERT)
+            {
+              events[replay * uids + i->uid] = Create<ReplayEvent> ();
+            }
+        }
+    }
+
+  uint64_t now = 0;
+  uint32_t size = 0;
+  uint32_t peak = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  m_cacheMisses.Start ();
+  for (uint32_t replay = 0; replay < replays; replay++)
+    {
+      uint32_t offset = replay * uids;
+      for (std::vector<SchedulerTraceRecord>::const_iterator i = m_records.begin (); i != m_records.end (); i++)
+        {
+          uint32_t uid = offset + i->uid;
+          Scheduler::Event ev;
+          switch (i->operation)
+            {
+            case SchedulerTraceRecord::INSERT:
+              ev.impl = PeekPointer (events[uid]);
+              ev.key.m_ts = now + i->delay;
+              ev.key.m_uid = uid;
+              ev.key.m_context = 0;
+              timestamps[uid] = ev.key.m_ts;
+              scheduler->Insert (ev);
+              peak = std::max (peak, ++size);
+              break;
+            case SchedulerTraceRecord::EXECUTE:
+              // skip the events, which were cancelled but not removed
+              do
+                {
+                  ev = scheduler->RemoveNext ();
+                  size--;
+                }
+              while (ev.impl->IsCancelled ());
+              NS_ABORT_MSG_UNLESS (ev.key.m_uid == uid,
+                                   "Event " << ev.key.m_uid - offset << " executed instead of " << i->uid <<
+                                   ", the trace was not recorded from the start of the simulation");
+              now = ev.key.m_ts;
+              break;
+            case SchedulerTraceRecord::CANCEL:
+              if (!removeCheap)
+                {
+                  events[uid]->Cancel ();
+                  break;
+                }
+              // fall through
+            case SchedulerTraceRecord::REMOVE:
+              ev.impl = PeekPointer (events[uid]);
+              ev.key.m_ts = timestamps[uid];
+              ev.key.m_uid = uid;
+              ev.key.m_context = 0;
+              scheduler->Remove (ev);
+              ev.impl->Cancel ();
+              size--;
+              break;
+            }
+        }
+      // Drop the events left at the end of the recorded simulation. The
+      // next replay starts after them, as time cannot go backwards.
+      while (!scheduler->IsEmpty ())
+        {
+          now = scheduler->RemoveNext ().key.m_ts;
+        }
+      size = 0;
+    }
+  uint64_t misses = m_cacheMisses.End ();
+  double elapsed = time.End () / 1000.0;
+  uint64_t operations = (uint64_t) replays * m_records.size ();
+
+  std::cout << std::left << std::setw (2 * g_fwidth) << factory.GetTypeId ().GetName () <<
+    std::setw (g_fwidth) << elapsed <<
+    std::setw (g_fwidth) << (elapsed * 1e9 / operations);
+  if (m_cacheMisses.IsAvailable ())
+    {
+      std::cout << std::setw (g_fwidth) << ((double) misses / operations);
+    }
+  else
+    {
+      std::cout << std::setw (g_fwidth) << "n/a";
+    }
+  LOG (std::setw (g_fwidth) << peak);
+}
+
+
+int main (int argc, char *argv[])
+{
+  std::string filename = "";
+  std::string schedulers = "ns3::MapScheduler,ns3::HeapScheduler,ns3::ListScheduler,"
+    "ns3::CalendarScheduler,ns3::IndexedHeapScheduler";
+  uint32_t runs = 1;
+  uint64_t ops = 1000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the schedulers on a recorded scheduler trace.\n"
+             "\n"
+             "Record the trace of a simulation with\n"
+             "  --ns3::DefaultSimulatorImpl::SchedulerTraceFile=<filename>\n"
+             "and replay it with --file=<filename>. Every scheduler runs the\n"
+             "same sequence of insertions, executions, cancellations and\n"
+             "removals. The table reports the time per operation, the cache\n"
+             "misses per operation, and the peak number of events in the\n"
+             "scheduler, including the cancelled events, which are not removed.");
+  cmd.AddValue ("file",  "scheduler trace file", filename);
+  cmd.AddValue ("schedulers", "comma-separated list of scheduler TypeIds", schedulers);
+  cmd.AddValue ("runs",  "number of runs per scheduler (default 1)", runs);
+  cmd.AddValue ("ops",   "minimum number of operations per run, the trace is replayed "
+                "as many times as needed (default 1E6)", ops);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+
+  if (filename.empty ())
+    {
+      std::cerr << g_me << "no scheduler trace file, see --help" << std::endl;
+      return 1;
+    }
+
+  LOGME ("file: " << filename);
+  Replay replay (filename, ops);
+
+  LOG ("");
+  LOG (std::left << std::setw (2 * g_fwidth) << "Scheduler" <<
+       std::setw (g_fwidth) << "Time (s)" <<
+       std::setw (g_fwidth) << "Per (ns/op)" <<
+       std::setw (g_fwidth) << "Misses/op" <<
+       std::setw (g_fwidth) << "Peak size");
+  LOG (std::setfill ('-') << std::setw (6 * g_fwidth) << "" << std::setfill (' '));
+
+  std::istringstream names (schedulers);
+  std::string name;
+  while (std::getline (names, name, ','))
+    {
+      ObjectFactory factory (name);
+      for (uint32_t i = 0; i < runs; i++)
+        {
+          replay.Run (factory);
+        }
+    }
+
+  LOG ("");
+  return 0;
+}
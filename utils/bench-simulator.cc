@@ -22,6 +22,8 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <new>
+#include <stdlib.h>
 #include <string.h>
 
 #include "ns3/core-module.h"
@@ -39,13 +41,35 @@ std::string g_me;
 // Output field width
 int g_fwidth = 6;
 
+// Number of heap allocations
+uint64_t g_allocations = 0;
+
+void *
+operator new (size_t size)
+{
+  ++g_allocations;
+  void *p = malloc (size ? size : 1);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void
+operator delete (void *p) throw ()
+{
+  free (p);
+}
+
 class Bench 
 {
 public:
   Bench (const uint32_t population, const uint32_t total)
   : m_population (population),
     m_total (total),
-    m_count (0)
+    m_count (0),
+    m_cancel (false)
   { };
   
   void SetRandomStream (Ptr<RandomVariableStream> stream)
@@ -62,15 +86,23 @@ public:
   {
     m_total = total;
   }
+
+  void SetCancel (const bool cancel)
+  {
+    m_cancel = cancel;
+  }
     
   void RunBench (void);
 private:
   void Cb (void);
+  void Timeout (void);
   
   Ptr<RandomVariableStream> m_rand;
   uint32_t m_population;
   uint32_t m_total;
   uint32_t m_count;
+  bool m_cancel;
+  std::vector<EventId> m_timeouts;
 };
 
 void
@@ -78,9 +110,13 @@ Bench::RunBench (void)
 {
   SystemWallClockMs time;
   double init, simu;
+  uint64_t initAllocs, simuAllocs;
 
   DEB ("initializing");
+  m_count = 0;
+  m_timeouts.assign (m_population, EventId ());
 
+  initAllocs = g_allocations;
   time.Start ();
   for (uint32_t i = 0; i < m_population; ++i)
     {
@@ -89,21 +125,26 @@ Bench::RunBench (void)
     }
   init = time.End ();
   init /= 1000;
+  initAllocs = g_allocations - initAllocs;
   DEB ("initialization took " << init << "s");
 
   DEB ("running");
+  simuAllocs = g_allocations;
   time.Start ();
   Simulator::Run ();
   simu = time.End ();
   simu /= 1000;
+  simuAllocs = g_allocations - simuAllocs;
   DEB ("run took " << simu << "s");
 
   LOG (std::setw (g_fwidth) << init <<
        std::setw (g_fwidth) << (m_population / init) <<
        std::setw (g_fwidth) << (init / m_population) <<
+       std::setw (g_fwidth) << ((double) initAllocs / m_population) <<
        std::setw (g_fwidth) << simu <<
        std::setw (g_fwidth) << (m_count / simu) <<
-       std::setw (g_fwidth) << (simu / m_count));
+       std::setw (g_fwidth) << (simu / m_count) <<
+       std::setw (g_fwidth) << ((double) simuAllocs / m_count));
 
   // Clean up scheduler
   Simulator::Destroy ();
@@ -120,9 +161,22 @@ Bench::Cb (void)
 
   Time after = NanoSeconds (m_rand->GetValue ());
   Simulator::Schedule (after, &Bench::Cb, this);
+  if (m_cancel)
+    {
+      // Restart a timeout, like a MAC waiting for an ack: the previous
+      // timeout of this slot is cancelled before it expires.
+      EventId &timeout = m_timeouts[m_count % m_population];
+      timeout.Cancel ();
+      timeout = Simulator::Schedule (after * 10, &Bench::Timeout, this);
+    }
   ++m_count;
 }
 
+void
+Bench::Timeout (void)
+{
+}
+
 
 Ptr<RandomVariableStream>
 GetRandomStream (std::string filename)
@@ -184,8 +238,11 @@ int main (int argc, char *argv[])
 
   bool schedCal  = false;
   bool schedHeap = false;
+  bool schedIndexed = false;
   bool schedList = false;
   bool schedMap  = true;
+  bool pool      = true;
+  bool cancel    = false;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
@@ -203,8 +260,11 @@ int main (int argc, char *argv[])
              "to be ascii, giving the relative event times in ns.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("indexed", "use IndexedHeapScheduler",    schedIndexed);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("pool",  "reuse the memory of events (default true)", pool);
+  cmd.AddValue ("cancel", "restart a timeout in every event, cancelling the previous one", cancel);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
@@ -218,32 +278,42 @@ int main (int argc, char *argv[])
   ObjectFactory factory ("ns3::MapScheduler");
   if (schedCal)  { factory.SetTypeId ("ns3::CalendarScheduler"); }
   if (schedHeap) { factory.SetTypeId ("ns3::HeapScheduler");     }
+  if (schedIndexed) { factory.SetTypeId ("ns3::IndexedHeapScheduler"); }
   if (schedList) { factory.SetTypeId ("ns3::ListScheduler");     }  
   Simulator::SetScheduler (factory);
+  if (!pool)
+    {
+      EventImpl::DisablePool ();
+    }
 
   LOGME (std::setprecision (g_fwidth - 6));
   DEB ("debugging is ON");
 
   LOGME ("scheduler: " << factory.GetTypeId ().GetName ());
+  LOGME ("event pool: " << (pool ? "enabled" : "disabled"));
+  LOGME ("cancelled timeouts: " << (cancel ? "enabled" : "disabled"));
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
   
   Bench *bench = new Bench (pop, total);
   bench->SetRandomStream (GetRandomStream (filename));
+  bench->SetCancel (cancel);
 
   // table header
   LOG ("");
   LOG (std::left << std::setw (g_fwidth) << "Run #" <<
-       std::left << std::setw (3 * g_fwidth) << "Inititialization:" <<
-       std::left << std::setw (3 * g_fwidth) << "Simulation:");
+       std::left << std::setw (4 * g_fwidth) << "Inititialization:" <<
+       std::left << std::setw (4 * g_fwidth) << "Simulation:");
   LOG (std::left << std::setw (g_fwidth) << "" <<
        std::left << std::setw (g_fwidth) << "Time (s)" <<
        std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
        std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
+       std::left << std::setw (g_fwidth) << "Allocs/ev" <<
        std::left << std::setw (g_fwidth) << "Time (s)" <<
        std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
-       std::left << std::setw (g_fwidth) << "Per (s/ev)" );
+       std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
+       std::left << std::setw (g_fwidth) << "Allocs/ev" );
   LOG (std::setfill ('-') <<
        std::right << std::setw (g_fwidth) << " " <<
        std::right << std::setw (g_fwidth) << " " <<       
@@ -251,6 +321,8 @@ int main (int argc, char *argv[])
        std::right << std::setw (g_fwidth) << " " <<       
        std::right << std::setw (g_fwidth) << " " <<       
        std::right << std::setw (g_fwidth) << " " <<       
+       std::right << std::setw (g_fwidth) << " " <<       
+       std::right << std::setw (g_fwidth) << " " <<       
        std::right << std::setw (g_fwidth) << " " <<
        std::setfill (' ')
        );
@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <time.h>
+
+#include <sqlite3.h>
+
+#include "ns3/core-module.h"
+#include "ns3/stats-module.h"
+
+using namespace ns3;
+
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+
+// Output field width
+int g_fwidth = 14;
+
+/**
+ * \returns The monotonic clock, in ns.
+ */
+static uint64_t
+NowNs (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * Print the rate of an output.
+ *
+ * \param name The name of the output.
+ * \param start The start time, in ns.
+ * \param rows The number of rows written.
+ */
+static void
+Print (std::string name, uint64_t start, uint64_t rows)
+{
+  double elapsed = NowNs () - start;
+  LOG (std::left << std::setw (3 * g_fwidth) << name << std::right
+       << std::setw (g_fwidth) << std::fixed << std::setprecision (0) << rows * 1e9 / elapsed
+       << std::setw (g_fwidth) << std::setprecision (3) << elapsed / 1e9);
+}
+
+/**
+ * A data calculator which outputs many counters and values, as the
+ * calculators of a large campaign.
+ */
+class ManyCalculator : public DataCalculator
+{
+public:
+  /**
+   * \param rows The number of rows.
+   */
+  ManyCalculator (uint32_t rows)
+    : m_rows (rows)
+  {
+  }
+
+  virtual void Output (DataOutputCallback &callback) const
+  {
+    for (uint32_t i = 0; i < m_rows; i += 2)
+      {
+        std::ostringstream context;
+        context << "node[" << i / 64 << "]";
+        callback.OutputSingleton (context.str (), "packets", i);
+        callback.OutputSingleton (context.str (), "delay", i * 1e-6);
+      }
+  }
+
+private:
+  uint32_t m_rows;  //!< The number of rows.
+};
+
+/**
+ * The former output of the singletons: a statement built and parsed per
+ * row, run by sqlite3_get_table, in a single transaction.
+ */
+class LegacyCallback : public DataOutputCallback
+{
+public:
+  /**
+   * \param db The database.
+   * \param run The run label.
+   */
+  LegacyCallback (sqlite3 *db, std::string run)
+    : m_db (db),
+      m_runLabel (run)
+  {
+    Exec ("create table if not exists Singletons ( run text, name text, variable text, value )");
+  }
+
+  /**
+   * Run a statement.
+   * \param exe The statement.
+   */
+  void Exec (std::string exe)
+  {
+    char **result;
+    int nrows, ncols;
+    char *errMsg = 0;
+    if (sqlite3_get_table (m_db, exe.c_str (), &result, &nrows, &ncols, &errMsg) != SQLITE_OK)
+      {
+        std::cerr << "sqlite3 error: " << errMsg << std::endl;
+      }
+    sqlite3_free_table (result);
+  }
+
+  /**
+   * Insert a singleton.
+   * \param key The name.
+   * \param variable The variable.
+   * \param val The value, as a SQL literal.
+   */
+  template <typename T>
+  void Insert (std::string key, std::string variable, T val)
+  {
+    std::stringstream sstr;
+    sstr << "insert into Singletons (run,name,variable,value) values ('" <<
+    m_runLabel << "', '" <<
+    key << "', '" <<
+    variable << "', " <<
+    val << ")";
+    Exec (sstr.str ());
+  }
+
+  virtual void OutputStatistic (std::string key, std::string variable,
+                                const StatisticalSummary *statSum)
+  {
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, int val)
+  {
+    Insert (key, variable, val);
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, uint32_t val)
+  {
+    Insert (key, variable, val);
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, double val)
+  {
+    Insert (key, variable, val);
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, std::string val)
+  {
+    Insert (key, variable, "'" + val + "'");
+  }
+  virtual void OutputSingleton (std::string key, std::string variable, Time val)
+  {
+    Insert (key, variable, val.GetTimeStep ());
+  }
+
+private:
+  sqlite3 *m_db;           //!< The database.
+  std::string m_runLabel;  //!< The run label.
+};
+
+/**
+ * Remove a database and its journals.
+ * \param prefix The prefix of the database.
+ */
+static void
+Remove (std::string prefix)
+{
+  std::remove ((prefix + ".db").c_str ());
+  std::remove ((prefix + ".db-journal").c_str ());
+  std::remove ((prefix + ".db-wal").c_str ());
+  std::remove ((prefix + ".db-shm").c_str ());
+}
+
+/**
+ * Output the data with a SqliteDataOutput.
+ *
+ * \param name The name of the configuration.
+ * \param data The data.
+ * \param prefix The prefix of the database.
+ * \param rows The number of rows.
+ * \param writeAheadLog Use the write-ahead log.
+ * \param asynchronous Insert the rows from a thread.
+ */
+static void
+Bench (std::string name, DataCollector &data, std::string prefix, uint32_t rows,
+       bool writeAheadLog, bool asynchronous)
+{
+  Remove (prefix);
+  Ptr<SqliteDataOutput> output = CreateObject<SqliteDataOutput> ();
+  output->SetFilePrefix (prefix);
+  output->SetAttribute ("WriteAheadLog", BooleanValue (writeAheadLog));
+  output->SetAttribute ("Asynchronous", BooleanValue (asynchronous));
+  uint64_t start = NowNs ();
+  output->Output (data);
+  if (asynchronous)
+    {
+      Print (name + " Output", start, rows);
+    }
+  output->Wait ();
+  Print (name, start, rows);
+  output->Dispose ();
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t rows = 1000000;
+  std::string prefix = "bench-sqlite-output";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the output of singletons to a SQLite database.\n"
+             "\n"
+             "The table reports the rows written per second by the former\n"
+             "output, a statement parsed per row, and by SqliteDataOutput,\n"
+             "with prepared statements, with the write-ahead log, and from a\n"
+             "thread (then the rate of Output, which returns before the rows\n"
+             "are written, is also reported).");
+  cmd.AddValue ("rows", "number of rows (default 1000000)", rows);
+  cmd.AddValue ("prefix", "prefix of the database, removed at the end", prefix);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  rows = (rows + 1) / 2 * 2;
+
+  DataCollector data;
+  data.DescribeRun ("bench", "sqlite", "singletons", "run0");
+  data.AddDataCalculator (CreateObject<ManyCalculator> (rows));
+
+  LOGME ("rows: " << rows << ", sqlite " << sqlite3_libversion ());
+  LOG ("");
+  LOG (std::left << std::setw (3 * g_fwidth) << "Output" << std::right
+       << std::setw (g_fwidth) << "rows/s" << std::setw (g_fwidth) << "s");
+  LOG (std::setfill ('-') << std::setw (5 * g_fwidth) << "" << std::setfill (' '));
+
+  Remove (prefix);
+  uint64_t start = NowNs ();
+  sqlite3 *db;
+  sqlite3_open ((prefix + ".db").c_str (), &db);
+  {
+    LegacyCallback callback (db, data.GetRunLabel ());
+    callback.Exec ("BEGIN");
+    for (DataCalculatorList::iterator i = data.DataCalculatorBegin ();
+         i != data.DataCalculatorEnd (); i++)
+      {
+        (*i)->Output (callback);
+      }
+    callback.Exec ("COMMIT");
+  }
+  sqlite3_close (db);
+  Print ("Statement per row", start, rows);
+
+  Bench ("Prepared statement", data, prefix, rows, false, false);
+  Bench ("Write-ahead log", data, prefix, rows, true, false);
+  Bench ("Write-ahead log, thread", data, prefix, rows, true, true);
+  Remove (prefix);
+
+  LOG ("");
+  return 0;
+}
@@ -0,0 +1,162 @@
+#! /usr/bin/env python
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+"""Read the binary traces written by ns3::BinaryTraceRecorder.
+
+As a module:
+
+    import imp
+    trace = imp.load_source('trace', 'utils/read-binary-trace.py')
+    series = trace.read('energy.nstr')
+    times, values = series['node0/RemainingEnergy']
+
+The times are in nanoseconds.  The lists convert to numpy arrays with
+numpy.array().
+
+As a program, it lists the series of a file, or prints the samples of a
+series as comma-separated values:
+
+    ./utils/read-binary-trace.py energy.nstr
+    ./utils/read-binary-trace.py energy.nstr node0/RemainingEnergy
+"""
+
+import struct
+import sys
+import zlib
+
+MAGIC = b'NS3TRACE'
+VERSION = 1
+SERIES_BLOCK = 1
+CHUNK_BLOCK = 2
+CODEC_DEFLATE = 1
+INTEGER_SERIES = 1
+
+
+def _varints(data, offset, end, count):
+    """Decode count variable-length integers, return them and the offset after."""
+    values = []
+    for _ in range(count):
+        value = 0
+        shift = 0
+        while True:
+            if offset >= end:
+                raise ValueError('truncated chunk')
+            byte = bytearray(data[offset:offset + 1])[0]
+            offset += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        # zigzag
+        values.append((value >> 1) ^ -(value & 1))
+    return values, offset
+
+
+def _decode_chunk(data, samples, times_size, integer):
+    """Decode the columns of a chunk."""
+    deltas, offset = _varints(data, 0, times_size, samples)
+    times = []
+    time = 0
+    for delta in deltas:
+        time += delta
+        times.append(time)
+
+    values = []
+    if integer:
+        deltas, offset = _varints(data, offset, len(data), samples)
+        last = 0
+        for delta in deltas:
+            last += delta
+            values.append(last)
+        return times, values
+
+    data = bytearray(data)
+    last = 0
+    for _ in range(samples):
+        control = data[offset]
+        offset += 1
+        lead = control >> 4
+        length = control & 0x0f
+        x = 0
+        for j in range(length):
+            x |= data[offset + j] << (8 * (7 - lead - j))
+        offset += length
+        last ^= x
+        values.append(struct.unpack('<d', struct.pack('<Q', last))[0])
+    return times, values
+
+
+def read(filename):
+    """Read a binary trace.
+
+    Returns a dictionary from the names of the series to a pair of lists,
+    the times of the samples in nanoseconds and their values.
+    """
+    with open(filename, 'rb') as f:
+        data = f.read()
+    if data[:8] != MAGIC or struct.unpack_from('<I', data, 8)[0] != VERSION:
+        raise ValueError('%s is not a binary trace' % filename)
+
+    names = {}
+    types = {}
+    series = {}
+    offset = 16
+    while offset < len(data):
+        block = bytearray(data[offset:offset + 1])[0]
+        if block == SERIES_BLOCK:
+            sid, stype, size = struct.unpack_from('<IBH', data, offset + 1)
+            name = data[offset + 8:offset + 8 + size].decode('utf-8')
+            names[sid] = name
+            types[sid] = stype
+            series[name] = ([], [])
+            offset += 8 + size
+        elif block == CHUNK_BLOCK:
+            sid, samples, codec, times_size, raw_size, stored_size = \
+                struct.unpack_from('<IIBIII', data, offset + 1)
+            offset += 22
+            chunk = data[offset:offset + stored_size]
+            offset += stored_size
+            if codec == CODEC_DEFLATE:
+                chunk = zlib.decompress(chunk)
+            if len(chunk) != raw_size:
+                raise ValueError('corrupted chunk in %s' % filename)
+            times, values = _decode_chunk(chunk, samples, times_size,
+                                          types[sid] == INTEGER_SERIES)
+            series[names[sid]][0].extend(times)
+            series[names[sid]][1].extend(values)
+        else:
+            raise ValueError('unknown block in %s' % filename)
+    return series
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.stderr.write(__doc__)
+        return 1
+    series = read(argv[1])
+    if len(argv) < 3:
+        for name in sorted(series):
+            print('%s: %d samples' % (name, len(series[name][0])))
+        return 0
+    times, values = series[argv[2]]
+    print('time_ns,value')
+    for time, value in zip(times, values):
+        print('%d,%r' % (time, value))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))